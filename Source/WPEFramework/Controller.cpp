@@ -600,6 +600,29 @@ namespace Plugin {
         return (response);
     }
 
+    /* virtual */ Core::ProxyType<Core::JSON::IElement> Controller::Parameters(const string& designator)
+    {
+        Core::ProxyType<Core::JSON::IElement> result;
+        string callsign(Core::JSONRPC::Message::Callsign(designator));
+
+        if (callsign.empty() || (callsign == PluginHost::JSONRPC::Callsign())) {
+            result = PluginHost::JSONRPC::Parameters(designator);
+        } else {
+            Core::ProxyType<PluginHost::Server::Service> service;
+
+            // Forwarded calls can have their parameters parsed directly as well, if the plugin knows them.
+            if ((_pluginServer->Services().FromIdentifier(callsign, service) == Core::ERROR_NONE) && (service->State() == PluginHost::IShell::ACTIVATED)) {
+                PluginHost::IDispatcher* plugin = service->Dispatcher();
+
+                if (plugin != nullptr) {
+                    result = plugin->Parameters(Core::JSONRPC::Message::VersionedFullMethod(designator));
+                }
+            }
+        }
+
+        return (result);
+    }
+
     void Controller::DeleteDirectory(const string& directory)
     {
         Core::Directory dir(directory.c_str());
@@ -284,6 +284,7 @@ namespace Plugin {
         void Transfered(const uint32_t result, const string& source, const string& destination);
         void StateChange(PluginHost::IShell* plugin);
         virtual Core::ProxyType<Core::JSONRPC::Message> Invoke(const uint32_t channelId, const Core::JSONRPC::Message& inbound) override;
+        virtual Core::ProxyType<Core::JSON::IElement> Parameters(const string& designator) override;
         void DeleteDirectory(const string& directory);
 
         void RegisterAll();
@@ -16,6 +16,12 @@ set(PRIORITY 0 CACHE STRING "Change the nice level [-20 - 20]")
 set(POLICY 0 CACHE STRING "NA")
 set(OOMADJUST 0 CACHE STRING "Adapt the OOM score [-15 - 15]")
 set(STACKSIZE 0 CACHE STRING "Default stack size per thread")
+set(REACTORS 1 CACHE STRING "Number of resource monitor threads serving the sockets")
+set(BACKPRESSURE_HIGH_BYTES 0 CACHE STRING "Bytes queued for a channel before its overflow policy kicks in (0 is unlimited)")
+set(BACKPRESSURE_HIGH_MESSAGES 0 CACHE STRING "Messages queued for a channel before its overflow policy kicks in (0 is unlimited)")
+set(BACKPRESSURE_POLICY "coalesce" CACHE STRING "What to do with a full channel send queue [coalesce, dropoldest, disconnect]")
+set(WEBSOCKET_COMPRESSION 0 CACHE STRING "WebSocket permessage-deflate level offered to clients [0 (off) - 9]")
+set(HTTP_COMPRESSION false CACHE STRING "Encode (gzip/deflate) HTTP response bodies for clients that accept it")
 
 map()
   key(plugins)
@@ -41,10 +47,26 @@ map()
     kv(policy ${POLICY})
     kv(oomadjust ${OOMADJUST})
     kv(stacksize ${STACKSIZE})
+    kv(reactors ${REACTORS})
 end()
 ans(PROCESS_CONFIG)
 map_append(${CONFIG} process ${PROCESS_CONFIG})
 
+map()
+    kv(highbytes ${BACKPRESSURE_HIGH_BYTES})
+    kv(highmessages ${BACKPRESSURE_HIGH_MESSAGES})
+    kv(policy ${BACKPRESSURE_POLICY})
+end()
+ans(BACKPRESSURE_CONFIG)
+map_append(${CONFIG} backpressure ${BACKPRESSURE_CONFIG})
+
+map()
+    kv(level ${WEBSOCKET_COMPRESSION})
+    kv(content ${HTTP_COMPRESSION})
+end()
+ans(COMPRESSION_CONFIG)
+map_append(${CONFIG} compression ${COMPRESSION_CONFIG})
+
 map()
     kv(callsign Controller)
     key(configuration)
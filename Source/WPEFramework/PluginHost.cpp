@@ -324,6 +324,13 @@ namespace PluginHost {
             if (serviceConfig.Process.StackSize.IsSet() == true) {
                 Core::Thread::DefaultStackSize(serviceConfig.Process.StackSize.Value());
             }
+
+            // Needs to be set before the first socket is opened.
+            if ((serviceConfig.Process.Reactors.IsSet() == true) && (serviceConfig.Process.Reactors.Value() > 1)) {
+                if (Core::ResourceMonitor::Instance().Reactors(serviceConfig.Process.Reactors.Value()) != Core::ERROR_NONE) {
+                    SYSLOG(Logging::Startup, (_T("Sockets already opened, running on %d reactor(s)."), Core::ResourceMonitor::Instance().Reactors()));
+                }
+            }
         }
 
 #ifndef __WIN32__
@@ -541,14 +548,27 @@ namespace PluginHost {
                     while (index.Next() == true) {
                         printf("  Thread%02d:  %d\n", count++, index.Current().Value());
                     }
+                    Core::JSON::ArrayType<MetaData::Server::Pool>::Iterator pools(metaData.Pools.Elements());
+                    printf("Pools:\n");
+                    while (pools.Next() == true) {
+                        const MetaData::Server::Pool& pool(pools.Current());
+                        printf("  %-24s hits: %d, misses: %d, in use: %d/%d, idle: %d, trimmed: %d\n", pool.Name.Value().c_str(), pool.Hits.Value(), pool.Misses.Value(), pool.InUse.Value(), pool.HighWater.Value(), pool.Idle.Value(), pool.Trimmed.Value());
+                    }
                     status->Release();
                     break;
                 }
 #if !defined(__WIN32__) && !defined(__APPLE__)
                 case 'M': {
-                    printf("\nMonitor callstack:\n");
-                    printf("============================================================\n");
-                    PublishCallstack(Core::ResourceMonitor::Instance().Id());
+                    Core::ResourceMonitor& monitor(Core::ResourceMonitor::Instance());
+
+                    for (uint8_t reactor = 0; reactor < monitor.Reactors(); reactor++) {
+                        // A reactor that never had a resource, has no thread either.
+                        if (monitor.Id(reactor) != 0) {
+                            printf("\nMonitor callstack [%d]:\n", reactor);
+                            printf("============================================================\n");
+                            PublishCallstack(monitor.Id(reactor));
+                        }
+                    }
                     break;
                 }
                 case 'Q':
@@ -24,6 +24,14 @@ ENUM_CONVERSION_BEGIN(PluginHost::InputHandler::type)
 
 ENUM_CONVERSION_END(PluginHost::InputHandler::type)
 
+ENUM_CONVERSION_BEGIN(PluginHost::Channel::overflow)
+
+    { PluginHost::Channel::COALESCE, _TXT("coalesce") },
+    { PluginHost::Channel::DROPOLDEST, _TXT("dropoldest") },
+    { PluginHost::Channel::DISCONNECT, _TXT("disconnect") },
+
+ENUM_CONVERSION_END(PluginHost::Channel::overflow)
+
 namespace PluginHost
 {
     /* static */ Core::ProxyType<Web::Response> Server::Channel::_missingCallsign(Core::ProxyType<Web::Response>::Create());
@@ -205,6 +213,11 @@ namespace PluginHost
                 newInfo.Name = name;
             }
 
+            newInfo.Depth = client->QueueDepth();
+            newInfo.Bytes = client->QueueBytes();
+            newInfo.Dropped = client->Dropped();
+            newInfo.Coalesced = client->Coalesced();
+
             metaData.Add(newInfo);
         }
     }
@@ -613,6 +626,21 @@ namespace PluginHost
         , _services(*this, _config, configuration.Process.IsSet() ? configuration.Process.StackSize.Value() : 0)
         , _controller()
     {
+        // Every channel that gets connected from now on, bounds its send queue to this.
+        PluginHost::Channel::DefaultLimits(PluginHost::Channel::Backpressure(
+            configuration.Backpressure.HighBytes.Value(),
+            configuration.Backpressure.LowBytes.Value(),
+            configuration.Backpressure.HighMessages.Value(),
+            configuration.Backpressure.LowMessages.Value(),
+            configuration.Backpressure.Policy.Value()));
+
+        // And offers WebSocket compression and encoded HTTP bodies, if configured.
+        PluginHost::Channel::DefaultCompression(Web::WebSocket::Compression(
+            configuration.Compression.Level.Value(),
+            configuration.Compression.WindowBits.Value(),
+            configuration.Compression.ContextTakeover.Value(),
+            configuration.Compression.Threshold.Value()));
+        PluginHost::Channel::DefaultEncoding(configuration.Compression.Content.Value());
 
         // See if the persitent path for our-selves exist, if not we will create it :-)
         Core::File persistentPath(_config.PersistentPath() + _T("PluginHost"));
@@ -91,6 +91,7 @@ namespace PluginHost {
                     , Policy()
                     , StackSize(0)
                     , Umask(0003)
+                    , Reactors(1)
                 {
                     Add(_T("user"), &User);
                     Add(_T("group"), &Group);
@@ -99,6 +100,7 @@ namespace PluginHost {
                     Add(_T("oomadjust"), &OOMAdjust);
                     Add(_T("stacksize"), &StackSize);
                     Add(_T("umask"), &Umask);
+                    Add(_T("reactors"), &Reactors);
                 }
                 ProcessSet(const ProcessSet& copy)
                     : Core::JSON::Container()
@@ -109,6 +111,7 @@ namespace PluginHost {
                     , Policy(copy.Policy)
                     , StackSize(copy.StackSize)
                     , Umask(copy.Umask)
+                    , Reactors(copy.Reactors)
                 {
                     Add(_T("user"), &User);
                     Add(_T("group"), &Group);
@@ -117,6 +120,7 @@ namespace PluginHost {
                     Add(_T("oomadjust"), &OOMAdjust);
                     Add(_T("stacksize"), &StackSize);
                     Add(_T("umask"), &Umask);
+                    Add(_T("reactors"), &Reactors);
                 }
                 ~ProcessSet()
                 {
@@ -131,6 +135,7 @@ namespace PluginHost {
                     OOMAdjust = RHS.OOMAdjust;
                     StackSize = RHS.StackSize;
                     Umask = RHS.Umask;
+                    Reactors = RHS.Reactors;
 
                     return (*this);
                 }
@@ -142,6 +147,7 @@ namespace PluginHost {
                 Core::JSON::EnumType<Core::ProcessInfo::scheduler> Policy;
                 Core::JSON::DecUInt32 StackSize;
                 Core::JSON::DecUInt16 Umask;
+                Core::JSON::DecUInt8 Reactors;
             };
 
             class InputConfig : public Core::JSON::Container {
@@ -180,6 +186,110 @@ namespace PluginHost {
                 Core::JSON::EnumType<PluginHost::InputHandler::type> Type;
             };
 
+            class BackpressureConfig : public Core::JSON::Container {
+            public:
+                BackpressureConfig()
+                    : Core::JSON::Container()
+                    , HighBytes(0)
+                    , LowBytes(0)
+                    , HighMessages(0)
+                    , LowMessages(0)
+                    , Policy(PluginHost::Channel::COALESCE)
+                {
+                    Add(_T("highbytes"), &HighBytes);
+                    Add(_T("lowbytes"), &LowBytes);
+                    Add(_T("highmessages"), &HighMessages);
+                    Add(_T("lowmessages"), &LowMessages);
+                    Add(_T("policy"), &Policy);
+                }
+                BackpressureConfig(const BackpressureConfig& copy)
+                    : Core::JSON::Container()
+                    , HighBytes(copy.HighBytes)
+                    , LowBytes(copy.LowBytes)
+                    , HighMessages(copy.HighMessages)
+                    , LowMessages(copy.LowMessages)
+                    , Policy(copy.Policy)
+                {
+                    Add(_T("highbytes"), &HighBytes);
+                    Add(_T("lowbytes"), &LowBytes);
+                    Add(_T("highmessages"), &HighMessages);
+                    Add(_T("lowmessages"), &LowMessages);
+                    Add(_T("policy"), &Policy);
+                }
+                ~BackpressureConfig()
+                {
+                }
+                BackpressureConfig& operator=(const BackpressureConfig& RHS)
+                {
+                    HighBytes = RHS.HighBytes;
+                    LowBytes = RHS.LowBytes;
+                    HighMessages = RHS.HighMessages;
+                    LowMessages = RHS.LowMessages;
+                    Policy = RHS.Policy;
+                    return (*this);
+                }
+
+                // Per channel send queue limits, 0 is unlimited. Bytes are only counted if highbytes is set.
+                Core::JSON::DecUInt32 HighBytes;
+                Core::JSON::DecUInt32 LowBytes;
+                Core::JSON::DecUInt32 HighMessages;
+                Core::JSON::DecUInt32 LowMessages;
+                Core::JSON::EnumType<PluginHost::Channel::overflow> Policy;
+            };
+
+            class CompressionConfig : public Core::JSON::Container {
+            public:
+                CompressionConfig()
+                    : Core::JSON::Container()
+                    , Level(0)
+                    , WindowBits(15)
+                    , ContextTakeover(true)
+                    , Threshold(WEBSOCKET_DEFLATE_THRESHOLD)
+                    , Content(false)
+                {
+                    Add(_T("level"), &Level);
+                    Add(_T("windowbits"), &WindowBits);
+                    Add(_T("contexttakeover"), &ContextTakeover);
+                    Add(_T("threshold"), &Threshold);
+                    Add(_T("content"), &Content);
+                }
+                CompressionConfig(const CompressionConfig& copy)
+                    : Core::JSON::Container()
+                    , Level(copy.Level)
+                    , WindowBits(copy.WindowBits)
+                    , ContextTakeover(copy.ContextTakeover)
+                    , Threshold(copy.Threshold)
+                    , Content(copy.Content)
+                {
+                    Add(_T("level"), &Level);
+                    Add(_T("windowbits"), &WindowBits);
+                    Add(_T("contexttakeover"), &ContextTakeover);
+                    Add(_T("threshold"), &Threshold);
+                    Add(_T("content"), &Content);
+                }
+                ~CompressionConfig()
+                {
+                }
+                CompressionConfig& operator=(const CompressionConfig& RHS)
+                {
+                    Level = RHS.Level;
+                    WindowBits = RHS.WindowBits;
+                    ContextTakeover = RHS.ContextTakeover;
+                    Threshold = RHS.Threshold;
+                    Content = RHS.Content;
+                    return (*this);
+                }
+
+                // WebSocket permessage-deflate, offered to clients if the level (1-9) is not 0.
+                Core::JSON::DecUInt8 Level;
+                Core::JSON::DecUInt8 WindowBits;
+                Core::JSON::Boolean ContextTakeover;
+                Core::JSON::DecUInt16 Threshold;
+
+                // HTTP response bodies, encoded (gzip/deflate) for clients that accept it.
+                Core::JSON::Boolean Content;
+            };
+
         public:
             Config()
                 : Version()
@@ -210,6 +320,8 @@ namespace PluginHost {
                 , DefaultTraceCategories(false)
                 , Process()
                 , Input()
+                , Backpressure()
+                , Compression()
                 , Configs()
             {
                 // No IdleTime
@@ -232,6 +344,8 @@ namespace PluginHost {
                 Add(_T("redirect"), &Redirect);
                 Add(_T("process"), &Process);
                 Add(_T("input"), &Input);
+                Add(_T("backpressure"), &Backpressure);
+                Add(_T("compression"), &Compression);
                 Add(_T("plugins"), &Plugins);
                 Add(_T("configs"), &Configs);
             }
@@ -260,6 +374,8 @@ namespace PluginHost {
             Core::JSON::String DefaultTraceCategories;
             ProcessSet Process;
             InputConfig Input;
+            BackpressureConfig Backpressure;
+            CompressionConfig Compression;
             Core::JSON::String Configs;
             Core::JSON::ArrayType<Plugin::Config> Plugins;
         };
@@ -372,6 +488,10 @@ namespace PluginHost {
                     newElement = _workers[teller].Runs();
                     metaData.ThreadPoolRuns.Add(newElement);
                 }
+
+                Core::ProxyPoolAdministrator::Instance().Visit([&metaData](const Core::IProxyPool& pool) {
+                    metaData.Pools.Add(MetaData::Server::Pool(pool));
+                });
             }
             inline ::ThreadId ThreadId(const uint8_t index) const
             {
@@ -1767,7 +1887,7 @@ namespace PluginHost {
         // Links. A Channel is identified by an ID, this way, whenever a link dies
         // (is closed) during the service process, the ChannelMap will
         // not find it and just "flush" the presented work.
-        class EXTERNAL Channel : public PluginHost::Channel {
+        class EXTERNAL Channel : public PluginHost::Channel, public Core::JSONRPC::Message::IResolver {
             Channel() = delete;
             Channel(const Channel& copy) = delete;
             Channel& operator=(const Channel&) = delete;
@@ -2090,6 +2210,8 @@ namespace PluginHost {
 
                 TRACE(WebFlow, (Core::proxy_cast<Web::Request>(request)));
 
+                PluginHost::Channel::Accepts(*request);
+
                 // See if a token has been hooked up to the request, maybe we need a
                 // different security provider.
                 if (request->WebToken.IsSet()) {
@@ -2207,7 +2329,10 @@ namespace PluginHost {
 
                 if (_service.IsValid() == true) {
                     if (State() == JSONRPC) {
-                        result = Factories::Instance().JSONRPC();
+                        Core::ProxyType<Web::JSONBodyType<Core::JSONRPC::Message>> message(Factories::Instance().JSONRPC());
+
+                        message->Resolver(this);
+                        result = message;
                     } else {
                         result = _service->Inbound(identifier);
                     }
@@ -2219,6 +2344,28 @@ namespace PluginHost {
             {
                 TRACE(SocketFlow, (element));
             }
+            // Called while a message from this channel is being parsed, on the same thread, so before it
+            // reaches Received(). Do not let a message that will be refused there reach the handlers.
+            virtual Core::ProxyType<Core::JSON::IElement> Parameters(const Core::JSONRPC::Message& message) override
+            {
+                Core::ProxyType<Core::JSON::IElement> result;
+
+                if (_service.IsValid() == true) {
+                    PluginHost::Channel::Lock();
+                    bool securityClearance = _security->Allowed(message);
+                    PluginHost::Channel::Unlock();
+
+                    if (securityClearance == true) {
+                        IDispatcher* dispatcher = _service->Dispatcher();
+
+                        if (dispatcher != nullptr) {
+                            result = dispatcher->Parameters(message.Designator.Value());
+                        }
+                    }
+                }
+
+                return (result);
+            }
             virtual void Received(Core::ProxyType<Core::JSON::IElement>& element)
             {
                 bool securityClearance = true;
@@ -2504,6 +2651,9 @@ namespace PluginHost {
                 // First clear all shit from last time..
                 Cleanup();
 
+                // Hand back the pooled elements that were not needed since the previous run.
+                Core::ProxyPoolAdministrator::Instance().Trim();
+
                 // Now suspend those that have no activity.
                 BaseClass::Iterator index(BaseClass::Clients());
 
@@ -0,0 +1,372 @@
+#include "Demultiplexer.h"
+
+namespace WPEFramework {
+
+namespace Broadcast {
+
+    constexpr uint8_t Demultiplexer::PacketSize;
+    constexpr uint8_t Demultiplexer::SyncByte;
+    constexpr uint16_t Demultiplexer::Pids;
+    constexpr uint16_t Demultiplexer::MaxSectionSize;
+
+    static constexpr uint16_t NoPid = static_cast<uint16_t>(~0);
+
+    /* static */ Core::ProxyPoolType<Core::DataStore> Demultiplexer::_pool(4);
+
+    Demultiplexer::Demultiplexer(const uint16_t packets)
+        : _adminLock()
+        , _dispatching(NoPid)
+        , _partialLength(0)
+        , _ring(packets * PacketSize)
+        , _statistics()
+    {
+        ::memset(_pids, 0, sizeof(_pids));
+    }
+
+    Demultiplexer::~Demultiplexer()
+    {
+        for (uint16_t index = 0; index < Pids; index++) {
+            delete _pids[index];
+        }
+    }
+
+    uint32_t Demultiplexer::Filter(const uint16_t pid, const uint8_t tableId, const uint8_t tableMask,
+        const uint16_t extension, const uint16_t extensionMask, ISection* callback)
+    {
+        uint32_t result = Core::ERROR_BAD_REQUEST;
+
+        if ((pid < Pids) && (callback != nullptr)) {
+            _adminLock.Lock();
+
+            if (_pids[pid] == nullptr) {
+                _pids[pid] = new Pid(_pool.Element(static_cast<uint32_t>(MaxSectionSize)));
+            }
+
+            std::vector<Selection>& filters(_pids[pid]->_filters);
+            std::vector<Selection>::iterator index(filters.begin());
+
+            while ((index != filters.end()) && (index->Callback != callback)) {
+                index++;
+            }
+
+            const Selection selection = { tableId, tableMask, extension, extensionMask, callback };
+
+            if (index == filters.end()) {
+                filters.push_back(selection);
+            } else {
+                *index = selection;
+            }
+
+            _adminLock.Unlock();
+
+            result = Core::ERROR_NONE;
+        }
+
+        return (result);
+    }
+
+    uint32_t Demultiplexer::Revoke(ISection* callback, const uint16_t pid)
+    {
+        uint32_t result = Core::ERROR_UNAVAILABLE;
+
+        _adminLock.Lock();
+
+        for (uint16_t index = (pid < Pids ? pid : 0); index < (pid < Pids ? pid + 1 : Pids); index++) {
+            Pid* entry = _pids[index];
+
+            if (entry != nullptr) {
+                std::vector<Selection>::iterator loop(entry->_filters.begin());
+
+                while (loop != entry->_filters.end()) {
+                    if (loop->Callback != callback) {
+                        loop++;
+                    } else if (_dispatching == index) {
+                        // Revoked from within a Handle() on this PID, Deliver() removes it.
+                        loop->Callback = nullptr;
+                        loop++;
+                        result = Core::ERROR_NONE;
+                    } else {
+                        loop = entry->_filters.erase(loop);
+                        result = Core::ERROR_NONE;
+                    }
+                }
+
+                if ((entry->_filters.empty() == true) && (_dispatching == NoPid)) {
+                    delete entry;
+                    _pids[index] = nullptr;
+                }
+            }
+        }
+
+        _adminLock.Unlock();
+
+        return (result);
+    }
+
+    void Demultiplexer::Reset()
+    {
+        _adminLock.Lock();
+
+        for (uint16_t index = 0; index < Pids; index++) {
+            if (_pids[index] != nullptr) {
+                _pids[index]->Reset();
+            }
+        }
+        _partialLength = 0;
+
+        _adminLock.Unlock();
+    }
+
+    uint32_t Demultiplexer::Input(const uint8_t data[], const uint32_t length)
+    {
+        uint32_t offset = 0;
+        uint32_t count = 0;
+
+        _adminLock.Lock();
+
+        if (_partialLength > 0) {
+            const uint8_t part = static_cast<uint8_t>(std::min(static_cast<uint32_t>(PacketSize - _partialLength), length));
+
+            ::memcpy(&(_partial[_partialLength]), data, part);
+            _partialLength += part;
+            offset = part;
+
+            if (_partialLength == PacketSize) {
+                Packet(_partial);
+                _partialLength = 0;
+                count++;
+            }
+        }
+
+        while (offset < length) {
+            if (data[offset] != SyncByte) {
+                // Lost the packet boundary, the next sync byte is only trusted if the packet after
+                // it starts with one as well (as far as we can see).
+                _statistics.SyncLosses++;
+
+                do {
+                    offset++;
+                } while ((offset < length) && ((data[offset] != SyncByte) || (((offset + PacketSize) < length) && (data[offset + PacketSize] != SyncByte))));
+            } else if ((length - offset) >= PacketSize) {
+                Packet(&(data[offset]));
+                offset += PacketSize;
+                count++;
+            } else {
+                _partialLength = static_cast<uint8_t>(length - offset);
+                ::memcpy(_partial, &(data[offset]), _partialLength);
+                offset = length;
+            }
+        }
+
+        _adminLock.Unlock();
+
+        return (count);
+    }
+
+    uint32_t Demultiplexer::Read(const int fd)
+    {
+        uint32_t result = Core::ERROR_NONE;
+        ssize_t size;
+
+        do {
+            size = ::read(fd, _ring.data(), _ring.size());
+        } while ((size < 0) && (errno == EINTR));
+
+        if (size > 0) {
+            Input(_ring.data(), static_cast<uint32_t>(size));
+        } else if (size == 0) {
+            result = Core::ERROR_UNAVAILABLE;
+        } else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            result = Core::ERROR_TIMEDOUT;
+        } else {
+            result = Core::ERROR_GENERAL;
+        }
+
+        return (result);
+    }
+
+    uint32_t Demultiplexer::Load(const string& fileName)
+    {
+        uint32_t result = Core::ERROR_OPENING_FAILED;
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+
+        if (fd != -1) {
+            while ((result = Read(fd)) == Core::ERROR_NONE) {
+                // Keep on reading till the end of the file.
+            }
+
+            if (result == Core::ERROR_UNAVAILABLE) {
+                result = Core::ERROR_NONE;
+            }
+
+            ::close(fd);
+        }
+
+        return (result);
+    }
+
+    void Demultiplexer::Packet(const uint8_t packet[])
+    {
+        const uint16_t pidId = ((packet[1] & 0x1F) << 8) | packet[2];
+        Pid* pid = _pids[pidId];
+
+        _statistics.Packets++;
+
+        if (pid == nullptr) {
+            // Not interested in this PID.
+        } else if ((packet[1] & 0x80) != 0) {
+            // The transport_error_indicator, whatever we were collecting is lost.
+            _statistics.TransportErrors++;
+            pid->Reset();
+        } else {
+            const uint8_t control = ((packet[3] >> 4) & 0x03);
+            uint8_t offset = 4;
+
+            if ((control & 0x02) != 0) {
+                // Skip the adaptation field, on a signalled discontinuity start all over.
+                if ((packet[4] > 0) && ((packet[5] & 0x80) != 0)) {
+                    pid->Reset();
+                }
+                offset = (packet[4] < (PacketSize - 5) ? 5 + packet[4] : PacketSize);
+            }
+
+            // Only packets with a payload count, sections are never scrambled.
+            if (((control & 0x01) != 0) && (offset < PacketSize) && ((packet[3] & 0xC0) == 0)) {
+                const uint8_t continuity = (packet[3] & 0x0F);
+
+                if (continuity == pid->_continuity) {
+                    // A duplicate packet, already processed.
+                    return;
+                } else if ((pid->_continuity <= 0x0F) && (continuity != ((pid->_continuity + 1) & 0x0F))) {
+                    // Lost packets, whatever we were collecting is incomplete.
+                    _statistics.ContinuityErrors++;
+                    pid->_filled = 0;
+                }
+
+                pid->_continuity = continuity;
+
+                const uint8_t* payload = &(packet[offset]);
+                uint8_t length = PacketSize - offset;
+
+                if ((packet[1] & 0x40) == 0) {
+                    if (pid->_filled > 0) {
+                        Collect(*pid, pidId, payload, length);
+                    }
+                } else {
+                    // The payload_unit_start_indicator, the pointer_field tells how many bytes
+                    // still finish the section we were collecting, before the new one(s) start.
+                    const uint8_t pointer = payload[0];
+
+                    payload++;
+                    length--;
+
+                    if (pointer >= length) {
+                        pid->_filled = 0;
+                    } else {
+                        if (pid->_filled > 0) {
+                            Collect(*pid, pidId, payload, pointer);
+                            pid->_filled = 0;
+                        }
+
+                        payload += pointer;
+                        length -= pointer;
+
+                        // Sections follow each other, till the end or stuffing.
+                        while ((length > 0) && (payload[0] != 0xFF)) {
+                            const uint8_t used = Collect(*pid, pidId, payload, length);
+
+                            payload += used;
+                            length -= used;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    uint8_t Demultiplexer::Collect(Pid& pid, const uint16_t pidId, const uint8_t data[], const uint8_t length)
+    {
+        uint8_t* section = pid._buffer->Buffer();
+        uint8_t used = 0;
+
+        if (pid._filled < 3) {
+            // Collect the header, to know the table and the length.
+            used = std::min(static_cast<uint8_t>(3 - pid._filled), length);
+            ::memcpy(&(section[pid._filled]), data, used);
+            pid._filled += used;
+
+            if (pid._filled == 3) {
+                const uint8_t tableId = section[0];
+
+                pid._length = 3 + (((section[1] & 0x0F) << 8) | section[2]);
+                pid._wanted = false;
+
+                for (const Selection& entry : pid._filters) {
+                    pid._wanted = pid._wanted || ((entry.Callback != nullptr) && (((tableId ^ entry.TableId) & entry.TableMask) == 0));
+                }
+            }
+        }
+
+        if (pid._filled >= 3) {
+            const uint8_t part = static_cast<uint8_t>(std::min(static_cast<uint16_t>(length - used), static_cast<uint16_t>(pid._length - pid._filled)));
+
+            // Sections of tables nobody is interested in, are only counted out.
+            if (pid._wanted == true) {
+                ::memcpy(&(section[pid._filled]), &(data[used]), part);
+            }
+            pid._filled += part;
+            used += part;
+
+            if (pid._filled == pid._length) {
+                if (pid._wanted == true) {
+                    Deliver(pid, pidId);
+                }
+                pid._filled = 0;
+            }
+        }
+
+        return (used);
+    }
+
+    void Demultiplexer::Deliver(Pid& pid, const uint16_t pidId)
+    {
+        const MPEG::Section section(Core::DataElement(pid._buffer, 0, pid._length));
+
+        if (((section.HasSectionSyntax() == true) && (pid._length < 12)) || (section.IsValid() == false)) {
+            _statistics.CRCErrors++;
+        } else {
+            const bool syntax = section.HasSectionSyntax();
+            const uint16_t extension = section.Extension();
+
+            _statistics.Sections++;
+            _dispatching = pidId;
+
+            // Index based, a callback may install new filters while we are at it.
+            for (uint32_t index = 0; index < pid._filters.size(); index++) {
+                const Selection& entry(pid._filters[index]);
+
+                if ((entry.Callback != nullptr) && (((section.TableId() ^ entry.TableId) & entry.TableMask) == 0) && ((syntax == false) || (((extension ^ entry.Extension) & entry.ExtensionMask) == 0))) {
+                    entry.Callback->Handle(section);
+                }
+            }
+
+            _dispatching = NoPid;
+
+            // Whoever kept a copy of the section, now owns this buffer. If nobody did, it goes back
+            // to the pool and is handed out right away again.
+            pid._buffer = _pool.Element(static_cast<uint32_t>(MaxSectionSize));
+
+            // Drop the filters revoked during the callbacks.
+            std::vector<Selection>::iterator index(pid._filters.begin());
+            while (index != pid._filters.end()) {
+                if (index->Callback == nullptr) {
+                    index = pid._filters.erase(index);
+                } else {
+                    index++;
+                }
+            }
+        }
+    }
+
+} // namespace Broadcast
+} // namespace WPEFramework
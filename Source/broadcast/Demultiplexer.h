@@ -0,0 +1,156 @@
+#ifndef __BROADCAST_DEMULTIPLEXER_H
+#define __BROADCAST_DEMULTIPLEXER_H
+
+// ---- Include system wide include files ----
+
+// ---- Include local include files ----
+#include "Definitions.h"
+#include "MPEGSection.h"
+#include "Module.h"
+
+// ---- Referenced classes and types ----
+
+// ---- Helper types and constants ----
+
+// ---- Helper functions ----
+
+// ---- Class Definition ----
+
+namespace WPEFramework {
+namespace Broadcast {
+
+    // Software section filter on an MPEG-2 transport stream. Whatever delivers the raw 188 byte
+    // packets (a DVR device, a .ts file, a socket), feeds them in here and the sections matching
+    // the installed filters are reassembled, CRC checked and offered on the ISection interface.
+    // The section offered is a view on the (pooled, reference counted) buffer it was reassembled
+    // in. Keeping a copy of the section keeps the buffer, the PID continues in another one from
+    // the pool, so nothing is copied nor allocated to hold on to a section.
+    class EXTERNAL Demultiplexer {
+    private:
+        Demultiplexer(const Demultiplexer&) = delete;
+        Demultiplexer& operator=(const Demultiplexer&) = delete;
+
+    public:
+        static constexpr uint8_t PacketSize = 188;
+        static constexpr uint8_t SyncByte = 0x47;
+        static constexpr uint16_t Pids = 8192;
+        static constexpr uint16_t MaxSectionSize = 4096 + 3;
+
+        struct Statistics {
+            uint64_t Packets;
+            uint32_t SyncLosses;
+            uint32_t TransportErrors;
+            uint32_t ContinuityErrors;
+            uint32_t CRCErrors;
+            uint32_t Sections;
+        };
+
+    private:
+        struct Selection {
+            uint8_t TableId;
+            uint8_t TableMask;
+            uint16_t Extension;
+            uint16_t ExtensionMask;
+            ISection* Callback;
+        };
+
+        class Pid {
+        private:
+            Pid(const Pid&) = delete;
+            Pid& operator=(const Pid&) = delete;
+
+        public:
+            Pid(const Core::ProxyType<Core::DataStore>& buffer)
+                : _filters()
+                , _continuity(~0)
+                , _filled(0)
+                , _length(0)
+                , _wanted(false)
+                , _buffer(buffer)
+            {
+            }
+            ~Pid()
+            {
+            }
+
+        public:
+            inline void Reset()
+            {
+                _continuity = ~0;
+                _filled = 0;
+                _length = 0;
+                _wanted = false;
+            }
+
+        public:
+            std::vector<Selection> _filters;
+            uint8_t _continuity;
+            // Bytes of the section collected so far, 0 if not collecting.
+            uint16_t _filled;
+            // Total length of the section, 0 if not yet known.
+            uint16_t _length;
+            // Is there a filter for the table being collected, if not, it is only skipped.
+            bool _wanted;
+            // Where the section is collected, MaxSectionSize bytes from the pool.
+            Core::ProxyType<Core::DataStore> _buffer;
+        };
+
+    public:
+        // The packets argument is the size of the read buffer, in packets, used by Read().
+        Demultiplexer(const uint16_t packets = 512);
+        ~Demultiplexer();
+
+    public:
+        // Install (or update) a filter for sections on the given PID. The table id and extension of
+        // a section are matched against the given values, only on the bits set in the masks. For
+        // sections without the section syntax (e.g. the TDT) the extension is not checked.
+        uint32_t Filter(const uint16_t pid, const uint8_t tableId, const uint8_t tableMask,
+            const uint16_t extension, const uint16_t extensionMask, ISection* callback);
+        inline uint32_t Filter(const uint16_t pid, const uint8_t tableId, ISection* callback)
+        {
+            return (Filter(pid, tableId, 0xFF, 0, 0, callback));
+        }
+        // Remove the filter(s) of this callback on the given PID, or on all PIDs.
+        uint32_t Revoke(ISection* callback, const uint16_t pid = ~0);
+
+        // Drop all partially collected sections, e.g. after a retune.
+        void Reset();
+
+        // Feed in transport stream data. It does not need to start or end on a packet boundary,
+        // a partial packet is kept till the next call. Returns the number of packets processed.
+        uint32_t Input(const uint8_t data[], const uint32_t length);
+
+        // Read a chunk of the transport stream from a file descriptor (DVR device, file, pipe) and
+        // process it. Returns ERROR_NONE if data was processed, ERROR_UNAVAILABLE at the end of the
+        // stream, ERROR_TIMEDOUT if a non-blocking descriptor had nothing available.
+        uint32_t Read(const int fd);
+        // Process a complete .ts file.
+        uint32_t Load(const string& fileName);
+
+        inline const Statistics& Statistic() const
+        {
+            return (_statistics);
+        }
+
+    private:
+        void Packet(const uint8_t packet[]);
+        uint8_t Collect(Pid& pid, const uint16_t pidId, const uint8_t data[], const uint8_t length);
+        void Deliver(Pid& pid, const uint16_t pidId);
+
+    private:
+        Core::CriticalSection _adminLock;
+        Pid* _pids[Pids];
+        uint16_t _dispatching;
+        uint8_t _partial[PacketSize];
+        uint8_t _partialLength;
+        std::vector<uint8_t> _ring;
+        Statistics _statistics;
+
+        // Shared by all demultiplexers, a section kept may outlive the demultiplexer it came from.
+        static Core::ProxyPoolType<Core::DataStore> _pool;
+    };
+
+} // namespace Broadcast
+} // namespace WPEFramework
+
+#endif // __BROADCAST_DEMULTIPLEXER_H
@@ -202,6 +202,89 @@ namespace Broadcast {
             private:
                 MPEG::Descriptor _data;
             };
+
+            class EXTERNAL ShortEvent {
+            private:
+                ShortEvent operator=(const ShortEvent& rhs) = delete;
+
+            public:
+                constexpr static uint8_t TAG = 0x4D;
+
+            public:
+                ShortEvent()
+                    : _data()
+                {
+                }
+                ShortEvent(const ShortEvent& copy)
+                    : _data(copy._data)
+                {
+                }
+                ShortEvent(const MPEG::Descriptor& copy)
+                    : _data(copy)
+                {
+                }
+                ~ShortEvent()
+                {
+                }
+
+            public:
+                // ISO 639-2 language code, e.g. "eng".
+                string Language() const
+                {
+                    return (_data.Length() >= 5 ? Core::ToString(reinterpret_cast<const char*>(&(_data[0])), 3) : string());
+                }
+                string Name() const
+                {
+                    const char* text;
+                    const uint8_t length = Name(text);
+                    return (length > 0 ? Core::ToString(text, length) : string());
+                }
+                string Text() const
+                {
+                    const char* text;
+                    const uint8_t length = Text(text);
+                    return (length > 0 ? Core::ToString(text, length) : string());
+                }
+                // The same, in place in the descriptor, nothing is copied. Returns the length.
+                uint8_t Name(const char*& text) const
+                {
+                    return (Characters(3, text));
+                }
+                uint8_t Text(const char*& text) const
+                {
+                    text = nullptr;
+                    return (_data.Length() > 5 ? Characters(3 + 1 + _data[3], text) : 0);
+                }
+
+            private:
+                uint8_t Characters(const uint8_t offset, const char*& text) const
+                {
+                    const uint8_t size = _data.Length() - 2;
+                    uint8_t result = 0;
+
+                    text = nullptr;
+
+                    if (offset < size) {
+                        const uint8_t length = std::min(_data[offset], static_cast<uint8_t>(size - offset - 1));
+                        uint8_t skip = 0;
+
+                        // A first byte below 0x20 selects the character table, 0x10 and 0x1F are followed
+                        // by more selector bytes. The text is handed out as is, without the selection.
+                        if ((length > 0) && (_data[offset + 1] < 0x20)) {
+                            skip = (_data[offset + 1] == 0x10 ? 3 : (_data[offset + 1] == 0x1F ? 2 : 1));
+                        }
+                        if (length > skip) {
+                            text = reinterpret_cast<const char*>(&(_data[offset + 1 + skip]));
+                            result = length - skip;
+                        }
+                    }
+
+                    return (result);
+                }
+
+            private:
+                MPEG::Descriptor _data;
+            };
         }
     }
 }
@@ -4,6 +4,7 @@
 // ---- Include system wide include files ----
 
 // ---- Include local include files ----
+#include "Definitions.h"
 #include "MPEGDescriptor.h"
 #include "MPEGSection.h"
 #include "Module.h"
@@ -20,10 +21,16 @@ namespace WPEFramework {
 namespace Broadcast {
     namespace DVB {
 
+        // The Event Information Table, one per service. The present/following tables hold (at most) two
+        // sections, the event running now and the next one. The schedule is spread over 16 table ids, in
+        // segments of 3 hours, and is sparse by design, so each section is parsed on its own.
         class EXTERNAL EIT {
         public:
-            static const uint16_t ACTUAL = 0x42;
-            static const uint16_t OTHER = 0x46;
+            static const uint16_t ACTUAL = 0x4E;
+            static const uint16_t OTHER = 0x4F;
+            static const uint16_t SCHEDULE_ACTUAL = 0x50;
+            static const uint16_t SCHEDULE_OTHER = 0x60;
+            static const uint16_t SCHEDULE_LAST = 0x6F;
 
         public:
             enum running {
@@ -35,26 +42,26 @@ namespace Broadcast {
             };
 
         public:
-            class ServiceIterator {
+            class EventIterator {
             public:
-                ServiceIterator()
+                EventIterator()
                     : _info()
                     , _offset(~0)
                 {
                 }
-                ServiceIterator(const Core::DataElement& data)
+                EventIterator(const Core::DataElement& data)
                     : _info(data)
                     , _offset(~0)
                 {
                 }
-                ServiceIterator(const ServiceIterator& copy)
+                EventIterator(const EventIterator& copy)
                     : _info(copy._info)
                     , _offset(copy._offset)
                 {
                 }
-                ~ServiceIterator() {}
+                ~EventIterator() {}
 
-                ServiceIterator& operator=(const ServiceIterator& RHS)
+                EventIterator& operator=(const EventIterator& RHS)
                 {
                     _info = RHS._info;
                     _offset = RHS._offset;
@@ -63,50 +70,62 @@ namespace Broadcast {
                 }
 
             public:
-                inline bool IsValid() const { return (_offset < _info.Size()); }
+                // The header and the descriptors of the event must both be there.
+                inline bool IsValid() const
+                {
+                    return (((static_cast<uint32_t>(_offset) + 12) <= _info.Size()) && ((static_cast<uint32_t>(_offset) + 12 + DescriptorSize()) <= _info.Size()));
+                }
                 inline void Reset() { _offset = ~0; }
                 inline bool Next()
                 {
                     if (_offset == static_cast<uint16_t>(~0)) {
                         _offset = 0;
-                    } else if (_offset < _info.Size()) {
-                        _offset += (DescriptorSize() + 5);
+                    } else if (IsValid() == true) {
+                        _offset += (DescriptorSize() + 12);
                     }
 
                     return (IsValid());
                 }
-                inline bool EIT_PF() const
+                inline uint16_t EventId() const
                 {
-                    return ((_info[_offset + 2] & 0x01) != 0);
+                    return ((_info[_offset + 0] << 8) | _info[_offset + 1]);
                 }
-                inline bool EIT_Schedule() const
+                // Seconds since the epoch (UTC), ~0 if the start time is not defined (NVOD reference events).
+                inline uint32_t StartTime() const
                 {
-                    return ((_info[_offset + 2] & 0x02) != 0);
+                    const uint16_t MJD = (_info[_offset + 2] << 8) | _info[_offset + 3];
+
+                    return (MJD == 0xFFFF ? ~0 : (static_cast<uint32_t>(MJD - 40587) * 86400) + Seconds(&(_info[_offset + 4])));
                 }
-                inline bool IsFreeToAir() const
+                // In seconds.
+                inline uint32_t Duration() const
                 {
-                    return ((_info[_offset + 3] & 0x10) != 0);
+                    return (Seconds(&(_info[_offset + 7])));
                 }
                 inline running RunningMode() const
                 {
-                    return (static_cast<running>((_info[_offset + 3] & 0xE0) >> 5));
+                    return (static_cast<running>((_info[_offset + 10] & 0xE0) >> 5));
                 }
-                inline uint16_t ServiceId() const
+                inline bool IsFreeToAir() const
                 {
-                    return ((_info[_offset + 0] << 8) | _info[_offset + 1]);
+                    return ((_info[_offset + 10] & 0x10) == 0);
                 }
                 inline MPEG::DescriptorIterator Descriptors() const
                 {
-                    return (MPEG::DescriptorIterator(
-                        Core::DataElement(_info, _offset + 5, DescriptorSize())));
+                    const uint16_t size = DescriptorSize();
+
+                    // A DataElement of size 0 would be the rest of the buffer.
+                    return (size == 0 ? MPEG::DescriptorIterator() : MPEG::DescriptorIterator(Core::DataElement(_info, _offset + 12, size)));
                 }
-                inline uint8_t Services() const
+                inline uint16_t Events() const
                 {
-                    uint8_t count = 0;
-                    uint16_t offset = 0;
-                    while (offset < _info.Size()) {
-                        offset += (((_info[offset + 3] << 8) | _info[offset + 4]) & 0x0FFF) + 5;
-                        count++;
+                    uint16_t count = 0;
+                    uint32_t offset = 0;
+                    while ((offset + 12) <= _info.Size()) {
+                        offset += (((_info[offset + 10] << 8) | _info[offset + 11]) & 0x0FFF) + 12;
+                        if (offset <= _info.Size()) {
+                            count++;
+                        }
                     }
                     return (count);
                 }
@@ -114,7 +133,12 @@ namespace Broadcast {
             private:
                 inline uint16_t DescriptorSize() const
                 {
-                    return ((_info[_offset + 3] << 8) | _info[_offset + 4]) & 0x0FFF;
+                    return ((_info[_offset + 10] << 8) | _info[_offset + 11]) & 0x0FFF;
+                }
+                // Times are coded as 6 BCD digits, hhmmss.
+                static inline uint32_t Seconds(const uint8_t bcd[])
+                {
+                    return ((Broadcast::ConvertBCD<uint32_t>(&(bcd[0]), 2, true) * 3600) + (Broadcast::ConvertBCD<uint32_t>(&(bcd[1]), 2, true) * 60) + Broadcast::ConvertBCD<uint32_t>(&(bcd[2]), 2, true));
                 }
 
             private:
@@ -125,22 +149,20 @@ namespace Broadcast {
         public:
             EIT()
                 : _data()
-                , _transportStreamId(~0)
+                , _tableId(0)
+                , _serviceId(~0)
             {
             }
-            EIT(const MPEG::Table& data)
+            EIT(const MPEG::Section& data)
                 : _data(data.Data())
-                , _transportStreamId(data.Extension())
-            {
-            }
-            EIT(const uint16_t transportStreamId, const Core::DataElement& data)
-                : _data(data)
-                , _transportStreamId(transportStreamId)
+                , _tableId(data.TableId())
+                , _serviceId(data.Extension())
             {
             }
             EIT(const EIT& copy)
                 : _data(copy._data)
-                , _transportStreamId(copy._transportStreamId)
+                , _tableId(copy._tableId)
+                , _serviceId(copy._serviceId)
             {
             }
             ~EIT() {}
@@ -148,33 +170,56 @@ namespace Broadcast {
             EIT& operator=(const EIT& rhs)
             {
                 _data = rhs._data;
-                _transportStreamId = rhs._transportStreamId;
+                _tableId = rhs._tableId;
+                _serviceId = rhs._serviceId;
                 return (*this);
             }
             bool operator==(const EIT& rhs) const
             {
-                return ((_transportStreamId == rhs._transportStreamId) && (_data == rhs._data));
+                return ((_tableId == rhs._tableId) && (_serviceId == rhs._serviceId) && (_data == rhs._data));
             }
             bool operator!=(const EIT& rhs) const { return (!operator==(rhs)); }
 
         public:
             inline bool IsValid() const
             {
-                return ((_transportStreamId != static_cast<uint16_t>(~0)) && (_data.Size() >= 2));
+                return ((_tableId >= ACTUAL) && (_tableId <= SCHEDULE_LAST) && (_data.Size() >= 6));
+            }
+            inline uint8_t TableId() const { return (_tableId); }
+            inline bool IsActual() const
+            {
+                return ((_tableId == ACTUAL) || ((_tableId & 0xF0) == SCHEDULE_ACTUAL));
+            }
+            inline bool IsSchedule() const
+            {
+                return (_tableId >= SCHEDULE_ACTUAL);
+            }
+            inline uint16_t ServiceId() const { return (_serviceId); }
+            uint16_t TransportStreamId() const
+            {
+                return (_data.GetNumber<uint16_t, Core::ENDIAN_BIG>(0));
             }
-            inline uint16_t TransportStreamId() const { return (_transportStreamId); }
             uint16_t OriginalNetworkId() const
             {
-                return (_data.GetNumber<uint16_t, Core::ENDIAN_BIG>(0) & 0x1FFF);
+                return (_data.GetNumber<uint16_t, Core::ENDIAN_BIG>(2));
+            }
+            uint8_t SegmentLastSectionNumber() const
+            {
+                return (_data[4]);
+            }
+            uint8_t LastTableId() const
+            {
+                return (_data[5]);
             }
-            ServiceIterator Services() const
+            EventIterator Events() const
             {
-                return (ServiceIterator(Core::DataElement(_data, 3, _data.Size() - 3)));
+                return (_data.Size() > 6 ? EventIterator(Core::DataElement(_data, 6, _data.Size() - 6)) : EventIterator());
             }
 
         private:
             Core::DataElement _data;
-            uint16_t _transportStreamId;
+            uint8_t _tableId;
+            uint16_t _serviceId;
         };
 
     } // namespace DVB
@@ -85,20 +85,14 @@ namespace Broadcast {
             inline void Reset() { _index = NUMBER_MAX_UNSIGNED(uint32_t); }
             bool Next()
             {
-                uint8_t descriptorLength;
-
                 if (_index == NUMBER_MAX_UNSIGNED(uint32_t)) {
                     _index = 0;
-                    descriptorLength = _descriptors[1] + 2;
                 } else if (_index < _descriptors.Size()) {
                     _index += (_descriptors[_index + 1] + 2);
-                    if ((_index + 2) < _descriptors.Size()) {
-                        descriptorLength = _descriptors[_index + 1] + 2;
-                    }
                 }
 
                 // See if we have a valid descriptor, Does it fit the block we have ?
-                if ((_index + descriptorLength) > _descriptors.Size()) {
+                if (((_index + 2) > _descriptors.Size()) || ((_index + _descriptors[_index + 1] + 2) > _descriptors.Size())) {
                     // It's too big, Jump to the end..
                     _index = static_cast<uint32_t>(_descriptors.Size());
                 }
@@ -121,7 +115,7 @@ namespace Broadcast {
                 }
 
                 while (((_index + 2) < _descriptors.Size()) && (_descriptors[_index] != tagId)) {
-                    _index += _descriptors[1] + 2;
+                    _index += _descriptors[_index + 1] + 2;
                 }
 
                 // See if we have a valid descriptor, Does it fit the block we have ?
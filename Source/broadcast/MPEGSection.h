@@ -117,9 +117,10 @@ namespace Broadcast {
                 , _version(NUMBER_MAX_UNSIGNED(uint8_t))
                 , _lastSectionNumber(NUMBER_MAX_UNSIGNED(uint8_t))
                 , _tableId(0)
-                , _sections()
+                , _count(0)
                 , _data(Core::DataElement(data, 0, 0))
             {
+                ::memset(_received, 0, sizeof(_received));
             }
             ~Table() {}
 
@@ -127,17 +128,21 @@ namespace Broadcast {
             inline void Storage(const Core::ProxyType<Core::DataStore>& data)
             {
                 // Drop the current table, load a new storage
-                _sections.clear();
                 _data = Core::DataElement(data);
-                _lastSectionNumber = NUMBER_MAX_UNSIGNED(uint8_t);
-                _version = NUMBER_MAX_UNSIGNED(uint8_t);
+                Reset();
             }
             inline bool IsValid() const
             {
-                return ((_sections.size() > 0) && ((_sections.size() - 1) == _lastSectionNumber));
+                return ((_count > 0) && ((_count - 1) == _lastSectionNumber));
             }
             inline uint16_t TableId() const { return (_tableId); }
             inline uint16_t Extension() const { return (_extension); }
+            inline uint8_t Version() const { return (_version); }
+            inline uint8_t LastSectionNumber() const { return (_lastSectionNumber); }
+            inline bool HasSection(const uint8_t sectionNumber) const
+            {
+                return ((_received[sectionNumber >> 5] & (1u << (sectionNumber & 0x1F))) != 0);
+            }
             template <typename TYPE>
             TYPE GetNumber(const uint16_t offset) const
             {
@@ -146,10 +151,8 @@ namespace Broadcast {
             inline void Clear()
             {
                 // Drop the current table, load a new storage
-                _sections.clear();
                 _data.Size(0);
-                _lastSectionNumber = NUMBER_MAX_UNSIGNED(uint8_t);
-                _version = NUMBER_MAX_UNSIGNED(uint8_t);
+                Reset();
             }
             inline Core::DataElement& Data() { return (_data); }
             inline const Core::DataElement& Data() const { return (_data); }
@@ -158,7 +161,7 @@ namespace Broadcast {
                 bool addSection = section.IsValid();
 
                 if (addSection == true) {
-                    if (_sections.size() != 0) {
+                    if (_count != 0) {
                         // Starting something for TableId A and then continue with other
                         // TableId's Seems to me like a programming error.
                         if (_tableId != section.TableId()) {
@@ -169,8 +172,8 @@ namespace Broadcast {
 
                         if ((addSection == true) && (section.Version() != _version)) {
                             // Give back all the elemts we do not use..
-                            _sections.clear();
                             _data.Size(0);
+                            Reset();
                             _lastSectionNumber = section.LastSectionNumber();
                             _version = section.Version();
 
@@ -187,36 +190,30 @@ namespace Broadcast {
                         _extension = section.Extension();
                     }
 
+                    addSection = addSection && (section.SectionNumber() <= _lastSectionNumber);
+
                     if (addSection == true) {
+                        // The sections are kept in order of their number, find where this one goes.
+                        const uint8_t sectionNumber = section.SectionNumber();
+                        const Core::DataElement data(section.Data());
                         uint32_t offset = 0;
-                        uint32_t slotValue = (section.SectionNumber() << 16) | section.Length();
-
-                        std::list<uint32_t>::iterator index(_sections.begin());
-
-                        while (index != _sections.end()) {
-                            uint16_t thisLength(*index & 0xFFFF);
-                            uint8_t thisSection((*index >> 16) & 0xFF);
-
-                            if (section.SectionNumber() == thisSection) {
-                                // Replace it..
-                                Insert(section.Data(), thisLength, offset);
-                                *index = slotValue;
-                                break;
-                            } else if (section.SectionNumber() < thisSection) {
-                                // We need to extend the last part
-                                Insert(section.Data(), 0, offset);
-                                index = _sections.insert(index, slotValue);
-                                break;
+
+                        for (uint16_t index = 0; index < sectionNumber; index++) {
+                            if (HasSection(static_cast<uint8_t>(index)) == true) {
+                                offset += _lengths[index];
                             }
-                            offset += thisLength;
                         }
 
-                        if (index == _sections.end()) {
-                            ASSERT(offset == _data.Size());
-
-                            Insert(section.Data(), 0, offset);
-                            _sections.push_back(slotValue);
+                        if (HasSection(sectionNumber) == true) {
+                            // Replace it..
+                            Insert(data, _lengths[sectionNumber], offset);
+                        } else {
+                            Insert(data, 0, offset);
+                            _received[sectionNumber >> 5] |= (1u << (sectionNumber & 0x1F));
+                            _count++;
                         }
+
+                        _lengths[sectionNumber] = static_cast<uint16_t>(data.Size());
                     }
                 }
 
@@ -224,8 +221,15 @@ namespace Broadcast {
             }
 
         private:
+            inline void Reset()
+            {
+                ::memset(_received, 0, sizeof(_received));
+                _count = 0;
+                _lastSectionNumber = NUMBER_MAX_UNSIGNED(uint8_t);
+                _version = NUMBER_MAX_UNSIGNED(uint8_t);
+            }
             void Insert(const Core::DataElement& data, const uint16_t allocatedLength,
-                const uint16_t offset)
+                const uint32_t offset)
             {
                 if (offset < _data.Size()) {
                     // We need to scrink or extend space...
@@ -253,10 +257,141 @@ namespace Broadcast {
             uint8_t _version;
             uint8_t _lastSectionNumber;
             uint8_t _tableId;
-            std::list<uint32_t> _sections;
+            // Bitmap of the section numbers received, and the length each one has in _data.
+            uint16_t _count;
+            uint32_t _received[8];
+            uint16_t _lengths[256];
             Core::DataElement _data;
         };
 
+        // Collects the tables of one PID, a table per table id and extension (e.g. the EIT of every
+        // service), from the sections the broadcaster repeats over and over. A section seen before,
+        // same version and same CRC, is dropped before it is copied or parsed. A table is only
+        // reported once it is complete and something in it changed since it was last reported.
+        class EXTERNAL SectionCache {
+        private:
+            SectionCache(const SectionCache&) = delete;
+            SectionCache& operator=(const SectionCache&) = delete;
+
+            class Entry {
+            private:
+                Entry(const Entry&) = delete;
+                Entry& operator=(const Entry&) = delete;
+
+            public:
+                Entry()
+                    : _table(Core::ProxyType<Core::DataStore>::Create(512))
+                    , _changed(false)
+                {
+                    ::memset(_crcs, 0, sizeof(_crcs));
+                }
+                ~Entry() {}
+
+            public:
+                Table _table;
+                // Indexed by section number, only valid for the sections the table has.
+                uint32_t _crcs[256];
+                bool _changed;
+            };
+
+            struct Sections {
+                uint8_t Version;
+                uint32_t Received[8];
+                uint32_t CRCs[256];
+            };
+
+            typedef std::map<uint32_t, Entry> Entries;
+            typedef std::map<uint32_t, Sections> SectionMap;
+
+        public:
+            SectionCache()
+                : _entries()
+                , _sections()
+                , _duplicates(0)
+            {
+            }
+            ~SectionCache() {}
+
+        public:
+            // Returns the table this section is part of, if it completed or changed it, nullptr
+            // otherwise. Only sections with the section syntax, that are currently applicable, are
+            // taken in. The CRC is only checked for sections that are not dropped, sections offered
+            // on the ISection interface have been checked already.
+            const Table* AddSection(const Section& section)
+            {
+                const Table* result = nullptr;
+
+                if ((section.HasSectionSyntax() == true) && (section.Length() >= 12) && (section.IsCurrent() == true)) {
+                    Entry& entry(_entries[(section.TableId() << 16) | section.Extension()]);
+                    const uint8_t sectionNumber = section.SectionNumber();
+                    const uint32_t crc = section.GetNumber<uint32_t>(section.Length() - 4);
+
+                    if ((entry._table.Version() == section.Version()) && (entry._table.HasSection(sectionNumber) == true) && (entry._crcs[sectionNumber] == crc)) {
+                        _duplicates++;
+                    } else if (entry._table.AddSection(section) == true) {
+                        entry._crcs[sectionNumber] = crc;
+                        entry._changed = true;
+                    }
+
+                    if ((entry._changed == true) && (entry._table.IsValid() == true)) {
+                        entry._changed = false;
+                        result = &(entry._table);
+                    }
+                }
+
+                return (result);
+            }
+            // For tables that are processed section by section, and are never assembled: the EIT schedule
+            // is sparse by design, it would never be complete. Returns true if the section is new, or its
+            // content changed, since it was last seen. No section data is copied.
+            bool IsNew(const Section& section)
+            {
+                bool result = false;
+
+                if ((section.HasSectionSyntax() == true) && (section.Length() >= 12) && (section.IsCurrent() == true)) {
+                    Sections& entry(_sections[(section.TableId() << 16) | section.Extension()]);
+                    const uint8_t sectionNumber = section.SectionNumber();
+                    const uint32_t crc = section.GetNumber<uint32_t>(section.Length() - 4);
+                    const uint32_t mask = (1u << (sectionNumber & 0x1F));
+
+                    // A new entry starts out all zero, nothing received yet.
+                    if (entry.Version != section.Version()) {
+                        ::memset(entry.Received, 0, sizeof(entry.Received));
+                        entry.Version = section.Version();
+                    }
+
+                    if (((entry.Received[sectionNumber >> 5] & mask) != 0) && (entry.CRCs[sectionNumber] == crc)) {
+                        _duplicates++;
+                    } else {
+                        entry.Received[sectionNumber >> 5] |= mask;
+                        entry.CRCs[sectionNumber] = crc;
+                        result = true;
+                    }
+                }
+
+                return (result);
+            }
+            inline void Clear()
+            {
+                _entries.clear();
+                _sections.clear();
+            }
+            inline uint32_t Tables() const
+            {
+                return (static_cast<uint32_t>(_entries.size() + _sections.size()));
+            }
+            // The number of sections dropped as they did not bring anything new.
+            inline uint32_t Duplicates() const
+            {
+                return (_duplicates);
+            }
+
+        private:
+            Entries _entries;
+            SectionMap _sections;
+            uint32_t _duplicates;
+        };
+
     } // namespace MPEG
 } // namespace Broadcast
 } // namespace WPEFramework
@@ -57,8 +57,7 @@ namespace Broadcast {
             Parser(Networks& parent, ITuner* source, const bool scan, const uint16_t pid)
                 : _parent(parent)
                 , _source(source)
-                , _actual(Core::ProxyType<Core::DataStore>::Create(512))
-                , _others(Core::ProxyType<Core::DataStore>::Create(512))
+                , _cache()
                 , _pid(pid)
             {
                 if (scan == true) {
@@ -97,24 +96,17 @@ namespace Broadcast {
 
                 ASSERT(section.IsValid());
 
-                if (section.TableId() == DVB::NIT::ACTUAL) {
-                    _actual.AddSection(section);
-                    if (_actual.IsValid() == true) {
-                        _parent.Load(DVB::NIT(_actual));
-                    }
-                } else if (section.TableId() == DVB::NIT::OTHER) {
-                    _others.AddSection(section);
-                    if (_others.IsValid() == true) {
-                        _parent.Load(DVB::NIT(_others));
-                    }
+                const MPEG::Table* table = _cache.AddSection(section);
+
+                if (table != nullptr) {
+                    _parent.Load(DVB::NIT(*table));
                 }
             }
 
         private:
             Networks& _parent;
             ITuner* _source;
-            MPEG::Table _actual;
-            MPEG::Table _others;
+            MPEG::SectionCache _cache;
             uint16_t _pid;
         };
 
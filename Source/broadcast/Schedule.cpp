@@ -0,0 +1,468 @@
+#include "Schedule.h"
+
+namespace WPEFramework {
+
+namespace Broadcast {
+
+    namespace {
+
+        // Layout of the persisted store: the header, a record per service, the events of all services
+        // (in the order of the services), and the string pool. It is a cache of this box, it is written
+        // and read in the native byte order.
+        struct FileHeader {
+            uint32_t Magic;
+            uint32_t Version;
+            uint32_t Services;
+            uint32_t Events;
+            uint32_t Strings;
+            uint32_t Reserved;
+        };
+
+        struct FileService {
+            uint64_t Service;
+            uint32_t Events;
+            uint32_t Reserved;
+        };
+
+        constexpr uint32_t FileMagic = 0x45504721; // "EPG!"
+        constexpr uint32_t FileVersion = 1;
+        constexpr uint32_t IndexSize = 1024;
+
+        inline uint32_t Hash(const char text[], const uint32_t length)
+        {
+            uint32_t hash = 2166136261;
+
+            for (uint32_t index = 0; index < length; index++) {
+                hash = (hash ^ static_cast<uint8_t>(text[index])) * 16777619;
+            }
+
+            return (hash);
+        }
+    }
+
+    uint32_t Schedules::Window(const uint16_t originalNetworkId, const uint16_t transportStreamId, const uint16_t serviceId,
+        const uint32_t start, const uint32_t end, std::list<Event>& events) const
+    {
+        uint32_t count = 0;
+        const uint64_t service = Key(originalNetworkId, transportStreamId, serviceId);
+
+        _adminLock.Lock();
+
+        ServiceMap::const_iterator entry(_services.find(service));
+
+        if (entry != _services.end()) {
+            Entries::const_iterator index(Find(entry->second, start));
+
+            while ((index != entry->second.end()) && (index->Start < end)) {
+                events.push_back(Resolve(service, *index));
+                count++;
+                index++;
+            }
+        }
+
+        _adminLock.Unlock();
+
+        return (count);
+    }
+
+    bool Schedules::NowNext(const uint16_t originalNetworkId, const uint16_t transportStreamId, const uint16_t serviceId,
+        const uint32_t time, Current& info) const
+    {
+        const uint64_t service = Key(originalNetworkId, transportStreamId, serviceId);
+
+        _adminLock.Lock();
+
+        ServiceMap::const_iterator entry(_services.find(service));
+        const bool result = (entry != _services.end());
+
+        info.Now = Event();
+        info.Next = Event();
+
+        if (result == true) {
+            Entries::const_iterator index(Find(entry->second, time));
+
+            if ((index != entry->second.end()) && (index->Start <= time)) {
+                info.Now = Resolve(service, *index);
+                index++;
+            }
+            if (index != entry->second.end()) {
+                info.Next = Resolve(service, *index);
+            }
+        }
+
+        _adminLock.Unlock();
+
+        return (result);
+    }
+
+    uint32_t Schedules::NowNext(const uint32_t time, std::list<Current>& services) const
+    {
+        uint32_t count = 0;
+
+        _adminLock.Lock();
+
+        for (const std::pair<const uint64_t, Entries>& entry : _services) {
+            Entries::const_iterator index(Find(entry.second, time));
+
+            if (index != entry.second.end()) {
+                services.emplace_back();
+                Current& info(services.back());
+
+                if (index->Start <= time) {
+                    info.Now = Resolve(entry.first, *index);
+                    index++;
+                }
+                if (index != entry.second.end()) {
+                    info.Next = Resolve(entry.first, *index);
+                }
+                count++;
+            }
+        }
+
+        _adminLock.Unlock();
+
+        return (count);
+    }
+
+    void Schedules::Expire(const uint32_t time)
+    {
+        uint32_t dropped = 0;
+
+        _adminLock.Lock();
+
+        ServiceMap::iterator entry(_services.begin());
+
+        while (entry != _services.end()) {
+            Entries& entries(entry->second);
+            Entries::iterator last(entries.begin() + (Find(entries, time) - entries.cbegin()));
+
+            if (last != entries.begin()) {
+                dropped += static_cast<uint32_t>(last - entries.begin());
+                entries.erase(entries.begin(), last);
+                entries.shrink_to_fit();
+            }
+
+            if (entries.empty() == true) {
+                entry = _services.erase(entry);
+            } else {
+                entry++;
+            }
+        }
+
+        if (dropped > 0) {
+            // The pool only grows, start a fresh one with the strings still in use.
+            std::vector<char> strings;
+
+            _events -= dropped;
+            strings.swap(_strings);
+            _strings.assign(1, '\0');
+            _index.assign(IndexSize, 0);
+            _interned = 0;
+
+            for (std::pair<const uint64_t, Entries>& service : _services) {
+                for (Entry& event : service.second) {
+                    event.Title = Intern(&(strings[event.Title]), static_cast<uint32_t>(::strlen(&(strings[event.Title]))));
+                    event.Text = Intern(&(strings[event.Text]), static_cast<uint32_t>(::strlen(&(strings[event.Text]))));
+                }
+            }
+
+            _strings.shrink_to_fit();
+        }
+
+        _adminLock.Unlock();
+    }
+
+    void Schedules::Clear()
+    {
+        _adminLock.Lock();
+
+        _services.clear();
+        _strings.assign(1, '\0');
+        _index.assign(IndexSize, 0);
+        _interned = 0;
+        _events = 0;
+
+        _adminLock.Unlock();
+    }
+
+    uint32_t Schedules::Footprint() const
+    {
+        _adminLock.Lock();
+
+        uint32_t result = static_cast<uint32_t>(_strings.capacity() + (_index.capacity() * sizeof(uint32_t)));
+
+        for (const std::pair<const uint64_t, Entries>& entry : _services) {
+            result += static_cast<uint32_t>(sizeof(entry) + (entry.second.capacity() * sizeof(Entry)));
+        }
+
+        _adminLock.Unlock();
+
+        return (result);
+    }
+
+    uint32_t Schedules::Save(const string& fileName) const
+    {
+        uint32_t result = Core::ERROR_WRITE_ERROR;
+
+        _adminLock.Lock();
+
+        const uint32_t size = static_cast<uint32_t>(sizeof(FileHeader) + (_services.size() * sizeof(FileService)) + (_events * sizeof(Entry)) + _strings.size());
+        const string newFile(fileName + _T(".new"));
+
+        // Written next to the one we have, and only replacing it once complete.
+        Core::File(newFile).Destroy();
+
+        {
+            Core::DataElementFile file(newFile, Core::DataElementFile::READABLE | Core::DataElementFile::WRITABLE | Core::DataElementFile::SHAREABLE | Core::DataElementFile::CREATE, size);
+
+            if ((file.IsValid() == true) && (file.Size() == size)) {
+                uint8_t* buffer = file.Buffer();
+                const FileHeader header = { FileMagic, FileVersion, static_cast<uint32_t>(_services.size()), _events, static_cast<uint32_t>(_strings.size()), 0 };
+
+                ::memcpy(buffer, &header, sizeof(header));
+                buffer += sizeof(header);
+
+                for (const std::pair<const uint64_t, Entries>& entry : _services) {
+                    const FileService service = { entry.first, static_cast<uint32_t>(entry.second.size()), 0 };
+
+                    ::memcpy(buffer, &service, sizeof(service));
+                    buffer += sizeof(service);
+                }
+                for (const std::pair<const uint64_t, Entries>& entry : _services) {
+                    ::memcpy(buffer, entry.second.data(), entry.second.size() * sizeof(Entry));
+                    buffer += (entry.second.size() * sizeof(Entry));
+                }
+                ::memcpy(buffer, _strings.data(), _strings.size());
+
+                file.Sync();
+                result = Core::ERROR_NONE;
+            }
+        }
+
+        if ((result == Core::ERROR_NONE) && (Core::File(newFile).Move(fileName) == false)) {
+            result = Core::ERROR_WRITE_ERROR;
+        }
+
+        _adminLock.Unlock();
+
+        return (result);
+    }
+
+    uint32_t Schedules::Restore(const string& fileName)
+    {
+        uint32_t result = Core::ERROR_OPENING_FAILED;
+        Core::DataElementFile file(fileName, Core::DataElementFile::READABLE);
+
+        if (file.IsValid() == true) {
+            const uint8_t* buffer = file.Buffer();
+            const uint64_t size = file.Size();
+            FileHeader header;
+
+            result = Core::ERROR_READ_ERROR;
+
+            if (size >= sizeof(header)) {
+                ::memcpy(&header, buffer, sizeof(header));
+            }
+
+            if ((size >= sizeof(header)) && (header.Magic == FileMagic) && (header.Version == FileVersion) && (header.Strings > 0) && (size == (sizeof(FileHeader) + (static_cast<uint64_t>(header.Services) * sizeof(FileService)) + (static_cast<uint64_t>(header.Events) * sizeof(Entry)) + header.Strings))) {
+                const uint8_t* services = &(buffer[sizeof(FileHeader)]);
+                const uint8_t* events = &(services[header.Services * sizeof(FileService)]);
+                const char* strings = reinterpret_cast<const char*>(&(events[header.Events * sizeof(Entry)]));
+                ServiceMap loaded;
+                uint32_t count = 0;
+                bool valid = (strings[0] == '\0') && (strings[header.Strings - 1] == '\0');
+
+                for (uint32_t index = 0; (valid == true) && (index < header.Services); index++) {
+                    FileService service;
+
+                    ::memcpy(&service, &(services[index * sizeof(FileService)]), sizeof(service));
+
+                    valid = (service.Events <= (header.Events - count));
+
+                    if (valid == true) {
+                        Entries& entries(loaded[service.Service]);
+
+                        entries.resize(service.Events);
+                        ::memcpy(entries.data(), &(events[count * sizeof(Entry)]), service.Events * sizeof(Entry));
+                        count += service.Events;
+
+                        for (const Entry& entry : entries) {
+                            valid = valid && (entry.Title < header.Strings) && (entry.Text < header.Strings);
+                        }
+                    }
+                }
+
+                if ((valid == true) && (count == header.Events)) {
+                    _adminLock.Lock();
+
+                    _services.swap(loaded);
+                    _strings.assign(strings, strings + header.Strings);
+                    _events = header.Events;
+                    Rehash(IndexSize);
+
+                    _adminLock.Unlock();
+
+                    result = Core::ERROR_NONE;
+                }
+            }
+        }
+
+        return (result);
+    }
+
+    void Schedules::Load(const DVB::EIT& table)
+    {
+        if (table.IsValid() == true) {
+            const uint64_t service = Key(table.OriginalNetworkId(), table.TransportStreamId(), table.ServiceId());
+            DVB::EIT::EventIterator index(table.Events());
+
+            _adminLock.Lock();
+
+            Entries& entries(_services[service]);
+
+            while (index.Next() == true) {
+                const uint32_t start = index.StartTime();
+
+                // NVOD reference events have no time of their own, nothing to schedule.
+                if (start != static_cast<uint32_t>(~0)) {
+                    Entry entry;
+
+                    entry.Start = start;
+                    entry.Duration = index.Duration();
+                    entry.Title = 0;
+                    entry.Text = 0;
+                    entry.Language = 0;
+                    entry.EventId = index.EventId();
+                    entry.Info = static_cast<uint8_t>(index.RunningMode()) | (index.IsFreeToAir() == true ? 0x08 : 0x00);
+                    entry.Reserved = 0;
+
+                    MPEG::DescriptorIterator descriptors(index.Descriptors());
+
+                    if (descriptors.Tag(DVB::Descriptors::ShortEvent::TAG) == true) {
+                        DVB::Descriptors::ShortEvent info(descriptors.Current());
+                        const string language(info.Language());
+                        const char* text;
+                        uint8_t length;
+
+                        // Interned straight from the section, only a string not seen before is copied.
+                        length = info.Name(text);
+                        entry.Title = Intern(text, length);
+                        length = info.Text(text);
+                        entry.Text = Intern(text, length);
+
+                        if (language.length() == 3) {
+                            entry.Language = (static_cast<uint8_t>(language[0]) << 16) | (static_cast<uint8_t>(language[1]) << 8) | static_cast<uint8_t>(language[2]);
+                        }
+                    }
+
+                    Insert(entries, entry);
+                }
+            }
+
+            if (entries.empty() == true) {
+                _services.erase(service);
+            }
+
+            _adminLock.Unlock();
+        }
+    }
+
+    void Schedules::Insert(Entries& entries, const Entry& entry)
+    {
+        Entries::iterator index(std::lower_bound(entries.begin(), entries.end(), entry.Start,
+            [](const Entry& element, const uint32_t start) { return (element.Start < start); }));
+
+        if ((index != entries.end()) && (index->Start == entry.Start) && (index->Duration == entry.Duration) && (index->EventId == entry.EventId)) {
+            // Same event, same slot, the most common case by far. Only the texts might be new.
+            *index = entry;
+        } else {
+            const uint32_t end = entry.Start + entry.Duration;
+
+            // The event moved, or the schedule changed: whatever has the same id, or overlaps with
+            // the new slot, is gone.
+            Entries::iterator last(std::remove_if(entries.begin(), entries.end(), [&entry, end](const Entry& element) {
+                return ((element.EventId == entry.EventId) || ((element.Start < end) && ((element.Start + element.Duration) > entry.Start)));
+            }));
+
+            _events -= static_cast<uint32_t>(entries.end() - last);
+            entries.erase(last, entries.end());
+
+            index = std::lower_bound(entries.begin(), entries.end(), entry.Start,
+                [](const Entry& element, const uint32_t start) { return (element.Start < start); });
+
+            entries.insert(index, entry);
+            _events++;
+        }
+    }
+
+    uint32_t Schedules::Intern(const char text[], const uint32_t maxLength)
+    {
+        // The pool holds zero terminated strings, a zero in the text ends it.
+        const uint32_t length = (maxLength > 0 ? static_cast<uint32_t>(::strnlen(text, maxLength)) : 0);
+        uint32_t result = 0;
+
+        if (length > 0) {
+            const uint32_t mask = static_cast<uint32_t>(_index.size() - 1);
+            uint32_t slot = Hash(text, length) & mask;
+
+            while ((_index[slot] != 0) && ((::strncmp(&(_strings[_index[slot]]), text, length) != 0) || (_strings[_index[slot] + length] != '\0'))) {
+                slot = (slot + 1) & mask;
+            }
+
+            if (_index[slot] != 0) {
+                result = _index[slot];
+            } else {
+                result = static_cast<uint32_t>(_strings.size());
+                _strings.insert(_strings.end(), text, text + length);
+                _strings.push_back('\0');
+                _index[slot] = result;
+                _interned++;
+
+                // Keep the table at most half full, the probe sequences stay short.
+                if ((_interned * 2) > _index.size()) {
+                    Rehash(static_cast<uint32_t>(_index.size() * 2));
+                }
+            }
+        }
+
+        return (result);
+    }
+
+    void Schedules::Rehash(const uint32_t size)
+    {
+        uint32_t offset = 1;
+        uint32_t mask = size - 1;
+
+        _interned = 0;
+        while (offset < _strings.size()) {
+            _interned++;
+            offset += static_cast<uint32_t>(::strlen(&(_strings[offset])) + 1);
+        }
+        while ((_interned * 2) > mask) {
+            mask = (mask << 1) | 1;
+        }
+
+        _index.assign(mask + 1, 0);
+
+        // All strings in the pool, are the strings in the table.
+        for (offset = 1; offset < _strings.size(); offset += static_cast<uint32_t>(::strlen(&(_strings[offset])) + 1)) {
+            uint32_t slot = Hash(&(_strings[offset]), static_cast<uint32_t>(::strlen(&(_strings[offset])))) & mask;
+
+            while (_index[slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+
+            _index[slot] = offset;
+        }
+    }
+
+    /* static */ Schedules::Entries::const_iterator Schedules::Find(const Entries& entries, const uint32_t time)
+    {
+        // The events of a service do not overlap, ordered on start time they are ordered on end time
+        // as well: the first one ending after the given time is the one running, or the next one.
+        return (std::upper_bound(entries.begin(), entries.end(), time,
+            [](const uint32_t time, const Entry& element) { return (time < (element.Start + element.Duration)); }));
+    }
+
+}
+} // namespace WPEFramework::Broadcast
@@ -9,7 +9,11 @@ namespace WPEFramework {
 
 namespace Broadcast {
 
-    class Schedules {
+    // The EPG, the events of all services as they are found in the EIT's. Every service has an array
+    // of events, ordered on their start time, so a time window or the now/next event is a binary
+    // search away. The events are kept compact, the strings (titles, descriptions) are interned in
+    // a string pool, the same title repeated over the week is only stored once.
+    class EXTERNAL Schedules {
     private:
         Schedules(const Schedules&) = delete;
         Schedules& operator=(const Schedules&) = delete;
@@ -56,8 +60,7 @@ namespace Broadcast {
             Parser(Schedules& parent, ITuner* source, const bool scan)
                 : _parent(parent)
                 , _source(source)
-                , _actual(Core::ProxyType<Core::DataStore>::Create(512))
-                , _others(Core::ProxyType<Core::DataStore>::Create(512))
+                , _cache()
             {
                 if (scan == true) {
                     Scan(true);
@@ -79,13 +82,9 @@ namespace Broadcast {
         public:
             void Scan(const bool scan)
             {
-                if (scan == true) {
-                    // Start loading the SDT info
-                    _source->Filter(0x11, DVB::EIT::ACTUAL, this);
-                    _source->Filter(0x11, DVB::EIT::OTHER, this);
-                } else {
-                    _source->Filter(0x11, DVB::EIT::OTHER, nullptr);
-                    _source->Filter(0x11, DVB::EIT::ACTUAL, nullptr);
+                // The EIT is on PID 0x12, present/following and the schedule, of this and other transport streams.
+                for (uint16_t tableId = DVB::EIT::ACTUAL; tableId <= DVB::EIT::SCHEDULE_LAST; tableId++) {
+                    _source->Filter(0x12, static_cast<uint8_t>(tableId), (scan == true ? this : nullptr));
                 }
             }
 
@@ -95,35 +94,185 @@ namespace Broadcast {
 
                 ASSERT(section.IsValid());
 
-                if (section.TableId() == DVB::EIT::ACTUAL) {
-                    _actual.AddSection(section);
-                    if (_actual.IsValid() == true) {
-                        _parent.Load(DVB::EIT(_actual));
-                    }
-                } else if (section.TableId() == DVB::EIT::OTHER) {
-                    _others.AddSection(section);
-                    if (_others.IsValid() == true) {
-                        _parent.Load(DVB::EIT(_others));
-                    }
+                // The schedule is never complete, every section carries its own events. The cache
+                // drops the ones seen before, what remains updates the store.
+                if (_cache.IsNew(section) == true) {
+                    _parent.Load(DVB::EIT(section));
                 }
             }
 
         private:
             Schedules& _parent;
             ITuner* _source;
-            MPEG::Table _actual;
-            MPEG::Table _others;
+            MPEG::SectionCache _cache;
         };
 
         typedef std::list<Parser> Scanners;
 
+        // The compact form of an event, the strings are offsets in the string pool. This is also the
+        // form in which they are persisted, so keep it free of padding.
+        struct Entry {
+            uint32_t Start;
+            uint32_t Duration;
+            uint32_t Title;
+            uint32_t Text;
+            uint32_t Language;
+            uint16_t EventId;
+            uint8_t Info;
+            uint8_t Reserved;
+        };
+
+        typedef std::vector<Entry> Entries;
+        // Keyed on the DVB triplet: original network id (16), transport stream id (16), service id (16).
+        typedef std::map<uint64_t, Entries> ServiceMap;
+
+    public:
+        class Event {
+        private:
+            friend class Schedules;
+
+            Event(const uint64_t service, const Entry& entry, const char strings[])
+                : _service(service)
+                , _eventId(entry.EventId)
+                , _start(entry.Start)
+                , _duration(entry.Duration)
+                , _info(entry.Info)
+                , _language()
+                , _title(&(strings[entry.Title]))
+                , _text(&(strings[entry.Text]))
+            {
+                if (entry.Language != 0) {
+                    const char language[] = { static_cast<char>(entry.Language >> 16), static_cast<char>(entry.Language >> 8), static_cast<char>(entry.Language) };
+                    _language = string(language, sizeof(language));
+                }
+            }
+
+        public:
+            Event()
+                : _service(~0)
+                , _eventId(~0)
+                , _start(0)
+                , _duration(0)
+                , _info(0)
+                , _language()
+                , _title()
+                , _text()
+            {
+            }
+            Event(const Event& copy)
+                : _service(copy._service)
+                , _eventId(copy._eventId)
+                , _start(copy._start)
+                , _duration(copy._duration)
+                , _info(copy._info)
+                , _language(copy._language)
+                , _title(copy._title)
+                , _text(copy._text)
+            {
+            }
+            ~Event()
+            {
+            }
+
+            Event& operator=(const Event& rhs)
+            {
+                _service = rhs._service;
+                _eventId = rhs._eventId;
+                _start = rhs._start;
+                _duration = rhs._duration;
+                _info = rhs._info;
+                _language = rhs._language;
+                _title = rhs._title;
+                _text = rhs._text;
+
+                return (*this);
+            }
+
+        public:
+            inline bool IsValid() const
+            {
+                return (_service != static_cast<uint64_t>(~0));
+            }
+            inline uint16_t OriginalNetworkId() const
+            {
+                return (static_cast<uint16_t>(_service >> 32));
+            }
+            inline uint16_t TransportStreamId() const
+            {
+                return (static_cast<uint16_t>(_service >> 16));
+            }
+            inline uint16_t ServiceId() const
+            {
+                return (static_cast<uint16_t>(_service));
+            }
+            inline uint16_t EventId() const
+            {
+                return (_eventId);
+            }
+            // Seconds since the epoch (UTC).
+            inline uint32_t Start() const
+            {
+                return (_start);
+            }
+            inline uint32_t End() const
+            {
+                return (_start + _duration);
+            }
+            // In seconds.
+            inline uint32_t Duration() const
+            {
+                return (_duration);
+            }
+            inline DVB::EIT::running RunningMode() const
+            {
+                return (static_cast<DVB::EIT::running>(_info & 0x07));
+            }
+            inline bool IsFreeToAir() const
+            {
+                return ((_info & 0x08) != 0);
+            }
+            inline const string& Language() const
+            {
+                return (_language);
+            }
+            inline const string& Title() const
+            {
+                return (_title);
+            }
+            inline const string& Text() const
+            {
+                return (_text);
+            }
+
+        private:
+            uint64_t _service;
+            uint16_t _eventId;
+            uint32_t _start;
+            uint32_t _duration;
+            uint8_t _info;
+            string _language;
+            string _title;
+            string _text;
+        };
+
+        struct Current {
+            Event Now;
+            Event Next;
+        };
+
     public:
         Schedules()
             : _adminLock()
             , _scanners()
             , _sink(*this)
             , _scan(true)
+            , _services()
+            , _strings()
+            , _index()
+            , _interned(0)
+            , _events(0)
         {
+            Clear();
             ITuner::Register(&_sink);
         }
         virtual ~Schedules()
@@ -147,6 +296,35 @@ namespace Broadcast {
             _adminLock.Unlock();
         }
 
+        // The events of the service that (partly) fall within the [start, end) window, in order.
+        // Returns the number of events added to the list.
+        uint32_t Window(const uint16_t originalNetworkId, const uint16_t transportStreamId, const uint16_t serviceId,
+            const uint32_t start, const uint32_t end, std::list<Event>& events) const;
+
+        // The event running at the given time, and the one after it. Returns false if the service is
+        // not known.
+        bool NowNext(const uint16_t originalNetworkId, const uint16_t transportStreamId, const uint16_t serviceId,
+            const uint32_t time, Current& info) const;
+        // The same, for all services that have an event running or coming up. Returns the number of
+        // services added to the list.
+        uint32_t NowNext(const uint32_t time, std::list<Current>& services) const;
+
+        // Drop the events that ended before the given time, and the strings only they used.
+        void Expire(const uint32_t time);
+        void Clear();
+
+        inline uint32_t Events() const
+        {
+            return (_events);
+        }
+        // The memory the store occupies, in bytes, give or take the administration of the containers.
+        uint32_t Footprint() const;
+
+        // Persist the store to a file, or load it from one, so the EPG is available right away after a
+        // restart. The file is memory mapped, the events and strings are copied in one go.
+        uint32_t Save(const string& fileName) const;
+        uint32_t Restore(const string& fileName);
+
     private:
         void Deactivated(ITuner* tuner)
         {
@@ -179,18 +357,34 @@ namespace Broadcast {
 
             _adminLock.Unlock();
         }
-        void Load(const DVB::EIT& table)
-        {
-            _adminLock.Lock();
+        void Load(const DVB::EIT& table);
+        void Insert(Entries& entries, const Entry& entry);
+        uint32_t Intern(const char text[], const uint32_t length);
+        void Rehash(const uint32_t size);
 
-            _adminLock.Unlock();
+        inline Event Resolve(const uint64_t service, const Entry& entry) const
+        {
+            return (Event(service, entry, _strings.data()));
+        }
+        static inline uint64_t Key(const uint16_t originalNetworkId, const uint16_t transportStreamId, const uint16_t serviceId)
+        {
+            return ((static_cast<uint64_t>(originalNetworkId) << 32) | (static_cast<uint64_t>(transportStreamId) << 16) | serviceId);
         }
+        // The first event of the service still running at the given time, or coming up after it.
+        static Entries::const_iterator Find(const Entries& entries, const uint32_t time);
 
     private:
         mutable Core::CriticalSection _adminLock;
         Scanners _scanners;
         Sink _sink;
         bool _scan;
+        ServiceMap _services;
+        // All strings, zero terminated, one after the other. Offset 0 is the empty string.
+        std::vector<char> _strings;
+        // Open addressing hash table on the strings in the pool, 0 is a free slot.
+        std::vector<uint32_t> _index;
+        uint32_t _interned;
+        uint32_t _events;
     };
 
 } // namespace Broadcast
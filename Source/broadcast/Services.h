@@ -56,8 +56,7 @@ namespace Broadcast {
             Parser(Services& parent, ITuner* source, const bool scan)
                 : _parent(parent)
                 , _source(source)
-                , _actual(Core::ProxyType<Core::DataStore>::Create(512))
-                , _others(Core::ProxyType<Core::DataStore>::Create(512))
+                , _cache()
             {
                 if (scan == true) {
                     Scan(true);
@@ -95,24 +94,18 @@ namespace Broadcast {
 
                 ASSERT(section.IsValid());
 
-                if (section.TableId() == DVB::SDT::ACTUAL) {
-                    _actual.AddSection(section);
-                    if (_actual.IsValid() == true) {
-                        _parent.Load(DVB::SDT(_actual));
-                    }
-                } else if (section.TableId() == DVB::SDT::OTHER) {
-                    _others.AddSection(section);
-                    if (_others.IsValid() == true) {
-                        _parent.Load(DVB::SDT(_others));
-                    }
+                // The broadcaster repeats the SDT every few seconds, only changes get through.
+                const MPEG::Table* table = _cache.AddSection(section);
+
+                if (table != nullptr) {
+                    _parent.Load(DVB::SDT(*table));
                 }
             }
 
         private:
             Services& _parent;
             ITuner* _source;
-            MPEG::Table _actual;
-            MPEG::Table _others;
+            MPEG::SectionCache _cache;
         };
 
         typedef std::list<Parser> Scanners;
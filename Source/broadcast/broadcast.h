@@ -4,7 +4,9 @@
 #include "Module.h"
 
 #include "Definitions.h"
+#include "Demultiplexer.h"
 #include "Descriptors.h"
+#include "EIT.h"
 #include "MPEGDescriptor.h"
 #include "MPEGSection.h"
 #include "MPEGTable.h"
@@ -12,6 +14,7 @@
 #include "Networks.h"
 #include "ProgramTable.h"
 #include "SDT.h"
+#include "Schedule.h"
 #include "Services.h"
 #include "TDT.h"
 #include "TimeDate.h"
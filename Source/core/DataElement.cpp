@@ -1,5 +1,11 @@
 #include "DataElement.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define __CRC32_CLMUL__
+#endif
+
 namespace WPEFramework {
 namespace Core {
 
@@ -50,6 +56,136 @@ namespace Core {
         0xbcb4666d, 0xb8757bda, 0xb5365d03, 0xb1f740b4
     };
 
+    namespace {
+
+        // Slice-by-8: slice N holds the CRC of a byte followed by N zero bytes, so 8 bytes
+        // are folded in with 8 independent lookups instead of 8 dependent ones.
+        class CRCSlices {
+        public:
+            CRCSlices()
+            {
+                for (uint16_t index = 0; index < 256; index++) {
+                    _table[0][index] = g_CRCtable[index];
+                }
+                for (uint8_t slice = 1; slice < 8; slice++) {
+                    for (uint16_t index = 0; index < 256; index++) {
+                        const uint32_t previous = _table[slice - 1][index];
+                        _table[slice][index] = (previous << 8) ^ g_CRCtable[previous >> 24];
+                    }
+                }
+            }
+
+        public:
+            uint32_t Calculate(uint32_t crc, const uint8_t data[], uint32_t length) const
+            {
+                while (length >= 8) {
+                    const uint32_t word = crc ^ ((data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3]);
+
+                    crc = _table[7][word >> 24] ^ _table[6][(word >> 16) & 0xFF] ^ _table[5][(word >> 8) & 0xFF] ^ _table[4][word & 0xFF]
+                        ^ _table[3][data[4]] ^ _table[2][data[5]] ^ _table[1][data[6]] ^ _table[0][data[7]];
+
+                    data += 8;
+                    length -= 8;
+                }
+                while (length != 0) {
+                    crc = (crc << 8) ^ _table[0][(crc >> 24) ^ *data];
+                    data++;
+                    length--;
+                }
+
+                return (crc);
+            }
+
+        private:
+            uint32_t _table[8][256];
+        };
+
+        static const CRCSlices& Slices()
+        {
+            static const CRCSlices slices;
+
+            return (slices);
+        }
+
+#if defined(__CRC32_CLMUL__)
+        // Folding with carry-less multiplication, along the lines of Intel's "Fast CRC Computation
+        // for Generic Polynomials Using PCLMULQDQ", for a not reflected polynomial. A 128 bit block
+        // moved D bits further is replaced by its high half times x^(D+64) mod P and its low half
+        // times x^D mod P, which leaves the remainder unchanged. The constants are {x^(D+64), x^D} mod P.
+        static constexpr uint32_t CLMULMinimum = 64;
+
+        __attribute__((target("ssse3,pclmul"))) inline __m128i Fold(const __m128i value, const __m128i constants)
+        {
+            return (_mm_xor_si128(_mm_clmulepi64_si128(value, constants, 0x11), _mm_clmulepi64_si128(value, constants, 0x00)));
+        }
+
+        __attribute__((target("ssse3,pclmul"))) uint32_t CalculateCLMUL(uint32_t crc, const uint8_t data[], uint32_t length)
+        {
+            // Blocks are taken in as big endian 128 bit numbers, so the first bit is x^127.
+            const __m128i swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            const __m128i fold512 = _mm_set_epi32(0, 0x8833794c, 0, 0xe6228b11);
+            const __m128i fold384 = _mm_set_epi32(0, 0x64bf7a9b, 0, 0x8c3828a8);
+            const __m128i fold256 = _mm_set_epi32(0, 0x569700e5, 0, 0x75be46b7);
+            const __m128i fold128 = _mm_set_epi32(0, 0xc5b9cd4c, 0, 0xe8a45605);
+            const __m128i* block = reinterpret_cast<const __m128i*>(data);
+
+            // The running CRC is added to the first 32 bits of the message.
+            __m128i x0 = _mm_shuffle_epi8(_mm_xor_si128(_mm_loadu_si128(&block[0]), _mm_cvtsi32_si128(__builtin_bswap32(crc))), swap);
+            __m128i x1 = _mm_shuffle_epi8(_mm_loadu_si128(&block[1]), swap);
+            __m128i x2 = _mm_shuffle_epi8(_mm_loadu_si128(&block[2]), swap);
+            __m128i x3 = _mm_shuffle_epi8(_mm_loadu_si128(&block[3]), swap);
+
+            block += 4;
+            length -= 64;
+
+            while (length >= 64) {
+                x0 = _mm_xor_si128(Fold(x0, fold512), _mm_shuffle_epi8(_mm_loadu_si128(&block[0]), swap));
+                x1 = _mm_xor_si128(Fold(x1, fold512), _mm_shuffle_epi8(_mm_loadu_si128(&block[1]), swap));
+                x2 = _mm_xor_si128(Fold(x2, fold512), _mm_shuffle_epi8(_mm_loadu_si128(&block[2]), swap));
+                x3 = _mm_xor_si128(Fold(x3, fold512), _mm_shuffle_epi8(_mm_loadu_si128(&block[3]), swap));
+                block += 4;
+                length -= 64;
+            }
+
+            x0 = _mm_xor_si128(_mm_xor_si128(Fold(x0, fold384), Fold(x1, fold256)), _mm_xor_si128(Fold(x2, fold128), x3));
+
+            while (length >= 16) {
+                x0 = _mm_xor_si128(Fold(x0, fold128), _mm_shuffle_epi8(_mm_loadu_si128(block), swap));
+                block++;
+                length -= 16;
+            }
+
+            // What is left over is equivalent to these 16 bytes, fed to a zero CRC, and the tail.
+            uint8_t folded[16];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(folded), _mm_shuffle_epi8(x0, swap));
+
+            crc = Slices().Calculate(0, folded, sizeof(folded));
+
+            return (Slices().Calculate(crc, reinterpret_cast<const uint8_t*>(block), length));
+        }
+
+        static bool HasCLMUL()
+        {
+            uint32_t eax, ebx, ecx, edx;
+
+            return ((__get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0) && ((ecx & bit_PCLMUL) != 0) && ((ecx & bit_SSSE3) != 0));
+        }
+#endif
+    }
+
+    /* static */ uint32_t CRC32Calculator::Calculate(const uint32_t crc, const uint8_t data[], const uint32_t length)
+    {
+#if defined(__CRC32_CLMUL__)
+        static const bool clmul = HasCLMUL();
+
+        if ((clmul == true) && (length >= CLMULMinimum)) {
+            return (CalculateCLMUL(crc, data, length));
+        }
+#endif
+
+        return (Slices().Calculate(crc, data, length));
+    }
+
     /// <summary>
     /// Calculates the CRC value over a (part of) the raw buffer.
     /// </summary>
@@ -59,13 +195,8 @@ namespace Core {
     uint32_t DataElement::CRC32(const uint64_t offset, const uint64_t size) const
     {
         ASSERT(offset + size <= m_Size);
-        uint32_t crc = 0xffffffff;
-
-        for (uint32_t index = 0; index < static_cast<uint32_t>(size); ++index) {
-            crc = (crc << 8) ^ g_CRCtable[((crc >> 24) ^ m_Buffer[static_cast<uint32_t>(offset) + index]) & 0xff];
-        }
 
-        return (crc);
+        return (CRC32Calculator::Calculate(~0, &(m_Buffer[offset]), static_cast<uint32_t>(size)));
     }
 
     void LinkedDataElement::GetBuffer(uint64_t offset, uint32_t size, uint8_t* buffer) const
@@ -93,6 +93,51 @@ namespace Core {
         uint8_t* _buffer;
     };
 
+    // MPEG-2 CRC32: polynomial 0x04C11DB7, most significant bit first, no final XOR.
+    // Data can be fed in as many parts as it arrives in, e.g. a section spread over TS packets,
+    // the result only depends on all bytes fed since the last Reset().
+    class EXTERNAL CRC32Calculator {
+    public:
+        CRC32Calculator()
+            : _crc(~0)
+        {
+        }
+        CRC32Calculator(const CRC32Calculator& copy)
+            : _crc(copy._crc)
+        {
+        }
+        ~CRC32Calculator()
+        {
+        }
+
+        CRC32Calculator& operator=(const CRC32Calculator& rhs)
+        {
+            _crc = rhs._crc;
+
+            return (*this);
+        }
+
+    public:
+        inline void Reset()
+        {
+            _crc = ~0;
+        }
+        inline void Input(const uint8_t data[], const uint32_t length)
+        {
+            _crc = Calculate(_crc, data, length);
+        }
+        inline uint32_t Result() const
+        {
+            return (_crc);
+        }
+
+        // Continue a CRC with the given bytes, start with ~0 for a fresh one.
+        static uint32_t Calculate(const uint32_t crc, const uint8_t data[], const uint32_t length);
+
+    private:
+        uint32_t _crc;
+    };
+
     class EXTERNAL DataElement {
     protected:
         void UpdateCache(const uint64_t offset, uint8_t* buffer, const uint64_t size, const uint64_t maxSize)
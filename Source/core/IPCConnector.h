@@ -18,7 +18,14 @@ namespace Core {
     struct IMessage {
     public:
         typedef IMessage BaseElement;
-        typedef uint32_t Identifier;
+
+        // Every frame carries, next to the label, the sequence number of the call it
+        // belongs to. This allows multiple calls to be outstanding on one channel and
+        // the responses to be matched to the right call, in any order.
+        struct Identifier {
+            uint32_t Label;
+            uint32_t Sequence;
+        };
 
         class Serializer {
         private:
@@ -51,6 +58,7 @@ namespace Core {
                 _current = &element;
 
                 ASSERT(_length <= 0x1FFFFFFF);
+                ASSERT(element.Sequence() <= 0x0FFFFFFF);
 
                 return (true);
             }
@@ -62,7 +70,7 @@ namespace Core {
 
                 while ((_current != nullptr) && (result < maxLength)) {
                     if (_offset < 4) {
-                        uint32_t length = _length + CommandSize();
+                        uint32_t length = _length + CommandSize() + SequenceSize();
 
                         // Write the length. Continue as long as the top bt is active..
                         while ((_offset < 4) && (result < maxLength)) {
@@ -91,16 +99,29 @@ namespace Core {
                         }
                     }
 
+                    // Write the sequence, Same structure as length..
+                    while ((_offset >= 8) && (_offset < 12) && (result < maxLength)) {
+                        uint32_t value = _current->Sequence() >> (7 * (_offset - 8));
+                        stream[result] = ((value & 0x7F) | (value >= 0x80 ? 0x80 : 0x00));
+                        result++;
+
+                        if (value >= 0x80) {
+                            _offset++;
+                        } else {
+                            _offset = 12;
+                        }
+                    }
+
                     if (result < maxLength) {
-                        // Write the command, Same structure as length..
-                        uint16_t handled = _current->Serialize(&stream[result], maxLength - result, _offset - 8);
+                        // Write the payload..
+                        uint16_t handled = _current->Serialize(&stream[result], maxLength - result, _offset - 12);
 
                         result += handled;
                         _offset += handled;
 
-                        ASSERT_VERBOSE((_offset - 8) <= _length, "%d <= %d", (_offset - 8), _length);
+                        ASSERT_VERBOSE((_offset - 12) <= _length, "%d <= %d", (_offset - 12), _length);
 
-                        if ((_offset - 8) == _length) {
+                        if ((_offset - 12) == _length) {
                             const IMessage* ready = _current;
                             _current = nullptr;
 
@@ -119,6 +140,10 @@ namespace Core {
             {
                 return (_current->Label() > 0x1FFFFF ? 4 : (_current->Label() > 0xCFFF ? 3 : (_current->Label() > 0x7F ? 2 : 1)));
             }
+            inline uint32_t SequenceSize() const
+            {
+                return (_current->Sequence() > 0x1FFFFF ? 4 : (_current->Sequence() > 0x3FFF ? 3 : (_current->Sequence() > 0x7F ? 2 : 1)));
+            }
 
         private:
             uint32_t _length;
@@ -136,6 +161,7 @@ namespace Core {
                 : _length(0)
                 , _offset(0)
                 , _label(0)
+                , _sequence(0)
                 , _current(nullptr)
             {
             }
@@ -145,14 +171,14 @@ namespace Core {
 
         public:
             virtual void Deserialized(IMessage& element) = 0;
-            virtual IMessage* Element(const uint32_t& label) = 0;
+            virtual IMessage* Element(const Identifier& identifier) = 0;
 
             uint16_t Deserialize(const uint8_t stream[], const uint16_t maxLength)
             {
                 uint16_t result = 0;
 
                 while (result < maxLength) {
-					if ((_current == nullptr) && (_offset < 8)) {
+					if ((_current == nullptr) && (_offset < 12)) {
                         // We have nothing, start by getting the length/command
                         while ((_offset < 4) && (result < maxLength)) {
                             _length |= ((stream[result] & (_offset == 3 ? 0xFF : 0x7F)) << (7 * _offset));
@@ -175,30 +201,51 @@ namespace Core {
                             }
                         }
 
-                        if (_offset == 8) {
-                            _current = Element(_label);
+                        while ((_offset >= 8) && (_offset < 12) && (result < maxLength)) {
+                            _sequence |= ((stream[result] & (_offset == 11 ? 0xFF : 0x7F)) << (7 * (_offset - 8)));
+                            _length--;
+
+                            if ((stream[result++] & 0x80) != 0) {
+                                _offset++;
+                            } else {
+                                _offset = 12;
+                            }
+                        }
+
+                        if (_offset == 12) {
+                            Identifier identifier;
+                            identifier.Label = _label;
+                            identifier.Sequence = _sequence;
+
+                            _current = Element(identifier);
                             _label = 0;
+                            _sequence = 0;
                         }
                     }
 
-                    ASSERT((_offset - 8) <= _length);
+                    if (_offset < 12) {
+                        // Header is not complete yet, wait for more data.
+                        break;
+                    }
+
+                    ASSERT((_offset - 12) <= _length);
 
-                    if ((_offset - 8) < _length) {
+                    if ((_offset - 12) < _length) {
 
                         // There could be multiple packages in this frame, do not read/handle more than what fits in the frame.
-                        uint16_t handled((maxLength - result) > static_cast<uint16_t>(_length - (_offset - 8)) ? static_cast<uint16_t>(_length - (_offset - 8)) : (maxLength - result));
+                        uint16_t handled((maxLength - result) > static_cast<uint16_t>(_length - (_offset - 12)) ? static_cast<uint16_t>(_length - (_offset - 12)) : (maxLength - result));
 
                         if (_current != nullptr) {
-                            handled = _current->Deserialize(&stream[result], handled, _offset - 8);
+                            handled = _current->Deserialize(&stream[result], handled, _offset - 12);
                         }
 
                         _offset += handled;
                         result += handled;
                     }
 
-                    ASSERT((_offset - 8) <= _length);
+                    ASSERT((_offset - 12) <= _length);
 
-                    if ((_offset - 8) == _length) {
+                    if ((_offset - 12) == _length) {
                         if (_current != nullptr) {
                             IMessage* ready = _current;
                             _current = nullptr;
@@ -215,6 +262,7 @@ namespace Core {
             uint32_t _length;
             uint32_t _offset;
             uint32_t _label;
+            uint32_t _sequence;
             IMessage* _current;
         };
 
@@ -222,6 +270,7 @@ namespace Core {
         virtual ~IMessage() {}
 
         virtual uint32_t Label() const = 0;
+        virtual uint32_t Sequence() const = 0;
         virtual uint32_t Length() const = 0;
         virtual uint16_t Serialize(uint8_t[] /* stream*/, const uint16_t /* maxLength */, const uint32_t offset) const = 0;
         virtual uint16_t Deserialize(const uint8_t[] /* stream*/, const uint16_t /* maxLength */, const uint32_t offset) = 0;
@@ -232,6 +281,8 @@ namespace Core {
         virtual ~IIPC();
 
         virtual uint32_t Label() const = 0;
+        virtual uint32_t Sequence() const = 0;
+        virtual void Sequence(const uint32_t sequence) = 0;
         virtual ProxyType<IMessage> IParameters() = 0;
         virtual ProxyType<IMessage> IResponse() = 0;
     };
@@ -509,6 +560,10 @@ namespace Core {
             {
                 return (REALIDENTIFIER);
             }
+            virtual uint32_t Sequence() const
+            {
+                return (_parent.Sequence());
+            }
             virtual uint32_t Length() const
             {
                 return (_Length<PACKAGE, REALIDENTIFIER>());
@@ -640,11 +695,13 @@ namespace Core {
         IPCMessageType()
             : _parameters(*this)
             , _response(*this)
+            , _sequence(0)
         {
         }
         IPCMessageType(const PARAMETERS& info)
             : _parameters(*this, info)
             , _response(*this)
+            , _sequence(0)
         {
         }
 #ifdef __WIN32__
@@ -677,6 +734,14 @@ namespace Core {
         {
             return (IDENTIFIER);
         }
+        virtual uint32_t Sequence() const
+        {
+            return (_sequence);
+        }
+        virtual void Sequence(const uint32_t sequence)
+        {
+            _sequence = sequence;
+        }
         virtual ProxyType<IMessage> IParameters()
         {
             return ProxyType<IMessage>(&_parameters, &_parameters);
@@ -694,6 +759,7 @@ namespace Core {
     private:
         RawSerializedType<PARAMETERS, (IDENTIFIER << 1)> _parameters;
         RawSerializedType<RESPONSE, ((IDENTIFIER << 1) | 0x1)> _response;
+        uint32_t _sequence;
     };
 
     template <typename RPCMESSAGE>
@@ -778,11 +844,20 @@ namespace Core {
             IPCFactory(const IPCFactory& copy) = delete;
             IPCFactory& operator=(const IPCFactory&) = delete;
 
+            // An outstanding call, waiting for its response. Multiple calls can be
+            // outstanding on a channel at the same time, they are identified by the
+            // sequence number they were sent out with.
+            struct Outbound {
+                Core::ProxyType<IIPC> Message;
+                IDispatchType<IIPC>* Callback;
+            };
+            typedef std::map<uint32_t, Outbound> OutboundMap;
+
             IPCFactory()
                 : _lock()
                 , _inbound()
                 , _outbound()
-                , _callback(nullptr)
+                , _sequence(0)
                 , _factory()
                 , _handlers()
             {
@@ -799,7 +874,7 @@ namespace Core {
                 : _lock()
                 , _inbound()
                 , _outbound()
-                , _callback(nullptr)
+                , _sequence(0)
                 , _factory(factory)
                 , _handlers()
             {
@@ -851,21 +926,29 @@ namespace Core {
 
             inline bool InProgress() const
             {
-                return (_outbound.IsValid());
+                _lock.Lock();
+
+                bool result = (_outbound.empty() == false);
+
+                _lock.Unlock();
+
+                return (result);
             }
 
-            inline ProxyType<IMessage> Element(const uint32_t& identifier)
+            inline ProxyType<IMessage> Element(const IMessage::Identifier& identifier)
             {
                 ProxyType<IMessage> result;
-                uint32_t searchIdentifier(identifier >> 1);
+                uint32_t searchIdentifier(identifier.Label >> 1);
 
                 _lock.Lock();
 
-                if (identifier & 0x01) {
-                    if ((_outbound.IsValid() == true) && (_outbound->Label() == searchIdentifier)) {
-                        result = _outbound->IResponse();
+                if (identifier.Label & 0x01) {
+                    OutboundMap::iterator index(_outbound.find(identifier.Sequence));
+
+                    if ((index != _outbound.end()) && (index->second.Message->Label() == searchIdentifier)) {
+                        result = index->second.Message->IResponse();
                     } else {
-                        TRACE_L1("Unexpected response message for ID [%d].\n", searchIdentifier);
+                        TRACE_L1("Unexpected response message for ID [%d], sequence [%d].\n", searchIdentifier, identifier.Sequence);
                     }
                 } else {
                     ASSERT(_inbound.IsValid() == false);
@@ -873,6 +956,8 @@ namespace Core {
                     ProxyType<IIPC> rpcCall(_factory->Element(searchIdentifier));
 
                     if (rpcCall.IsValid() == true) {
+                        // The response to this call should go out with the sequence it came in with.
+                        rpcCall->Sequence(identifier.Sequence);
                         _inbound = rpcCall;
                         result = rpcCall->IParameters();
                     } else {
@@ -891,11 +976,8 @@ namespace Core {
 
                 TRACE_L1("Flushing the IPC mechanims. %d", __LINE__);
 
-                _callback = nullptr;
+                _outbound.clear();
 
-                if (_outbound.IsValid() == true) {
-                    _outbound.Release();
-                }
                 if (_inbound.IsValid() == true) {
                     _inbound.Release();
                 }
@@ -909,15 +991,17 @@ namespace Core {
 
                 _lock.Lock();
 
-                if ((_outbound.IsValid() == true) && (_outbound->IResponse() == rhs)) {
+                OutboundMap::iterator index((rhs->Label() & 0x01) ? _outbound.find(rhs->Sequence()) : _outbound.end());
+
+                if ((index != _outbound.end()) && (index->second.Message->IResponse() == rhs)) {
 
-                    ASSERT(_callback != nullptr);
+                    ASSERT(index->second.Callback != nullptr);
 
-                    ProxyType<IIPC> handledObject(_outbound);
+                    ProxyType<IIPC> handledObject(index->second.Message);
+                    IDispatchType<IIPC>* callback(index->second.Callback);
 
-                    _outbound.Release();
-                    _callback->Dispatch(*handledObject);
-                    _callback = nullptr;
+                    _outbound.erase(index);
+                    callback->Dispatch(*handledObject);
                 }
                 // If this is *NOT* the outbound call, it is inbound and thus it must have been registered
                 else if (_inbound.IsValid() == true) {
@@ -943,37 +1027,77 @@ namespace Core {
                 return (procedure);
             }
 
-            inline void SetOutbound(const Core::ProxyType<IIPC>& outbound, IDispatchType<IIPC>* callback)
+            inline uint32_t SetOutbound(const Core::ProxyType<IIPC>& outbound, IDispatchType<IIPC>* callback)
             {
                 _lock.Lock();
 
                 ASSERT((outbound.IsValid() == true) && (callback != nullptr));
-                ASSERT((_outbound.IsValid() == false) && (_callback == nullptr));
 
-                _outbound = outbound;
-                _callback = callback;
+                // Sequence numbers are sent as a varint of at most 4 bytes, so wrap at 28 bits.
+                uint32_t sequence = _sequence;
+                _sequence = (_sequence + 1) & 0x0FFFFFFF;
+
+                ASSERT(_outbound.find(sequence) == _outbound.end());
+
+                outbound->Sequence(sequence);
+
+                Outbound& entry(_outbound[sequence]);
+                entry.Message = outbound;
+                entry.Callback = callback;
 
                 _lock.Unlock();
+
+                return (sequence);
             }
 
-            inline bool AbortOutbound()
+            // Abort a specific outstanding call. Returns true if the call was still outstanding.
+            inline bool AbortOutbound(const uint32_t sequence)
             {
                 bool result = false;
 
                 _lock.Lock();
 
-                if (_outbound.IsValid() == true) {
+                OutboundMap::iterator index(_outbound.find(sequence));
+
+                if (index != _outbound.end()) {
+
+                    ProxyType<IIPC> handledObject(index->second.Message);
+                    IDispatchType<IIPC>* callback(index->second.Callback);
 
                     result = true;
 
-                    if (_callback != nullptr) {
-                        _callback->Dispatch(*_outbound);
-                        _callback = nullptr;
+                    _outbound.erase(index);
+
+                    if (callback != nullptr) {
+                        callback->Dispatch(*handledObject);
                     }
+                }
 
-                    _outbound.Release();
-                } else {
-                    ASSERT(_callback == nullptr);
+                _lock.Unlock();
+
+                return (result);
+            }
+
+            // Abort all outstanding calls. Returns true if there was at least one call outstanding.
+            inline bool AbortOutbound()
+            {
+                bool result = false;
+
+                _lock.Lock();
+
+                while (_outbound.empty() == false) {
+
+                    OutboundMap::iterator index(_outbound.begin());
+                    ProxyType<IIPC> handledObject(index->second.Message);
+                    IDispatchType<IIPC>* callback(index->second.Callback);
+
+                    result = true;
+
+                    _outbound.erase(index);
+
+                    if (callback != nullptr) {
+                        callback->Dispatch(*handledObject);
+                    }
                 }
 
                 _lock.Unlock();
@@ -984,8 +1108,8 @@ namespace Core {
         private:
             mutable CriticalSection _lock;
             Core::ProxyType<IIPC> _inbound;
-            mutable Core::ProxyType<IIPC> _outbound;
-            IDispatchType<IIPC>* _callback;
+            OutboundMap _outbound;
+            uint32_t _sequence;
             Core::ProxyType<FactoryType<IIPC, uint32_t>> _factory;
             std::map<uint32_t, ProxyType<IIPCServer>> _handlers;
         };
@@ -1167,6 +1291,7 @@ namespace Core {
             IPCTrigger(IPCFactory& administration)
                 : _administration(administration)
                 , _signal(false, true)
+                , _sequence(~0)
             {
             }
             virtual ~IPCTrigger()
@@ -1174,16 +1299,20 @@ namespace Core {
             }
 
         public:
+            inline void Sequence(const uint32_t sequence)
+            {
+                _sequence = sequence;
+            }
             uint32_t Wait(const uint32_t waitTime)
             {
                 uint32_t result = Core::ERROR_NONE;
 
                 // Now we wait for ever, to get a signal that we are done :-)
                 if (_signal.Lock(waitTime) != Core::ERROR_NONE) {
-                    _administration.AbortOutbound();
+                    _administration.AbortOutbound(_sequence);
 
                     result = Core::ERROR_TIMEDOUT;
-                } else if (_administration.AbortOutbound() == true) {
+                } else if (_administration.AbortOutbound(_sequence) == true) {
                     result = Core::ERROR_ASYNC_FAILED;
                 }
 
@@ -1197,6 +1326,7 @@ namespace Core {
         private:
             IPCFactory& _administration;
             Event _signal;
+            uint32_t _sequence;
         };
 
     public:
@@ -1337,13 +1467,10 @@ namespace Core {
         {
             uint32_t success = Core::ERROR_UNAVAILABLE;
 
-            _serialize.Lock();
-
-            if (_administration.InProgress() == true) {
-                success = Core::ERROR_INPROGRESS;
-            } else if (_link.IsOpen() == true) {
+            if (_link.IsOpen() == true) {
                 // We need to accept a CONST object to avoid an additional object creation
-                // proxy casted objects.
+                // proxy casted objects. Calls are not serialized, the response is matched
+                // to this call by the sequence number assigned here.
                 _administration.SetOutbound(command, completed);
 
                 // Send out the
@@ -1352,22 +1479,18 @@ namespace Core {
                 success = Core::ERROR_NONE;
             }
 
-            _serialize.Unlock();
-
             return (success);
         }
         virtual uint32_t Execute(ProxyType<IIPC>& command, const uint32_t waitTime)
         {
             uint32_t success = Core::ERROR_CONNECTION_CLOSED;
 
-            _serialize.Lock();
-
             if (_link.IsOpen() == true) {
                 IPCTrigger sink(_administration);
 
                 // We need to accept a CONST object to avoid an additional object creation
                 // proxy casted objects.
-                _administration.SetOutbound(command, &sink);
+                sink.Sequence(_administration.SetOutbound(command, &sink));
 
                 // Send out the
                 _link.Submit(command->IParameters());
@@ -1375,8 +1498,6 @@ namespace Core {
                 success = sink.Wait(waitTime);
             }
 
-            _serialize.Unlock();
-
             return (success);
         }
         inline void CallProcedure(ProxyType<IIPCServer>& procedure, ProxyType<IIPC>& message)
@@ -1385,7 +1506,6 @@ namespace Core {
         }
 
     private:
-        CriticalSection _serialize;
         IPCLink _link;
         EXTENSION _extension;
     };
@@ -2,6 +2,7 @@
 #define __JSON_H
 
 #include <map>
+#include <vector>
 
 #include "Enumerate.h"
 #include "FileSystem.h"
@@ -1667,10 +1668,141 @@ namespace Core {
             static constexpr uint16_t PARSE = 5;
 
         public:
+            // Elements are stored in chunks that double in size (8, 16, 32, ...). Elements never move once
+            // they are added, so references (and the pointers a Container registers to its own members)
+            // stay valid, and indexed access is O(1). Chunks are kept on Clear(), for reuse.
+            class Storage {
+            private:
+                static constexpr uint8_t FirstShift = 3;
+
+            public:
+                Storage()
+                    : _chunks()
+                    , _size(0)
+                {
+                }
+                Storage(const Storage& copy)
+                    : _chunks()
+                    , _size(0)
+                {
+                    Copy(copy);
+                }
+                ~Storage()
+                {
+                    Clear();
+
+                    for (uint8_t* chunk : _chunks) {
+                        ::operator delete(chunk);
+                    }
+                }
+
+                Storage& operator=(const Storage& RHS)
+                {
+                    if (this != &RHS) {
+                        Clear();
+                        Copy(RHS);
+                    }
+
+                    return (*this);
+                }
+
+            public:
+                inline uint32_t size() const
+                {
+                    return (_size);
+                }
+                inline bool empty() const
+                {
+                    return (_size == 0);
+                }
+                inline uint32_t Capacity() const
+                {
+                    return (((1UL << _chunks.size()) - 1) << FirstShift);
+                }
+                void Reserve(const uint32_t count)
+                {
+                    while (Capacity() < count) {
+                        _chunks.push_back(static_cast<uint8_t*>(::operator new((1UL << (_chunks.size() + FirstShift)) * sizeof(ELEMENT))));
+                    }
+                }
+                inline ELEMENT& Append()
+                {
+                    Reserve(_size + 1);
+
+                    return (*(new (Slot(_size++)) ELEMENT()));
+                }
+                inline ELEMENT& Append(const ELEMENT& element)
+                {
+                    Reserve(_size + 1);
+
+                    return (*(new (Slot(_size++)) ELEMENT(element)));
+                }
+                void Clear()
+                {
+                    while (_size > 0) {
+                        _size--;
+                        reinterpret_cast<ELEMENT*>(Slot(_size))->~ELEMENT();
+                    }
+                }
+                inline ELEMENT& operator[](const uint32_t index)
+                {
+                    ASSERT(index < _size);
+
+                    return (*reinterpret_cast<ELEMENT*>(Slot(index)));
+                }
+                inline const ELEMENT& operator[](const uint32_t index) const
+                {
+                    ASSERT(index < _size);
+
+                    return (*reinterpret_cast<const ELEMENT*>(const_cast<Storage*>(this)->Slot(index)));
+                }
+                inline ELEMENT& back()
+                {
+                    return (operator[](_size - 1));
+                }
+
+            private:
+                void Copy(const Storage& copy)
+                {
+                    Reserve(copy._size);
+
+                    for (uint32_t index = 0; index < copy._size; index++) {
+                        new (Slot(_size++)) ELEMENT(copy[index]);
+                    }
+                }
+                inline uint8_t* Slot(const uint32_t index)
+                {
+                    uint32_t position = index + (1UL << FirstShift);
+                    uint8_t chunk = HighestBit(position);
+
+                    return (&(_chunks[chunk - FirstShift][(position - (1UL << chunk)) * sizeof(ELEMENT)]));
+                }
+                static inline uint8_t HighestBit(const uint32_t value)
+                {
+#ifdef __GNUC__
+                    return (static_cast<uint8_t>(31 - __builtin_clz(value)));
+#else
+                    uint8_t result = 0;
+                    uint32_t remainder = value;
+
+                    while ((remainder >>= 1) != 0) {
+                        result++;
+                    }
+
+                    return (result);
+#endif
+                }
+
+            private:
+                std::vector<uint8_t*> _chunks;
+                uint32_t _size;
+            };
+
+            // Iterators hold a position, not a pointer, so they survive elements being added.
             template <typename ARRAYELEMENT>
             class ConstIteratorType {
             private:
-                typedef std::list<ARRAYELEMENT> ArrayContainer;
+                typedef Storage ArrayContainer;
                 enum State {
                     AT_BEGINNING,
                     AT_ELEMENT,
@@ -1680,19 +1812,19 @@ namespace Core {
             public:
                 ConstIteratorType()
                     : _container(nullptr)
-                    , _iterator()
+                    , _index(0)
                     , _state(AT_BEGINNING)
                 {
                 }
                 ConstIteratorType(const ArrayContainer& container)
                     : _container(&container)
-                    , _iterator(container.begin())
+                    , _index(0)
                     , _state(AT_BEGINNING)
                 {
                 }
                 ConstIteratorType(const ConstIteratorType<ARRAYELEMENT>& copy)
                     : _container(copy._container)
-                    , _iterator(copy._iterator)
+                    , _index(copy._index)
                     , _state(copy._state)
                 {
                 }
@@ -1703,7 +1835,7 @@ namespace Core {
                 ConstIteratorType<ARRAYELEMENT>& operator=(const ConstIteratorType<ARRAYELEMENT>& RHS)
                 {
                     _container = RHS._container;
-                    _iterator = RHS._iterator;
+                    _index = RHS._index;
                     _state = RHS._state;
 
                     return (*this);
@@ -1716,9 +1848,7 @@ namespace Core {
                 }
                 void Reset()
                 {
-                    if (_container != nullptr) {
-                        _iterator = _container->begin();
-                    }
+                    _index = 0;
                     _state = AT_BEGINNING;
                 }
                 virtual bool Next()
@@ -1726,14 +1856,14 @@ namespace Core {
                     if (_container != nullptr) {
                         if (_state != AT_END) {
                             if (_state != AT_BEGINNING) {
-                                _iterator++;
+                                _index++;
                             }
 
-                            while ((_iterator != _container->end()) && (_iterator->IsSet() == false)) {
-                                _iterator++;
+                            while ((_index < _container->size()) && ((*_container)[_index].IsSet() == false)) {
+                                _index++;
                             }
 
-                            _state = (_iterator != _container->end() ? AT_ELEMENT : AT_END);
+                            _state = (_index < _container->size() ? AT_ELEMENT : AT_END);
                         }
                     } else {
                         _state = AT_END;
@@ -1744,7 +1874,7 @@ namespace Core {
                 {
                     ASSERT(_state == AT_ELEMENT);
 
-                    return (*_iterator);
+                    return ((*_container)[_index]);
                 }
                 inline uint32_t Count() const
                 {
@@ -1753,13 +1883,13 @@ namespace Core {
 
             private:
                 const ArrayContainer* _container;
-                typename ArrayContainer::const_iterator _iterator;
+                uint32_t _index;
                 State _state;
             };
             template <typename ARRAYELEMENT>
             class IteratorType {
             private:
-                typedef std::list<ARRAYELEMENT> ArrayContainer;
+                typedef Storage ArrayContainer;
                 enum State {
                     AT_BEGINNING,
                     AT_ELEMENT,
@@ -1769,19 +1899,19 @@ namespace Core {
             public:
                 IteratorType()
                     : _container(nullptr)
-                    , _iterator()
+                    , _index(0)
                     , _state(AT_BEGINNING)
                 {
                 }
                 IteratorType(ArrayContainer& container)
                     : _container(&container)
-                    , _iterator(container.begin())
+                    , _index(0)
                     , _state(AT_BEGINNING)
                 {
                 }
                 IteratorType(const IteratorType<ARRAYELEMENT>& copy)
                     : _container(copy._container)
-                    , _iterator(copy._iterator)
+                    , _index(copy._index)
                     , _state(copy._state)
                 {
                 }
@@ -1792,7 +1922,7 @@ namespace Core {
                 IteratorType<ARRAYELEMENT>& operator=(const IteratorType<ARRAYELEMENT>& RHS)
                 {
                     _container = RHS._container;
-                    _iterator = RHS._iterator;
+                    _index = RHS._index;
                     _state = RHS._state;
 
                     return (*this);
@@ -1805,9 +1935,7 @@ namespace Core {
                 }
                 void Reset()
                 {
-                    if (_container != nullptr) {
-                        _iterator = _container->begin();
-                    }
+                    _index = 0;
                     _state = AT_BEGINNING;
                 }
                 bool Next()
@@ -1815,14 +1943,14 @@ namespace Core {
                     if (_container != nullptr) {
                         if (_state != AT_END) {
                             if (_state != AT_BEGINNING) {
-                                _iterator++;
+                                _index++;
                             }
 
-                            while ((_iterator != _container->end()) && (_iterator->IsSet() == false)) {
-                                _iterator++;
+                            while ((_index < _container->size()) && ((*_container)[_index].IsSet() == false)) {
+                                _index++;
                             }
 
-                            _state = (_iterator != _container->end() ? AT_ELEMENT : AT_END);
+                            _state = (_index < _container->size() ? AT_ELEMENT : AT_END);
                         }
                     } else {
                         _state = AT_END;
@@ -1833,13 +1961,13 @@ namespace Core {
                 {
                     ASSERT(_state == AT_ELEMENT);
 
-                    return (&(*_iterator));
+                    return (&((*_container)[_index]));
                 }
                 ARRAYELEMENT& Current()
                 {
                     ASSERT(_state == AT_ELEMENT);
 
-                    return (*_iterator);
+                    return ((*_container)[_index]);
                 }
                 inline uint32_t Count() const
                 {
@@ -1848,7 +1976,7 @@ namespace Core {
 
             private:
                 ArrayContainer* _container;
-                typename ArrayContainer::iterator _iterator;
+                uint32_t _index;
                 State _state;
             };
 
@@ -1883,55 +2011,36 @@ namespace Core {
             virtual void Clear() override
             {
                 _state = 0;
-                _data.clear();
+                _data.Clear();
             }
             inline uint16_t Length() const
             {
                 return static_cast<uint16_t>(_data.size());
             }
+            // Make room for at least count elements, so they can be added without allocations.
+            inline void Reserve(const uint32_t count)
+            {
+                _data.Reserve(count);
+            }
             inline ELEMENT& Add()
             {
-                _data.push_back(ELEMENT());
-
-                return (_data.back());
+                return (_data.Append());
             }
             inline ELEMENT& Add(const ELEMENT& element)
             {
-                _data.push_back(element);
-
-                return (_data.back());
+                return (_data.Append(element));
             }
             ELEMENT& operator[](const uint32_t index)
             {
-                uint32_t skip = index;
                 ASSERT(index < Length());
 
-                typename std::list<ELEMENT>::iterator locator = _data.begin();
-
-                while (skip != 0) {
-                    locator++;
-                    skip--;
-                }
-
-                ASSERT(locator != _data.end());
-
-                return (*locator);
+                return (_data[index]);
             }
             const ELEMENT& operator[](const uint32_t index) const
             {
-                uint32_t skip = index;
                 ASSERT(index < Length());
 
-                typename std::list<ELEMENT>::const_iterator locator = _data.begin();
-
-                while (skip != 0) {
-                    locator++;
-                    skip--;
-                }
-
-                ASSERT(locator != _data.end());
-
-                return (*locator);
+                return (_data[index]);
             }
             const ELEMENT& Get(const uint32_t index) const
             {
@@ -2031,7 +2140,7 @@ namespace Core {
                                 break;
                             default:
                                 offset = PARSE;
-                                _data.push_back(ELEMENT());
+                                _data.Append();
                                 break;
                             }
                         }
@@ -2113,7 +2222,7 @@ namespace Core {
                     if (offset == PARSE) {
                         if (_count > 0) {
                             _count--;
-                            _data.emplace_back(ELEMENT());
+                            _data.Append();
                         } else {
                             offset = 0;
                         }
@@ -2131,7 +2240,7 @@ namespace Core {
         private:
             uint8_t _state;
             uint16_t _count;
-            std::list<ELEMENT> _data;
+            Storage _data;
             mutable IteratorType<ELEMENT> _iterator;
         };
 
@@ -2149,7 +2258,7 @@ namespace Core {
             static constexpr uint16_t PARSE = 5;
 
             typedef std::pair<const TCHAR*, IElement*> JSONLabelValue;
-            typedef std::list<JSONLabelValue> JSONElementList;
+            typedef std::vector<JSONLabelValue> JSONElementList;
 
             class Iterator {
             private:
@@ -2220,6 +2329,7 @@ namespace Core {
             Container()
                 : _state(0)
                 , _data()
+                , _index()
                 , _iterator()
                 , _fieldName(true)
             {
@@ -2231,13 +2341,7 @@ namespace Core {
         public:
             bool HasLabel(const string& label) const
             {
-                JSONElementList::const_iterator index(_data.begin());
-
-                while ((index != _data.end()) && (index->first != label)) {
-                    index++;
-                }
-
-                return (index != _data.end());
+                return (Lookup(label.c_str()) != static_cast<uint16_t>(~0));
             }
             virtual bool IsSet() const override
             {
@@ -2268,7 +2372,10 @@ namespace Core {
 
             void Add(const TCHAR label[], IElement* element)
             {
+                ASSERT(_data.size() < static_cast<uint16_t>(~0));
+
                 _data.push_back(JSONLabelValue(label, element));
+                _index.clear();
             }
             void Remove(const TCHAR label[])
             {
@@ -2280,6 +2387,7 @@ namespace Core {
 
                 if (index != _data.end()) {
                     _data.erase(index);
+                    _index.clear();
                 }
             }
 
@@ -2519,21 +2627,72 @@ namespace Core {
 
                 return (loaded);
             }
-            IElement* Find(const char label[])
+            // The labels are indexed in a (lazily built) open addressing hash table, holding the position
+            // of the element in _data (+1, 0 is an empty slot). Any Add/Remove drops the index.
+            static uint32_t Hash(const TCHAR label[])
             {
-                IElement* result = nullptr;
+                uint32_t hash = 2166136261u;
 
-                JSONElementList::iterator index = _data.begin();
+                while (*label != '\0') {
+                    hash = (hash ^ static_cast<uint32_t>(*label++)) * 16777619u;
+                }
 
-                while ((index != _data.end()) && (strcmp(label, index->first) != 0)) {
-                    index++;
+                return (hash);
+            }
+            void BuildIndex() const
+            {
+                uint32_t size = 8;
+
+                while (size < (_data.size() * 2)) {
+                    size <<= 1;
                 }
 
-                if (index != _data.end()) {
-                    result = index->second;
+                _index.assign(size, 0);
+
+                for (uint16_t position = 0; position < _data.size(); position++) {
+                    uint32_t slot = Hash(_data[position].first) & (size - 1);
+
+                    while (_index[slot] != 0) {
+                        slot = (slot + 1) & (size - 1);
+                    }
+
+                    _index[slot] = position + 1;
+                }
+            }
+            uint16_t Lookup(const TCHAR label[]) const
+            {
+                uint16_t result = static_cast<uint16_t>(~0);
+
+                if (_data.empty() == false) {
+                    if (_index.empty() == true) {
+                        BuildIndex();
+                    }
+
+                    uint32_t mask = static_cast<uint32_t>(_index.size() - 1);
+                    uint32_t slot = Hash(label) & mask;
+
+                    // Labels are added in order, so with duplicates, the first one added is found first.
+                    while ((_index[slot] != 0) && (result == static_cast<uint16_t>(~0))) {
+                        if (_tcscmp(label, _data[_index[slot] - 1].first) == 0) {
+                            result = _index[slot] - 1;
+                        }
+                        slot = (slot + 1) & mask;
+                    }
+                }
+
+                return (result);
+            }
+            IElement* Find(const char label[])
+            {
+                IElement* result = nullptr;
+
+                uint16_t position = Lookup(label);
+
+                if (position != static_cast<uint16_t>(~0)) {
+                    result = _data[position].second;
                 }
                 if (Request(label) == true) {
-                    index = _data.end();
+                    JSONElementList::iterator index = _data.end();
 
                     while ((result == nullptr) && (index != _data.begin())) {
                         index--;
@@ -2565,6 +2724,7 @@ namespace Core {
                 mutable IMessagePack* pack;
             } _current;
             JSONElementList _data;
+            mutable std::vector<uint16_t> _index;
             mutable JSONElementList::const_iterator _iterator;
             mutable String _fieldName;
         };
@@ -89,6 +89,128 @@ namespace Core {
                 Core::JSON::String Data;
             };
 
+            // Whoever owns the inbound channel knows which handler a designator ends up on. If it can hand
+            // out the object that handler takes as "params", they are parsed straight into it.
+            // It is asked while the message is still being parsed, so before the complete message could be
+            // checked, it gets the message as far as it is parsed to judge on it.
+            struct IResolver {
+                virtual ~IResolver() {}
+
+                virtual Core::ProxyType<Core::JSON::IElement> Parameters(const Message& message) = 0;
+            };
+
+            // The "params" or "result" of a message. Holds the raw JSON text, or a typed element that is
+            // (de)serialized in place, so it does not need to pass through an intermediate string.
+            class EXTERNAL Payload : public Core::JSON::String {
+            private:
+                Payload(const Payload&) = delete;
+
+            public:
+                Payload(const Message* parent = nullptr)
+                    : Core::JSON::String(false)
+                    , _parent(parent)
+                    , _element()
+                {
+                }
+                virtual ~Payload()
+                {
+                }
+
+                Payload& operator=(const string& RHS)
+                {
+                    if (_element.IsValid() == true) {
+                        _element.Release();
+                    }
+                    Core::JSON::String::operator=(RHS);
+
+                    return (*this);
+                }
+                Payload& operator=(const TCHAR RHS[])
+                {
+                    if (_element.IsValid() == true) {
+                        _element.Release();
+                    }
+                    Core::JSON::String::operator=(RHS);
+
+                    return (*this);
+                }
+                // A typed element is shared, not copied.
+                Payload& operator=(const Payload& RHS)
+                {
+                    Core::JSON::String::operator=(RHS);
+                    _element = RHS._element;
+
+                    return (*this);
+                }
+
+            public:
+                inline const Core::ProxyType<Core::JSON::IElement>& Element() const
+                {
+                    return (_element);
+                }
+                inline void Element(const Core::ProxyType<Core::JSON::IElement>& element)
+                {
+                    Core::JSON::String::Clear();
+                    _element = element;
+                }
+                const string Value() const
+                {
+                    string result;
+
+                    if (_element.IsValid() == true) {
+                        _element->ToString(result);
+                    } else {
+                        result = Core::JSON::String::Value();
+                    }
+
+                    return (result);
+                }
+                virtual bool IsSet() const override
+                {
+                    return ((_element.IsValid() == true) || (Core::JSON::String::IsSet() == true));
+                }
+                virtual bool IsNull() const override
+                {
+                    return ((_element.IsValid() == false) && (Core::JSON::String::IsNull() == true));
+                }
+                virtual void Clear() override
+                {
+                    if (_element.IsValid() == true) {
+                        _element.Release();
+                    }
+                    Core::JSON::String::Clear();
+                }
+
+            protected:
+                virtual uint16_t Serialize(char stream[], const uint16_t maxLength, uint16_t& offset) const override
+                {
+                    return (_element.IsValid() == true ? static_cast<const Core::JSON::IElement&>(*_element).Serialize(stream, maxLength, offset) : Core::JSON::String::Serialize(stream, maxLength, offset));
+                }
+                virtual uint16_t Deserialize(const char stream[], const uint16_t maxLength, uint16_t& offset) override
+                {
+                    if (offset == 0) {
+                        if (_element.IsValid() == true) {
+                            _element.Release();
+                        }
+
+                        // Only objects are taken in directly, anything else is kept as text for the handler to judge.
+                        if ((_parent != nullptr) && (stream[0] == '{')) {
+                            _element = _parent->Resolve();
+
+                            if (_element.IsValid() == true) {
+                                _element->Clear();
+                            }
+                        }
+                    }
+
+                    return (_element.IsValid() == true ? static_cast<Core::JSON::IElement&>(*_element).Deserialize(stream, maxLength, offset) : Core::JSON::String::Deserialize(stream, maxLength, offset));
+                }
+
+            private:
+                const Message* _parent;
+                Core::ProxyType<Core::JSON::IElement> _element;
+            };
+
         public:
             static constexpr TCHAR DefaultVersion[] = _T("2.0");
 
@@ -97,9 +219,10 @@ namespace Core {
                 , JSONRPC(DefaultVersion)
                 , Id(~0)
                 , Designator()
-                , Parameters(false)
-                , Result(false)
+                , Parameters(this)
+                , Result()
                 , Error()
+                , _resolver(nullptr)
             {
                 Add(_T("jsonrpc"), &JSONRPC);
                 Add(_T("id"), &Id);
@@ -198,6 +321,12 @@ namespace Core {
                 Parameters.Clear();
                 Result.Clear();
                 Error.Clear();
+                _resolver = nullptr;
+            }
+            // Only lasts until the message is cleared, so set it each time the message is taken for receiving.
+            inline void Resolver(IResolver* resolver)
+            {
+                _resolver = resolver;
             }
             string Callsign() const
             {
@@ -230,9 +359,19 @@ namespace Core {
             Core::JSON::String JSONRPC;
             Core::JSON::DecUInt32 Id;
             Core::JSON::String Designator;
-            Core::JSON::String Parameters;
-            Core::JSON::String Result;
+            Payload Parameters;
+            Payload Result;
             Info Error;
+
+        private:
+            // The "params" can only be taken in directly if the "method" preceded them.
+            Core::ProxyType<Core::JSON::IElement> Resolve() const
+            {
+                return ((_resolver != nullptr) && (Designator.IsSet() == true) ? _resolver->Parameters(*this) : Core::ProxyType<Core::JSON::IElement>());
+            }
+
+        private:
+            IResolver* _resolver;
         };
 
         class EXTERNAL Connection {
@@ -277,10 +416,176 @@ namespace Core {
             uint32_t _sequence;
         };
 
+        // A notification serialized once for all subscribers of an event. The subscribers only differ in
+        // the designator in front of the event name, everything from the event name onwards is shared.
+        class EXTERNAL Frame {
+        private:
+            Frame() = delete;
+            Frame(const Frame&) = delete;
+            Frame& operator=(const Frame&) = delete;
+
+        public:
+            Frame(const string& event, const string& parameters)
+                : _event(event)
+                , _body()
+            {
+                _body.reserve(event.length() + parameters.length() + 12);
+
+                Escape(_body, event);
+
+                if (parameters.empty() == true) {
+                    _body += _T("\"}");
+                } else {
+                    _body += _T("\",\"params\":");
+                    _body += parameters;
+                    _body += '}';
+                }
+            }
+            ~Frame()
+            {
+            }
+
+        public:
+            const string& Event() const
+            {
+                return (_event);
+            }
+            const string& Body() const
+            {
+                return (_body);
+            }
+
+            static void Escape(string& destination, const string& source)
+            {
+                for (const TCHAR character : source) {
+                    if ((character == '\"') || (character == '\\')) {
+                        destination += '\\';
+                    }
+                    destination += character;
+                }
+            }
+
+        private:
+            const string _event;
+            string _body;
+        };
+
+        // The per subscriber view on a Frame: the JSON-RPC header with its designator, followed by the
+        // shared body. It can only be serialized.
+        class EXTERNAL Notification : public Core::JSON::IElement {
+        private:
+            Notification(const Notification&) = delete;
+            Notification& operator=(const Notification&) = delete;
+
+        public:
+            Notification()
+                : _frame()
+                , _designator()
+                , _header()
+                , _position(0)
+            {
+            }
+            ~Notification()
+            {
+            }
+
+        public:
+            void Set(const Core::ProxyType<Frame>& frame, const string& designator)
+            {
+                ASSERT(frame.IsValid() == true);
+
+                _frame = frame;
+                _designator = (designator.empty() == true ? frame->Event() : designator + '.' + frame->Event());
+                _header = _T("{\"jsonrpc\":\"");
+                _header += Message::DefaultVersion;
+                _header += _T("\",\"method\":\"");
+
+                if (designator.empty() == false) {
+                    Frame::Escape(_header, designator);
+                    _header += '.';
+                }
+
+                _position = 0;
+            }
+            // The full method name, so it can be coalesced like any other notification.
+            const string& Designator() const
+            {
+                return (_designator);
+            }
+            uint32_t Length() const
+            {
+                return (_frame.IsValid() == true ? static_cast<uint32_t>(_header.length() + _frame->Body().length()) : 0);
+            }
+
+            virtual void Clear() override
+            {
+                if (_frame.IsValid() == true) {
+                    _frame.Release();
+                }
+                _designator.clear();
+                _header.clear();
+                _position = 0;
+            }
+            virtual bool IsSet() const override
+            {
+                return (_frame.IsValid());
+            }
+            virtual bool IsNull() const override
+            {
+                return (false);
+            }
+            // The offset only tells if we are in the middle of it, the position itself might not fit in it.
+            virtual uint16_t Serialize(char stream[], const uint16_t maxLength, uint16_t& offset) const override
+            {
+                uint16_t loaded = 0;
+
+                if (offset == 0) {
+                    _position = 0;
+                }
+
+                if (_frame.IsValid() == true) {
+                    const uint32_t headerLength = static_cast<uint32_t>(_header.length());
+                    const string& body(_frame->Body());
+
+                    if (_position < headerLength) {
+                        loaded = static_cast<uint16_t>(std::min(headerLength - _position, static_cast<uint32_t>(maxLength)));
+                        ::memcpy(stream, &(_header[_position]), loaded);
+                        _position += loaded;
+                    }
+                    if ((_position >= headerLength) && (loaded < maxLength)) {
+                        uint32_t start = _position - headerLength;
+                        uint16_t size = static_cast<uint16_t>(std::min(static_cast<uint32_t>(body.length()) - start, static_cast<uint32_t>(maxLength - loaded)));
+                        ::memcpy(&(stream[loaded]), &(body[start]), size);
+                        loaded += size;
+                        _position += size;
+                    }
+                }
+
+                offset = (_position < Length() ? 1 : 0);
+
+                return (loaded);
+            }
+            virtual uint16_t Deserialize(const char[], const uint16_t, uint16_t& offset) override
+            {
+                // Notifications are outbound only.
+                ASSERT(false);
+                offset = 0;
+                return (0);
+            }
+
+        private:
+            Core::ProxyType<Frame> _frame;
+            string _designator;
+            string _header;
+            mutable uint32_t _position;
+        };
+
         class EXTERNAL Handler {
         private:
             typedef std::function<void(const Connection& channel, const string& parameters)> CallbackFunction;
             typedef std::function<uint32_t(const string& method, const string& parameters, string& result)> InvokeFunction;
+            typedef std::function<uint32_t(const string& method, const Message::Payload& parameters, Message::Payload& result)> DirectFunction;
+            typedef std::function<Core::ProxyType<Core::JSON::IElement>()> ParametersFunction;
 
             class Entry {
             private:
@@ -316,16 +621,29 @@ namespace Core {
                 Entry(const CallbackFunction& callback)
                     : _asynchronous(true)
                     , _info(callback)
+                    , _direct()
+                    , _parameters()
                 {
                 }
                 Entry(const InvokeFunction& callback)
                     : _asynchronous(false)
                     , _info(callback)
+                    , _direct()
+                    , _parameters()
+                {
+                }
+                Entry(const InvokeFunction& callback, const DirectFunction& direct, const ParametersFunction& parameters)
+                    : _asynchronous(false)
+                    , _info(callback)
+                    , _direct(direct)
+                    , _parameters(parameters)
                 {
                 }
                 Entry(const Entry& copy)
                     : _asynchronous(copy._asynchronous)
                     , _info(copy._info, copy._asynchronous)
+                    , _direct(copy._direct)
+                    , _parameters(copy._parameters)
                 {
                 }
                 ~Entry()
@@ -348,10 +666,34 @@ namespace Core {
                     }
                     return (result);
                 }
+                uint32_t Invoke(const Connection connection, const string& method, const Message::Payload& parameters, Message::Payload& response)
+                {
+                    uint32_t result;
+
+                    if (_direct) {
+                        result = _direct(method, parameters, response);
+                        if ((result == Core::ERROR_NONE) && (response.IsSet() == false)) {
+                            response = string();
+                        }
+                    } else {
+                        string text;
+                        result = Invoke(connection, method, parameters.Value(), text);
+                        if (result == Core::ERROR_NONE) {
+                            response = text;
+                        }
+                    }
+                    return (result);
+                }
+                Core::ProxyType<Core::JSON::IElement> Parameters() const
+                {
+                    return (_parameters ? _parameters() : Core::ProxyType<Core::JSON::IElement>());
+                }
 
             private:
                 bool _asynchronous;
                 Functions _info;
+                DirectFunction _direct;
+                ParametersFunction _parameters;
             };
 
             class Observer {
@@ -397,6 +739,7 @@ namespace Core {
             typedef std::map<string, ObserverList> ObserverMap;
 
             typedef std::function<void(const uint32_t id, const string& designator, const string& data)> NotificationFunction;
+            typedef std::function<void(const uint32_t id, const string& designator, const Core::ProxyType<Frame>& frame)> FrameFunction;
 
         public:
             Handler() = delete;
@@ -408,6 +751,7 @@ namespace Core {
                 , _handlers()
                 , _observers()
                 , _notificationFunction(notificationFunction)
+                , _frameFunction()
                 , _versions(versions)
             {
             }
@@ -416,6 +760,26 @@ namespace Core {
                 , _handlers(copy._handlers)
                 , _observers()
                 , _notificationFunction(notificationFunction)
+                , _frameFunction()
+                , _versions(versions)
+            {
+            }
+            // If a frame function is given, events are serialized once and that frame is handed to all subscribers.
+            Handler(const NotificationFunction& notificationFunction, const FrameFunction& frameFunction, const std::vector<uint8_t>& versions)
+                : _adminLock()
+                , _handlers()
+                , _observers()
+                , _notificationFunction(notificationFunction)
+                , _frameFunction(frameFunction)
+                , _versions(versions)
+            {
+            }
+            Handler(const NotificationFunction& notificationFunction, const FrameFunction& frameFunction, const std::vector<uint8_t>& versions, const Handler& copy)
+                : _adminLock()
+                , _handlers(copy._handlers)
+                , _observers()
+                , _notificationFunction(notificationFunction)
+                , _frameFunction(frameFunction)
                 , _versions(versions)
             {
             }
@@ -560,6 +924,31 @@ namespace Core {
                 }
                 return (result);
             }
+            // Same as above, but the parameters may already be parsed into the type the method takes, and
+            // a typed result is handed back as is, to be serialized straight into the outbound message.
+            uint32_t Invoke(const Connection connection, const string& method, const Message::Payload& parameters, Message::Payload& response)
+            {
+                uint32_t result = Core::ERROR_UNKNOWN_KEY;
+
+                response.Clear();
+
+                HandlerMap::iterator index = _handlers.find(Message::Method(method));
+                if (index != _handlers.end()) {
+                    result = index->second.Invoke(connection, method, parameters, response);
+                }
+                return (result);
+            }
+            // The object the "params" of this method are parsed in to, if it is known up front.
+            Core::ProxyType<Core::JSON::IElement> Parameters(const string& method) const
+            {
+                Core::ProxyType<Core::JSON::IElement> result;
+
+                HandlerMap::const_iterator index = _handlers.find(Message::Method(method));
+                if (index != _handlers.end()) {
+                    result = index->second.Parameters();
+                }
+                return (result);
+            }
             void Subscribe(const uint32_t id, const string& eventId, const string& callsign, Core::JSONRPC::Message& response)
             {
                 _adminLock.Lock();
@@ -664,6 +1053,43 @@ namespace Core {
             }
 
         private:
+            void Register(const string& methodName, const InvokeFunction& lambda, const DirectFunction& direct, const ParametersFunction& parameters)
+            {
+                _handlers.emplace(std::piecewise_construct,
+                    std::make_tuple(methodName),
+                    std::make_tuple(lambda, direct, parameters));
+            }
+            // Only objects can be taken in directly, see Message::Payload.
+            template <typename INBOUND>
+            static typename Core::TypeTraits::enable_if<std::is_base_of<Core::JSON::Container, INBOUND>::value, ParametersFunction>::type
+            Factory()
+            {
+                return ([]() -> Core::ProxyType<Core::JSON::IElement> {
+                    return (Core::ProxyType<Core::JSON::IElement>(Core::ProxyType<INBOUND>::Create()));
+                });
+            }
+            template <typename INBOUND>
+            static typename Core::TypeTraits::enable_if<!std::is_base_of<Core::JSON::Container, INBOUND>::value, ParametersFunction>::type
+            Factory()
+            {
+                return (ParametersFunction());
+            }
+            // Use the parameters as they were parsed on arrival, or parse them now from the text.
+            template <typename INBOUND>
+            static const INBOUND& Inbound(const Message::Payload& parameters, INBOUND& local)
+            {
+                const INBOUND* result = nullptr;
+
+                if (parameters.Element().IsValid() == true) {
+                    result = dynamic_cast<const INBOUND*>(&(*(parameters.Element())));
+                }
+                if (result == nullptr) {
+                    local.FromString(parameters.Value());
+                    result = &local;
+                }
+
+                return (*result);
+            }
             template <typename PARAMETER, typename GET_METHOD, typename REALOBJECT>
             void InternalProperty(const ::TemplateIntToType<1>&, const string& methodName, const GET_METHOD& getMethod, REALOBJECT* objectPtr)
             {
@@ -797,7 +1223,11 @@ namespace Core {
                     inbound.FromString(parameters);
                     return (actualMethod(inbound));
                 };
-                Register(methodName, implementation);
+                DirectFunction direct = [actualMethod](const string&, const Message::Payload& parameters, Message::Payload&) -> uint32_t {
+                    INBOUND inbound;
+                    return (actualMethod(Inbound(parameters, inbound)));
+                };
+                Register(methodName, implementation, direct, Factory<INBOUND>());
             }
             template <typename INBOUND, typename OUTBOUND, typename METHOD>
             void InternalRegister(const ::TemplateIntToType<1>&, const ::TemplateIntToType<0>&, const string& methodName, const METHOD& method)
@@ -813,7 +1243,15 @@ namespace Core {
                     }
                     return (code);
                 };
-                Register(methodName, implementation);
+                DirectFunction direct = [actualMethod](const string&, const Message::Payload&, Message::Payload& result) -> uint32_t {
+                    Core::ProxyType<OUTBOUND> outbound(Core::ProxyType<OUTBOUND>::Create());
+                    uint32_t code = actualMethod(*outbound);
+                    if (code == Core::ERROR_NONE) {
+                        result.Element(Core::ProxyType<Core::JSON::IElement>(outbound));
+                    }
+                    return (code);
+                };
+                Register(methodName, implementation, direct, ParametersFunction());
             }
             template <typename INBOUND, typename OUTBOUND, typename METHOD>
             void InternalRegister(const ::TemplateIntToType<0>&, const ::TemplateIntToType<0>&, const string& methodName, const METHOD& method)
@@ -831,7 +1269,16 @@ namespace Core {
                     }
                     return (code);
                 };
-                Register(methodName, implementation);
+                DirectFunction direct = [actualMethod](const string&, const Message::Payload& parameters, Message::Payload& result) -> uint32_t {
+                    INBOUND inbound;
+                    Core::ProxyType<OUTBOUND> outbound(Core::ProxyType<OUTBOUND>::Create());
+                    uint32_t code = actualMethod(Inbound(parameters, inbound), *outbound);
+                    if (code == Core::ERROR_NONE) {
+                        result.Element(Core::ProxyType<Core::JSON::IElement>(outbound));
+                    }
+                    return (code);
+                };
+                Register(methodName, implementation, direct, Factory<INBOUND>());
             }
             template <typename INBOUND, typename OUTBOUND, typename METHOD, typename REALOBJECT>
             void InternalRegister(const ::TemplateIntToType<1>&, const ::TemplateIntToType<1>&, const string& methodName, const METHOD& method, REALOBJECT* objectPtr)
@@ -851,7 +1298,11 @@ namespace Core {
                     inbound.FromString(parameters);
                     return (actualMethod(inbound));
                 };
-                Register(methodName, implementation);
+                DirectFunction direct = [actualMethod](const string&, const Message::Payload& parameters, Message::Payload&) -> uint32_t {
+                    INBOUND inbound;
+                    return (actualMethod(Inbound(parameters, inbound)));
+                };
+                Register(methodName, implementation, direct, Factory<INBOUND>());
             }
             template <typename INBOUND, typename OUTBOUND, typename METHOD, typename REALOBJECT>
             void InternalRegister(const ::TemplateIntToType<1>&, const ::TemplateIntToType<0>&, const string& methodName, const METHOD& method, REALOBJECT* objectPtr)
@@ -867,7 +1318,15 @@ namespace Core {
                     }
                     return (code);
                 };
-                Register(methodName, implementation);
+                DirectFunction direct = [actualMethod](const string&, const Message::Payload&, Message::Payload& result) -> uint32_t {
+                    Core::ProxyType<OUTBOUND> outbound(Core::ProxyType<OUTBOUND>::Create());
+                    uint32_t code = actualMethod(*outbound);
+                    if (code == Core::ERROR_NONE) {
+                        result.Element(Core::ProxyType<Core::JSON::IElement>(outbound));
+                    }
+                    return (code);
+                };
+                Register(methodName, implementation, direct, ParametersFunction());
             }
             template <typename INBOUND, typename OUTBOUND, typename METHOD, typename REALOBJECT>
             void InternalRegister(const ::TemplateIntToType<0>&, const ::TemplateIntToType<0>&, const string& methodName, const METHOD& method, REALOBJECT* objectPtr)
@@ -885,7 +1344,16 @@ namespace Core {
                     }
                     return (code);
                 };
-                Register(methodName, implementation);
+                DirectFunction direct = [actualMethod](const string&, const Message::Payload& parameters, Message::Payload& result) -> uint32_t {
+                    INBOUND inbound;
+                    Core::ProxyType<OUTBOUND> outbound(Core::ProxyType<OUTBOUND>::Create());
+                    uint32_t code = actualMethod(Inbound(parameters, inbound), *outbound);
+                    if (code == Core::ERROR_NONE) {
+                        result.Element(Core::ProxyType<Core::JSON::IElement>(outbound));
+                    }
+                    return (code);
+                };
+                Register(methodName, implementation, direct, Factory<INBOUND>());
             }
             template <typename INBOUND, typename METHOD>
             void InternalAnnounce(const ::TemplateIntToType<1>&, const string& methodName, const METHOD& method)
@@ -930,30 +1398,42 @@ namespace Core {
             uint32_t InternalNotify(const string& event, const string& parameters, std::function<bool(const string&)>&& sendifmethod = std::function<bool(const string&)>())
             {
                 uint32_t result = Core::ERROR_UNKNOWN_KEY;
+                ObserverList recipients;
 
                 _adminLock.Lock();
 
-                ObserverMap::iterator index = _observers.find(event);
+                ObserverMap::const_iterator index = _observers.find(event);
 
                 if (index != _observers.end()) {
-                    ObserverList& clients = index->second;
-                    ObserverList::iterator loop = clients.begin();
-
                     result = Core::ERROR_NONE;
 
-                    while (loop != clients.end()) {
-                        const string& designator(loop->Designator());
+                    for (const Observer& client : index->second) {
+                        recipients.emplace_back(client.Id(), client.Designator());
+                    }
+                }
 
-                        if (!sendifmethod || sendifmethod(designator)) {
+                _adminLock.Unlock();
 
-                            _notificationFunction(loop->Id(), (designator.empty() == false ? designator + '.' + event : event), parameters);
-                        }
+                // Hand it out without holding the lock, the channels have their own.
+                if (recipients.empty() == false) {
+                    Core::ProxyType<Frame> frame;
 
-                        loop++;
+                    if (_frameFunction) {
+                        frame = Core::ProxyType<Frame>::Create(event, parameters);
                     }
-                }
 
-                _adminLock.Unlock();
+                    for (const Observer& client : recipients) {
+                        const string& designator(client.Designator());
+
+                        if (!sendifmethod || sendifmethod(designator)) {
+                            if (frame.IsValid() == true) {
+                                _frameFunction(client.Id(), designator, frame);
+                            } else {
+                                _notificationFunction(client.Id(), (designator.empty() == false ? designator + '.' + event : event), parameters);
+                            }
+                        }
+                    }
+                }
 
                 return (result);
             }
@@ -963,6 +1443,7 @@ namespace Core {
             HandlerMap _handlers;
             ObserverMap _observers;
             NotificationFunction _notificationFunction;
+            FrameFunction _frameFunction;
             const std::vector<uint8_t> _versions;
         };
 
@@ -80,11 +80,28 @@ namespace Core {
         {
             _state |= FLUSH_LINE;
         }
-        inline void PassThrough(const uint16_t passThroughBytes)
+        inline void PassThrough(const uint32_t passThroughBytes)
         {
             _state |= EXTERNALPASS | SKIP_WHITESPACE;
             _byteCounter = passThroughBytes;
         }
+        // Bytes still to be passed through. These may also be consumed without the parser seeing
+        // them, e.g. moved straight from a socket into a file, as long as they are reported as Passed.
+        inline uint32_t PassThrough() const
+        {
+            return ((_state & EXTERNALPASS) != 0 ? _byteCounter : 0);
+        }
+        inline void Passed(const uint32_t passedBytes)
+        {
+            ASSERT(passedBytes <= PassThrough());
+
+            _byteCounter -= passedBytes;
+
+            if (_byteCounter == 0) {
+                _state &= (~EXTERNALPASS);
+                _parent.EndOfPassThrough();
+            }
+        }
         uint16_t Deserialize(const uint8_t stream[], const uint16_t maxLength)
         {
             uint16_t current = 0;
@@ -92,7 +109,7 @@ namespace Core {
             while (current < maxLength) {
                 // Pass through if requested..
                 while (((_state & EXTERNALPASS) != 0) && (current < maxLength)) {
-                    uint16_t passOn = ((maxLength - current) > _byteCounter ? _byteCounter : (maxLength - current));
+                    uint16_t passOn = static_cast<uint16_t>(static_cast<uint32_t>(maxLength - current) > _byteCounter ? _byteCounter : static_cast<uint32_t>(maxLength - current));
 
                     _parent.Parse(&stream[current], passOn);
 
@@ -204,7 +221,7 @@ namespace Core {
 
     private:
         uint16_t _state;
-        uint16_t _byteCounter;
+        uint32_t _byteCounter;
         string _buffer;
         HANDLER& _parent;
         TCHAR _splitChar;
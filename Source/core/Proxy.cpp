@@ -0,0 +1,76 @@
+#include "Proxy.h"
+
+namespace WPEFramework {
+namespace Core {
+
+    /* static */ ProxyPoolAdministrator& ProxyPoolAdministrator::Instance()
+    {
+        // Constructed by the first pool, so it outlives all pools.
+        static ProxyPoolAdministrator g_Administrator;
+
+        return (g_Administrator);
+    }
+
+    ProxyPoolAdministrator::ProxyPoolAdministrator()
+        : _adminLock()
+        , _pools()
+    {
+    }
+
+    ProxyPoolAdministrator::~ProxyPoolAdministrator()
+    {
+    }
+
+    void ProxyPoolAdministrator::Register(IProxyPool* pool)
+    {
+        ASSERT(pool != nullptr);
+
+        _adminLock.Lock();
+
+        ASSERT(std::find(_pools.begin(), _pools.end(), pool) == _pools.end());
+
+        _pools.push_back(pool);
+
+        _adminLock.Unlock();
+    }
+
+    void ProxyPoolAdministrator::Unregister(IProxyPool* pool)
+    {
+        _adminLock.Lock();
+
+        _pools.remove(pool);
+
+        _adminLock.Unlock();
+    }
+
+    void ProxyPoolAdministrator::Visit(const std::function<void(const IProxyPool& pool)>& inspector) const
+    {
+        _adminLock.Lock();
+
+        for (const IProxyPool* pool : _pools) {
+            inspector(*pool);
+        }
+
+        _adminLock.Unlock();
+    }
+
+    uint32_t ProxyPoolAdministrator::Trim()
+    {
+        uint32_t trimmed = 0;
+
+        _adminLock.Lock();
+
+        for (IProxyPool* pool : _pools) {
+            trimmed += pool->Trim();
+        }
+
+        _adminLock.Unlock();
+
+        if (trimmed != 0) {
+            TRACE_L1("Trimmed %d idle pool elements", trimmed);
+        }
+
+        return (trimmed);
+    }
+}
+} // namespace WPEFramework::Core
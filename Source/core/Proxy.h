@@ -18,6 +18,9 @@
 #define __PROXY_H
 
 // ---- Include system wide include files ----
+#include <atomic>
+#include <functional>
+#include <list>
 #include <map>
 
 // ---- Include local include files ----
@@ -29,6 +32,11 @@
 
 // ---- Helper types and constants ----
 
+// Idle elements a ProxyPoolType keeps, unless specified otherwise.
+#ifndef PROXY_POOL_LIMIT
+#define PROXY_POOL_LIMIT 64
+#endif
+
 // ---- Helper functions ----
 
 // ---- Class Definition ----
@@ -915,8 +923,52 @@ namespace Core {
         return (l_Received);
     }
 
+    // Every ProxyPoolType registers itself, so the pools of a process can be inspected and trimmed.
+    struct EXTERNAL IProxyPool {
+        virtual ~IProxyPool() {}
+
+        // The (mangled) type name of the pooled elements.
+        virtual const char* Name() const = 0;
+        // Requests served from the pool and requests that required a new element.
+        virtual uint32_t Hits() const = 0;
+        virtual uint32_t Misses() const = 0;
+        // Elements currently handed out and the most that were ever handed out at the same time.
+        virtual uint32_t InUse() const = 0;
+        virtual uint32_t HighWater() const = 0;
+        // Idle elements kept and the elements deleted as they exceeded the limit or were trimmed.
+        virtual uint32_t QueuedElements() const = 0;
+        virtual uint32_t Trimmed() const = 0;
+        // Delete the idle elements that have not been used since the previous trim.
+        virtual uint32_t Trim() = 0;
+    };
+
+    class EXTERNAL ProxyPoolAdministrator {
+    private:
+        ProxyPoolAdministrator(const ProxyPoolAdministrator&) = delete;
+        ProxyPoolAdministrator& operator=(const ProxyPoolAdministrator&) = delete;
+
+        ProxyPoolAdministrator();
+
+    public:
+        ~ProxyPoolAdministrator();
+
+        static ProxyPoolAdministrator& Instance();
+
+    public:
+        void Register(IProxyPool* pool);
+        void Unregister(IProxyPool* pool);
+
+        // Inspect all pools, the administration is locked while doing so.
+        void Visit(const std::function<void(const IProxyPool& pool)>& inspector) const;
+        uint32_t Trim();
+
+    private:
+        mutable CriticalSection _adminLock;
+        std::list<IProxyPool*> _pools;
+    };
+
     template <typename PROXYPOOLELEMENT>
-    class ProxyPoolType {
+    class ProxyPoolType : public IProxyPool {
     private:
         template <typename ELEMENT>
         class ProxyObjectType : public Core::ProxyObject<ELEMENT> {
@@ -971,9 +1023,8 @@ namespace Core {
 
                     baseElement->__Clear<PROXYPOOLELEMENT>();
 
-                    Core::ProxyType<ThisClass> returnObject(static_cast<IReferenceCounted*>(baseElement), baseElement);
-
-                    _queue.Return(returnObject);
+                    // Idle elements are parked without a reference, the pool hands out the first one.
+                    _queue.Return(baseElement);
 
                     return (Core::ERROR_DESTRUCTION_SUCCEEDED);
                 }
@@ -1051,41 +1102,108 @@ namespace Core {
         ProxyPoolType(const ProxyPoolType<PROXYPOOLELEMENT>&);
         ProxyPoolType<PROXYPOOLELEMENT>& operator=(const ProxyPoolType<PROXYPOOLELEMENT>&);
 
+        static constexpr uint32_t EMPTY = static_cast<uint32_t>(~0);
+
+        struct Slot {
+            ProxyPoolElement* Element;
+            std::atomic<uint32_t> Next;
+        };
+
+        // Idle elements are parked in slots. The slots holding an element and the free slots are kept
+        // on two lock free stacks, linked by slot index. The head of a stack carries a tag next to the
+        // index, so a slot that is popped and pushed again in the mean time can not fool the swap.
+        class Stack {
+        private:
+            Stack(const Stack&) = delete;
+            Stack& operator=(const Stack&) = delete;
+
+        public:
+            Stack()
+                : _head(EMPTY)
+            {
+            }
+            ~Stack()
+            {
+            }
+
+        public:
+            void Push(Slot slots[], const uint32_t index)
+            {
+                uint64_t head = _head.load(std::memory_order_relaxed);
+
+                do {
+                    slots[index].Next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+                } while (_head.compare_exchange_weak(head, (((head >> 32) + 1) << 32) | index, std::memory_order_release, std::memory_order_relaxed) == false);
+            }
+            uint32_t Pop(Slot slots[])
+            {
+                uint64_t head = _head.load(std::memory_order_acquire);
+                uint32_t index;
+
+                while ((index = static_cast<uint32_t>(head)) != EMPTY) {
+                    uint32_t next = slots[index].Next.load(std::memory_order_relaxed);
+
+                    if (_head.compare_exchange_weak(head, (((head >> 32) + 1) << 32) | next, std::memory_order_acquire, std::memory_order_acquire) == true) {
+                        break;
+                    }
+                }
+
+                return (index);
+            }
+
+        private:
+            std::atomic<uint64_t> _head;
+        };
+
     public:
-        ProxyPoolType(const uint32_t initialQueueSize)
-            : _createdElements(0)
-            , _queue(initialQueueSize)
-            , _lock()
-        {
+        // The pool keeps at most maxQueueSize idle elements, elements returned beyond that are deleted.
+        ProxyPoolType(const uint32_t initialQueueSize, const uint32_t maxQueueSize = PROXY_POOL_LIMIT)
+            : _capacity(std::max(initialQueueSize, maxQueueSize))
+            , _slots(new Slot[_capacity])
+            , _occupied()
+            , _free()
+            , _limit(_capacity)
+            , _createdElements(0)
+            , _idle(0)
+            , _lowWater(0)
+            , _inUse(0)
+            , _highWater(0)
+            , _hits(0)
+            , _misses(0)
+            , _trimmed(0)
+        {
+            for (uint32_t index = _capacity; index != 0; index--) {
+                _slots[index - 1].Element = nullptr;
+                _free.Push(_slots, index - 1);
+            }
+
+            ProxyPoolAdministrator::Instance().Register(this);
         }
         ~ProxyPoolType()
         {
+            uint32_t index;
+
+            ProxyPoolAdministrator::Instance().Unregister(this);
+
+            while ((index = _occupied.Pop(_slots)) != EMPTY) {
+                delete _slots[index].Element;
+            }
+
+            delete[] _slots;
         }
 
     public:
         Core::ProxyType<PROXYPOOLELEMENT> Element()
         {
             Core::ProxyType<PROXYPOOLELEMENT> result;
+            ProxyPoolElement* element = Acquire();
 
-            _lock.Lock();
-
-            if (_queue.Count() == 0) {
-
-                _createdElements++;
-
-                _lock.Unlock();
-
+            if (element == nullptr) {
                 result = ProxyPoolElement::Create(*this);
 
                 // TRACE_L1("Created a new element for: %s [%p]\n", typeid(PROXYPOOLELEMENT).name(), &static_cast<PROXYPOOLELEMENT&>(*result));
             } else {
-                Core::ProxyType<ProxyPoolElement> listLoad;
-
-                _queue.Remove(0, listLoad);
-
-                _lock.Unlock();
-
-                result = Core::proxy_cast<PROXYPOOLELEMENT>(listLoad);
+                result = Core::ProxyType<PROXYPOOLELEMENT>(static_cast<IReferenceCounted*>(element), element);
 
                 // TRACE_L1("Reused an element for: %s [%p]\n", typeid(PROXYPOOLELEMENT).name(), &static_cast<PROXYPOOLELEMENT&>(*result));
             }
@@ -1096,56 +1214,160 @@ namespace Core {
         Core::ProxyType<PROXYPOOLELEMENT> Element(Arg1 argument1)
         {
             Core::ProxyType<PROXYPOOLELEMENT> result;
+            ProxyPoolElement* element = Acquire();
 
-            _lock.Lock();
-
-            if (_queue.Count() == 0) {
-
-                _createdElements++;
-
-                _lock.Unlock();
-
+            if (element == nullptr) {
                 result = ProxyPoolElement::Create(*this, argument1);
-
-                // TRACE_L1("Created a new element for: %s [%p]\n", typeid(PROXYPOOLELEMENT).name(), &static_cast<PROXYPOOLELEMENT&>(*result));
             } else {
-                Core::ProxyType<ProxyPoolElement> listLoad;
+                result = Core::ProxyType<PROXYPOOLELEMENT>(static_cast<IReferenceCounted*>(element), element);
+            }
 
-                _queue.Remove(0, listLoad);
+            return (result);
+        }
+        void Return(ProxyPoolElement* element)
+        {
+            _inUse.fetch_sub(1, std::memory_order_relaxed);
 
-                _lock.Unlock();
+            uint32_t index = (_idle.load(std::memory_order_relaxed) < _limit.load(std::memory_order_relaxed) ? _free.Pop(_slots) : EMPTY);
 
-                result = Core::proxy_cast<PROXYPOOLELEMENT>(listLoad);
+            if (index == EMPTY) {
+                _trimmed.fetch_add(1, std::memory_order_relaxed);
 
-                // TRACE_L1("Reused an element for: %s [%p]\n", typeid(PROXYPOOLELEMENT).name(), &static_cast<PROXYPOOLELEMENT&>(*result));
+                delete element;
+            } else {
+                // TRACE_L1("Returned an element for: %s [%p]\n", typeid(PROXYPOOLELEMENT).name(), &static_cast<PROXYPOOLELEMENT&>(*element));
+                _slots[index].Element = element;
+                _idle.fetch_add(1, std::memory_order_relaxed);
+                _occupied.Push(_slots, index);
             }
+        }
+        inline uint32_t CreatedElements() const
+        {
+            return (_createdElements.load(std::memory_order_relaxed));
+        }
+        virtual uint32_t QueuedElements() const override
+        {
+            return (_idle.load(std::memory_order_relaxed));
+        }
+        inline uint32_t CurrentQueueSize() const
+        {
+            return (_capacity);
+        }
+        inline uint32_t Limit() const
+        {
+            return (_limit.load(std::memory_order_relaxed));
+        }
+        // The limit can be changed at runtime, but never beyond the size the pool was created with.
+        inline void Limit(const uint32_t maxQueueSize)
+        {
+            _limit.store(std::min(maxQueueSize, _capacity), std::memory_order_relaxed);
 
-            return (result);
+            while ((_idle.load(std::memory_order_relaxed) > _limit.load(std::memory_order_relaxed)) && (Drop() == true)) {
+                _trimmed.fetch_add(1, std::memory_order_relaxed);
+            }
         }
-        void Return(Core::ProxyType<ProxyPoolElement>& element) const
+
+        virtual const char* Name() const override
         {
-            _lock.Lock();
-            // TRACE_L1("Returned an element for: %s [%p]\n", typeid(PROXYPOOLELEMENT).name(), &static_cast<PROXYPOOLELEMENT&>(*element));
-            _queue.Add(element);
-            _lock.Unlock();
+            return (typeid(PROXYPOOLELEMENT).name());
         }
-        inline uint32_t CreatedElements() const
+        virtual uint32_t Hits() const override
         {
-            return (_createdElements);
+            return (_hits.load(std::memory_order_relaxed));
         }
-        inline uint32_t QueuedElements() const
+        virtual uint32_t Misses() const override
         {
-            return (_queue.Count());
+            return (_misses.load(std::memory_order_relaxed));
         }
-        inline uint32_t CurrentQueueSize() const
+        virtual uint32_t InUse() const override
+        {
+            return (_inUse.load(std::memory_order_relaxed));
+        }
+        virtual uint32_t HighWater() const override
         {
-            return (_queue.CurrentQueueSize());
+            return (_highWater.load(std::memory_order_relaxed));
+        }
+        virtual uint32_t Trimmed() const override
+        {
+            return (_trimmed.load(std::memory_order_relaxed));
+        }
+        virtual uint32_t Trim() override
+        {
+            // Whatever stayed idle since the previous trim, is not needed.
+            uint32_t surplus = _lowWater.exchange(EMPTY, std::memory_order_relaxed);
+            uint32_t count = 0;
+
+            if (surplus == EMPTY) {
+                surplus = _idle.load(std::memory_order_relaxed);
+            }
+
+            while ((count < surplus) && (Drop() == true)) {
+                count++;
+            }
+
+            _trimmed.fetch_add(count, std::memory_order_relaxed);
+
+            return (count);
         }
 
     private:
-        uint32_t _createdElements;
-        mutable Core::ProxyList<ProxyPoolElement> _queue;
-        mutable Core::CriticalSection _lock;
+        ProxyPoolElement* Acquire()
+        {
+            ProxyPoolElement* result = nullptr;
+            uint32_t index = _occupied.Pop(_slots);
+            uint32_t idle = 0;
+
+            if (index == EMPTY) {
+                _misses.fetch_add(1, std::memory_order_relaxed);
+                _createdElements.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                result = _slots[index].Element;
+                _free.Push(_slots, index);
+                idle = _idle.fetch_sub(1, std::memory_order_relaxed) - 1;
+                _hits.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            uint32_t low = _lowWater.load(std::memory_order_relaxed);
+            while ((idle < low) && (_lowWater.compare_exchange_weak(low, idle, std::memory_order_relaxed) == false)) {
+            }
+
+            uint32_t inUse = _inUse.fetch_add(1, std::memory_order_relaxed) + 1;
+            uint32_t high = _highWater.load(std::memory_order_relaxed);
+            while ((inUse > high) && (_highWater.compare_exchange_weak(high, inUse, std::memory_order_relaxed) == false)) {
+            }
+
+            return (result);
+        }
+        bool Drop()
+        {
+            uint32_t index = _occupied.Pop(_slots);
+
+            if (index != EMPTY) {
+                ProxyPoolElement* element = _slots[index].Element;
+
+                _free.Push(_slots, index);
+                _idle.fetch_sub(1, std::memory_order_relaxed);
+
+                delete element;
+            }
+
+            return (index != EMPTY);
+        }
+
+    private:
+        const uint32_t _capacity;
+        Slot* _slots;
+        Stack _occupied;
+        Stack _free;
+        std::atomic<uint32_t> _limit;
+        std::atomic<uint32_t> _createdElements;
+        std::atomic<uint32_t> _idle;
+        std::atomic<uint32_t> _lowWater;
+        std::atomic<uint32_t> _inUse;
+        std::atomic<uint32_t> _highWater;
+        std::atomic<uint32_t> _hits;
+        std::atomic<uint32_t> _misses;
+        std::atomic<uint32_t> _trimmed;
     };
 
     template <typename PROXYKEY, typename PROXYELEMENT>
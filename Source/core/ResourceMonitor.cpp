@@ -10,5 +10,50 @@ namespace Core {
         static ResourceMonitor& _instance = SingletonType<ResourceMonitor>::Instance();
         return (_instance);
     }
+
+    ResourceMonitor::~ResourceMonitor()
+    {
+        std::vector<ResourceMonitorBase*>::iterator index(_reactors.begin());
+
+        // The first reactor is ourselves..
+        ASSERT(*index == this);
+
+        while (++index != _reactors.end()) {
+            delete *index;
+        }
+    }
+
+    uint32_t ResourceMonitor::Reactors(const uint8_t count)
+    {
+        // Resources are mapped on a reactor by hash, changing the number of reactors
+        // while resources are registered would route their breaks to the wrong thread,
+        // or delete the reactor they are registered with.
+        uint32_t result = Core::ERROR_NONE;
+        const uint8_t required = std::max(count, static_cast<uint8_t>(1));
+
+        ASSERT(count > 0);
+
+        if (required != _reactors.size()) {
+            std::vector<ResourceMonitorBase*>::const_iterator index(_reactors.begin());
+
+            while ((index != _reactors.end()) && ((*index)->Count() == 0)) {
+                index++;
+            }
+
+            if (index != _reactors.end()) {
+                result = Core::ERROR_ILLEGAL_STATE;
+            } else {
+                while (_reactors.size() < required) {
+                    _reactors.push_back(new ResourceMonitorBase());
+                }
+                while (_reactors.size() > required) {
+                    delete _reactors.back();
+                    _reactors.pop_back();
+                }
+            }
+        }
+
+        return (result);
+    }
 }
 } // namespace WPEFramework::Core
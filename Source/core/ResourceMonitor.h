@@ -7,6 +7,14 @@
 #include "Thread.h"
 #include "Trace.h"
 
+#include <vector>
+
+#if defined(RESOURCE_MONITOR_EPOLL) && defined(__LINUX__) && !defined(__APPLE__)
+#define __RESOURCE_MONITOR_EPOLL__
+#include <map>
+#include <sys/epoll.h>
+#endif
+
 namespace WPEFramework {
 
 namespace Core {
@@ -16,6 +24,13 @@ namespace Core {
 
         typedef signed int handle;
 
+        // Flags that can be combined with the poll events returned by Events(). They are
+        // only honoured by the epoll backend, the poll backend strips them.
+        enum : uint16_t {
+            EDGE_TRIGGERED = 0x4000,
+            ONESHOT = 0x8000
+        };
+
         virtual handle Descriptor() const = 0;
         virtual uint16_t Events() = 0;
         virtual void Handle(const uint16_t events) = 0;
@@ -25,6 +40,26 @@ namespace Core {
     class ResourceMonitorType {
     private:
         static constexpr uint8_t FileDescriptorAllocation = 32;
+#ifdef __RESOURCE_MONITOR_EPOLL__
+        static constexpr uint8_t EventBatchSize = 64;
+
+        enum slotState : uint8_t {
+            SLOT_FREE = 0x00,
+            SLOT_USED = 0x01,
+            SLOT_NEW = 0x02,
+            SLOT_QUEUED = 0x04,
+            SLOT_HANDLED = 0x08,
+            SLOT_DISARMED = 0x10
+        };
+
+        struct Slot {
+            RESOURCE* resource;
+            IResource::handle descriptor;
+            uint32_t generation;
+            uint16_t events;
+            uint8_t state;
+        };
+#endif
 
         typedef ResourceMonitorType<RESOURCE> Parent;
 
@@ -46,7 +81,7 @@ namespace Core {
             virtual ~MonitorWorker()
             {
                 Stop();
-                _parent.Break();
+                _parent.Wakeup();
                 Wait(Thread::BLOCKED | Thread::STOPPED, Core::infinite);
             }
 
@@ -70,12 +105,28 @@ namespace Core {
         ResourceMonitorType()
             : _monitor(nullptr)
             , _adminLock()
+#ifdef __RESOURCE_MONITOR_EPOLL__
+            , _slots()
+            , _freeSlots()
+            , _updates()
+            , _index()
+            , _owners()
+            , _breakLock()
+            , _breaks()
+            , _refreshAll(false)
+            , _usedSlots(0)
+#else
             , _resourceList()
+#endif
             , _monitorRuns(0)
             , _watchDog()
             , _name(_T("Monitor::") + ClassNameOnly(typeid(RESOURCE).name()).Text())
 #ifdef __WIN32__
             , _action(WSACreateEvent())
+#elif defined(__RESOURCE_MONITOR_EPOLL__)
+            , _eventArray(static_cast<struct ::epoll_event*>(::malloc(sizeof(::epoll_event) * EventBatchSize)))
+            , _epollDescriptor(-1)
+            , _signalDescriptor(-1)
 #else
             , _descriptorArrayLength(FileDescriptorAllocation)
             , _descriptorArray(static_cast<struct pollfd*>(::malloc(sizeof(::pollfd) * (_descriptorArrayLength + 1))))
@@ -87,22 +138,39 @@ namespace Core {
         {
 
             // All resources should be gone !!!
+#ifdef __RESOURCE_MONITOR_EPOLL__
+            ASSERT(_index.size() == 0);
+#else
             ASSERT(_resourceList.size() == 0);
+#endif
 
             if (_monitor != nullptr) {
                 _adminLock.Lock();
 
+#ifdef __RESOURCE_MONITOR_EPOLL__
+                _index.clear();
+                _updates.clear();
+#else
                 _resourceList.clear();
+#endif
 
                 _monitor->Block();
-                Break();
+                Wakeup();
 
                 _adminLock.Unlock();
 
                 delete _monitor;
             }
 
-#ifdef __LINUX__
+#ifdef __RESOURCE_MONITOR_EPOLL__
+            ::free(_eventArray);
+            if (_epollDescriptor != -1) {
+                ::close(_epollDescriptor);
+            }
+            if (_signalDescriptor != -1) {
+                ::close(_signalDescriptor);
+            }
+#elif defined(__LINUX__)
             ::free(_descriptorArray);
             if (_signalDescriptor != -1) {
                 ::close(_signalDescriptor);
@@ -126,6 +194,80 @@ namespace Core {
         {
             return (_monitor != nullptr ? _monitor->Id() : 0);
         }
+        uint32_t Count() const
+        {
+            _adminLock.Lock();
+#ifdef __RESOURCE_MONITOR_EPOLL__
+            uint32_t result = static_cast<uint32_t>(_index.size());
+#else
+            uint32_t result = static_cast<uint32_t>(_resourceList.size());
+#endif
+            _adminLock.Unlock();
+
+            return (result);
+        }
+#ifdef __RESOURCE_MONITOR_EPOLL__
+        void Register(RESOURCE& resource)
+        {
+            _adminLock.Lock();
+
+            // Make sure this entry does not exist, only register resources once !!!
+            ASSERT(_index.find(&resource) == _index.end());
+
+            uint32_t slot = Allocate(resource);
+
+            _index.insert(std::pair<RESOURCE*, uint32_t>(&resource, slot));
+
+            if (_usedSlots == 1) {
+                if (_monitor == nullptr) {
+                    _monitor = new MonitorWorker(*this);
+
+                    // Wait till we are at least initialized
+                    _monitor->Wait(Thread::BLOCKED | Thread::STOPPED);
+                }
+
+                _monitor->Run();
+            } else {
+                Wakeup();
+            }
+
+            _adminLock.Unlock();
+        }
+        void Unregister(RESOURCE& resource)
+        {
+            _adminLock.Lock();
+
+            typename std::map<RESOURCE*, uint32_t>::iterator index(_index.find(&resource));
+
+            if (index != _index.end()) {
+                _slots[index->second].resource = nullptr;
+                Queue(index->second);
+                _index.erase(index);
+                Wakeup();
+            }
+
+            _adminLock.Unlock();
+        }
+        // Re-evaluate the Events() of all registered resources.
+        inline void Break()
+        {
+            _breakLock.Lock();
+            _refreshAll = true;
+            _breakLock.Unlock();
+
+            Wakeup();
+        }
+        // Re-evaluate the Events() of this resource only. This does not take the
+        // administration lock, so it can be called from within resource locks.
+        inline void Break(RESOURCE& resource)
+        {
+            _breakLock.Lock();
+            _breaks.push_back(&resource);
+            _breakLock.Unlock();
+
+            Wakeup();
+        }
+#else
         void Register(RESOURCE& resource)
         {
             _adminLock.Lock();
@@ -145,7 +287,7 @@ namespace Core {
 
                 _monitor->Run();
             } else {
-                Break();
+                Wakeup();
             }
 
             _adminLock.Unlock();
@@ -159,12 +301,23 @@ namespace Core {
 
             if (index != _resourceList.end()) {
                 *index = nullptr;
-                Break();
+                Wakeup();
             }
 
             _adminLock.Unlock();
         }
         inline void Break()
+        {
+            Wakeup();
+        }
+        inline void Break(RESOURCE& /* resource */)
+        {
+            Wakeup();
+        }
+#endif
+
+    private:
+        inline void Wakeup()
         {
 
             ASSERT(_monitor != nullptr);
@@ -255,15 +408,273 @@ namespace Core {
 
             ASSERT(_signalDescriptor != -1);
 
+#ifdef __RESOURCE_MONITOR_EPOLL__
+            _epollDescriptor = ::epoll_create1(EPOLL_CLOEXEC);
+
+            ASSERT(_epollDescriptor != -1);
+
+            if ((_epollDescriptor != -1) && (_signalDescriptor != -1)) {
+                struct ::epoll_event info;
+
+                // The signal descriptor is the only one that does not map on a slot.
+                info.events = EPOLLIN;
+                info.data.u64 = ~static_cast<uint64_t>(0);
+
+                if (::epoll_ctl(_epollDescriptor, EPOLL_CTL_ADD, _signalDescriptor, &info) != 0) {
+                    TRACE_L1("Could not add the signal descriptor to epoll. Error %d", errno);
+                }
+            }
+
+            return ((_signalDescriptor != -1) && (_epollDescriptor != -1));
+#else
             _descriptorArray[0].fd = _signalDescriptor;
             _descriptorArray[0].events = POLLIN;
             _descriptorArray[0].revents = 0;
 
             return (_signalDescriptor != -1);
+#endif
         }
 #endif
 
-#ifdef __LINUX__
+#ifdef __RESOURCE_MONITOR_EPOLL__
+        // Slot administration. A slot is identified towards epoll by its index and its
+        // generation, so events still pending for a released slot are never dispatched
+        // to the resource that reused it.
+        uint32_t Allocate(RESOURCE& resource)
+        {
+            uint32_t index;
+
+            if (_freeSlots.empty() == false) {
+                index = _freeSlots.back();
+                _freeSlots.pop_back();
+            } else {
+                index = static_cast<uint32_t>(_slots.size());
+                _slots.push_back(Slot());
+                _slots[index].generation = 0;
+            }
+
+            Slot& slot(_slots[index]);
+
+            slot.resource = &resource;
+            slot.descriptor = -1;
+            slot.events = 0;
+            slot.state = SLOT_USED | SLOT_NEW;
+
+            _usedSlots++;
+
+            Queue(index);
+
+            return (index);
+        }
+        void Release(const uint32_t index)
+        {
+            Slot& slot(_slots[index]);
+
+            if (slot.descriptor != -1) {
+                Detach(index);
+            }
+
+            slot.resource = nullptr;
+            slot.state = SLOT_FREE;
+            slot.generation++;
+
+            _freeSlots.push_back(index);
+            _usedSlots--;
+        }
+        inline void Queue(const uint32_t index)
+        {
+            Slot& slot(_slots[index]);
+
+            if ((slot.state & SLOT_QUEUED) == 0) {
+                slot.state |= SLOT_QUEUED;
+                _updates.push_back(index);
+            }
+        }
+        void Detach(const uint32_t index)
+        {
+            Slot& slot(_slots[index]);
+            uint32_t descriptor = static_cast<uint32_t>(slot.descriptor);
+
+            // Only remove the registration if this slot still owns the descriptor. If the
+            // descriptor was closed and reused, it belongs to another slot by now.
+            if ((descriptor < _owners.size()) && (_owners[descriptor] == (index + 1))) {
+                ::epoll_ctl(_epollDescriptor, EPOLL_CTL_DEL, slot.descriptor, nullptr);
+                _owners[descriptor] = 0;
+            }
+
+            slot.descriptor = -1;
+            slot.events = 0;
+        }
+        void Attach(const uint32_t index, const IResource::handle descriptor, const uint16_t events)
+        {
+            Slot& slot(_slots[index]);
+            struct ::epoll_event info;
+
+            info.events = (events & 0x3FFF) | ((events & IResource::EDGE_TRIGGERED) != 0 ? static_cast<uint32_t>(EPOLLET) : 0) | ((events & IResource::ONESHOT) != 0 ? static_cast<uint32_t>(EPOLLONESHOT) : 0);
+            info.data.u64 = (static_cast<uint64_t>(slot.generation) << 32) | index;
+
+            if (slot.descriptor == descriptor) {
+                if (::epoll_ctl(_epollDescriptor, EPOLL_CTL_MOD, descriptor, &info) != 0) {
+                    TRACE_L1("epoll modify failed with error <%d>", errno);
+                }
+            } else {
+                if (slot.descriptor != -1) {
+                    Detach(index);
+                }
+
+                uint32_t entry = static_cast<uint32_t>(descriptor);
+
+                if (entry >= _owners.size()) {
+                    _owners.resize(((entry / FileDescriptorAllocation) + 1) * FileDescriptorAllocation, 0);
+                }
+
+                // A stale registration of a closed and reused descriptor is taken over.
+                if ((::epoll_ctl(_epollDescriptor, EPOLL_CTL_ADD, descriptor, &info) != 0) && ((errno != EEXIST) || (::epoll_ctl(_epollDescriptor, EPOLL_CTL_MOD, descriptor, &info) != 0))) {
+                    TRACE_L1("epoll add failed with error <%d>", errno);
+                }
+
+                _owners[entry] = index + 1;
+                slot.descriptor = descriptor;
+            }
+
+            slot.events = events;
+            slot.state &= ~SLOT_DISARMED;
+        }
+        void Update(const uint32_t index)
+        {
+            RESOURCE* resource = _slots[index].resource;
+            uint16_t events;
+
+            _slots[index].state &= ~(SLOT_QUEUED | SLOT_HANDLED | SLOT_NEW);
+
+            // Events() may report an Opened()/Closed() that registers new resources, which can
+            // grow, and so move, the slots. Do not hold on to the slot over the Events().
+            if ((resource == nullptr) || ((events = resource->Events()) == 0)) {
+                if (resource != nullptr) {
+                    _index.erase(resource);
+                }
+                Release(index);
+            } else {
+                const Slot& slot(_slots[index]);
+                IResource::handle descriptor = resource->Descriptor();
+
+                // Only bother the kernel if the interest actually changed.
+                if ((descriptor != slot.descriptor) || (events != slot.events) || ((slot.state & SLOT_DISARMED) != 0)) {
+                    Attach(index, descriptor, events);
+                }
+            }
+        }
+        void Dispatch(const uint32_t index, const uint16_t flagsSet)
+        {
+            Arm<WATCHDOG>();
+
+            _slots[index].resource->Handle(flagsSet);
+
+            Reset<WATCHDOG>();
+
+            // The handler may have registered new resources (e.g. an accepted connection), which
+            // can grow, and so move, the slots. Do not hold on to the slot over the Handle().
+            _slots[index].state |= SLOT_HANDLED;
+
+            Queue(index);
+        }
+        uint32_t Worker()
+        {
+            uint32_t delay = 0;
+
+            _monitorRuns++;
+
+            _adminLock.Lock();
+
+            // Bring the kernel interest list in line with the resources that changed,
+            // the untouched ones keep their registration.
+            for (uint32_t index = 0; index < _updates.size(); index++) {
+                Update(_updates[index]);
+            }
+            _updates.clear();
+
+            if (_usedSlots > 0) {
+                _adminLock.Unlock();
+
+                int result = ::epoll_wait(_epollDescriptor, _eventArray, EventBatchSize, -1);
+
+                _adminLock.Lock();
+
+                if (result == -1) {
+                    if (errno != EINTR) {
+                        TRACE_L1("epoll_wait failed with error <%d>", errno);
+                    }
+                    result = 0;
+                }
+
+                // Only the resources that are ready get a call..
+                for (int entry = 0; entry < result; entry++) {
+                    uint64_t id = _eventArray[entry].data.u64;
+
+                    if (id == ~static_cast<uint64_t>(0)) {
+                        /* We have a valid signal, read the info from the fd */
+                        struct signalfd_siginfo info;
+                        uint32_t VARIABLE_IS_NOT_USED bytes = read(_signalDescriptor, &info, sizeof(info));
+                        ASSERT(bytes == sizeof(info) || bytes == 0);
+                    } else {
+                        uint32_t index = static_cast<uint32_t>(id & 0xFFFFFFFF);
+
+                        // The entry might have been removed from observing in the mean time...
+                        if ((index < _slots.size()) && (_slots[index].generation == static_cast<uint32_t>(id >> 32)) && (_slots[index].resource != nullptr)) {
+                            if ((_slots[index].events & IResource::ONESHOT) != 0) {
+                                _slots[index].state |= SLOT_DISARMED;
+                            }
+                            Dispatch(index, static_cast<uint16_t>(_eventArray[entry].events & 0x3FFF));
+                        }
+                    }
+                }
+
+                // ..and the ones that were explicitly broken in on, as a break might have
+                // been issued by this RESOURCE.
+                std::vector<RESOURCE*> breaks;
+                bool refreshAll;
+
+                _breakLock.Lock();
+                breaks.swap(_breaks);
+                refreshAll = _refreshAll;
+                _refreshAll = false;
+                _breakLock.Unlock();
+
+                if (refreshAll == true) {
+                    typename std::map<RESOURCE*, uint32_t>::const_iterator index(_index.begin());
+
+                    while (index != _index.end()) {
+                        Trigger(index->second);
+                        index++;
+                    }
+                } else {
+                    typename std::vector<RESOURCE*>::const_iterator index(breaks.begin());
+
+                    while (index != breaks.end()) {
+                        typename std::map<RESOURCE*, uint32_t>::const_iterator entry(_index.find(*index));
+
+                        if (entry != _index.end()) {
+                            Trigger(entry->second);
+                        }
+                        index++;
+                    }
+                }
+            } else {
+                _monitor->Block();
+                delay = Core::infinite;
+            }
+
+            _adminLock.Unlock();
+
+            return (delay);
+        }
+        inline void Trigger(const uint32_t index)
+        {
+            if ((_slots[index].state & (SLOT_NEW | SLOT_HANDLED)) == 0) {
+                Dispatch(index, 0);
+            }
+        }
+#elif defined(__LINUX__)
         uint32_t Worker()
         {
             uint32_t delay = 0;
@@ -290,8 +701,9 @@ namespace Core {
             int filledFileDescriptors = 1;
             typename std::list<RESOURCE*>::iterator index = _resourceList.begin();
 
-            // Fill in all entries required/updated..
-            while (index != _resourceList.end()) {
+            // Fill in all entries required/updated.. Resources registered from within an Events()
+            // land at the end of the list, if they do not fit, they are picked up on the next run.
+            while ((index != _resourceList.end()) && (filledFileDescriptors < static_cast<int>(_descriptorArrayLength))) {
                 RESOURCE* entry = (*index);
 
                 uint16_t events;
@@ -300,7 +712,7 @@ namespace Core {
                     index = _resourceList.erase(index);
                 } else {
                     _descriptorArray[filledFileDescriptors].fd = entry->Descriptor();
-                    _descriptorArray[filledFileDescriptors].events = events;
+                    _descriptorArray[filledFileDescriptors].events = (events & 0x3FFF);
                     _descriptorArray[filledFileDescriptors].revents = 0;
                     filledFileDescriptors++;
                     index++;
@@ -449,12 +861,28 @@ namespace Core {
     private:
         MonitorWorker* _monitor;
         mutable Core::CriticalSection _adminLock;
+#ifdef __RESOURCE_MONITOR_EPOLL__
+        std::vector<Slot> _slots;
+        std::vector<uint32_t> _freeSlots;
+        std::vector<uint32_t> _updates;
+        std::map<RESOURCE*, uint32_t> _index;
+        std::vector<uint32_t> _owners;
+        Core::CriticalSection _breakLock;
+        std::vector<RESOURCE*> _breaks;
+        bool _refreshAll;
+        uint32_t _usedSlots;
+#else
         std::list<RESOURCE*> _resourceList;
+#endif
         uint32_t _monitorRuns;
         WATCHDOG _watchDog;
         string _name;
 
-#ifdef __LINUX__
+#ifdef __RESOURCE_MONITOR_EPOLL__
+        struct ::epoll_event* _eventArray;
+        int _epollDescriptor;
+        int _signalDescriptor;
+#elif defined(__LINUX__)
         uint32_t _descriptorArrayLength;
         struct ::pollfd* _descriptorArray;
         int _signalDescriptor;
@@ -499,7 +927,9 @@ namespace Core {
     private:
         ResourceMonitor()
             : ResourceMonitorBase()
+            , _reactors()
         {
+            _reactors.push_back(this);
         }
         ResourceMonitor(const ResourceMonitor&) = delete;
         ResourceMonitor& operator=(const ResourceMonitor&) = delete;
@@ -508,7 +938,94 @@ namespace Core {
 
     public:
         static ResourceMonitor& Instance();
-        ~ResourceMonitor() {}
+        ~ResourceMonitor();
+
+    public:
+        // Resources are spread over the reactors (monitor threads) based on a hash
+        // of their address. The number of reactors can only be changed before the
+        // first resource is registered, after that ERROR_ILLEGAL_STATE is returned.
+        uint32_t Reactors(const uint8_t count);
+        inline uint8_t Reactors() const
+        {
+            return (static_cast<uint8_t>(_reactors.size()));
+        }
+        inline void Register(IResource& resource)
+        {
+            Reactor(resource).Register(resource);
+        }
+        inline void Unregister(IResource& resource)
+        {
+            Reactor(resource).Unregister(resource);
+        }
+        inline void Break()
+        {
+            std::vector<ResourceMonitorBase*>::iterator index(_reactors.begin());
+
+            while (index != _reactors.end()) {
+                // Reactors without any resources have no thread to wake up.
+                if ((*index)->Id() != 0) {
+                    (*index)->Break();
+                }
+                index++;
+            }
+        }
+        inline void Break(IResource& resource)
+        {
+            Reactor(resource).Break(resource);
+        }
+        uint32_t Runs() const
+        {
+            uint32_t result = 0;
+            std::vector<ResourceMonitorBase*>::const_iterator index(_reactors.begin());
+
+            while (index != _reactors.end()) {
+                result += (*index)->Runs();
+                index++;
+            }
+
+            return (result);
+        }
+        uint32_t Count() const
+        {
+            uint32_t result = 0;
+            std::vector<ResourceMonitorBase*>::const_iterator index(_reactors.begin());
+
+            while (index != _reactors.end()) {
+                result += (*index)->Count();
+                index++;
+            }
+
+            return (result);
+        }
+        inline ::ThreadId Id() const
+        {
+            return (ResourceMonitorBase::Id());
+        }
+        inline ::ThreadId Id(const IResource& resource) const
+        {
+            return (Reactor(resource).Id());
+        }
+        inline ::ThreadId Id(const uint8_t reactor) const
+        {
+            return (reactor < _reactors.size() ? _reactors[reactor]->Id() : 0);
+        }
+
+    private:
+        inline ResourceMonitorBase& Reactor(const IResource& resource) const
+        {
+            uint32_t index = 0;
+
+            if (_reactors.size() > 1) {
+                // Fibonacci hashing, allocations of the same size class are nicely spread.
+                uint64_t key = (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(&resource)) >> 4) * 0x9E3779B97F4A7C15ULL;
+                index = static_cast<uint32_t>(key >> 32) % static_cast<uint32_t>(_reactors.size());
+            }
+
+            return (*_reactors[index]);
+        }
+
+    private:
+        std::vector<ResourceMonitorBase*> _reactors;
     };
 }
 } // namespace WPEFramework::Core
@@ -647,7 +647,7 @@ namespace Core {
             m_State &= ~SerialPort::OPEN;
             close(m_Descriptor);
             m_Descriptor = -1;
-            ResourceMonitor::Instance().Break();
+            ResourceMonitor::Instance().Break(*this);
 
             m_syncAdmin.Unlock();
 
@@ -689,7 +689,7 @@ namespace Core {
             // Right, a wait till connection is closed is requested..
             while ((waiting > 0) && (m_State != 0)) {
                 // Make sure we aren't in the monitor thread waiting for close completion.
-                ASSERT(Core::Thread::ThreadId() != ResourceMonitor::Instance().Id());
+                ASSERT(Core::Thread::ThreadId() != ResourceMonitor::Instance().Id(*this));
 
                 uint32_t sleepSlot = (waiting > SLEEPSLOT_TIME ? SLEEPSLOT_TIME : waiting);
 
@@ -723,7 +723,7 @@ namespace Core {
 #else
     if ((m_State & (SerialPort::OPEN | SerialPort::EXCEPTION | SerialPort::WRITESLOT)) == SerialPort::OPEN) {
         m_State |= SerialPort::WRITESLOT;
-        ResourceMonitor::Instance().Break();
+        ResourceMonitor::Instance().Break(*this);
     }
 #endif
 
@@ -12,6 +12,10 @@ namespace Core {
         : _semaphore(::CreateSemaphore(nullptr, 1, 1, sourceName))
     {
     }
+    SharedBuffer::Semaphore::Semaphore(const TCHAR sourceName[], const uint32_t initialCount, const uint32_t maximumCount)
+        : _semaphore(::CreateSemaphore(nullptr, initialCount, maximumCount, sourceName))
+    {
+    }
 #else
     SharedBuffer::Semaphore::Semaphore(sem_t* storage)
         : _semaphore(storage)
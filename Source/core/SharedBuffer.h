@@ -45,7 +45,9 @@ namespace Core {
         SharedBuffer(const SharedBuffer&) = delete;
         SharedBuffer& operator=(const SharedBuffer&) = delete;
 
-    private:
+    public:
+        // Also usable for additional semaphores that users of the buffer keep in their
+        // administration space, like the buffer does with its own producer and consumer.
         class Semaphore {
         private:
             Semaphore() = delete;
@@ -55,6 +57,8 @@ namespace Core {
         public:
 #ifdef __WIN32__
             Semaphore(const TCHAR name[]);
+            // Only the first one to open the name creates it, with the given count.
+            Semaphore(const TCHAR name[], const uint32_t initialCount, const uint32_t maximumCount);
 #else
             Semaphore(sem_t* storage);
             //Semaphore(sem_t* storage, bool initialize) {
@@ -74,6 +78,8 @@ namespace Core {
             sem_t* _semaphore;
 #endif
         };
+
+    private:
         struct Administration {
 
             uint32_t _bytesWritten;
@@ -10,6 +10,7 @@
 #include <arpa/inet.h>
 #include <fcntl.h>
 #include <net/if.h>
+#include <sys/uio.h>
 #define __ERRORRESULT__ errno
 #define __ERROR_AGAIN__ EAGAIN
 #define __ERROR_WOULDBLOCK__ EWOULDBLOCK
@@ -25,6 +26,7 @@
 #include <execinfo.h>
 #include <signal.h>
 #include <sys/ioctl.h>
+#include <sys/sendfile.h>
 #include <sys/signalfd.h>
 #endif
 
@@ -120,6 +122,50 @@ namespace Core {
 
     static constexpr uint32_t MAX_LISTEN_QUEUE = 64;
     static constexpr uint32_t SLEEPSLOT_TIME = 100;
+    static constexpr uint32_t MAX_FRAME_SIZE = 0xFFFF;
+    // The most a single sendfile() may move and what fits in a (default sized) pipe.
+    static constexpr uint32_t MAX_SENDFILE_SIZE = 0x7FFFF000;
+    static constexpr uint32_t MAX_SPLICE_SIZE = 0x10000;
+
+#ifdef __WIN32__
+    typedef WSABUF IOSegment;
+
+    inline void Segment(IOSegment& segment, uint8_t* data, const uint32_t length)
+    {
+        segment.buf = reinterpret_cast<char*>(data);
+        segment.len = length;
+    }
+#else
+    typedef struct iovec IOSegment;
+
+    inline void Segment(IOSegment& segment, uint8_t* data, const uint32_t length)
+    {
+        segment.iov_base = data;
+        segment.iov_len = length;
+    }
+#endif
+
+    // Describe <length> bytes, starting at <offset> in a ring of <size> bytes, as (at most) two
+    // contiguous segments. Returns the number of segments used.
+    inline uint8_t Segments(IOSegment segments[2], uint8_t* ring, const uint32_t size, const uint32_t offset, const uint32_t length)
+    {
+        uint32_t first = std::min(length, size - offset);
+
+        Segment(segments[0], &(ring[offset]), first);
+
+        if (first < length) {
+            Segment(segments[1], ring, length - first);
+        }
+
+        return (first < length ? 2 : 1);
+    }
+
+    // A buffer size of ~0 means: use whatever the OS has configured for the socket. Callers
+    // passing a 16 bits size still use the 16 bits variant of ~0.
+    inline bool IsSystemDefault(const uint32_t size)
+    {
+        return ((size == static_cast<uint16_t>(~0)) || (size == static_cast<uint32_t>(~0)));
+    }
 
     inline void DestroySocket(SOCKET& socket)
     {
@@ -169,8 +215,8 @@ namespace Core {
         const enumType socketType,
         const NodeId& refLocalNode,
         const NodeId& refremoteNode,
-        const uint16_t nSendBufferSize,
-        const uint16_t nReceiveBufferSize)
+        const uint32_t nSendBufferSize,
+        const uint32_t nReceiveBufferSize)
         : m_LocalNode(refLocalNode)
         , m_RemoteNode(refremoteNode)
         , m_ReceiveBufferSize(nReceiveBufferSize)
@@ -182,7 +228,15 @@ namespace Core {
         , m_ReceivedNode()
         , m_SendBuffer(nullptr)
         , m_ReceiveBuffer(nullptr)
+        , m_ReadOffset(0)
+        , m_ReadBytes(0)
+        , m_SendBytes(0)
+        , m_SendOffset(0)
     {
+#ifdef __LINUX__
+        m_Pipe[0] = -1;
+        m_Pipe[1] = -1;
+#endif
         TRACE_L5("Constructor SocketPort (NodeId&) <%p>", (this));
     }
 
@@ -190,8 +244,8 @@ namespace Core {
         const enumType socketType,
         const SOCKET& refConnector,
         const NodeId& remoteNode,
-        const uint16_t nSendBufferSize,
-        const uint16_t nReceiveBufferSize)
+        const uint32_t nSendBufferSize,
+        const uint32_t nReceiveBufferSize)
         : m_LocalNode(remoteNode.AnyInterface())
         , m_RemoteNode(remoteNode)
         , m_ReceiveBufferSize(nReceiveBufferSize)
@@ -203,7 +257,15 @@ namespace Core {
         , m_ReceivedNode()
         , m_SendBuffer(nullptr)
         , m_ReceiveBuffer(nullptr)
+        , m_ReadOffset(0)
+        , m_ReadBytes(0)
+        , m_SendBytes(0)
+        , m_SendOffset(0)
     {
+#ifdef __LINUX__
+        m_Pipe[0] = -1;
+        m_Pipe[1] = -1;
+#endif
         NodeId::SocketInfo localAddress;
         socklen_t localSize = sizeof(localAddress);
 
@@ -230,6 +292,13 @@ namespace Core {
         // the virtuals might be called, which are destructed at this point !!!!
         ASSERT(m_Socket == INVALID_SOCKET);
 
+#ifdef __LINUX__
+        if (m_Pipe[0] != -1) {
+            ::close(m_Pipe[0]);
+            ::close(m_Pipe[1]);
+        }
+#endif
+
         ::free(m_SendBuffer);
     }
 
@@ -290,6 +359,7 @@ namespace Core {
     {
         uint32_t nStatus = Core::ERROR_ILLEGAL_STATE;
 
+        m_ReadOffset = 0;
         m_ReadBytes = 0;
         m_SendBytes = 0;
         m_SendOffset = 0;
@@ -396,7 +466,7 @@ namespace Core {
 #endif
                 }
 
-                ResourceMonitor::Instance().Break();
+                ResourceMonitor::Instance().Break(*this);
             }
 
             if (waitTime > 0) {
@@ -408,7 +478,7 @@ namespace Core {
 
                     // We probably did not get a response from the otherside on the close
                     // sloppy but let's forcefully close it
-                    ResourceMonitor::Instance().Break();
+                    ResourceMonitor::Instance().Break(*this);
 
                     closed = (WaitForClosure(Core::infinite) == Core::ERROR_NONE);
 
@@ -429,7 +499,7 @@ namespace Core {
         if ((m_State & (SocketPort::SHUTDOWN | SocketPort::OPEN | SocketPort::EXCEPTION)) == SocketPort::OPEN) {
 
             m_State |= SocketPort::WRITESLOT;
-            ResourceMonitor::Instance().Break();
+            ResourceMonitor::Instance().Break(*this);
         }
         m_syncAdmin.Unlock();
     }
@@ -445,20 +515,26 @@ namespace Core {
         uint32_t receiveBuffer = m_ReceiveBufferSize;
         uint32_t sendBuffer = m_SendBufferSize;
 
-        if (m_ReceiveBufferSize == static_cast<uint16_t>(~0)) {
+        if (IsSystemDefault(m_ReceiveBufferSize) == true) {
             ::getsockopt(socket, SOL_SOCKET, SO_RCVBUF, (char*)&value, &valueLength);
 
-            receiveBuffer = static_cast<uint32_t>(value);
+            // The ring never gets smaller than the 64KB it has always been, larger OS buffers are followed.
+            receiveBuffer = std::max(static_cast<uint32_t>(value), static_cast<uint32_t>(0xFFFF));
+
+            m_ReceiveBufferSize = receiveBuffer;
 
             TRACE_L1("Receive buffer size. %d", receiveBuffer);
         } else if ((receiveBuffer != 0) && (::setsockopt(socket, SOL_SOCKET, SO_RCVBUF, (const char*)&receiveBuffer, sizeof(receiveBuffer)) == SOCKET_ERROR)) {
             TRACE_L1("Error could not set Receive buffer size (%d).", receiveBuffer);
         }
 
-        if (m_SendBufferSize == static_cast<uint16_t>(~0)) {
+        if (IsSystemDefault(m_SendBufferSize) == true) {
             ::getsockopt(socket, SOL_SOCKET, SO_SNDBUF, (char*)&value, &valueLength);
 
-            sendBuffer = static_cast<uint32_t>(value);
+            // Same 64KB minimum as the receive ring.
+            sendBuffer = std::max(static_cast<uint32_t>(value), static_cast<uint32_t>(0xFFFF));
+
+            m_SendBufferSize = sendBuffer;
 
             TRACE_L1("Send buffer size. %d", sendBuffer);
         } else if ((sendBuffer != 0) && (::setsockopt(socket, SOL_SOCKET, SO_SNDBUF, (const char*)&sendBuffer, sizeof(sendBuffer)) == SOCKET_ERROR)) {
@@ -595,7 +671,7 @@ namespace Core {
         // Right, a wait till connection is closed is requested..
         while ((waiting > 0) && (IsOpen() == false)) {
             // Make sure we aren't in the monitor thread waiting for close completion.
-            ASSERT(Core::Thread::ThreadId() != ResourceMonitor::Instance().Id());
+            ASSERT(Core::Thread::ThreadId() != ResourceMonitor::Instance().Id(*this));
 
             uint32_t sleepSlot = (waiting > SLEEPSLOT_TIME ? SLEEPSLOT_TIME : waiting);
 
@@ -629,7 +705,7 @@ namespace Core {
         // Right, a wait till connection is closed is requested..
         while ((waiting > 0) && (IsClosed() == false)) {
             // Make sure we aren't in the monitor thread waiting for close completion.
-            ASSERT(Core::Thread::ThreadId() != ResourceMonitor::Instance().Id());
+            ASSERT(Core::Thread::ThreadId() != ResourceMonitor::Instance().Id(*this));
 
             uint32_t sleepSlot = (waiting > SLEEPSLOT_TIME ? SLEEPSLOT_TIME : waiting);
 
@@ -746,6 +822,32 @@ namespace Core {
         }
     }
 
+    void SocketPort::Fill()
+    {
+        uint16_t size = 1;
+
+        if (m_SendBytes == 0) {
+            m_SendOffset = 0;
+        }
+
+        // Keep on asking for data as long as it is offered and there is a reasonable amount of
+        // contiguous space left, small leftovers are filled after the next write made room.
+        while ((size != 0) && (m_SendBytes < m_SendBufferSize)) {
+            uint32_t tail = (m_SendOffset + m_SendBytes) % m_SendBufferSize;
+            uint32_t space = (tail >= m_SendOffset ? m_SendBufferSize - tail : m_SendOffset - tail);
+
+            if ((space < (m_SendBufferSize / 4)) && (m_SendBytes != 0)) {
+                size = 0;
+            } else {
+                size = SendData(&(m_SendBuffer[tail]), static_cast<uint16_t>(std::min(space, MAX_FRAME_SIZE)));
+
+                ASSERT(size <= space);
+
+                m_SendBytes += size;
+            }
+        }
+    }
+
     void SocketPort::Write()
     {
         bool dataLeftToSend = true;
@@ -755,37 +857,87 @@ namespace Core {
         m_State &= (~(SocketPort::WRITE | SocketPort::WRITESLOT));
 
         while (((m_State & (SocketPort::WRITE | SocketPort::SHUTDOWN | SocketPort::OPEN | SocketPort::EXCEPTION)) == SocketPort::OPEN) && (dataLeftToSend == true)) {
-            if (m_SendOffset == m_SendBytes) {
-                m_SendBytes = SendData(m_SendBuffer, m_SendBufferSize);
-                m_SendOffset = 0;
-                dataLeftToSend = (m_SendOffset != m_SendBytes);
+            int32_t sendSize = 0;
+            bool fromFile = false;
 
-                ASSERT(m_SendBytes <= m_SendBufferSize);
-            }
+            if ((m_State & SocketPort::LINK) != 0) {
+                // A stream has no message boundaries, gather what is queued in the ring and write
+                // it, wrapped or not, with a single call.
+                Fill();
 
-            if (dataLeftToSend == true) {
-                int32_t sendSize;
+                if (m_SendBytes == 0) {
+                    // Nothing buffered, the link might continue with the content of a file.
+                    File::Handle file = INVALID_HANDLE_VALUE;
+                    uint32_t length = SendFile(file);
 
-                // Sockets are non blocking the Send buffer size is equal to the buffer size. We only send
-                // if the buffer free (SEND flag) is active, so the buffer should always fit.
-                if (((m_State & SocketPort::LINK) == 0) && (m_RemoteNode.IsValid() == true)) {
-                    ASSERT(m_RemoteNode.IsValid() == true);
+                    if (length != 0) {
+                        ASSERT(file != INVALID_HANDLE_VALUE);
 
-                    sendSize = ::sendto(m_Socket,
-                        reinterpret_cast<const char*>(&m_SendBuffer[m_SendOffset]),
-                        m_SendBytes - m_SendOffset, 0,
-                        static_cast<const NodeId&>(m_RemoteNode),
-                        m_RemoteNode.Size());
+                        fromFile = true;
+                        sendSize = Transmit(file, length);
+                    }
+                }
 
-                } else {
-                    sendSize = ::send(m_Socket,
-                        reinterpret_cast<const char*>(&m_SendBuffer[m_SendOffset]),
-                        m_SendBytes - m_SendOffset, 0);
+                dataLeftToSend = ((m_SendBytes != 0) || (fromFile == true));
+
+                if ((fromFile == false) && (dataLeftToSend == true)) {
+                    IOSegment segments[2];
+                    uint8_t count = Segments(segments, m_SendBuffer, m_SendBufferSize, m_SendOffset, m_SendBytes);
+
+#ifdef __WIN32__
+                    DWORD sent;
+                    sendSize = (::WSASend(m_Socket, segments, count, &sent, 0, nullptr, nullptr) == 0 ? static_cast<int32_t>(sent) : SOCKET_ERROR);
+#else
+                    sendSize = static_cast<int32_t>(::writev(m_Socket, segments, count));
+#endif
                 }
+            } else {
+                // Datagrams are sent one frame at a time.
+                if (m_SendBytes == 0) {
+                    m_SendOffset = 0;
+                    m_SendBytes = SendData(m_SendBuffer, static_cast<uint16_t>(std::min(m_SendBufferSize, MAX_FRAME_SIZE)));
+                    dataLeftToSend = (m_SendBytes != 0);
 
-                if (sendSize >= 0) {
-                    m_SendOffset = ((m_State & SocketPort::LINK) != 0 ? m_SendOffset + sendSize : m_SendBytes);
-                } else {
+                    ASSERT(m_SendBytes <= m_SendBufferSize);
+                }
+
+                if (dataLeftToSend == true) {
+                    if (m_RemoteNode.IsValid() == true) {
+                        sendSize = ::sendto(m_Socket,
+                            reinterpret_cast<const char*>(m_SendBuffer),
+                            m_SendBytes, 0,
+                            static_cast<const NodeId&>(m_RemoteNode),
+                            m_RemoteNode.Size());
+                    } else {
+                        sendSize = ::send(m_Socket,
+                            reinterpret_cast<const char*>(m_SendBuffer),
+                            m_SendBytes, 0);
+                    }
+                }
+            }
+
+            if (dataLeftToSend == true) {
+                if (fromFile == true) {
+                    if (sendSize > 0) {
+                        SentFile(sendSize);
+                    } else if (sendSize == 0) {
+                        // The file ended before the promised length, the stream can not be completed.
+                        TRACE_L1("File content missing, closing the connection.");
+                        m_State |= SocketPort::EXCEPTION;
+                        StateChange();
+                    }
+                } else if (sendSize >= 0) {
+                    if ((m_State & SocketPort::LINK) == 0) {
+                        m_SendBytes = 0;
+                    } else {
+                        ASSERT(static_cast<uint32_t>(sendSize) <= m_SendBytes);
+
+                        m_SendBytes -= sendSize;
+                        m_SendOffset = (m_SendBytes == 0 ? 0 : (m_SendOffset + sendSize) % m_SendBufferSize);
+                    }
+                }
+
+                if (sendSize < 0) {
                     uint32_t l_Result = __ERRORRESULT__;
 
                     if ((l_Result == __ERROR_WOULDBLOCK__) || (l_Result == __ERROR_AGAIN__) || (l_Result == __ERROR_INPROGRESS__)) {
@@ -802,6 +954,103 @@ namespace Core {
         m_syncAdmin.Unlock();
     }
 
+    // Move file content to the socket, returns the bytes taken from the file.
+    int32_t SocketPort::Transmit(File::Handle file, const uint32_t length)
+    {
+#ifdef __LINUX__
+        // Straight from the page cache into the socket, the file position moves along.
+        return (static_cast<int32_t>(::sendfile(m_Socket, file, nullptr, std::min(length, MAX_SENDFILE_SIZE))));
+#else
+        // No zero-copy on this platform, stage the content in the (empty) ring and write it from there.
+        uint32_t size = std::min(length, m_SendBufferSize);
+#ifdef __WIN32__
+        DWORD loaded = 0;
+        int32_t result = (::ReadFile(file, m_SendBuffer, size, &loaded, nullptr) != FALSE ? static_cast<int32_t>(loaded) : -1);
+#else
+        int32_t result = static_cast<int32_t>(::read(file, m_SendBuffer, size));
+#endif
+        if (result > 0) {
+            m_SendOffset = 0;
+            m_SendBytes = result;
+        }
+
+        return (result);
+#endif
+    }
+
+    // Move socket content to the file, returns the bytes stored in the file.
+    int32_t SocketPort::Splice(File::Handle file, const uint32_t length)
+    {
+#ifdef __LINUX__
+        // The kernel moves the pages from the socket, through a pipe, into the file.
+        int32_t result = static_cast<int32_t>(::splice(m_Socket, nullptr, m_Pipe[1], nullptr, std::min(length, MAX_SPLICE_SIZE), SPLICE_F_MOVE | SPLICE_F_NONBLOCK));
+
+        if (result > 0) {
+            int32_t pending = result;
+
+            while (pending > 0) {
+                ssize_t stored = ::splice(m_Pipe[0], nullptr, file, nullptr, pending, SPLICE_F_MOVE);
+
+                if (stored <= 0) {
+                    // Whatever is stuck in the pipe is lost, this stream can not be continued. Drop
+                    // the pipe with its content, a next transfer starts with a fresh one.
+                    TRACE_L1("Could not store the received content. %d", errno);
+                    ::close(m_Pipe[0]);
+                    ::close(m_Pipe[1]);
+                    m_Pipe[0] = -1;
+                    m_Pipe[1] = -1;
+
+                    m_State |= SocketPort::EXCEPTION;
+                    StateChange();
+
+                    // Only report what actually made it into the file.
+                    result -= pending;
+                    pending = 0;
+                } else {
+                    pending -= static_cast<int32_t>(stored);
+                }
+            }
+        }
+
+        return (result);
+#else
+        DEBUG_VARIABLE(file);
+        DEBUG_VARIABLE(length);
+
+        ASSERT(false);
+
+        return (SOCKET_ERROR);
+#endif
+    }
+
+    void SocketPort::Dispatch()
+    {
+        bool progress = true;
+
+        while ((m_ReadBytes != 0) && (progress == true)) {
+            uint32_t available = std::min(m_ReadBytes, m_ReceiveBufferSize - m_ReadOffset);
+            uint16_t offered = static_cast<uint16_t>(std::min(available, MAX_FRAME_SIZE));
+            uint16_t handledBytes = ReceiveData(&(m_ReceiveBuffer[m_ReadOffset]), offered);
+
+            ASSERT(offered >= handledBytes);
+
+            m_ReadBytes -= handledBytes;
+            m_ReadOffset = (m_ReadBytes == 0 ? 0 : (m_ReadOffset + handledBytes) % m_ReceiveBufferSize);
+
+            if (handledBytes < offered) {
+                if ((offered == available) && ((m_ReadOffset + m_ReadBytes) > m_ReceiveBufferSize)) {
+                    // The consumer needs more contiguous data than there is up to the end of the
+                    // ring, line up the wrapped data behind it and offer it again.
+                    std::rotate(m_ReceiveBuffer, &(m_ReceiveBuffer[m_ReadOffset]), &(m_ReceiveBuffer[m_ReceiveBufferSize]));
+                    m_ReadOffset = 0;
+                } else {
+                    // Offer the remainder once more, if nothing is taken, wait for more data.
+                    progress = (handledBytes != 0);
+                }
+            }
+        }
+    }
+
     void SocketPort::Read()
     {
         m_syncAdmin.Lock();
@@ -810,26 +1059,67 @@ namespace Core {
 
         while ((m_State & (SocketPort::READ | SocketPort::EXCEPTION | SocketPort::OPEN)) == SocketPort::OPEN) {
             uint32_t l_Size;
+            IOSegment segments[2];
+            File::Handle file = INVALID_HANDLE_VALUE;
+            uint32_t fileLength = 0;
+
+#ifdef __LINUX__
+            // With an empty ring, the next bytes might be meant for a file, move them without copying.
+            if (((m_State & SocketPort::LINK) != 0) && (m_ReadBytes == 0) && ((fileLength = ReceiveFile(file)) != 0)) {
+                ASSERT(file != INVALID_HANDLE_VALUE);
+
+                // The pipe is only created for the first transfer, without it the buffered path is taken.
+                if ((m_Pipe[0] == -1) && (::pipe2(m_Pipe, O_CLOEXEC | O_NONBLOCK) != 0)) {
+                    m_Pipe[0] = -1;
+                    fileLength = 0;
+                }
+            }
+#endif
 
             if (m_ReadBytes == m_ReceiveBufferSize) {
+                // The consumer did not take anything out of a full ring, nothing we can do but drop it.
+                m_ReadOffset = 0;
                 m_ReadBytes = 0;
             }
 
+            if (((m_State & SocketPort::LINK) == 0) && (m_ReadOffset != 0)) {
+                // A datagram can not be split over the end of the ring, line up what is left
+                // at the start so the next one can use all of the free space.
+                ::memmove(m_ReceiveBuffer, &(m_ReceiveBuffer[m_ReadOffset]), m_ReadBytes);
+                m_ReadOffset = 0;
+            }
+
+            uint8_t count = Segments(segments, m_ReceiveBuffer, m_ReceiveBufferSize, (m_ReadOffset + m_ReadBytes) % m_ReceiveBufferSize, m_ReceiveBufferSize - m_ReadBytes);
+
             // Read the actual data from the port.
-            if (((m_State & SocketPort::LINK) == 0) && (m_LocalNode.Type() != NodeId::TYPE_NETLINK)) {
+            if (fileLength != 0) {
+                l_Size = Splice(file, fileLength);
+            } else if (((m_State & SocketPort::LINK) == 0) && (m_LocalNode.Type() != NodeId::TYPE_NETLINK)) {
                 NodeId::SocketInfo l_Remote;
                 socklen_t l_Address = sizeof(l_Remote);
 
-                l_Size = ::recvfrom(m_Socket,
-                    reinterpret_cast<char*>(&m_ReceiveBuffer[m_ReadBytes]),
-                    m_ReceiveBufferSize - m_ReadBytes, 0, (struct sockaddr*)&l_Remote,
-                    &l_Address);
+                // A datagram can not be split, it goes into the first free segment.
+#ifdef __WIN32__
+                l_Size = ::recvfrom(m_Socket, segments[0].buf, segments[0].len, 0, (struct sockaddr*)&l_Remote, &l_Address);
+#else
+                l_Size = ::recvfrom(m_Socket, segments[0].iov_base, segments[0].iov_len, 0, (struct sockaddr*)&l_Remote, &l_Address);
+#endif
 
                 m_ReceivedNode = l_Remote;
+            } else if ((m_State & SocketPort::LINK) == 0) {
+#ifdef __WIN32__
+                l_Size = ::recv(m_Socket, segments[0].buf, segments[0].len, 0);
+#else
+                l_Size = ::recv(m_Socket, segments[0].iov_base, segments[0].iov_len, 0);
+#endif
             } else {
-                l_Size = ::recv(m_Socket,
-                    reinterpret_cast<char*>(&m_ReceiveBuffer[m_ReadBytes]),
-                    m_ReceiveBufferSize - m_ReadBytes, 0);
+#ifdef __WIN32__
+                DWORD received;
+                DWORD flags = 0;
+                l_Size = (::WSARecv(m_Socket, segments, count, &received, &flags, nullptr, nullptr) == 0 ? received : static_cast<uint32_t>(SOCKET_ERROR));
+#else
+                l_Size = ::readv(m_Socket, segments, count);
+#endif
             }
 
             if (l_Size == 0) {
@@ -837,6 +1127,8 @@ namespace Core {
                     // The otherside has closed the connection !!!
                     m_State = ((m_State & (~SocketPort::OPEN)) | SocketPort::EXCEPTION);
                 }
+            } else if ((l_Size != static_cast<uint32_t>(SOCKET_ERROR)) && (fileLength != 0)) {
+                ReceivedFile(l_Size);
             } else if (l_Size != static_cast<uint32_t>(SOCKET_ERROR)) {
                 m_ReadBytes += l_Size;
             } else {
@@ -853,18 +1145,7 @@ namespace Core {
                 }
             }
 
-            if (m_ReadBytes != 0) {
-                uint16_t handledBytes = ReceiveData(m_ReceiveBuffer, m_ReadBytes);
-
-                ASSERT(m_ReadBytes >= handledBytes);
-
-                m_ReadBytes -= handledBytes;
-
-                if ((m_ReadBytes != 0) && (handledBytes != 0)) {
-                    // Oops not all data was consumed, Lets remove the read data
-                    ::memcpy(m_ReceiveBuffer, &m_ReceiveBuffer[handledBytes], m_ReadBytes);
-                }
-            }
+            Dispatch();
         }
 
         m_syncAdmin.Unlock();
@@ -1086,8 +1367,8 @@ namespace Core {
     SocketDatagram::SocketDatagram(const bool rawSocket,
         const NodeId& localNode,
         const NodeId& remoteNode,
-        const uint16_t sendBufferSize,
-        const uint16_t receiveBufferSize)
+        const uint32_t sendBufferSize,
+        const uint32_t receiveBufferSize)
         : SocketPort((rawSocket ? SocketPort::RAW : SocketPort::DATAGRAM), localNode, remoteNode, sendBufferSize, receiveBufferSize)
     {
     }
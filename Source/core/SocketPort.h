@@ -5,6 +5,7 @@
 #ifndef __SOCKETPORT_H
 #define __SOCKETPORT_H
 
+#include "FileSystem.h"
 #include "Module.h"
 #include "NodeId.h"
 #include "Portability.h"
@@ -66,14 +67,14 @@ namespace Core {
         SocketPort(const enumType socketType,
             const NodeId& localNode,
             const NodeId& remoteNode,
-            const uint16_t sendBufferSize,
-            const uint16_t receiveBufferSize);
+            const uint32_t sendBufferSize,
+            const uint32_t receiveBufferSize);
 
         SocketPort(const enumType socketType,
             const SOCKET& connector,
             const NodeId& remoteNode,
-            const uint16_t sendBufferSize,
-            const uint16_t receiveBufferSize);
+            const uint32_t sendBufferSize,
+            const uint32_t receiveBufferSize);
 
         virtual ~SocketPort();
 
@@ -154,17 +155,18 @@ namespace Core {
         {
             return (m_ReceivedNode);
         }
-        inline uint16_t SendBufferSize() const
+        inline uint32_t SendBufferSize() const
         {
             return (m_SendBufferSize);
         }
-        inline uint16_t ReceiveBufferSize() const
+        inline uint32_t ReceiveBufferSize() const
         {
             return (m_ReceiveBufferSize);
         }
         inline void Flush()
         {
             m_syncAdmin.Lock();
+            m_ReadOffset = 0;
             m_ReadBytes = 0;
             m_SendBytes = 0;
             m_SendOffset = 0;
@@ -188,13 +190,38 @@ namespace Core {
         uint32_t Close(const uint32_t waitTime);
         void Trigger();
 
-        // Methods to extract and insert data into the socket buffers
+        // Methods to extract and insert data into the socket buffers. On connected (stream) sockets
+        // the buffers are rings: SendData is called repeatedly until it returns 0 or the free space
+        // is used, so several messages leave in one (scatter/gather) write. ReceiveData is offered
+        // contiguous spans of at most 64KB, returning less than offered keeps the remainder in the
+        // ring for the next call.
         virtual uint16_t SendData(uint8_t* dataFrame, const uint16_t maxSendSize) = 0;
         virtual uint16_t ReceiveData(uint8_t* dataFrame, const uint16_t receivedSize) = 0;
 
         // Signal a state change, Opened, Closed or Accepted
         virtual void StateChange() = 0;
 
+        // Zero-copy file transfer on connected (stream) sockets. Once everything offered through SendData
+        // has been written, SendFile is asked for a file to continue with. If it returns a length, up
+        // to that many bytes are written straight from the file, at its current position, to the socket
+        // and reported through SentFile. Before receiving into the ring (while it is empty), ReceiveFile
+        // is asked for a file that takes the next bytes from the socket, reported through ReceivedFile.
+        // A length of 0 continues on the buffered path.
+        virtual uint32_t SendFile(File::Handle& /* file */)
+        {
+            return (0);
+        }
+        virtual void SentFile(const uint32_t /* length */)
+        {
+        }
+        virtual uint32_t ReceiveFile(File::Handle& /* file */)
+        {
+            return (0);
+        }
+        virtual void ReceivedFile(const uint32_t /* length */)
+        {
+        }
+
         // In case of a single connection should be accepted, these methods help
         // changing the socket from a Listening socket to a connected socket and
         // back in case the socket closes.
@@ -223,6 +250,10 @@ namespace Core {
         void Accepted();
         void Read();
         void Write();
+        void Fill();
+        void Dispatch();
+        int32_t Transmit(File::Handle file, const uint32_t length);
+        int32_t Splice(File::Handle file, const uint32_t length);
         void BufferAlignment(SOCKET socket);
         SOCKET ConstructSocket(NodeId& localNode, const string& interfaceName);
         uint32_t WaitForOpen(const uint32_t time) const;
@@ -231,8 +262,8 @@ namespace Core {
     private:
         NodeId m_LocalNode;
         NodeId m_RemoteNode;
-        uint16_t m_ReceiveBufferSize;
-        uint16_t m_SendBufferSize;
+        uint32_t m_ReceiveBufferSize;
+        uint32_t m_SendBufferSize;
         enumType m_SocketType;
         SOCKET m_Socket;
         mutable CriticalSection m_syncAdmin;
@@ -240,9 +271,13 @@ namespace Core {
         NodeId m_ReceivedNode;
         uint8_t* m_SendBuffer;
         uint8_t* m_ReceiveBuffer;
-        uint16_t m_ReadBytes;
-        uint16_t m_SendBytes;
-        uint16_t m_SendOffset;
+        uint32_t m_ReadOffset;
+        uint32_t m_ReadBytes;
+        uint32_t m_SendBytes;
+        uint32_t m_SendOffset;
+#ifdef __LINUX__
+        int m_Pipe[2];
+#endif
     };
 
     class EXTERNAL SocketStream : public SocketPort {
@@ -255,8 +290,8 @@ namespace Core {
         SocketStream(const bool rawSocket,
             const NodeId& localNode,
             const NodeId& remoteNode,
-            const uint16_t sendBufferSize,
-            const uint16_t receiveBufferSize)
+            const uint32_t sendBufferSize,
+            const uint32_t receiveBufferSize)
             : SocketPort((rawSocket ? SocketPort::RAW : SocketPort::STREAM), localNode, remoteNode, sendBufferSize, receiveBufferSize)
         {
         }
@@ -264,8 +299,8 @@ namespace Core {
         SocketStream(const bool rawSocket,
             const SOCKET& connector,
             const NodeId& remoteNode,
-            const uint16_t sendBufferSize,
-            const uint16_t receiveBufferSize)
+            const uint32_t sendBufferSize,
+            const uint32_t receiveBufferSize)
             : SocketPort((rawSocket ? SocketPort::RAW : SocketPort::STREAM),
                   connector, remoteNode, sendBufferSize, receiveBufferSize)
         {
@@ -294,8 +329,8 @@ namespace Core {
         SocketDatagram(const bool rawSocket,
             const NodeId& localNode,
             const NodeId& remoteNode,
-            const uint16_t sendBufferSize,
-            const uint16_t receiveBufferSize);
+            const uint32_t sendBufferSize,
+            const uint32_t receiveBufferSize);
         virtual ~SocketDatagram();
 
     public:
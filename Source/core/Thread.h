@@ -21,6 +21,7 @@
 #ifndef __THREAD_H
 #define __THREAD_H
 
+#include <atomic>
 #include <sstream>
 
 #include "IAction.h"
@@ -40,7 +41,7 @@ namespace Core {
 #ifdef __POSIX__
         static void destruct(void* value)
         {
-            printf("Destructor ThreadControlBlockInfo <0x%p>\n", value);
+            TRACE_L5("Destructor ThreadControlBlockInfo <%p>", value);
             if (value != nullptr) {
                 delete reinterpret_cast<THREADLOCALSTORAGE*>(value);
             }
@@ -356,9 +357,19 @@ namespace Core {
         ProxyType<IDispatch> _job;
     };
 
+    // The pool gives every worker its own, fixed size, deque of jobs. A job is submitted to the deque of the
+    // submitting worker (if the submitter is one of the pool threads) or to the next worker in a round-robin
+    // fashion. A worker that runs out of work steals jobs from the other workers before going to sleep. Jobs
+    // only end up in the (allocating) overflow queue if all deques are filled up.
     template <typename CONTEXT, const uint16_t THREADCOUNT, const uint32_t QUEUESIZE = 0x7FFFFFFF>
     class ThreadPoolType {
     private:
+        enum : uint32_t {
+            SLOTS = (((QUEUESIZE / THREADCOUNT) + 1) > 64 ? 64 : ((QUEUESIZE / THREADCOUNT) + 1))
+        };
+
+        typedef ThreadPoolType<CONTEXT, THREADCOUNT, QUEUESIZE> Pool;
+
         template <typename RUNCONTEXT>
         class ThreadUnitType : public Thread {
             // -----------------------------------------------------------------------
@@ -374,32 +385,31 @@ namespace Core {
 
         public:
             ThreadUnitType(ThreadUnitType&& move)
-                : _executing()
-                , _queue(move._queue)
-                , _run(0)
-                , _active(false)
-                , _signal(false, false)
-            {
-            }
-            ThreadUnitType(QueueType<RUNCONTEXT>& queue, const TCHAR* threadName)
-                : Thread(Thread::DefaultStackSize(), threadName)
+                : _parent(move._parent)
                 , _executing()
-                , _queue(queue)
+                , _lock()
+                , _head(0)
+                , _count(0)
                 , _run(0)
                 , _active(false)
-                , _signal(false, false)
+                , _idle(false)
+                , _signal(true, true)
+                , _wake(false, true)
             {
-                Run();
             }
-            ThreadUnitType(QueueType<RUNCONTEXT>& queue, const uint32_t stackSize, const TCHAR* threadName)
+            ThreadUnitType(Pool& parent, const uint32_t stackSize, const TCHAR* threadName)
                 : Thread(stackSize, threadName)
+                , _parent(parent)
                 , _executing()
-                , _queue(queue)
+                , _lock()
+                , _head(0)
+                , _count(0)
                 , _run(0)
                 , _active(false)
-                , _signal(false, false)
+                , _idle(false)
+                , _signal(true, true)
+                , _wake(false, true)
             {
-                Run();
             }
 
             ~ThreadUnitType()
@@ -423,55 +433,171 @@ namespace Core {
             {
                 uint32_t result = Core::ERROR_UNAVAILABLE;
 
+                _executingLock.Lock();
+
                 if (thisElement == _executing) {
 
+                    _executingLock.Unlock();
+
                     TRACE_L1("Revoking object is currently running [%d].", _run);
 
                     // You can not wait on yourself to actually remove yourself. This will deadlock !!!
                     ASSERT(Thread::Id() != Thread::ThreadId());
 
+                    // The signal is reset as long as a job is executing, it is set when it completes.
                     result = _signal.Lock(waitTime);
+                } else {
+                    _executingLock.Unlock();
+                }
+
+                return (result);
+            }
+
+            // Deque of this worker. Jobs are taken from the front, by the owner and by thieves alike,
+            // so the submission order is kept as much as possible.
+            bool Push(const RUNCONTEXT& entry)
+            {
+                bool result = false;
+
+                _lock.Lock();
+
+                if (_count < SLOTS) {
+                    _slots[(_head + _count) % SLOTS] = entry;
+                    _count++;
+                    result = true;
+                }
+
+                _lock.Unlock();
+
+                return (result);
+            }
+            bool Pop(ThreadUnitType<RUNCONTEXT>& destination)
+            {
+                bool result = false;
+
+                _lock.Lock();
+
+                if (_count > 0) {
+                    destination.Execute(_slots[_head]);
+                    _slots[_head] = RUNCONTEXT();
+                    _head = (_head + 1) % SLOTS;
+                    _count--;
+                    result = true;
+                }
+
+                _lock.Unlock();
+
+                return (result);
+            }
+            bool Remove(const RUNCONTEXT& entry)
+            {
+                bool result = false;
+
+                _lock.Lock();
+
+                for (uint32_t index = 0; (index < _count) && (result == false); index++) {
+                    if (_slots[(_head + index) % SLOTS] == entry) {
+                        // Close the gap, move all entries behind it one place to the front.
+                        for (; index < (_count - 1); index++) {
+                            _slots[(_head + index) % SLOTS] = _slots[(_head + index + 1) % SLOTS];
+                        }
+                        _slots[(_head + _count - 1) % SLOTS] = RUNCONTEXT();
+                        _count--;
+                        result = true;
+                    }
                 }
 
+                _lock.Unlock();
+
                 return (result);
             }
+            void Flush()
+            {
+                _lock.Lock();
+
+                while (_count > 0) {
+                    _slots[_head] = RUNCONTEXT();
+                    _head = (_head + 1) % SLOTS;
+                    _count--;
+                }
+
+                _lock.Unlock();
+            }
+
+            // Called with the lock of the deque the job is taken from, taken. This way a job is always
+            // either in a deque or executing, when Revoke looks for it.
+            inline void Execute(const RUNCONTEXT& job)
+            {
+                _executingLock.Lock();
+                _executing = job;
+                _signal.ResetEvent();
+                _executingLock.Unlock();
+            }
+
+            // Idle administration, guarded by the idle lock of the pool.
+            inline bool IsIdle() const
+            {
+                return (_idle);
+            }
+            inline void Idle()
+            {
+                _idle = true;
+                _wake.ResetEvent();
+            }
+            inline void Wake()
+            {
+                _idle = false;
+                _wake.SetEvent();
+            }
+            inline void Awake()
+            {
+                _idle = false;
+            }
+            inline void Sleep()
+            {
+                _wake.Lock(Core::infinite);
+            }
 
         private:
             virtual uint32_t Worker()
             {
-                _signal.PulseEvent();
-
-                if (_queue.Extract(_executing, Core::infinite) == true) {
+                if (_parent.Extract(*this) == true) {
 
                     _active = true;
 
                     // Seems like we have work...
                     _executing.Dispatch();
 
-                    // Clear it out, we processed it.
-                    _executing = RUNCONTEXT();
-
                     _active = false;
                     _run++;
 
-                    // Yield the processor, just to make sure that the gap, between the comparison
-                    // of the Executing(.....) ended up in the lock, before we pulse it :-)
-                    ::SleepMs(0);
+                    // Clear it out, we processed it.
+                    _executingLock.Lock();
+                    _executing = RUNCONTEXT();
+                    _signal.SetEvent();
+                    _executingLock.Unlock();
 
                     // Do not wait keep on processing !!!
                     return (0);
                 }
 
-                // Oops queue disabled, wait for queue to start us again..
+                // Oops pool blocked, wait for the pool to start us again..
                 return (Core::infinite);
             }
 
         private:
+            Pool& _parent;
             RUNCONTEXT _executing;
-            QueueType<RUNCONTEXT>& _queue;
+            mutable CriticalSection _executingLock;
+            CriticalSection _lock;
+            RUNCONTEXT _slots[SLOTS];
+            uint32_t _head;
+            uint32_t _count;
             uint32_t _run;
             bool _active;
+            bool _idle;
             mutable Core::Event _signal;
+            Core::Event _wake;
         };
 
     public:
@@ -488,13 +614,27 @@ namespace Core {
 
     public:
         ThreadPoolType(const uint32_t stackSize = 0, const TCHAR* poolName = nullptr)
-            : _queue(QUEUESIZE)
+            : _units()
+            , _overflow()
+            , _overflowLock()
+            , _idleLock()
+            , _space(false, true)
+            , _pending(0)
+            , _sleeping(0)
+            , _next(0)
+            , _disabled(false)
         {
             _units.reserve(THREADCOUNT);
 
             for (uint32_t teller = 0; teller < THREADCOUNT; teller++) {
 
-                _units.emplace_back(_queue, stackSize, poolName);
+                _units.emplace_back(*this, stackSize, poolName);
+            }
+
+            // Only start the threads once all units are there, they steal from eachother.
+            for (uint32_t teller = 0; teller < THREADCOUNT; teller++) {
+
+                _units[teller].Run();
             }
         }
 
@@ -503,7 +643,7 @@ namespace Core {
             // Stop all threads...
             Block();
 
-            _queue.Flush();
+            Flush();
 
             // Wait till all threads have reached completion
             Wait(Thread::BLOCKED | Thread::STOPPED, Core::infinite);
@@ -516,7 +656,7 @@ namespace Core {
         }
         inline uint32_t Pending() const
         {
-            return (_queue.Length());
+            return (_pending);
         }
         inline uint32_t Active() const
         {
@@ -532,17 +672,52 @@ namespace Core {
         }
         inline void Submit(const CONTEXT& data, const uint32_t waitTime)
         {
-            if (QUEUESIZE == ~0) {
-                _queue.Post(data);
-            } else {
-                _queue.Insert(data, waitTime);
+            if ((_disabled == false) && (Reserve(waitTime) == true)) {
+                uint16_t index = Local();
+                uint16_t teller = 0;
+
+                // Try our own deque first, otherwise the ones from the others.
+                while ((teller < THREADCOUNT) && (_units[(index + teller) % THREADCOUNT].Push(data) == false)) {
+                    teller++;
+                }
+
+                if (teller < THREADCOUNT) {
+                    index = (index + teller) % THREADCOUNT;
+                } else {
+                    // All deques are full, park it in the overflow.
+                    _overflowLock.Lock();
+                    _overflow.push_back(data);
+                    _overflowLock.Unlock();
+                }
+
+                if (_sleeping > 0) {
+                    WakeUp(index);
+                }
             }
         }
         uint32_t Revoke(const CONTEXT& data, const uint32_t waitTime = Core::infinite)
         {
             uint32_t result = Core::ERROR_NONE;
+            bool removed = false;
+
+            for (uint16_t teller = 0; (teller < THREADCOUNT) && (removed == false); teller++) {
+                removed = _units[teller].Remove(data);
+            }
+
+            if (removed == false) {
+                _overflowLock.Lock();
 
-            if (_queue.Remove(data) == false) {
+                typename std::list<CONTEXT>::iterator index(std::find(_overflow.begin(), _overflow.end(), data));
+
+                if (index != _overflow.end()) {
+                    _overflow.erase(index);
+                    removed = true;
+                }
+
+                _overflowLock.Unlock();
+            }
+
+            if (removed == false) {
                 uint16_t count = THREADCOUNT;
 
                 // Check if it is currently being executed and wait till it is done.
@@ -550,6 +725,8 @@ namespace Core {
                     --count;
                 }
             } else {
+                Release();
+
                 TRACE_L1("Found the revoking object in the queue: %d", waitTime);
             }
 
@@ -570,16 +747,32 @@ namespace Core {
 
         void Block()
         {
+            _disabled = true;
+
             // Block all threads!!
             for (uint16_t teller = THREADCOUNT; teller > 0; --teller) {
                 _units[teller - 1].Block();
             }
 
-            _queue.Disable();
+            // Get the sleeping ones out of there, so they see we are blocked.
+            _idleLock.Lock();
+
+            for (uint16_t teller = THREADCOUNT; teller > 0; --teller) {
+                if (_units[teller - 1].IsIdle() == true) {
+                    _sleeping--;
+                    _units[teller - 1].Wake();
+                }
+            }
+
+            _idleLock.Unlock();
+
+            _space.SetEvent();
         }
 
         void Run()
         {
+            _disabled = false;
+
             // Make all threads active again !!
             for (uint16_t teller = THREADCOUNT; teller > 0; --teller) {
                 _units[teller - 1].Run();
@@ -595,8 +788,150 @@ namespace Core {
         }
 
     private:
-        QueueType<CONTEXT> _queue;
+        // Returns the deque to submit to. Jobs submitted from one of our own workers stay on that worker.
+        inline uint16_t Local()
+        {
+            ::ThreadId current = Thread::ThreadId();
+            uint16_t teller = 0;
+
+            while ((teller < THREADCOUNT) && (_units[teller].Id() != current)) {
+                teller++;
+            }
+
+            return (teller < THREADCOUNT ? teller : static_cast<uint16_t>(_next++ % THREADCOUNT));
+        }
+        // Claim a slot, if the pool is bounded, this might need to wait for a slot to be freed.
+        bool Reserve(const uint32_t waitTime)
+        {
+            bool result = false;
+            bool triggered = true;
+
+            do {
+                uint32_t current = _pending;
+
+                while ((current < QUEUESIZE) && (_pending.compare_exchange_weak(current, current + 1) == false)) {
+                    // current is reloaded, try again..
+                }
+
+                if (current < QUEUESIZE) {
+                    result = true;
+                } else {
+                    _space.ResetEvent();
+
+                    if ((_pending >= QUEUESIZE) && (_disabled == false)) {
+                        triggered = (_space.Lock(waitTime) == Core::ERROR_NONE);
+                    }
+                }
+            } while ((result == false) && (triggered == true) && (_disabled == false));
+
+            return (result);
+        }
+        inline void Release()
+        {
+            if (_pending.fetch_sub(1) >= QUEUESIZE) {
+                _space.SetEvent();
+            }
+        }
+        void WakeUp(const uint16_t preferred)
+        {
+            _idleLock.Lock();
+
+            uint16_t teller = 0;
+            uint16_t index = preferred;
+
+            // Prefer the owner of the deque, otherwise anyone that is idle can come and steal it.
+            while ((teller < THREADCOUNT) && (_units[index].IsIdle() == false)) {
+                index = (index + 1) % THREADCOUNT;
+                teller++;
+            }
+
+            if (teller < THREADCOUNT) {
+                _sleeping--;
+                _units[index].Wake();
+            }
+
+            _idleLock.Unlock();
+        }
+        bool Acquire(ThreadUnitType<CONTEXT>& unit)
+        {
+            bool result = unit.Pop(unit);
+
+            if (result == false) {
+                _overflowLock.Lock();
+
+                if (_overflow.empty() == false) {
+                    unit.Execute(_overflow.front());
+                    _overflow.pop_front();
+                    result = true;
+                }
+
+                _overflowLock.Unlock();
+
+                // Nothing left for us, see if we can help out one of the others.
+                for (uint16_t teller = 0; (teller < THREADCOUNT) && (result == false); teller++) {
+                    if (&(_units[teller]) != &unit) {
+                        result = _units[teller].Pop(unit);
+                    }
+                }
+            }
+
+            if (result == true) {
+                Release();
+            }
+
+            return (result);
+        }
+        // Called by a worker to get its next job. Only returns without a job if the pool is blocked.
+        bool Extract(ThreadUnitType<CONTEXT>& unit)
+        {
+            bool result = false;
+
+            while ((_disabled == false) && ((result = Acquire(unit)) == false)) {
+
+                _idleLock.Lock();
+                unit.Idle();
+                _sleeping++;
+                _idleLock.Unlock();
+
+                // Whoever submits, first claims the job and than checks for sleepers. We first register
+                // as sleeper and than check for jobs, so one of the two will see the other.
+                if ((_pending == 0) && (_disabled == false)) {
+                    unit.Sleep();
+                }
+
+                _idleLock.Lock();
+                if (unit.IsIdle() == true) {
+                    unit.Awake();
+                    _sleeping--;
+                }
+                _idleLock.Unlock();
+            }
+
+            return (result);
+        }
+        void Flush()
+        {
+            for (uint16_t teller = 0; teller < THREADCOUNT; teller++) {
+                _units[teller].Flush();
+            }
+
+            _overflowLock.Lock();
+            _overflow.clear();
+            _overflowLock.Unlock();
+
+            _pending = 0;
+        }
+
+    private:
         std::vector<ThreadUnitType<CONTEXT>> _units;
+        std::list<CONTEXT> _overflow;
+        CriticalSection _overflowLock;
+        CriticalSection _idleLock;
+        Core::Event _space;
+        std::atomic<uint32_t> _pending;
+        std::atomic<uint32_t> _sleeping;
+        std::atomic<uint32_t> _next;
+        std::atomic<bool> _disabled;
     };
 
     // template <typename CONTEXT, const uint16_t THREADCOUNT, const uint32_t QUEUESIZE>
@@ -26,6 +26,10 @@
 //
 namespace WPEFramework {
 namespace Core {
+    // The pending timers are kept in a 4-ary min-heap (of pointers, the content only needs to be copy
+    // constructable), ordered on a deadline taken from the monotonic clock.
+    // The interface still accepts (and reports) wall clock times, these are converted to a monotonic deadline
+    // the moment they are scheduled, so adjustments of the system time do not fire or stall pending timers.
     template <typename CONTENT>
     class TimerType {
     private:
@@ -38,18 +42,24 @@ namespace Core {
         public:
             inline TimedInfo()
                 : m_ScheduleTime(0)
+                , m_Deadline(0)
+                , m_Sequence(0)
                 , m_Info()
             {
             }
 
             inline TimedInfo(const uint64_t time, const ACTIVECONTENT& contents)
                 : m_ScheduleTime(time)
+                , m_Deadline(0)
+                , m_Sequence(0)
                 , m_Info(contents)
             {
             }
 
             inline TimedInfo(const TimedInfo& copy)
                 : m_ScheduleTime(copy.m_ScheduleTime)
+                , m_Deadline(copy.m_Deadline)
+                , m_Sequence(copy.m_Sequence)
                 , m_Info(copy.m_Info)
             {
             }
@@ -61,6 +71,8 @@ namespace Core {
             inline TimedInfo& operator=(const TimedInfo& RHS)
             {
                 m_ScheduleTime = RHS.m_ScheduleTime;
+                m_Deadline = RHS.m_Deadline;
+                m_Sequence = RHS.m_Sequence;
                 m_Info = RHS.m_Info;
 
                 return (*this);
@@ -76,13 +88,37 @@ namespace Core {
                 m_ScheduleTime = scheduleTime;
             }
 
+            inline uint64_t Deadline() const
+            {
+                return (m_Deadline);
+            }
+
+            inline void Deadline(const uint64_t deadline, const uint64_t sequence)
+            {
+                m_Deadline = deadline;
+                m_Sequence = sequence;
+            }
+
+            // Entries with the same deadline fire in the order they were scheduled.
+            inline bool operator<(const TimedInfo& RHS) const
+            {
+                return ((m_Deadline < RHS.m_Deadline) || ((m_Deadline == RHS.m_Deadline) && (m_Sequence < RHS.m_Sequence)));
+            }
+
             inline ACTIVECONTENT& Content()
             {
                 return (m_Info);
             }
 
+            inline const ACTIVECONTENT& Content() const
+            {
+                return (m_Info);
+            }
+
         private:
             uint64_t m_ScheduleTime;
+            uint64_t m_Deadline;
+            uint64_t m_Sequence;
             ACTIVECONTENT m_Info;
         };
 
@@ -111,7 +147,9 @@ namespace Core {
         };
 
         typedef TimedInfo<CONTENT> TimeInfoBlocks;
-        typedef typename std::list<TimeInfoBlocks> SubscriberList;
+        typedef typename std::vector<TimeInfoBlocks*> SubscriberList;
+
+        static constexpr uint8_t Arity = 4;
 
     public:
         TimerType(const uint32_t stackSize, const TCHAR* timerName)
@@ -119,21 +157,23 @@ namespace Core {
             , m_TimerThread(*this, stackSize, timerName)
             , m_Admin()
             , m_NextTrigger(NUMBER_MAX_UNSIGNED(uint64_t))
+            , m_Sequence(0)
         {
             // Everything is initialized, go...
             m_TimerThread.Block();
         }
         ~TimerType()
         {
-            m_Admin.Lock();
-
-            m_TimerThread.Block();
+            // Blocking the thread is not enough, a Run() it did not pick up yet is lost by that, and it
+            // would never report being blocked. Stop it, after the timer it might still be handling.
+            m_TimerThread.Stop();
+            m_TimerThread.Wait(Thread::STOPPED, Core::infinite);
 
             // Force kill on all pending stuff...
+            for (TimeInfoBlocks* entry : m_PendingQueue) {
+                delete entry;
+            }
             m_PendingQueue.clear();
-            m_Admin.Unlock();
-
-            m_TimerThread.Wait(Thread::BLOCKED, Core::infinite);
         }
 
         inline void Schedule(const Time& time, const CONTENT& info)
@@ -143,11 +183,11 @@ namespace Core {
 
         void Schedule(const uint64_t& time, const CONTENT& info)
         {
-            TimedInfo<CONTENT> timeInfo(time, info);
+            TimeInfoBlocks* timeInfo = new TimeInfoBlocks(time, info);
 
             m_Admin.Lock();
 
-            if (ScheduleEntry(timeInfo) == true) {
+            if (ScheduleEntry(timeInfo, Time::Now().Ticks(), Monotonic()) == true) {
                 m_TimerThread.Run();
             }
 
@@ -156,21 +196,23 @@ namespace Core {
 
         void Trigger(const uint64_t& time, const CONTENT& info)
         {
-            TimedInfo<CONTENT> newEntry(time, info);
+            TimeInfoBlocks* newEntry = new TimeInfoBlocks(time, info);
 
             m_Admin.Lock();
 
             typename SubscriberList::iterator index = m_PendingQueue.begin();
 
-            while ((index != m_PendingQueue.end()) && ((*index).Content() != info)) {
+            while ((index != m_PendingQueue.end()) && ((*index)->Content() != info)) {
                 ++index;
             }
 
             if (index != m_PendingQueue.end()) {
-                m_PendingQueue.erase(index);
+                TimeInfoBlocks* entry = *index;
+                RemoveAt(static_cast<uint32_t>(index - m_PendingQueue.begin()));
+                delete entry;
             }
 
-            if (ScheduleEntry(newEntry) == true) {
+            if (ScheduleEntry(newEntry, Time::Now().Ticks(), Monotonic()) == true) {
                 m_TimerThread.Run();
             }
 
@@ -183,16 +225,14 @@ namespace Core {
 
             m_Admin.Lock();
 
-            typename SubscriberList::iterator index = m_PendingQueue.begin();
-
             // Since we have the admin lock, we are pretty sure that there is not any
             // context running, so we can be pretty sure that if it was scheduled, it
             // is gone !!!
-            if (RemoveEntry(index, info) == true) {
+            if (RemoveEntry(info) == true) {
 
                 foundElement = true;
 
-                // If we added the new time up front, retrigger the scheduler.
+                // The first one might have been removed, retrigger the scheduler.
                 m_TimerThread.Run();
             }
 
@@ -208,7 +248,7 @@ namespace Core {
 
         uint32_t Pending() const
         {
-            return (m_PendingQueue.size());
+            return (static_cast<uint32_t>(m_PendingQueue.size()));
         }
 
         ::ThreadId ThreadId() const
@@ -221,6 +261,7 @@ namespace Core {
         {
             uint32_t delayTime = Core::infinite;
             uint64_t now = Time::Now().Ticks();
+            uint64_t monotonic = Monotonic();
 
             m_Admin.Lock();
 
@@ -228,23 +269,25 @@ namespace Core {
             // Ranging from 0-Core::infinite
             m_TimerThread.Block();
 
-            while ((m_PendingQueue.empty() == false) && (m_PendingQueue.front().ScheduleTime() <= now)) {
-                TimedInfo<CONTENT> info(m_PendingQueue.front());
+            while ((m_PendingQueue.empty() == false) && (m_PendingQueue.front()->Deadline() <= monotonic)) {
+                TimeInfoBlocks* info = m_PendingQueue.front();
 
                 // Make sure we loose the current one before we do the call, that one might add ;-)
-                m_PendingQueue.pop_front();
+                RemoveAt(0);
 
                 m_Admin.Unlock();
 
-                uint64_t reschedule = info.Content().Timed(info.ScheduleTime());
+                uint64_t reschedule = info->Content().Timed(info->ScheduleTime());
 
                 m_Admin.Lock();
 
                 if (reschedule != 0) {
                     ASSERT(reschedule > now);
 
-                    info.ScheduleTime(reschedule);
-                    ScheduleEntry(info);
+                    info->ScheduleTime(reschedule);
+                    ScheduleEntry(info, Time::Now().Ticks(), Monotonic());
+                } else {
+                    delete info;
                 }
             }
 
@@ -253,16 +296,16 @@ namespace Core {
                 m_NextTrigger = NUMBER_MAX_UNSIGNED(uint64_t);
             } else {
                 // Refresh the time, just to be on the safe side...
-                uint64_t delta = Time::Now().Ticks();
+                uint64_t delta = Monotonic();
+                uint64_t deadline = m_PendingQueue.front()->Deadline();
 
-                if (delta >= m_PendingQueue.front().ScheduleTime()) {
-                    m_NextTrigger = delta;
+                if (delta >= deadline) {
+                    m_NextTrigger = Time::Now().Ticks();
                     delayTime = 0;
                 } else {
-                    // The windows counter is in 100ns intervals dus we mmoeten even delen door  1000 (us) * 10 ns = 10.000
-                    // om de waarde in ms te krijgen.
-                    m_NextTrigger = m_PendingQueue.front().ScheduleTime();
-                    delayTime = static_cast<uint32_t>((m_NextTrigger - delta) / Time::TicksPerMillisecond);
+                    // Round up, waking up before the deadline only costs an extra round trip.
+                    m_NextTrigger = Time::Now().Ticks() + (deadline - delta);
+                    delayTime = static_cast<uint32_t>(((deadline - delta) + Time::TicksPerMillisecond - 1) / Time::TicksPerMillisecond);
                 }
             }
 
@@ -272,45 +315,110 @@ namespace Core {
         }
 
     private:
-        bool ScheduleEntry(TimedInfo<CONTENT>& infoBlock)
+        // Current time of a clock that is not affected by changes to the system time, in Time ticks.
+        static uint64_t Monotonic()
+        {
+#ifdef __WIN32__
+            return (static_cast<uint64_t>(::GetTickCount64()) * Time::TicksPerMillisecond);
+#else
+            struct timespec current;
+
+            clock_gettime(CLOCK_MONOTONIC, &current);
+
+            return ((static_cast<uint64_t>(current.tv_sec) * 1000 * Time::TicksPerMillisecond) + (static_cast<uint64_t>(current.tv_nsec) / (1000000 / Time::TicksPerMillisecond)));
+#endif
+        }
+        bool ScheduleEntry(TimeInfoBlocks* infoBlock, const uint64_t now, const uint64_t monotonic)
+        {
+            uint64_t deadline = (infoBlock->ScheduleTime() > now ? monotonic + (infoBlock->ScheduleTime() - now) : monotonic);
+
+            infoBlock->Deadline(deadline, m_Sequence++);
+
+            m_PendingQueue.push_back(infoBlock);
+
+            // If we added the new time up front, retrigger the scheduler.
+            return (SiftUp(static_cast<uint32_t>(m_PendingQueue.size() - 1)) == 0);
+        }
+        bool RemoveEntry(const CONTENT& info)
         {
-            bool reevaluate = false;
             typename SubscriberList::iterator index = m_PendingQueue.begin();
+            typename SubscriberList::iterator last = m_PendingQueue.begin();
 
-            while ((index != m_PendingQueue.end()) && (infoBlock.ScheduleTime() >= (*index).ScheduleTime())) {
+            // Compact all entries we keep to the front, than rebuild the heap in one go.
+            while (index != m_PendingQueue.end()) {
+                if ((*index)->Content() != info) {
+                    *last = *index;
+                    ++last;
+                } else {
+                    delete *index;
+                }
                 ++index;
             }
 
-            if (index == m_PendingQueue.begin()) {
-                m_PendingQueue.push_front(infoBlock);
+            bool removed = (last != m_PendingQueue.end());
 
-                // If we added the new time up front, retrigger the scheduler.
-                reevaluate = true;
-            } else if (index == m_PendingQueue.end()) {
-                m_PendingQueue.push_back(infoBlock);
-            } else {
-                m_PendingQueue.insert(index, infoBlock);
+            if (removed == true) {
+                m_PendingQueue.erase(last, m_PendingQueue.end());
+
+                for (uint32_t teller = static_cast<uint32_t>(m_PendingQueue.size() / Arity) + 1; teller > 0; --teller) {
+                    SiftDown(teller - 1);
+                }
             }
 
-            return (reevaluate);
+            return (removed);
         }
-        bool RemoveEntry(typename SubscriberList::iterator& index, const CONTENT& info)
+        void RemoveAt(const uint32_t index)
         {
-            bool changedHead = false;
+            uint32_t last = static_cast<uint32_t>(m_PendingQueue.size() - 1);
 
-            while (index != m_PendingQueue.end()) {
-                if (index->Content() == info) {
-                    changedHead = (index == m_PendingQueue.begin());
+            if (index != last) {
+                m_PendingQueue[index] = m_PendingQueue[last];
+                m_PendingQueue.pop_back();
 
-                    // Remove this... Found it, remove it.
-                    index = m_PendingQueue.erase(index);
-                } else {
+                if (SiftUp(index) == index) {
+                    SiftDown(index);
+                }
+            } else {
+                m_PendingQueue.pop_back();
+            }
+        }
+        uint32_t SiftUp(uint32_t index)
+        {
+            while (index > 0) {
+                uint32_t parent = (index - 1) / Arity;
 
-                    ++index;
+                if ((*m_PendingQueue[index] < *m_PendingQueue[parent]) == false) {
+                    break;
                 }
+
+                std::swap(m_PendingQueue[index], m_PendingQueue[parent]);
+                index = parent;
             }
 
-            return (changedHead);
+            return (index);
+        }
+        void SiftDown(uint32_t index)
+        {
+            uint32_t size = static_cast<uint32_t>(m_PendingQueue.size());
+
+            while (((index * Arity) + 1) < size) {
+                uint32_t first = (index * Arity) + 1;
+                uint32_t end = (first + Arity < size ? first + Arity : size);
+                uint32_t smallest = first;
+
+                for (uint32_t child = first + 1; child < end; child++) {
+                    if (*m_PendingQueue[child] < *m_PendingQueue[smallest]) {
+                        smallest = child;
+                    }
+                }
+
+                if ((*m_PendingQueue[smallest] < *m_PendingQueue[index]) == false) {
+                    break;
+                }
+
+                std::swap(m_PendingQueue[index], m_PendingQueue[smallest]);
+                index = smallest;
+            }
         }
 
     private:
@@ -318,6 +426,7 @@ namespace Core {
         TimeWorker m_TimerThread;
         CriticalSection m_Admin;
         uint64_t m_NextTrigger;
+        uint64_t m_Sequence;
     };
 
     template <typename HANDLER>
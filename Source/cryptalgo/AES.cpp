@@ -5,8 +5,10 @@ namespace Crypto {
 
     AESEncryption::AESEncryption(const aesType type)
         : _type(type)
+        , _offset(0)
     {
         ::memset(_iv, 0, sizeof(_iv));
+        ::memset(_stream, 0, sizeof(_stream));
     }
 
     AESEncryption::~AESEncryption()
@@ -17,7 +19,45 @@ namespace Crypto {
     {
         ASSERT((length == 16 /* 128 bits */) || (length == 24 /* 192 bits */) || (length == 32 /* 256 bits */));
         mbedtls_aes_init(&_context);
-        return (mbedtls_aes_setkey_enc(&_context, key, (length << 3)));
+
+        uint32_t result = mbedtls_aes_setkey_enc(&_context, key, (length << 3));
+
+        if ((result == 0) && (Type() == AES_GCM)) {
+            result = mbedtls_aes_gcm_setkey(&_gcm, &_context);
+        }
+
+        return (result);
+    }
+
+    void AESEncryption::InitialVector(const uint8_t length, const uint8_t iv[])
+    {
+        _offset = 0;
+
+        if (Type() == AES_GCM) {
+            mbedtls_aes_gcm_starts(&_gcm, &_context, MBEDTLS_AES_ENCRYPT, iv, length);
+        } else {
+            ASSERT(length == sizeof(_iv));
+        }
+
+        if (_iv != iv) {
+            const uint8_t size = std::min(length, static_cast<uint8_t>(sizeof(_iv)));
+            ::memcpy(_iv, iv, size);
+            ::memset(&_iv[size], 0, sizeof(_iv) - size);
+        }
+    }
+
+    uint32_t AESEncryption::AdditionalData(const uint32_t length, const uint8_t data[])
+    {
+        ASSERT(Type() == AES_GCM);
+
+        return (Type() == AES_GCM ? mbedtls_aes_gcm_update_ad(&_gcm, length, data) : Core::ERROR_UNAVAILABLE);
+    }
+
+    uint32_t AESEncryption::Tag(const uint8_t length, uint8_t tag[])
+    {
+        ASSERT(Type() == AES_GCM);
+
+        return (Type() == AES_GCM ? mbedtls_aes_gcm_finish(&_gcm, tag, length) : Core::ERROR_UNAVAILABLE);
     }
 
     uint32_t AESEncryption::Encrypt(const uint32_t length, const uint8_t input[], uint8_t output[])
@@ -27,13 +67,11 @@ namespace Crypto {
 
         switch (Type()) {
         case AES_ECB: {
-            uint32_t offset = 0;
             uint32_t blockSize = ((length / 16) * 16);
 
-            while (offset < blockSize) {
+            if (blockSize > 0) {
                 // First encrypt the whole blocks. No padding needed, yet
-                result = mbedtls_aes_crypt_ecb(&_context, MBEDTLS_AES_ENCRYPT, &(input[offset]), &(output[offset]));
-                offset += 16;
+                result = mbedtls_aes_crypt_ecb_blocks(&_context, MBEDTLS_AES_ENCRYPT, blockSize, input, output);
             }
 
             if (blockSize < length) {
@@ -151,6 +189,19 @@ namespace Crypto {
         }
             result = mbedtls_aes_crypt_ofb(&_context, length, &_offset, _iv, input, output);
             break;
+#endif
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+        case AES_CTR: {
+            // A stream cipher, partial blocks continue where the previous call left off.
+            result = mbedtls_aes_crypt_ctr(&_context, length, &_offset, _iv, _stream, input, output);
+            break;
+        }
+#endif
+#if defined(MBEDTLS_CIPHER_MODE_GCM)
+        case AES_GCM: {
+            result = mbedtls_aes_gcm_update(&_gcm, &_context, length, input, output);
+            break;
+        }
 #endif
         default:
             ASSERT(false);
@@ -165,6 +216,7 @@ namespace Crypto {
         , _offset(0)
     {
         ::memset(_iv, 0, sizeof(_iv));
+        ::memset(_stream, 0, sizeof(_stream));
     }
 
     AESDecryption::~AESDecryption()
@@ -182,7 +234,64 @@ namespace Crypto {
             // should ude the encryption key. Not sure !!!!!
             return (mbedtls_aes_setkey_dec(&_context, key, length << 3));
         }
-        return (mbedtls_aes_setkey_enc(&_context, key, (length << 3)));
+
+        uint32_t result = mbedtls_aes_setkey_enc(&_context, key, (length << 3));
+
+        if ((result == 0) && (Type() == AES_GCM)) {
+            result = mbedtls_aes_gcm_setkey(&_gcm, &_context);
+        }
+
+        return (result);
+    }
+
+    void AESDecryption::InitialVector(const uint8_t length, const uint8_t iv[])
+    {
+        _offset = 0;
+
+        if (Type() == AES_GCM) {
+            mbedtls_aes_gcm_starts(&_gcm, &_context, MBEDTLS_AES_DECRYPT, iv, length);
+        } else {
+            ASSERT(length == sizeof(_iv));
+        }
+
+        if (_iv != iv) {
+            const uint8_t size = std::min(length, static_cast<uint8_t>(sizeof(_iv)));
+            ::memcpy(_iv, iv, size);
+            ::memset(&_iv[size], 0, sizeof(_iv) - size);
+        }
+    }
+
+    uint32_t AESDecryption::AdditionalData(const uint32_t length, const uint8_t data[])
+    {
+        ASSERT(Type() == AES_GCM);
+
+        return (Type() == AES_GCM ? mbedtls_aes_gcm_update_ad(&_gcm, length, data) : Core::ERROR_UNAVAILABLE);
+    }
+
+    uint32_t AESDecryption::Verify(const uint8_t length, const uint8_t tag[])
+    {
+        ASSERT(Type() == AES_GCM);
+
+        uint32_t result = Core::ERROR_UNAVAILABLE;
+
+        if (Type() == AES_GCM) {
+            uint8_t calculated[16];
+
+            result = mbedtls_aes_gcm_finish(&_gcm, calculated, length);
+
+            if (result == 0) {
+                // Constant time, not to tell how much of a forged tag was right.
+                uint8_t difference = 0;
+
+                for (uint8_t index = 0; index < length; index++) {
+                    difference |= (calculated[index] ^ tag[index]);
+                }
+
+                result = (difference == 0 ? Core::ERROR_NONE : Core::ERROR_INCORRECT_HASH);
+            }
+        }
+
+        return (result);
     }
 
     uint32_t AESDecryption::Decrypt(const uint32_t length, const uint8_t input[], uint8_t output[])
@@ -191,13 +300,11 @@ namespace Crypto {
 
         switch (Type()) {
         case AES_ECB: {
-            uint32_t offset = 0;
             uint32_t blockSize = ((length / 16) * 16);
 
-            while (offset < blockSize) {
+            if (blockSize > 0) {
                 // First encrypt the whole blocks. No padding needed, yet
-                result = mbedtls_aes_crypt_ecb(&_context, MBEDTLS_AES_DECRYPT, &(input[offset]), &(output[offset]));
-                offset += 16;
+                result = mbedtls_aes_crypt_ecb_blocks(&_context, MBEDTLS_AES_DECRYPT, blockSize, input, output);
             }
 
             if (blockSize < length) {
@@ -313,6 +420,19 @@ namespace Crypto {
             }
             break;
         }
+#endif
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+        case AES_CTR: {
+            // A stream cipher, partial blocks continue where the previous call left off.
+            result = mbedtls_aes_crypt_ctr(&_context, length, &_offset, _iv, _stream, input, output);
+            break;
+        }
+#endif
+#if defined(MBEDTLS_CIPHER_MODE_GCM)
+        case AES_GCM: {
+            result = mbedtls_aes_gcm_update(&_gcm, &_context, length, input, output);
+            break;
+        }
 #endif
         default:
             ASSERT(false);
@@ -12,7 +12,9 @@ namespace Crypto {
         AES_CBC,
         AES_CFB8,
         AES_CFB128,
-        AES_OFB
+        AES_OFB,
+        AES_CTR,
+        AES_GCM
     };
 
     enum bitLength {
@@ -42,17 +44,24 @@ namespace Crypto {
         }
         inline void InitialVector(const uint8_t iv[16])
         {
-            _offset = 0;
-            ::memcpy(_iv, iv, sizeof(_iv));
+            InitialVector(sizeof(_iv), iv);
         }
+        // For AES_GCM this starts a new message, a 12 byte IV is the common case.
+        void InitialVector(const uint8_t length, const uint8_t iv[]);
         uint32_t Key(const uint8_t length, const uint8_t key[]);
 
+        // AES_GCM only, authenticated but not encrypted data. Pass it before the Encrypt calls.
+        uint32_t AdditionalData(const uint32_t length, const uint8_t data[]);
         uint32_t Encrypt(const uint32_t length, const uint8_t input[], uint8_t output[]);
+        // AES_GCM only, completes the message and reports its authentication tag (4 to 16 bytes).
+        uint32_t Tag(const uint8_t length, uint8_t tag[]);
 
     private:
         aesType _type;
         mbedtls_aes_context _context;
+        mbedtls_aes_gcm_context _gcm;
         uint8_t _iv[16];
+        uint8_t _stream[16];
         size_t _offset;
     };
 
@@ -77,19 +86,25 @@ namespace Crypto {
         }
         inline void InitialVector(const uint8_t iv[16])
         {
-            _offset = 0;
-            if (_iv != iv) {
-                ::memcpy(_iv, iv, sizeof(_iv));
-            }
+            InitialVector(sizeof(_iv), iv);
         }
+        // For AES_GCM this starts a new message, a 12 byte IV is the common case.
+        void InitialVector(const uint8_t length, const uint8_t iv[]);
         uint32_t Key(const uint8_t length, const uint8_t key[]);
 
+        // AES_GCM only, authenticated but not encrypted data. Pass it before the Decrypt calls.
+        uint32_t AdditionalData(const uint32_t length, const uint8_t data[]);
         uint32_t Decrypt(const uint32_t length, const uint8_t input[], uint8_t output[]);
+        // AES_GCM only, completes the message and checks it against the received tag. Returns
+        // Core::ERROR_INCORRECT_HASH if it does not match, the decrypted data is not to be trusted.
+        uint32_t Verify(const uint8_t length, const uint8_t tag[]);
 
     private:
         aesType _type;
         mbedtls_aes_context _context;
+        mbedtls_aes_gcm_context _gcm;
         uint8_t _iv[16];
+        uint8_t _stream[16];
         size_t _offset;
     };
 }
@@ -34,8 +34,19 @@ extern "C" {
 #if defined(MBEDTLS_PADLOCK_C)
 #include "mbedtls/padlock.h"
 #endif
-#if defined(MBEDTLS_AESNI_C)
-#include "mbedtls/aesni.h"
+
+// AES has instructions on x86 (AES-NI, with PCLMULQDQ for GHASH) and on ARMv8 (Crypto Extensions).
+// The x86 ones are built along with the portable code and picked at runtime; the ARM ones need a
+// toolchain targeting the extensions and are still only used if the CPU reports them.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define __AES_AESNI__
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__linux__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+#include <arm_neon.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#define __AES_ARMV8__
 #endif
 
 #if !defined(MBEDTLS_AES_ALT)
@@ -71,6 +82,29 @@ static void mbedtls_zeroize(void* v, uint32_t n)
     }
 #endif
 
+/*
+* 32-bit integer manipulation macros (big endian)
+*/
+#ifndef GET_UINT32_BE
+#define GET_UINT32_BE(n, b, i)                \
+    {                                         \
+        (n) = ((uint32_t)(b)[(i)] << 24)      \
+            | ((uint32_t)(b)[(i) + 1] << 16)  \
+            | ((uint32_t)(b)[(i) + 2] << 8)   \
+            | ((uint32_t)(b)[(i) + 3]);       \
+    }
+#endif
+
+#ifndef PUT_UINT32_BE
+#define PUT_UINT32_BE(n, b, i)                       \
+    {                                                \
+        (b)[(i)] = (unsigned char)((n) >> 24);       \
+        (b)[(i) + 1] = (unsigned char)((n) >> 16);   \
+        (b)[(i) + 2] = (unsigned char)((n) >> 8);    \
+        (b)[(i) + 3] = (unsigned char)((n));         \
+    }
+#endif
+
 #if defined(MBEDTLS_PADLOCK_C) && (defined(MBEDTLS_HAVE_X86) || defined(MBEDTLS_PADLOCK_ALIGN16))
 static int aes_padlock_ace = -1;
 #endif
@@ -497,11 +531,6 @@ int mbedtls_aes_setkey_enc(mbedtls_aes_context* ctx, const unsigned char* key,
 #endif
         ctx->rk = RK = ctx->buf;
 
-#if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64)
-    if (mbedtls_aesni_has_support(MBEDTLS_AESNI_AES))
-        return (mbedtls_aesni_setkey_enc((unsigned char*)ctx->rk, key, keybits));
-#endif
-
     for (i = 0; i < (keybits >> 5); i++) {
         GET_UINT32_LE(RK[i], key, i << 2);
     }
@@ -583,14 +612,6 @@ int mbedtls_aes_setkey_dec(mbedtls_aes_context* ctx, const unsigned char* key,
 
     ctx->nr = cty.nr;
 
-#if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64)
-    if (mbedtls_aesni_has_support(MBEDTLS_AESNI_AES)) {
-        mbedtls_aesni_inverse_key((unsigned char*)ctx->rk,
-            (const unsigned char*)cty.rk, ctx->nr);
-        goto exit;
-    }
-#endif
-
     SK = cty.rk + cty.nr * 4;
 
     *RK++ = *SK++;
@@ -726,6 +747,199 @@ void mbedtls_aes_decrypt(mbedtls_aes_context* ctx,
 }
 #endif /* !MBEDTLS_AES_DECRYPT_ALT */
 
+/*
+* Hardware AES. Both AES-NI and the ARMv8 Crypto Extensions take the round keys as laid out by
+* mbedtls_aes_setkey_enc/dec: the decryption schedule is already the one of the "equivalent
+* inverse cipher" (InvMixColumns applied to the middle round keys), which is what AESDEC and
+* AESD/AESIMC expect. Independent blocks are interleaved, so the round instructions of the
+* next block are issued while the previous ones are still in the pipeline.
+*/
+#define AES_INTERLEAVE 8
+
+#define AES_INTERLEAVED(OP, KEY) \
+    {                            \
+        b0 = OP(b0, KEY);        \
+        b1 = OP(b1, KEY);        \
+        b2 = OP(b2, KEY);        \
+        b3 = OP(b3, KEY);        \
+        b4 = OP(b4, KEY);        \
+        b5 = OP(b5, KEY);        \
+        b6 = OP(b6, KEY);        \
+        b7 = OP(b7, KEY);        \
+    }
+
+#if defined(__AES_AESNI__)
+__attribute__((target("aes,sse2"))) static void aes_crypt_aesni(const mbedtls_aes_context* ctx,
+    int mode,
+    uint32_t blocks,
+    const unsigned char* input,
+    unsigned char* output)
+{
+    const __m128i* source = reinterpret_cast<const __m128i*>(input);
+    __m128i* destination = reinterpret_cast<__m128i*>(output);
+    const int nr = ctx->nr;
+    __m128i key[15];
+    int i;
+
+    for (i = 0; i <= nr; i++)
+        key[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctx->rk) + i);
+
+    for (; blocks >= AES_INTERLEAVE; blocks -= AES_INTERLEAVE, source += AES_INTERLEAVE, destination += AES_INTERLEAVE) {
+        __m128i b0 = _mm_loadu_si128(&source[0]);
+        __m128i b1 = _mm_loadu_si128(&source[1]);
+        __m128i b2 = _mm_loadu_si128(&source[2]);
+        __m128i b3 = _mm_loadu_si128(&source[3]);
+        __m128i b4 = _mm_loadu_si128(&source[4]);
+        __m128i b5 = _mm_loadu_si128(&source[5]);
+        __m128i b6 = _mm_loadu_si128(&source[6]);
+        __m128i b7 = _mm_loadu_si128(&source[7]);
+
+        AES_INTERLEAVED(_mm_xor_si128, key[0]);
+
+        if (mode == MBEDTLS_AES_ENCRYPT) {
+            for (i = 1; i < nr; i++)
+                AES_INTERLEAVED(_mm_aesenc_si128, key[i]);
+            AES_INTERLEAVED(_mm_aesenclast_si128, key[nr]);
+        } else {
+            for (i = 1; i < nr; i++)
+                AES_INTERLEAVED(_mm_aesdec_si128, key[i]);
+            AES_INTERLEAVED(_mm_aesdeclast_si128, key[nr]);
+        }
+
+        _mm_storeu_si128(&destination[0], b0);
+        _mm_storeu_si128(&destination[1], b1);
+        _mm_storeu_si128(&destination[2], b2);
+        _mm_storeu_si128(&destination[3], b3);
+        _mm_storeu_si128(&destination[4], b4);
+        _mm_storeu_si128(&destination[5], b5);
+        _mm_storeu_si128(&destination[6], b6);
+        _mm_storeu_si128(&destination[7], b7);
+    }
+
+    for (; blocks > 0; blocks--, source++, destination++) {
+        __m128i b = _mm_xor_si128(_mm_loadu_si128(source), key[0]);
+
+        if (mode == MBEDTLS_AES_ENCRYPT) {
+            for (i = 1; i < nr; i++)
+                b = _mm_aesenc_si128(b, key[i]);
+            b = _mm_aesenclast_si128(b, key[nr]);
+        } else {
+            for (i = 1; i < nr; i++)
+                b = _mm_aesdec_si128(b, key[i]);
+            b = _mm_aesdeclast_si128(b, key[nr]);
+        }
+
+        _mm_storeu_si128(destination, b);
+    }
+}
+
+static bool aes_supported()
+{
+    uint32_t eax, ebx, ecx, edx;
+
+    return ((__get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0) && ((ecx & bit_AES) != 0));
+}
+
+#define aes_crypt_accelerated aes_crypt_aesni
+#endif
+
+#if defined(__AES_ARMV8__)
+#define AES_ARMV8_ENCRYPT_ROUND(B, KEY) vaesmcq_u8(vaeseq_u8(B, KEY))
+#define AES_ARMV8_DECRYPT_ROUND(B, KEY) vaesimcq_u8(vaesdq_u8(B, KEY))
+
+static void aes_crypt_armv8(const mbedtls_aes_context* ctx,
+    int mode,
+    uint32_t blocks,
+    const unsigned char* input,
+    unsigned char* output)
+{
+    const int nr = ctx->nr;
+    uint8x16_t key[15];
+    int i;
+
+    for (i = 0; i <= nr; i++)
+        key[i] = vld1q_u8(reinterpret_cast<const uint8_t*>(ctx->rk) + (i << 4));
+
+    for (; blocks >= AES_INTERLEAVE; blocks -= AES_INTERLEAVE, input += (AES_INTERLEAVE << 4), output += (AES_INTERLEAVE << 4)) {
+        uint8x16_t b0 = vld1q_u8(&input[0]);
+        uint8x16_t b1 = vld1q_u8(&input[16]);
+        uint8x16_t b2 = vld1q_u8(&input[32]);
+        uint8x16_t b3 = vld1q_u8(&input[48]);
+        uint8x16_t b4 = vld1q_u8(&input[64]);
+        uint8x16_t b5 = vld1q_u8(&input[80]);
+        uint8x16_t b6 = vld1q_u8(&input[96]);
+        uint8x16_t b7 = vld1q_u8(&input[112]);
+
+        if (mode == MBEDTLS_AES_ENCRYPT) {
+            for (i = 0; i < (nr - 1); i++)
+                AES_INTERLEAVED(AES_ARMV8_ENCRYPT_ROUND, key[i]);
+            AES_INTERLEAVED(vaeseq_u8, key[nr - 1]);
+        } else {
+            for (i = 0; i < (nr - 1); i++)
+                AES_INTERLEAVED(AES_ARMV8_DECRYPT_ROUND, key[i]);
+            AES_INTERLEAVED(vaesdq_u8, key[nr - 1]);
+        }
+
+        AES_INTERLEAVED(veorq_u8, key[nr]);
+
+        vst1q_u8(&output[0], b0);
+        vst1q_u8(&output[16], b1);
+        vst1q_u8(&output[32], b2);
+        vst1q_u8(&output[48], b3);
+        vst1q_u8(&output[64], b4);
+        vst1q_u8(&output[80], b5);
+        vst1q_u8(&output[96], b6);
+        vst1q_u8(&output[112], b7);
+    }
+
+    for (; blocks > 0; blocks--, input += 16, output += 16) {
+        uint8x16_t b = vld1q_u8(input);
+
+        if (mode == MBEDTLS_AES_ENCRYPT) {
+            for (i = 0; i < (nr - 1); i++)
+                b = vaesmcq_u8(vaeseq_u8(b, key[i]));
+            b = veorq_u8(vaeseq_u8(b, key[nr - 1]), key[nr]);
+        } else {
+            for (i = 0; i < (nr - 1); i++)
+                b = vaesimcq_u8(vaesdq_u8(b, key[i]));
+            b = veorq_u8(vaesdq_u8(b, key[nr - 1]), key[nr]);
+        }
+
+        vst1q_u8(output, b);
+    }
+}
+
+static bool aes_supported()
+{
+    return ((getauxval(AT_HWCAP) & HWCAP_AES) != 0);
+}
+
+#define aes_crypt_accelerated aes_crypt_armv8
+#endif
+
+static void aes_crypt_blocks(mbedtls_aes_context* ctx,
+    int mode,
+    uint32_t blocks,
+    const unsigned char* input,
+    unsigned char* output)
+{
+#if defined(aes_crypt_accelerated)
+    static const bool accelerated = aes_supported();
+
+    if (accelerated == true) {
+        aes_crypt_accelerated(ctx, mode, blocks, input, output);
+    } else
+#endif
+    {
+        for (; blocks > 0; blocks--, input += 16, output += 16) {
+            if (mode == MBEDTLS_AES_ENCRYPT)
+                mbedtls_aes_encrypt(ctx, input, output);
+            else
+                mbedtls_aes_decrypt(ctx, input, output);
+        }
+    }
+}
+
 /*
 * AES-ECB block encryption/decryption
 */
@@ -734,11 +948,6 @@ int mbedtls_aes_crypt_ecb(mbedtls_aes_context* ctx,
     const unsigned char input[16],
     unsigned char output[16])
 {
-#if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64)
-    if (mbedtls_aesni_has_support(MBEDTLS_AESNI_AES))
-        return (mbedtls_aesni_crypt_ecb(ctx, mode, input, output));
-#endif
-
 #if defined(MBEDTLS_PADLOCK_C) && defined(MBEDTLS_HAVE_X86)
     if (aes_padlock_ace) {
         if (mbedtls_padlock_xcryptecb(ctx, mode, input, output) == 0)
@@ -750,14 +959,103 @@ int mbedtls_aes_crypt_ecb(mbedtls_aes_context* ctx,
     }
 #endif
 
-    if (mode == MBEDTLS_AES_ENCRYPT)
-        mbedtls_aes_encrypt(ctx, input, output);
-    else
-        mbedtls_aes_decrypt(ctx, input, output);
+    aes_crypt_blocks(ctx, mode, 1, input, output);
 
     return (0);
 }
 
+/*
+* AES-ECB encryption/decryption of a run of blocks
+*/
+int mbedtls_aes_crypt_ecb_blocks(mbedtls_aes_context* ctx,
+    int mode,
+    uint32_t length,
+    const unsigned char* input,
+    unsigned char* output)
+{
+    if (length % 16)
+        return (MBEDTLS_ERR_AES_INVALID_INPUT_LENGTH);
+
+    aes_crypt_blocks(ctx, mode, length / 16, input, output);
+
+    return (0);
+}
+
+/*
+* Run of blocks processed per call of the block function in the chained modes, their
+* intermediate data lives on the stack.
+*/
+#define AES_BATCH 32
+
+static void aes_xor(unsigned char* output, const unsigned char* input, const unsigned char* stream, uint32_t length)
+{
+    uint32_t i = 0;
+
+    for (; (i + 8) <= length; i += 8) {
+        uint64_t a, b;
+        memcpy(&a, &input[i], 8);
+        memcpy(&b, &stream[i], 8);
+        a ^= b;
+        memcpy(&output[i], &a, 8);
+    }
+    for (; i < length; i++)
+        output[i] = (unsigned char)(input[i] ^ stream[i]);
+}
+
+/*
+* Big endian increment of the last width bytes of the counter block
+*/
+static void aes_increment(unsigned char counter[16], int width)
+{
+    int i;
+
+    for (i = 16; i > (16 - width); i--)
+        if (++counter[i - 1] != 0)
+            break;
+}
+
+/*
+* Counter mode over whole blocks, the counter blocks are encrypted AES_BATCH at a time
+*/
+static void aes_ctr_blocks(mbedtls_aes_context* ctx,
+    uint32_t blocks,
+    unsigned char counter[16],
+    int width,
+    const unsigned char* input,
+    unsigned char* output)
+{
+    unsigned char stream[AES_BATCH * 16];
+
+    while (blocks > 0) {
+        uint32_t count = (blocks < AES_BATCH ? blocks : AES_BATCH);
+        uint32_t low, i;
+
+        GET_UINT32_BE(low, counter, 12);
+
+        if ((width == 4) || ((low + count) > low)) {
+            // Only the last 32 bits change within this run of blocks
+            for (i = 0; i < count; i++) {
+                memcpy(&stream[i << 4], counter, 12);
+                PUT_UINT32_BE(low + i, stream, (i << 4) + 12);
+            }
+            low += count;
+            PUT_UINT32_BE(low, counter, 12);
+        } else {
+            for (i = 0; i < count; i++) {
+                memcpy(&stream[i << 4], counter, 16);
+                aes_increment(counter, width);
+            }
+        }
+
+        aes_crypt_blocks(ctx, MBEDTLS_AES_ENCRYPT, count, stream, stream);
+        aes_xor(output, input, stream, count << 4);
+
+        input += (count << 4);
+        output += (count << 4);
+        blocks -= count;
+    }
+}
+
 #if defined(MBEDTLS_CIPHER_MODE_CBC)
 /*
 * AES-CBC buffer encryption/decryption
@@ -770,7 +1068,6 @@ int mbedtls_aes_crypt_cbc(mbedtls_aes_context* ctx,
     unsigned char* output)
 {
     int i;
-    unsigned char temp[16];
 
     if (length % 16)
         return (MBEDTLS_ERR_AES_INVALID_INPUT_LENGTH);
@@ -787,18 +1084,24 @@ int mbedtls_aes_crypt_cbc(mbedtls_aes_context* ctx,
 #endif
 
     if (mode == MBEDTLS_AES_DECRYPT) {
+        // The decryption of the blocks is independent, only the XOR needs the previous
+        // ciphertext block. Keep a copy of it, the output may overwrite the input.
+        unsigned char chain[AES_BATCH * 16];
+
         while (length > 0) {
-            memcpy(temp, input, 16);
-            mbedtls_aes_crypt_ecb(ctx, mode, input, output);
+            uint32_t size = (length < sizeof(chain) ? length : sizeof(chain));
 
-            for (i = 0; i < 16; i++)
-                output[i] = (unsigned char)(output[i] ^ iv[i]);
+            memcpy(chain, input, size);
+            aes_crypt_blocks(ctx, mode, size / 16, chain, output);
 
-            memcpy(iv, temp, 16);
+            aes_xor(output, output, iv, 16);
+            aes_xor(&output[16], &output[16], chain, size - 16);
 
-            input += 16;
-            output += 16;
-            length -= 16;
+            memcpy(iv, &chain[size - 16], 16);
+
+            input += size;
+            output += size;
+            length -= size;
         }
     } else {
         while (length > 0) {
@@ -898,27 +1201,32 @@ int mbedtls_aes_crypt_cfb8(mbedtls_aes_context* ctx,
 */
 int mbedtls_aes_crypt_ctr(mbedtls_aes_context* ctx,
     uint32_t length,
-    uint32_t* nc_off,
+    size_t* nc_off,
     unsigned char nonce_counter[16],
     unsigned char stream_block[16],
     const unsigned char* input,
     unsigned char* output)
 {
-    int c, i;
-    uint32_t n = *nc_off;
+    uint32_t n = static_cast<uint32_t>(*nc_off);
 
-    while (length--) {
-        if (n == 0) {
-            mbedtls_aes_crypt_ecb(ctx, MBEDTLS_AES_ENCRYPT, nonce_counter, stream_block);
+    // Use up what is left of the current stream block
+    while ((n != 0) && (length > 0)) {
+        *output++ = (unsigned char)(*input++ ^ stream_block[n]);
+        n = (n + 1) & 0x0F;
+        length--;
+    }
 
-            for (i = 16; i > 0; i--)
-                if (++nonce_counter[i - 1] != 0)
-                    break;
-        }
-        c = *input++;
-        *output++ = (unsigned char)(c ^ stream_block[n]);
+    aes_ctr_blocks(ctx, length / 16, nonce_counter, 16, input, output);
 
-        n = (n + 1) & 0x0F;
+    input += (length & ~0x0F);
+    output += (length & ~0x0F);
+    length &= 0x0F;
+
+    if (length > 0) {
+        mbedtls_aes_crypt_ecb(ctx, MBEDTLS_AES_ENCRYPT, nonce_counter, stream_block);
+        aes_increment(nonce_counter, 16);
+        aes_xor(output, input, stream_block, length);
+        n = length;
     }
 
     *nc_off = n;
@@ -954,7 +1262,7 @@ int mbedtls_aes_crypt_ofb(mbedtls_aes_context* ctx,
     }
 
     while ((cnt + 16) <= length) {
-        mbedtls_aes_encrypt(ctx, iv, iv);
+        mbedtls_aes_crypt_ecb(ctx, MBEDTLS_AES_ENCRYPT, iv, iv);
 
         for (unsigned char teller = 0; teller < 16; teller++) {
 
@@ -964,7 +1272,7 @@ int mbedtls_aes_crypt_ofb(mbedtls_aes_context* ctx,
     }
 
     if (cnt < length) {
-        mbedtls_aes_encrypt(ctx, iv, iv);
+        mbedtls_aes_crypt_ecb(ctx, MBEDTLS_AES_ENCRYPT, iv, iv);
 
         while (cnt < length) {
             *output++ = iv[b_pos++] ^ *input++;
@@ -979,6 +1287,439 @@ int mbedtls_aes_crypt_ofb(mbedtls_aes_context* ctx,
 
 #endif /* MBEDTLS_CIPHER_MODE_OFB */
 
+#if defined(MBEDTLS_CIPHER_MODE_GCM)
+/*
+* Blocks encrypted and hashed per step, so the text is still in the cache for the second pass
+*/
+#define GCM_BATCH 256
+
+static const unsigned char gcm_zero[16] = { 0 };
+
+/*
+* Precompute small multiples of H, that is set
+*      HH[i] || HL[i] = H times i,
+* where i is seen as a field element as in [MGV], ie high-order bits
+* correspond to low powers of P. The result is stored in the same way, that
+* is the high-order bit of HH corresponds to P^0 and the low-order bit of HL
+* corresponds to P^127.
+*/
+static void gcm_gen_table(mbedtls_aes_gcm_context* gcm, const unsigned char h[16])
+{
+    int i, j;
+    uint64_t hi, lo;
+    uint64_t vl, vh;
+
+    GET_UINT32_BE(hi, h, 0);
+    GET_UINT32_BE(lo, h, 4);
+    vh = (uint64_t)hi << 32 | lo;
+
+    GET_UINT32_BE(hi, h, 8);
+    GET_UINT32_BE(lo, h, 12);
+    vl = (uint64_t)hi << 32 | lo;
+
+    /* 8 = 1000 corresponds to 1 in GF(2^128) */
+    gcm->HL[8] = vl;
+    gcm->HH[8] = vh;
+
+    /* 0 corresponds to 0 in GF(2^128) */
+    gcm->HH[0] = 0;
+    gcm->HL[0] = 0;
+
+    for (i = 4; i > 0; i >>= 1) {
+        uint32_t T = (vl & 1) * 0xe1000000U;
+        vl = (vh << 63) | (vl >> 1);
+        vh = (vh >> 1) ^ ((uint64_t)T << 32);
+
+        gcm->HL[i] = vl;
+        gcm->HH[i] = vh;
+    }
+
+    for (i = 2; i <= 8; i *= 2) {
+        uint64_t *HiL = gcm->HL + i, *HiH = gcm->HH + i;
+        vh = *HiH;
+        vl = *HiL;
+        for (j = 1; j < i; j++) {
+            HiH[j] = vh ^ gcm->HH[j];
+            HiL[j] = vl ^ gcm->HL[j];
+        }
+    }
+}
+
+/*
+* Shoup's method for multiplication use this table with
+*      last4[x] = x times P^128
+* where x and last4[x] are seen as elements of GF(2^128) as in [MGV]
+*/
+static const uint64_t last4[16] = {
+    0x0000, 0x1c20, 0x3840, 0x2460,
+    0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560,
+    0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+/*
+* Sets output to x times H using the precomputed tables.
+* x and output are seen as elements of GF(2^128) as in [MGV].
+*/
+static void gcm_mult(mbedtls_aes_gcm_context* gcm, const unsigned char x[16], unsigned char output[16])
+{
+    int i = 0;
+    unsigned char lo, hi, rem;
+    uint64_t zh, zl;
+
+    lo = x[15] & 0xf;
+
+    zh = gcm->HH[lo];
+    zl = gcm->HL[lo];
+
+    for (i = 15; i >= 0; i--) {
+        lo = x[i] & 0xf;
+        hi = (x[i] >> 4) & 0xf;
+
+        if (i != 15) {
+            rem = (unsigned char)zl & 0xf;
+            zl = (zh << 60) | (zl >> 4);
+            zh = (zh >> 4);
+            zh ^= (uint64_t)last4[rem] << 48;
+            zh ^= gcm->HH[lo];
+            zl ^= gcm->HL[lo];
+        }
+
+        rem = (unsigned char)zl & 0xf;
+        zl = (zh << 60) | (zl >> 4);
+        zh = (zh >> 4);
+        zh ^= (uint64_t)last4[rem] << 48;
+        zh ^= gcm->HH[hi];
+        zl ^= gcm->HL[hi];
+    }
+
+    PUT_UINT32_BE(zh >> 32, output, 0);
+    PUT_UINT32_BE(zh, output, 4);
+    PUT_UINT32_BE(zl >> 32, output, 8);
+    PUT_UINT32_BE(zl, output, 12);
+}
+
+#if defined(__AES_AESNI__)
+/*
+* Carry-less multiplication as in the Intel white paper "Carry-Less Multiplication and Its Usage
+* for Computing the GCM Mode": the operands are byte reflected, the 256-bit products of several
+* blocks are summed before the single shift and reduction, with H^4..H^1 for 4 blocks at a time.
+*/
+__attribute__((target("pclmul,ssse3"))) static inline __m128i gcm_clmul_reflect(const unsigned char block[16])
+{
+    return (_mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)), _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15)));
+}
+
+__attribute__((target("pclmul,ssse3"))) static inline void gcm_clmul_multiply(const __m128i a, const __m128i b, __m128i& low, __m128i& high)
+{
+    const __m128i middle = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+
+    low = _mm_xor_si128(low, _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x00), _mm_slli_si128(middle, 8)));
+    high = _mm_xor_si128(high, _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x11), _mm_srli_si128(middle, 8)));
+}
+
+__attribute__((target("pclmul,ssse3"))) static inline __m128i gcm_clmul_reduce(__m128i low, __m128i high)
+{
+    __m128i a, b, c;
+
+    // Shift the 256-bit product left by one, the operands are bit reflected.
+    a = _mm_srli_epi32(low, 31);
+    b = _mm_srli_epi32(high, 31);
+    low = _mm_slli_epi32(low, 1);
+    high = _mm_slli_epi32(high, 1);
+    c = _mm_srli_si128(a, 12);
+    b = _mm_slli_si128(b, 4);
+    a = _mm_slli_si128(a, 4);
+    low = _mm_or_si128(low, a);
+    high = _mm_or_si128(_mm_or_si128(high, b), c);
+
+    // Reduce modulo x^128 + x^7 + x^2 + x + 1.
+    a = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(low, 31), _mm_slli_epi32(low, 30)), _mm_slli_epi32(low, 25));
+    b = _mm_srli_si128(a, 4);
+    low = _mm_xor_si128(low, _mm_slli_si128(a, 12));
+    a = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(low, 1), _mm_srli_epi32(low, 2)), _mm_srli_epi32(low, 7));
+    low = _mm_xor_si128(low, _mm_xor_si128(a, b));
+
+    return (_mm_xor_si128(high, low));
+}
+
+__attribute__((target("pclmul,ssse3"))) static void gcm_clmul_powers(mbedtls_aes_gcm_context* gcm, const unsigned char h[16])
+{
+    const __m128i h1 = gcm_clmul_reflect(h);
+    __m128i power = h1;
+    int i;
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(gcm->HP[0]), power);
+
+    for (i = 1; i < 4; i++) {
+        __m128i low = _mm_setzero_si128();
+        __m128i high = _mm_setzero_si128();
+
+        gcm_clmul_multiply(power, h1, low, high);
+        power = gcm_clmul_reduce(low, high);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(gcm->HP[i]), power);
+    }
+}
+
+__attribute__((target("pclmul,ssse3"))) static void gcm_ghash_clmul(mbedtls_aes_gcm_context* gcm, const unsigned char* data, uint32_t blocks)
+{
+    const __m128i h1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(gcm->HP[0]));
+    const __m128i h2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(gcm->HP[1]));
+    const __m128i h3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(gcm->HP[2]));
+    const __m128i h4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(gcm->HP[3]));
+    __m128i x = gcm_clmul_reflect(gcm->buf);
+
+    for (; blocks >= 4; blocks -= 4, data += 64) {
+        __m128i low = _mm_setzero_si128();
+        __m128i high = _mm_setzero_si128();
+
+        gcm_clmul_multiply(_mm_xor_si128(x, gcm_clmul_reflect(&data[0])), h4, low, high);
+        gcm_clmul_multiply(gcm_clmul_reflect(&data[16]), h3, low, high);
+        gcm_clmul_multiply(gcm_clmul_reflect(&data[32]), h2, low, high);
+        gcm_clmul_multiply(gcm_clmul_reflect(&data[48]), h1, low, high);
+
+        x = gcm_clmul_reduce(low, high);
+    }
+
+    for (; blocks > 0; blocks--, data += 16) {
+        __m128i low = _mm_setzero_si128();
+        __m128i high = _mm_setzero_si128();
+
+        gcm_clmul_multiply(_mm_xor_si128(x, gcm_clmul_reflect(data)), h1, low, high);
+
+        x = gcm_clmul_reduce(low, high);
+    }
+
+    x = _mm_shuffle_epi8(x, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(gcm->buf), x);
+}
+
+static bool gcm_clmul_supported()
+{
+    uint32_t eax, ebx, ecx, edx;
+
+    return ((__get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0) && ((ecx & bit_PCLMUL) != 0) && ((ecx & bit_SSSE3) != 0));
+}
+
+#define gcm_ghash_accelerated gcm_ghash_clmul
+#endif
+
+/*
+* buf = (buf ^ X1) * H, buf = (buf ^ X2) * H, ... over the given blocks
+*/
+static void gcm_ghash(mbedtls_aes_gcm_context* gcm, const unsigned char* data, uint32_t blocks)
+{
+#if defined(gcm_ghash_accelerated)
+    static const bool accelerated = gcm_clmul_supported();
+
+    if (accelerated == true) {
+        gcm_ghash_accelerated(gcm, data, blocks);
+    } else
+#endif
+    {
+        for (; blocks > 0; blocks--, data += 16) {
+            aes_xor(gcm->buf, gcm->buf, data, 16);
+            gcm_mult(gcm, gcm->buf, gcm->buf);
+        }
+    }
+}
+
+/*
+* Absorb the bytes of a block that is filled in parts, the multiplication is done once it is full
+*/
+static void gcm_absorb(mbedtls_aes_gcm_context* gcm, uint32_t offset, const unsigned char* data, uint32_t length)
+{
+    aes_xor(&gcm->buf[offset], &gcm->buf[offset], data, length);
+
+    if ((offset + length) == 16)
+        gcm_ghash(gcm, gcm_zero, 1);
+}
+
+int mbedtls_aes_gcm_setkey(mbedtls_aes_gcm_context* gcm,
+    mbedtls_aes_context* ctx)
+{
+    unsigned char h[16];
+
+    memset(gcm, 0, sizeof(mbedtls_aes_gcm_context));
+    memset(h, 0, sizeof(h));
+
+    mbedtls_aes_crypt_ecb(ctx, MBEDTLS_AES_ENCRYPT, h, h);
+
+    gcm_gen_table(gcm, h);
+
+#if defined(gcm_ghash_accelerated)
+    if (gcm_clmul_supported() == true)
+        gcm_clmul_powers(gcm, h);
+#endif
+
+    mbedtls_zeroize(h, sizeof(h));
+
+    return (0);
+}
+
+int mbedtls_aes_gcm_starts(mbedtls_aes_gcm_context* gcm,
+    mbedtls_aes_context* ctx,
+    int mode,
+    const unsigned char* iv,
+    uint32_t iv_len)
+{
+    memset(gcm->buf, 0, sizeof(gcm->buf));
+
+    gcm->mode = mode;
+    gcm->len = 0;
+    gcm->add_len = 0;
+
+    if (iv_len == 12) {
+        memcpy(gcm->y, iv, iv_len);
+        gcm->y[12] = 0;
+        gcm->y[13] = 0;
+        gcm->y[14] = 0;
+        gcm->y[15] = 1;
+    } else {
+        unsigned char work_buf[16];
+
+        gcm_ghash(gcm, iv, iv_len / 16);
+
+        if ((iv_len % 16) != 0) {
+            gcm_absorb(gcm, 0, &iv[iv_len & ~0x0F], iv_len % 16);
+            gcm_ghash(gcm, gcm_zero, 1);
+        }
+
+        memset(work_buf, 0, sizeof(work_buf));
+        PUT_UINT32_BE(((uint64_t)iv_len * 8) >> 32, work_buf, 8);
+        PUT_UINT32_BE(((uint64_t)iv_len * 8), work_buf, 12);
+        gcm_ghash(gcm, work_buf, 1);
+
+        memcpy(gcm->y, gcm->buf, 16);
+        memset(gcm->buf, 0, sizeof(gcm->buf));
+    }
+
+    mbedtls_aes_crypt_ecb(ctx, MBEDTLS_AES_ENCRYPT, gcm->y, gcm->base_ectr);
+    aes_increment(gcm->y, 4);
+
+    return (0);
+}
+
+int mbedtls_aes_gcm_update_ad(mbedtls_aes_gcm_context* gcm,
+    uint32_t length,
+    const unsigned char* add)
+{
+    uint32_t offset = static_cast<uint32_t>(gcm->add_len % 16);
+
+    /* Additional data goes in front of the text */
+    if (gcm->len != 0)
+        return (MBEDTLS_ERR_AES_GCM_BAD_INPUT);
+
+    gcm->add_len += length;
+
+    if (offset != 0) {
+        uint32_t use = (length < (16 - offset) ? length : (16 - offset));
+
+        gcm_absorb(gcm, offset, add, use);
+        add += use;
+        length -= use;
+    }
+
+    gcm_ghash(gcm, add, length / 16);
+
+    if ((length % 16) != 0)
+        gcm_absorb(gcm, 0, &add[length & ~0x0F], length % 16);
+
+    return (0);
+}
+
+int mbedtls_aes_gcm_update(mbedtls_aes_gcm_context* gcm,
+    mbedtls_aes_context* ctx,
+    uint32_t length,
+    const unsigned char* input,
+    unsigned char* output)
+{
+    uint32_t offset = static_cast<uint32_t>(gcm->len % 16);
+    uint32_t use;
+
+    if (length == 0)
+        return (0);
+
+    /* Close a partial block of additional data */
+    if ((gcm->len == 0) && ((gcm->add_len % 16) != 0))
+        gcm_ghash(gcm, gcm_zero, 1);
+
+    gcm->len += length;
+
+    if (offset != 0) {
+        use = (length < (16 - offset) ? length : (16 - offset));
+
+        if (gcm->mode == MBEDTLS_AES_DECRYPT)
+            gcm_absorb(gcm, offset, input, use);
+        aes_xor(output, input, &gcm->ectr[offset], use);
+        if (gcm->mode == MBEDTLS_AES_ENCRYPT)
+            gcm_absorb(gcm, offset, output, use);
+
+        input += use;
+        output += use;
+        length -= use;
+    }
+
+    while (length >= 16) {
+        uint32_t blocks = (length / 16);
+
+        if (blocks > GCM_BATCH)
+            blocks = GCM_BATCH;
+
+        if (gcm->mode == MBEDTLS_AES_DECRYPT)
+            gcm_ghash(gcm, input, blocks);
+        aes_ctr_blocks(ctx, blocks, gcm->y, 4, input, output);
+        if (gcm->mode == MBEDTLS_AES_ENCRYPT)
+            gcm_ghash(gcm, output, blocks);
+
+        input += (blocks << 4);
+        output += (blocks << 4);
+        length -= (blocks << 4);
+    }
+
+    if (length > 0) {
+        mbedtls_aes_crypt_ecb(ctx, MBEDTLS_AES_ENCRYPT, gcm->y, gcm->ectr);
+        aes_increment(gcm->y, 4);
+
+        if (gcm->mode == MBEDTLS_AES_DECRYPT)
+            gcm_absorb(gcm, 0, input, length);
+        aes_xor(output, input, gcm->ectr, length);
+        if (gcm->mode == MBEDTLS_AES_ENCRYPT)
+            gcm_absorb(gcm, 0, output, length);
+    }
+
+    return (0);
+}
+
+int mbedtls_aes_gcm_finish(mbedtls_aes_gcm_context* gcm,
+    unsigned char* tag,
+    uint32_t tag_len)
+{
+    unsigned char work_buf[16];
+    uint64_t orig_len = gcm->len * 8;
+    uint64_t orig_add_len = gcm->add_len * 8;
+
+    if ((tag_len > 16) || (tag_len < 4))
+        return (MBEDTLS_ERR_AES_GCM_BAD_INPUT);
+
+    /* Close a partial last block */
+    if (((gcm->len % 16) != 0) || ((gcm->len == 0) && ((gcm->add_len % 16) != 0)))
+        gcm_ghash(gcm, gcm_zero, 1);
+
+    PUT_UINT32_BE((orig_add_len >> 32), work_buf, 0);
+    PUT_UINT32_BE((orig_add_len), work_buf, 4);
+    PUT_UINT32_BE((orig_len >> 32), work_buf, 8);
+    PUT_UINT32_BE((orig_len), work_buf, 12);
+
+    gcm_ghash(gcm, work_buf, 1);
+
+    aes_xor(tag, gcm->buf, gcm->base_ectr, tag_len);
+
+    return (0);
+}
+#endif /* MBEDTLS_CIPHER_MODE_GCM */
+
 #endif /* !MBEDTLS_AES_ALT */
 
 #if defined(MBEDTLS_SELF_TEST)
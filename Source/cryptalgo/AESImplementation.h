@@ -28,8 +28,9 @@
 #define MBEDTLS_CIPHER_MODE_CBC
 #define MBEDTLS_CIPHER_MODE_CFB
 #define MBEDTLS_CIPHER_MODE_OFB
+#define MBEDTLS_CIPHER_MODE_CTR
+#define MBEDTLS_CIPHER_MODE_GCM
 #undef MBEDTLS_SELF_TEST
-#undef MBEDTLS_CIPHER_MODE_CTR
 
 #include <stddef.h>
 #include <stdint.h>
@@ -40,6 +41,7 @@
 
 #define MBEDTLS_ERR_AES_INVALID_KEY_LENGTH -0x0020 /**< Invalid key length. */
 #define MBEDTLS_ERR_AES_INVALID_INPUT_LENGTH -0x0022 /**< Invalid data input length. */
+#define MBEDTLS_ERR_AES_GCM_BAD_INPUT -0x0014 /**< Bad GCM input parameters. */
 
 #ifdef __cplusplus
 extern "C" {
@@ -113,6 +115,26 @@ int mbedtls_aes_crypt_ecb(mbedtls_aes_context* ctx,
     const unsigned char input[16],
     unsigned char output[16]);
 
+/**
+	* \brief          AES-ECB encryption/decryption of a run of blocks
+	*
+	*                 The blocks are independent, so with AES-NI or the ARMv8
+	*                 Crypto Extensions several of them are kept in flight.
+	*
+	* \param ctx      AES context
+	* \param mode     MBEDTLS_AES_ENCRYPT or MBEDTLS_AES_DECRYPT
+	* \param length   length of the input data, a multiple of 16
+	* \param input    buffer holding the input data
+	* \param output   buffer holding the output data
+	*
+	* \return         0 if successful, or MBEDTLS_ERR_AES_INVALID_INPUT_LENGTH
+	*/
+int mbedtls_aes_crypt_ecb_blocks(mbedtls_aes_context* ctx,
+    int mode,
+    uint32_t length,
+    const unsigned char* input,
+    unsigned char* output);
+
 #if defined(MBEDTLS_CIPHER_MODE_CBC)
 /**
 	* \brief          AES-CBC buffer encryption/decryption
@@ -235,13 +257,108 @@ int mbedtls_aes_crypt_cfb8(mbedtls_aes_context* ctx,
 	*/
 int mbedtls_aes_crypt_ctr(mbedtls_aes_context* ctx,
     uint32_t length,
-    uint32_t* nc_off,
+    size_t* nc_off,
     unsigned char nonce_counter[16],
     unsigned char stream_block[16],
     const unsigned char* input,
     unsigned char* output);
 #endif /* MBEDTLS_CIPHER_MODE_CTR */
 
+#if defined(MBEDTLS_CIPHER_MODE_GCM)
+/**
+	* \brief          AES-GCM context structure
+	*
+	* \note           The 4-bit tables are used by the portable GHASH, the
+	*                 powers of H by the carry-less multiply (PCLMULQDQ).
+	*/
+typedef struct
+{
+    uint64_t HL[16]; /*!<  precalculated HTable low      */
+    uint64_t HH[16]; /*!<  precalculated HTable high     */
+    unsigned char HP[4][16]; /*!<  H^1..H^4, byte reflected */
+    unsigned char base_ectr[16]; /*!<  first ECTR for the tag     */
+    unsigned char ectr[16]; /*!<  ECTR of a partial block     */
+    unsigned char y[16]; /*!<  next counter block           */
+    unsigned char buf[16]; /*!<  GHASH accumulator           */
+    uint64_t add_len; /*!<  total additional data length */
+    uint64_t len; /*!<  total text length             */
+    int mode; /*!<  MBEDTLS_AES_ENCRYPT or MBEDTLS_AES_DECRYPT */
+} mbedtls_aes_gcm_context;
+
+/**
+	* \brief          GCM key setup, derives the hash subkey
+	*
+	* \param gcm      GCM context to be initialized
+	* \param ctx      AES context with an encryption key schedule
+	*
+	* \return         0 if successful
+	*/
+int mbedtls_aes_gcm_setkey(mbedtls_aes_gcm_context* gcm,
+    mbedtls_aes_context* ctx);
+
+/**
+	* \brief          Start a GCM message
+	*
+	* \param gcm      GCM context
+	* \param ctx      AES context with an encryption key schedule
+	* \param mode     MBEDTLS_AES_ENCRYPT or MBEDTLS_AES_DECRYPT
+	* \param iv       initialization vector, 12 bytes is the common case
+	* \param iv_len   length of the initialization vector
+	*
+	* \return         0 if successful
+	*/
+int mbedtls_aes_gcm_starts(mbedtls_aes_gcm_context* gcm,
+    mbedtls_aes_context* ctx,
+    int mode,
+    const unsigned char* iv,
+    uint32_t iv_len);
+
+/**
+	* \brief          Feed additional (authenticated only) data, any
+	*                 number of times before the first mbedtls_aes_gcm_update
+	*
+	* \param gcm      GCM context
+	* \param length   length of the additional data
+	* \param add      buffer holding the additional data
+	*
+	* \return         0 if successful, or MBEDTLS_ERR_AES_GCM_BAD_INPUT
+	*/
+int mbedtls_aes_gcm_update_ad(mbedtls_aes_gcm_context* gcm,
+    uint32_t length,
+    const unsigned char* add);
+
+/**
+	* \brief          GCM buffer encryption/decryption, any length, any
+	*                 number of times
+	*
+	* \param gcm      GCM context
+	* \param ctx      AES context with an encryption key schedule
+	* \param length   length of the input data
+	* \param input    buffer holding the input data
+	* \param output   buffer holding the output data
+	*
+	* \return         0 if successful
+	*/
+int mbedtls_aes_gcm_update(mbedtls_aes_gcm_context* gcm,
+    mbedtls_aes_context* ctx,
+    uint32_t length,
+    const unsigned char* input,
+    unsigned char* output);
+
+/**
+	* \brief          Finish the GCM message and produce the tag
+	*
+	* \param gcm      GCM context
+	* \param tag      buffer for holding the tag
+	* \param tag_len  length of the tag to generate, 4 to 16 bytes
+	*
+	* \return         0 if successful, or MBEDTLS_ERR_AES_GCM_BAD_INPUT
+	*/
+int mbedtls_aes_gcm_finish(mbedtls_aes_gcm_context* gcm,
+    unsigned char* tag,
+    uint32_t tag_len);
+#endif /* MBEDTLS_CIPHER_MODE_GCM */
+
 #if defined(MBEDTLS_CIPHER_MODE_OFB)
 /**
 	* \brief               AES-OFB buffer encryption/decryption
@@ -33,7 +33,7 @@ namespace Crypto {
                 keyLength = HASHALGORITHM::Length;
 
                 // Calculate the Hash over the key to use that i.s.o. the actual key.
-                hashKey.Input(reinterpret_cast<const uint8_t*>(key.c_str()), static_cast<uint16_t>(key.length()));
+                hashKey.Input(reinterpret_cast<const uint8_t*>(key.c_str()), key.length());
                 encryptionKey = hashKey.Result();
             } else {
                 keyLength = static_cast<uint8_t>(key.length());
@@ -94,20 +94,20 @@ namespace Crypto {
         /*
          *  Provide input to HMACType
          */
-        inline void Input(const uint8_t message_array[], const uint16_t length)
+        inline void Input(const uint8_t message_array[], const uint64_t length)
         {
             _algorithm.Input(message_array, length);
         }
 
         inline HMACType<HASHALGORITHM>& operator<<(const uint8_t message_array[])
         {
-            uint16_t length = 0;
+            uint64_t length = 0;
 
             while (message_array[length] != '\0') {
                 length++;
             }
 
-            _algorithm.Input(&message_array, length);
+            _algorithm.Input(message_array, length);
 
             return (*this);
         }
@@ -45,6 +45,20 @@
 #include "Winsock2.h"
 #endif // __WIN32__
 
+// SHA-1 and SHA-2 (256) have instructions on x86 (SHA-NI) and on ARMv8 (Crypto Extensions). The
+// x86 ones are built along with the portable code and picked at runtime; the ARM ones need a
+// toolchain targeting the extensions and are still only used if the CPU reports them.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define __HASH_SHANI__
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__linux__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#include <arm_neon.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#define __HASH_ARMV8__
+#endif
+
 // --------------------------------------------------------------------------------------------
 // MD5 functionality
 // --------------------------------------------------------------------------------------------
@@ -101,6 +115,10 @@
 #define SHA384_DIGEST_SIZE (384 / 8)
 #define SHA512_DIGEST_SIZE (512 / 8)
 
+// Input is handed to the update functions in parts of at most this size, so their
+// 32 bit block counting never overflows.
+#define HASH_CHUNK_SIZE (1024 * 1024 * 1024)
+
 #define SHA256_BLOCK_SIZE (512 / 8)
 #define SHA512_BLOCK_SIZE (1024 / 8)
 #define SHA384_BLOCK_SIZE SHA512_BLOCK_SIZE
@@ -217,31 +235,53 @@ namespace Crypto {
  *  Comments:
  *
  */
-    void SHA1::Input(const uint8_t message_array[], const uint16_t length)
-    {
-        uint16_t counter = length;
-        const uint8_t* current = &(message_array[0]);
+    static void sha1_transf(uint32_t state[5], const uint8_t message[], unsigned int block_nb);
 
+    void SHA1::Input(const uint8_t message_array[], const uint64_t length)
+    {
         ASSERT((_computed == false) || (_corrupted == false));
 
-        while (counter-- && !_corrupted) {
-            _messageBlock[_messageIndex++] = *current;
+        // The length is kept in bytes, 29 bits in _lengthLow and the rest in _lengthHigh.
+        const uint64_t total = ((static_cast<uint64_t>(_lengthHigh) << 29) | _lengthLow) + length;
+
+        if ((total >> 61) != 0) {
+            _corrupted = true; // Message is too long
+        }
+
+        if (_corrupted == false) {
+            const uint8_t* current = &(message_array[0]);
+            uint64_t counter = length;
+
+            _lengthLow = (total & 0x1FFFFFFF);
+            _lengthHigh = static_cast<uint32_t>(total >> 29);
 
-            _lengthLow++;
-            if (_lengthLow == 0x20000000) {
-                _lengthLow = 0;
-                _lengthHigh++;
-                if (_lengthHigh == 0) {
-                    _corrupted = true; // Message is too long
+            if (_messageIndex != 0) {
+                const uint32_t part = (counter < (64 - _messageIndex) ? static_cast<uint32_t>(counter) : (64 - _messageIndex));
+
+                ::memcpy(&(_messageBlock[_messageIndex]), current, part);
+                _messageIndex += part;
+                current += part;
+                counter -= part;
+
+                if (_messageIndex == 64) {
+                    ProcessMessageBlock();
+                    _messageIndex = 0;
                 }
             }
 
-            if (_messageIndex == 64) {
-                ProcessMessageBlock();
-                _messageIndex = 0;
+            // Full blocks are processed straight from the input.
+            while (counter >= 64) {
+                const uint64_t blocks = ((counter >> 6) > 0x01000000 ? 0x01000000 : (counter >> 6));
+
+                sha1_transf(H, current, static_cast<unsigned int>(blocks));
+                current += (blocks << 6);
+                counter -= (blocks << 6);
             }
 
-            current++;
+            if (counter != 0) {
+                ::memcpy(&(_messageBlock[0]), current, static_cast<size_t>(counter));
+                _messageIndex = static_cast<uint32_t>(counter);
+            }
         }
     }
 
@@ -319,6 +359,16 @@ namespace Crypto {
  *
  */
     void SHA1::ProcessMessageBlock()
+    {
+        sha1_transf(H, _messageBlock, 1);
+    }
+
+    static inline uint32_t sha1_shift(const uint8_t bits, const uint32_t word)
+    {
+        return ((word << bits) | (word >> (32 - bits)));
+    }
+
+    static void sha1_transf_c(uint32_t state[5], const uint8_t message[], unsigned int block_nb)
     {
         const unsigned K[] = { // Constants defined for SHA-1
             0x5A827999,
@@ -331,71 +381,75 @@ namespace Crypto {
         unsigned W[80]; // Word sequence
         unsigned A, B, C, D, E; // Word buffers
 
-        /*
-     *  Initialize the first 16 words in the array W
-     */
-        for (t = 0; t < 16; t++) {
-            W[t] = ((unsigned)_messageBlock[t * 4]) << 24;
-            W[t] |= ((unsigned)_messageBlock[t * 4 + 1]) << 16;
-            W[t] |= ((unsigned)_messageBlock[t * 4 + 2]) << 8;
-            W[t] |= ((unsigned)_messageBlock[t * 4 + 3]);
-        }
+        while (block_nb-- != 0) {
+            /*
+         *  Initialize the first 16 words in the array W
+         */
+            for (t = 0; t < 16; t++) {
+                W[t] = ((unsigned)message[t * 4]) << 24;
+                W[t] |= ((unsigned)message[t * 4 + 1]) << 16;
+                W[t] |= ((unsigned)message[t * 4 + 2]) << 8;
+                W[t] |= ((unsigned)message[t * 4 + 3]);
+            }
 
-        for (t = 16; t < 80; t++) {
-            W[t] = CircularShift(1, W[t - 3] ^ W[t - 8] ^ W[t - 14] ^ W[t - 16]);
-        }
+            for (t = 16; t < 80; t++) {
+                W[t] = sha1_shift(1, W[t - 3] ^ W[t - 8] ^ W[t - 14] ^ W[t - 16]);
+            }
 
-        A = H[0];
-        B = H[1];
-        C = H[2];
-        D = H[3];
-        E = H[4];
-
-        for (t = 0; t < 20; t++) {
-            temp = CircularShift(5, A) + ((B & C) | ((~B) & D)) + E + W[t] + K[0];
-            temp &= 0xFFFFFFFF;
-            E = D;
-            D = C;
-            C = CircularShift(30, B);
-            B = A;
-            A = temp;
-        }
+            A = state[0];
+            B = state[1];
+            C = state[2];
+            D = state[3];
+            E = state[4];
+
+            for (t = 0; t < 20; t++) {
+                temp = sha1_shift(5, A) + ((B & C) | ((~B) & D)) + E + W[t] + K[0];
+                temp &= 0xFFFFFFFF;
+                E = D;
+                D = C;
+                C = sha1_shift(30, B);
+                B = A;
+                A = temp;
+            }
 
-        for (t = 20; t < 40; t++) {
-            temp = CircularShift(5, A) + (B ^ C ^ D) + E + W[t] + K[1];
-            temp &= 0xFFFFFFFF;
-            E = D;
-            D = C;
-            C = CircularShift(30, B);
-            B = A;
-            A = temp;
-        }
+            for (t = 20; t < 40; t++) {
+                temp = sha1_shift(5, A) + (B ^ C ^ D) + E + W[t] + K[1];
+                temp &= 0xFFFFFFFF;
+                E = D;
+                D = C;
+                C = sha1_shift(30, B);
+                B = A;
+                A = temp;
+            }
 
-        for (t = 40; t < 60; t++) {
-            temp = CircularShift(5, A) + ((B & C) | (B & D) | (C & D)) + E + W[t] + K[2];
-            temp &= 0xFFFFFFFF;
-            E = D;
-            D = C;
-            C = CircularShift(30, B);
-            B = A;
-            A = temp;
-        }
+            for (t = 40; t < 60; t++) {
+                temp = sha1_shift(5, A) + ((B & C) | (B & D) | (C & D)) + E + W[t] + K[2];
+                temp &= 0xFFFFFFFF;
+                E = D;
+                D = C;
+                C = sha1_shift(30, B);
+                B = A;
+                A = temp;
+            }
 
-        for (t = 60; t < 80; t++) {
-            temp = CircularShift(5, A) + (B ^ C ^ D) + E + W[t] + K[3];
-            temp &= 0xFFFFFFFF;
-            E = D;
-            D = C;
-            C = CircularShift(30, B);
-            B = A;
-            A = temp;
-        }
+            for (t = 60; t < 80; t++) {
+                temp = sha1_shift(5, A) + (B ^ C ^ D) + E + W[t] + K[3];
+                temp &= 0xFFFFFFFF;
+                E = D;
+                D = C;
+                C = sha1_shift(30, B);
+                B = A;
+                A = temp;
+            }
 
-        H[0] = (H[0] + A) & 0xFFFFFFFF;
-        H[1] = (H[1] + B) & 0xFFFFFFFF;
-        H[2] = (H[2] + C) & 0xFFFFFFFF;
-        H[3] = (H[3] + D) & 0xFFFFFFFF;
-        H[4] = (H[4] + E) & 0xFFFFFFFF;
+            state[0] = (state[0] + A) & 0xFFFFFFFF;
+            state[1] = (state[1] + B) & 0xFFFFFFFF;
+            state[2] = (state[2] + C) & 0xFFFFFFFF;
+            state[3] = (state[3] + D) & 0xFFFFFFFF;
+            state[4] = (state[4] + E) & 0xFFFFFFFF;
+
+            message += 64;
+        }
     }
 
     /*
@@ -660,18 +714,18 @@ namespace Crypto {
         _context.buffer[15] = _context.d >> 24;
     }
 
-    void MD5::Input(const uint8_t message_array[], const uint16_t length)
+    void MD5::Input(const uint8_t message_array[], const uint64_t length)
     {
-        uint16_t sizeToHandle = length;
+        uint64_t sizeToHandle = length;
         const uint8_t* source = &message_array[0];
 
         while (sizeToHandle > 0) {
-            if (sizeToHandle > 512) {
-                MD5_Update(&_context, source, 512);
-                source += 512;
-                sizeToHandle -= 512;
+            if (sizeToHandle > HASH_CHUNK_SIZE) {
+                MD5_Update(&_context, source, HASH_CHUNK_SIZE);
+                source += HASH_CHUNK_SIZE;
+                sizeToHandle -= HASH_CHUNK_SIZE;
             } else {
-                MD5_Update(&_context, source, sizeToHandle);
+                MD5_Update(&_context, source, static_cast<unsigned long>(sizeToHandle));
                 sizeToHandle = 0;
             }
         }
@@ -823,7 +877,7 @@ namespace Crypto {
     // --------------------------------------------------------------------------------------------
     // SHA256 functionality
     // --------------------------------------------------------------------------------------------
-    static void sha256_transf(SHA256::Context* ctx, const unsigned char* message, unsigned int block_nb)
+    static void sha256_transf_c(uint32_t state[8], const unsigned char* message, unsigned int block_nb)
     {
         uint32_t w[64];
         uint32_t wv[8];
@@ -848,7 +902,7 @@ namespace Crypto {
             }
 
             for (j = 0; j < 8; j++) {
-                wv[j] = ctx->h[j];
+                wv[j] = state[j];
             }
 
             for (j = 0; j < 64; j++) {
@@ -866,7 +920,7 @@ namespace Crypto {
             }
 
             for (j = 0; j < 8; j++) {
-                ctx->h[j] += wv[j];
+                state[j] += wv[j];
             }
 #else
             PACK32(&sub_block[0], &w[0]);
@@ -935,14 +989,14 @@ namespace Crypto {
             SHA256_SCR(62);
             SHA256_SCR(63);
 
-            wv[0] = ctx->h[0];
-            wv[1] = ctx->h[1];
-            wv[2] = ctx->h[2];
-            wv[3] = ctx->h[3];
-            wv[4] = ctx->h[4];
-            wv[5] = ctx->h[5];
-            wv[6] = ctx->h[6];
-            wv[7] = ctx->h[7];
+            wv[0] = state[0];
+            wv[1] = state[1];
+            wv[2] = state[2];
+            wv[3] = state[3];
+            wv[4] = state[4];
+            wv[5] = state[5];
+            wv[6] = state[6];
+            wv[7] = state[7];
 
             SHA256_EXP(0, 1, 2, 3, 4, 5, 6, 7, 0);
             SHA256_EXP(7, 0, 1, 2, 3, 4, 5, 6, 1);
@@ -1009,18 +1063,265 @@ namespace Crypto {
             SHA256_EXP(2, 3, 4, 5, 6, 7, 0, 1, 62);
             SHA256_EXP(1, 2, 3, 4, 5, 6, 7, 0, 63);
 
-            ctx->h[0] += wv[0];
-            ctx->h[1] += wv[1];
-            ctx->h[2] += wv[2];
-            ctx->h[3] += wv[3];
-            ctx->h[4] += wv[4];
-            ctx->h[5] += wv[5];
-            ctx->h[6] += wv[6];
-            ctx->h[7] += wv[7];
+            state[0] += wv[0];
+            state[1] += wv[1];
+            state[2] += wv[2];
+            state[3] += wv[3];
+            state[4] += wv[4];
+            state[5] += wv[5];
+            state[6] += wv[6];
+            state[7] += wv[7];
 #endif /* !UNROLL_LOOPS */
         }
     }
 
+#if defined(__HASH_SHANI__)
+    // Intel SHA extensions, after the public domain reference code by Jeffrey Walton. The
+    // instructions keep the state as {A,B,E,F} and {C,D,G,H}, the message words big endian.
+    __attribute__((target("sha,sse4.1,ssse3"))) static void sha1_transf_shani(uint32_t state[5], const uint8_t message[], unsigned int block_nb)
+    {
+        const __m128i swap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+        __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1B);
+        __m128i e0 = _mm_set_epi32(state[4], 0, 0, 0);
+
+        while (block_nb-- != 0) {
+            const __m128i abcdSave = abcd;
+            const __m128i eSave = e0;
+            __m128i w[4];
+            __m128i previous = abcd;
+            __m128i e = e0;
+
+            for (uint8_t group = 0; group < 20; group++) {
+                __m128i& word = w[group & 0x3];
+
+                if (group < 4) {
+                    word = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&message[group << 4])), swap);
+                } else {
+                    word = _mm_sha1msg2_epu32(_mm_xor_si128(_mm_sha1msg1_epu32(word, w[(group + 1) & 0x3]), w[(group + 2) & 0x3]), w[(group + 3) & 0x3]);
+                }
+
+                e = (group == 0 ? _mm_add_epi32(e0, word) : _mm_sha1nexte_epu32(previous, word));
+                previous = abcd;
+
+                switch (group / 5) {
+                case 0:
+                    abcd = _mm_sha1rnds4_epu32(abcd, e, 0);
+                    break;
+                case 1:
+                    abcd = _mm_sha1rnds4_epu32(abcd, e, 1);
+                    break;
+                case 2:
+                    abcd = _mm_sha1rnds4_epu32(abcd, e, 2);
+                    break;
+                default:
+                    abcd = _mm_sha1rnds4_epu32(abcd, e, 3);
+                    break;
+                }
+            }
+
+            e0 = _mm_sha1nexte_epu32(previous, eSave);
+            abcd = _mm_add_epi32(abcd, abcdSave);
+            message += 64;
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+        state[4] = _mm_extract_epi32(e0, 3);
+    }
+
+    __attribute__((target("sha,sse4.1,ssse3"))) static void sha256_transf_shani(uint32_t state[8], const unsigned char* message, unsigned int block_nb)
+    {
+        const __m128i swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+        const __m128i cdab = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0])), 0xB1);
+        const __m128i efgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4])), 0x1B);
+        __m128i state0 = _mm_alignr_epi8(cdab, efgh, 8); // ABEF
+        __m128i state1 = _mm_blend_epi16(efgh, cdab, 0xF0); // CDGH
+
+        while (block_nb-- != 0) {
+            const __m128i abefSave = state0;
+            const __m128i cdghSave = state1;
+            __m128i w[4];
+
+            for (uint8_t group = 0; group < 4; group++) {
+                w[group] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&message[group << 4])), swap);
+            }
+
+            for (uint8_t group = 0; group < 16; group++) {
+                __m128i& word = w[group & 0x3];
+                const __m128i schedule = _mm_add_epi32(word, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&sha256_k[group << 2])));
+
+                state1 = _mm_sha256rnds2_epu32(state1, state0, schedule);
+                state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(schedule, 0x0E));
+
+                if (group < 12) {
+                    // W[16..63], four at a time, from the four groups before.
+                    const __m128i added = _mm_add_epi32(_mm_sha256msg1_epu32(word, w[(group + 1) & 0x3]), _mm_alignr_epi8(w[(group + 3) & 0x3], w[(group + 2) & 0x3], 4));
+                    word = _mm_sha256msg2_epu32(added, w[(group + 3) & 0x3]);
+                }
+            }
+
+            state0 = _mm_add_epi32(state0, abefSave);
+            state1 = _mm_add_epi32(state1, cdghSave);
+            message += 64;
+        }
+
+        const __m128i feba = _mm_shuffle_epi32(state0, 0x1B);
+        const __m128i dchg = _mm_shuffle_epi32(state1, 0xB1);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(feba, dchg, 0xF0)); // DCBA
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(dchg, feba, 8)); // HGFE
+    }
+
+    static bool sha_supported()
+    {
+        uint32_t eax, ebx, ecx, edx;
+        bool result = false;
+
+        if ((__get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0) && ((ecx & bit_SSE4_1) != 0) && ((ecx & bit_SSSE3) != 0) && (__get_cpuid_max(0, nullptr) >= 7)) {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            result = ((ebx & (1 << 29)) != 0);
+        }
+
+        return (result);
+    }
+
+    static bool sha1_supported()
+    {
+        return (sha_supported());
+    }
+
+    static bool sha256_supported()
+    {
+        return (sha_supported());
+    }
+
+#define sha1_transf_accelerated sha1_transf_shani
+#define sha256_transf_accelerated sha256_transf_shani
+#endif
+
+#if defined(__HASH_ARMV8__)
+    // ARMv8 Crypto Extensions, the state is kept in its natural order, the message words big endian.
+    static void sha1_transf_armv8(uint32_t state[5], const uint8_t message[], unsigned int block_nb)
+    {
+        const uint32_t K[] = { 0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6 };
+        uint32x4_t abcd = vld1q_u32(&state[0]);
+        uint32_t e0 = state[4];
+
+        while (block_nb-- != 0) {
+            const uint32x4_t abcdSave = abcd;
+            const uint32_t eSave = e0;
+            uint32x4_t w[4];
+            uint32_t e = e0;
+
+            for (uint8_t group = 0; group < 20; group++) {
+                uint32x4_t& word = w[group & 0x3];
+
+                if (group < 4) {
+                    word = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(&message[group << 4])));
+                } else {
+                    word = vsha1su1q_u32(vsha1su0q_u32(word, w[(group + 1) & 0x3], w[(group + 2) & 0x3]), w[(group + 3) & 0x3]);
+                }
+
+                const uint32x4_t schedule = vaddq_u32(word, vdupq_n_u32(K[group / 5]));
+                const uint32_t next = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+
+                if (group < 5) {
+                    abcd = vsha1cq_u32(abcd, e, schedule);
+                } else if ((group >= 10) && (group < 15)) {
+                    abcd = vsha1mq_u32(abcd, e, schedule);
+                } else {
+                    abcd = vsha1pq_u32(abcd, e, schedule);
+                }
+
+                e = next;
+            }
+
+            e0 = e + eSave;
+            abcd = vaddq_u32(abcd, abcdSave);
+            message += 64;
+        }
+
+        vst1q_u32(&state[0], abcd);
+        state[4] = e0;
+    }
+
+    static void sha256_transf_armv8(uint32_t state[8], const unsigned char* message, unsigned int block_nb)
+    {
+        uint32x4_t state0 = vld1q_u32(&state[0]);
+        uint32x4_t state1 = vld1q_u32(&state[4]);
+
+        while (block_nb-- != 0) {
+            const uint32x4_t abcdSave = state0;
+            const uint32x4_t efghSave = state1;
+            uint32x4_t w[4];
+
+            for (uint8_t group = 0; group < 4; group++) {
+                w[group] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(&message[group << 4])));
+            }
+
+            for (uint8_t group = 0; group < 16; group++) {
+                uint32x4_t& word = w[group & 0x3];
+                const uint32x4_t schedule = vaddq_u32(word, vld1q_u32(&sha256_k[group << 2]));
+                const uint32x4_t previous = state0;
+
+                state0 = vsha256hq_u32(state0, state1, schedule);
+                state1 = vsha256h2q_u32(state1, previous, schedule);
+
+                if (group < 12) {
+                    word = vsha256su1q_u32(vsha256su0q_u32(word, w[(group + 1) & 0x3]), w[(group + 2) & 0x3], w[(group + 3) & 0x3]);
+                }
+            }
+
+            state0 = vaddq_u32(state0, abcdSave);
+            state1 = vaddq_u32(state1, efghSave);
+            message += 64;
+        }
+
+        vst1q_u32(&state[0], state0);
+        vst1q_u32(&state[4], state1);
+    }
+
+    static bool sha1_supported()
+    {
+        return ((getauxval(AT_HWCAP) & HWCAP_SHA1) != 0);
+    }
+
+    static bool sha256_supported()
+    {
+        return ((getauxval(AT_HWCAP) & HWCAP_SHA2) != 0);
+    }
+
+#define sha1_transf_accelerated sha1_transf_armv8
+#define sha256_transf_accelerated sha256_transf_armv8
+#endif
+
+    static void sha1_transf(uint32_t state[5], const uint8_t message[], unsigned int block_nb)
+    {
+#if defined(sha1_transf_accelerated)
+        static const bool accelerated = sha1_supported();
+
+        if (accelerated == true) {
+            sha1_transf_accelerated(state, message, block_nb);
+        } else
+#endif
+        {
+            sha1_transf_c(state, message, block_nb);
+        }
+    }
+
+    static void sha256_transf(SHA256::Context* ctx, const unsigned char* message, unsigned int block_nb)
+    {
+#if defined(sha256_transf_accelerated)
+        static const bool accelerated = sha256_supported();
+
+        if (accelerated == true) {
+            sha256_transf_accelerated(ctx->h, message, block_nb);
+        } else
+#endif
+        {
+            sha256_transf_c(ctx->h, message, block_nb);
+        }
+    }
+
     void SHA256::Reset()
     {
 #ifndef UNROLL_LOOPS
@@ -1081,7 +1382,7 @@ namespace Crypto {
     {
         unsigned int block_nb;
         unsigned int pm_len;
-        unsigned int len_b;
+        uint64_t len_b;
 
 #ifndef UNROLL_LOOPS
         int i;
@@ -1094,7 +1395,7 @@ namespace Crypto {
 
         memset(_context.block + _context.len, 0, pm_len - _context.len);
         _context.block[_context.len] = 0x80;
-        UNPACK32(len_b, _context.block + pm_len - 4);
+        UNPACK64(len_b, _context.block + pm_len - 8);
 
         sha256_transf(&_context, _context.block, block_nb);
 
@@ -1114,18 +1415,18 @@ namespace Crypto {
 #endif /* !UNROLL_LOOPS */
     }
 
-    void SHA256::Input(const uint8_t message_array[], const uint16_t length)
+    void SHA256::Input(const uint8_t message_array[], const uint64_t length)
     {
-        uint16_t sizeToHandle = length;
+        uint64_t sizeToHandle = length;
         const uint8_t* source = &message_array[0];
 
         while (sizeToHandle > 0) {
-            if (sizeToHandle > SHA256_BLOCK_SIZE) {
-                sha256_update(&_context, source, SHA256_BLOCK_SIZE);
-                source += SHA256_BLOCK_SIZE;
-                sizeToHandle -= SHA256_BLOCK_SIZE;
+            if (sizeToHandle > HASH_CHUNK_SIZE) {
+                sha256_update(&_context, source, HASH_CHUNK_SIZE);
+                source += HASH_CHUNK_SIZE;
+                sizeToHandle -= HASH_CHUNK_SIZE;
             } else {
-                sha256_update(&_context, source, sizeToHandle);
+                sha256_update(&_context, source, static_cast<unsigned int>(sizeToHandle));
                 sizeToHandle = 0;
             }
         }
@@ -1249,7 +1550,7 @@ namespace Crypto {
     {
         unsigned int block_nb;
         unsigned int pm_len;
-        unsigned int len_b;
+        uint64_t len_b;
 
 #ifndef UNROLL_LOOPS
         int i;
@@ -1262,7 +1563,7 @@ namespace Crypto {
 
         memset(_context.block + _context.len, 0, pm_len - _context.len);
         _context.block[_context.len] = 0x80;
-        UNPACK32(len_b, _context.block + pm_len - 4);
+        UNPACK64(len_b, _context.block + pm_len - 8);
 
         sha256_transf(&_context, _context.block, block_nb);
 
@@ -1281,18 +1582,18 @@ namespace Crypto {
 #endif /* !UNROLL_LOOPS */
     }
 
-    void SHA224::Input(const uint8_t message_array[], const uint16_t length)
+    void SHA224::Input(const uint8_t message_array[], const uint64_t length)
     {
-        uint16_t sizeToHandle = length;
+        uint64_t sizeToHandle = length;
         const uint8_t* source = &message_array[0];
 
         while (sizeToHandle > 0) {
-            if (sizeToHandle > SHA224_BLOCK_SIZE) {
-                sha224_update(&_context, source, SHA224_BLOCK_SIZE);
-                source += SHA224_BLOCK_SIZE;
-                sizeToHandle -= SHA224_BLOCK_SIZE;
+            if (sizeToHandle > HASH_CHUNK_SIZE) {
+                sha224_update(&_context, source, HASH_CHUNK_SIZE);
+                source += HASH_CHUNK_SIZE;
+                sizeToHandle -= HASH_CHUNK_SIZE;
             } else {
-                sha224_update(&_context, source, sizeToHandle);
+                sha224_update(&_context, source, static_cast<unsigned int>(sizeToHandle));
                 sizeToHandle = 0;
             }
         }
@@ -1583,7 +1884,7 @@ namespace Crypto {
     {
         unsigned int block_nb;
         unsigned int pm_len;
-        unsigned int len_b;
+        uint64_t len_b;
 
 #ifndef UNROLL_LOOPS
         int i;
@@ -1596,7 +1897,7 @@ namespace Crypto {
 
         memset(_context.block + _context.len, 0, pm_len - _context.len);
         _context.block[_context.len] = 0x80;
-        UNPACK32(len_b, _context.block + pm_len - 4);
+        UNPACK64(len_b, _context.block + pm_len - 8);
 
         sha512_transf(&_context, _context.block, block_nb);
 
@@ -1616,18 +1917,18 @@ namespace Crypto {
 #endif /* !UNROLL_LOOPS */
     }
 
-    void SHA512::Input(const uint8_t message_array[], const uint16_t length)
+    void SHA512::Input(const uint8_t message_array[], const uint64_t length)
     {
-        uint16_t sizeToHandle = length;
+        uint64_t sizeToHandle = length;
         const uint8_t* source = &message_array[0];
 
         while (sizeToHandle > 0) {
-            if (sizeToHandle > SHA512_BLOCK_SIZE) {
-                sha512_update(&_context, source, SHA512_BLOCK_SIZE);
-                source += SHA512_BLOCK_SIZE;
-                sizeToHandle -= SHA512_BLOCK_SIZE;
+            if (sizeToHandle > HASH_CHUNK_SIZE) {
+                sha512_update(&_context, source, HASH_CHUNK_SIZE);
+                source += HASH_CHUNK_SIZE;
+                sizeToHandle -= HASH_CHUNK_SIZE;
             } else {
-                sha512_update(&_context, source, sizeToHandle);
+                sha512_update(&_context, source, static_cast<unsigned int>(sizeToHandle));
                 sizeToHandle = 0;
             }
         }
@@ -1752,7 +2053,7 @@ namespace Crypto {
     {
         unsigned int block_nb;
         unsigned int pm_len;
-        unsigned int len_b;
+        uint64_t len_b;
 
 #ifndef UNROLL_LOOPS
         int i;
@@ -1765,7 +2066,7 @@ namespace Crypto {
 
         memset(_context.block + _context.len, 0, pm_len - _context.len);
         _context.block[_context.len] = 0x80;
-        UNPACK32(len_b, _context.block + pm_len - 4);
+        UNPACK64(len_b, _context.block + pm_len - 8);
 
         sha512_transf(&_context, _context.block, block_nb);
 
@@ -1783,18 +2084,18 @@ namespace Crypto {
 #endif /* !UNROLL_LOOPS */
     }
 
-    void SHA384::Input(const uint8_t message_array[], const uint16_t length)
+    void SHA384::Input(const uint8_t message_array[], const uint64_t length)
     {
-        uint16_t sizeToHandle = length;
+        uint64_t sizeToHandle = length;
         const uint8_t* source = &message_array[0];
 
         while (sizeToHandle > 0) {
-            if (sizeToHandle > SHA384_BLOCK_SIZE) {
-                sha384_update(&_context, source, SHA384_BLOCK_SIZE);
-                source += SHA384_BLOCK_SIZE;
-                sizeToHandle -= SHA384_BLOCK_SIZE;
+            if (sizeToHandle > HASH_CHUNK_SIZE) {
+                sha384_update(&_context, source, HASH_CHUNK_SIZE);
+                source += HASH_CHUNK_SIZE;
+                sizeToHandle -= HASH_CHUNK_SIZE;
             } else {
-                sha384_update(&_context, source, sizeToHandle);
+                sha384_update(&_context, source, static_cast<unsigned int>(sizeToHandle));
                 sizeToHandle = 0;
             }
         }
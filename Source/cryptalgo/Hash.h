@@ -90,7 +90,7 @@ namespace Crypto {
         {
             Reset();
         }
-        inline SHA1(const uint8_t message_array[], const uint16_t length)
+        inline SHA1(const uint8_t message_array[], const uint64_t length)
         {
             Reset();
 
@@ -137,7 +137,7 @@ namespace Crypto {
         /*
          *  Provide input to SHA1
          */
-        void Input(const uint8_t message_array[], const uint16_t length);
+        void Input(const uint8_t message_array[], const uint64_t length);
 
         SHA1& operator<<(const uint8_t message_array[]);
         SHA1& operator<<(const uint8_t message_element);
@@ -206,7 +206,7 @@ namespace Crypto {
         {
             Reset();
         }
-        inline MD5(const uint8_t message_array[], const uint16_t length)
+        inline MD5(const uint8_t message_array[], const uint64_t length)
         {
             Reset();
 
@@ -252,7 +252,7 @@ namespace Crypto {
         /*
          *  Provide input to MD5
          */
-        void Input(const uint8_t message_array[], const uint16_t length);
+        void Input(const uint8_t message_array[], const uint64_t length);
 
         MD5& operator<<(const uint8_t message_array[]);
         MD5& operator<<(const uint8_t message_element);
@@ -269,7 +269,7 @@ namespace Crypto {
     class EXTERNAL SHA256 {
     public:
         typedef struct {
-            uint32_t tot_len;
+            uint64_t tot_len;
             uint32_t len;
             uint8_t block[2 * (512 / 8)];
             uint32_t h[8];
@@ -284,7 +284,7 @@ namespace Crypto {
         {
             Reset();
         }
-        inline SHA256(const uint8_t message_array[], const uint16_t length)
+        inline SHA256(const uint8_t message_array[], const uint64_t length)
         {
             Reset();
 
@@ -311,7 +311,7 @@ namespace Crypto {
         /*
          *  Provide input to SHA1
          */
-        void Input(const uint8_t message_array[], const uint16_t length);
+        void Input(const uint8_t message_array[], const uint64_t length);
 
         SHA256& operator<<(const uint8_t message_array[]);
         SHA256& operator<<(const uint8_t message_element);
@@ -334,7 +334,7 @@ namespace Crypto {
         {
             Reset();
         }
-        inline SHA224(const uint8_t message_array[], const uint16_t length)
+        inline SHA224(const uint8_t message_array[], const uint64_t length)
         {
             Reset();
 
@@ -361,7 +361,7 @@ namespace Crypto {
         /*
          *  Provide input to SHA224
          */
-        void Input(const uint8_t message_array[], const uint16_t length);
+        void Input(const uint8_t message_array[], const uint64_t length);
 
         SHA224& operator<<(const uint8_t message_array[]);
         SHA224& operator<<(const uint8_t message_element);
@@ -377,7 +377,7 @@ namespace Crypto {
     class EXTERNAL SHA512 {
     public:
         typedef struct {
-            uint32_t tot_len;
+            uint64_t tot_len;
             uint32_t len;
             uint8_t block[2 * (1024 / 8)];
             uint64_t h[8];
@@ -392,7 +392,7 @@ namespace Crypto {
         {
             Reset();
         }
-        inline SHA512(const uint8_t message_array[], const uint16_t length)
+        inline SHA512(const uint8_t message_array[], const uint64_t length)
         {
             Reset();
 
@@ -419,7 +419,7 @@ namespace Crypto {
         /*
          *  Provide input to SHA512
          */
-        void Input(const uint8_t message_array[], const uint16_t length);
+        void Input(const uint8_t message_array[], const uint64_t length);
 
         SHA512& operator<<(const uint8_t message_array[]);
         SHA512& operator<<(const uint8_t message_element);
@@ -442,7 +442,7 @@ namespace Crypto {
         {
             Reset();
         }
-        inline SHA384(const uint8_t message_array[], const uint16_t length)
+        inline SHA384(const uint8_t message_array[], const uint64_t length)
         {
             Reset();
 
@@ -469,7 +469,7 @@ namespace Crypto {
         /*
          *  Provide input to SHA384
          */
-        void Input(const uint8_t message_array[], const uint16_t length);
+        void Input(const uint8_t message_array[], const uint64_t length);
 
         SHA384& operator<<(const uint8_t message_array[]);
         SHA384& operator<<(const uint8_t message_element);
@@ -481,6 +481,22 @@ namespace Crypto {
         SHA512::Context _context;
         mutable bool _computed; // Is the digest computed?
     };
+
+    // Hash the content of a file. The file is mapped in memory and handed over in one go, instead
+    // of being read and fed in small pieces.
+    template <typename HASHALGORITHM>
+    bool HashFile(const string& fileName, HASHALGORITHM& hash)
+    {
+        Core::DataElementFile file(fileName, Core::DataElementFile::READABLE);
+
+        bool result = file.IsValid();
+
+        if (result == true) {
+            hash.Input(file.Buffer(), file.Size());
+        }
+
+        return (result);
+    }
 }
 }
 
@@ -20,13 +20,13 @@ namespace Crypto {
 
         virtual EnumHashType Type() const = 0;
         virtual void Reset() = 0;
-        virtual uint8_t* Result() = 0;
+        virtual const uint8_t* Result() = 0;
         virtual uint8_t Length() const = 0;
-        virtual void Input(const uint8_t block, const uint16_t length) = 0;
+        virtual void Input(const uint8_t block[], const uint64_t length) = 0;
     };
 
     template <typename HASHALGORITHM, const enum EnumHashType TYPE>
-    class HashStreamType {
+    class HashStreamType : public IHashStream {
         private :
             HashStreamType(const HashStreamType<HASHALGORITHM, TYPE>&);
         HashStreamType<HASHALGORITHM, TYPE> &
@@ -34,23 +34,29 @@ namespace Crypto {
 
         public :
             // For Hash streaming
-            HashStreamType();
+            HashStreamType()
+            : _hash()
+        {
+        }
 
         // For HMAC streaming
-        HashStreamType(const Core::TextFragment& key);
+        HashStreamType(const Core::TextFragment& key)
+            : _hash(key.Text())
+        {
+        }
 
         public :
             virtual void Reset(){
                 _hash.Reset(); }
-    virtual uint8_t* Result()
+    virtual const uint8_t* Result()
     {
         return (_hash.Result());
     }
     virtual uint8_t Length() const
     {
-        return (HASHALGORITHM::Length());
+        return (HASHALGORITHM::Length);
     }
-    virtual void Input(const uint8_t block[], const uint16_t length)
+    virtual void Input(const uint8_t block[], const uint64_t length)
     {
         _hash.Input(block, length);
     }
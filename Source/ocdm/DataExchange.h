@@ -4,19 +4,39 @@
 // ---- Include local include files ----
 #include <core/core.h>
 
+#include <atomic>
+
 // ---- Referenced classes and types ----
 
 // ---- Helper types and constants ----
 
 namespace OCDM {
 
+// The buffer is shared in one of two layouts, the producer (the decrypting side) picks one:
+// - A single slot: one sample at a time, the clients take turns using the producer/consumer
+//   semaphores of the SharedBuffer.
+// - A ring of slots: the buffer holds a number of equal slots, each with its own sample info,
+//   subsample map, status and "decrypted" semaphore. A slot takes a sample as large as the
+//   single slot layout of that size takes, samples are never split over slots. Clients queue samples in any free slot,
+//   the decrypting side takes them in order of submission, with as many threads as it likes.
+//   A client can also Allocate() a slot up front, fill it and have it decrypted in place.
+// The ring administration starts with a magic, where the single slot one has its status, so
+// a consumer can tell which one it attached to.
 class DataExchange : public WPEFramework::Core::SharedBuffer {
 private:
     DataExchange() = delete;
     DataExchange(const DataExchange&) = delete;
     DataExchange& operator=(const DataExchange&) = delete;
 
+public:
+    enum : uint8_t {
+        MaxSlots = 16,
+        NoSlot = 0xFF
+    };
+
 private:
+    static constexpr uint32_t RingMagic = 0x4F43524E; /* "OCRN" */
+
     struct Administration {
         uint32_t Status;
         uint8_t KeyId[17];
@@ -27,20 +47,105 @@ private:
         bool InitWithLast15;
     };
 
+    enum slotState : uint32_t {
+        SLOT_FREE,
+        SLOT_ALLOCATED,
+        SLOT_QUEUED,
+        SLOT_DECRYPTING,
+        SLOT_DECRYPTED
+    };
+
+    struct SlotAdministration {
+        std::atomic<uint32_t> State;
+        std::atomic<bool> Orphaned;
+        uint32_t Sequence;
+        uint32_t Status;
+        uint32_t Length;
+        uint8_t KeyId[17];
+        uint8_t IVLength;
+        uint8_t IV[24];
+        uint16_t SubLength;
+        uint8_t Sub[2048];
+        bool InitWithLast15;
+#ifndef __WIN32__
+        sem_t Decrypted;
+#endif
+    };
+
+    struct RingAdministration {
+        uint32_t Magic;
+        uint32_t Slots;
+        uint32_t SlotSize;
+        std::atomic<uint32_t> Sequence;
+#ifndef __WIN32__
+        sem_t Free;
+        sem_t Queued;
+#endif
+        SlotAdministration Slot[MaxSlots];
+    };
+
+    static_assert(sizeof(RingAdministration) <= 0xFFFF, "The administration space is limited to 64KB");
+
 public:
     DataExchange(const string& name)
         : WPEFramework::Core::SharedBuffer(name.c_str())
+        , _ring(reinterpret_cast<RingAdministration*>(AdministrationBuffer()))
+        , _free()
+        , _queued()
+        , _decrypted()
     {
+        if (_ring->Magic == RingMagic) {
+            Attach(name);
+        } else {
+            _ring = nullptr;
+        }
     }
     DataExchange(const string& name, const uint32_t bufferSize)
         : WPEFramework::Core::SharedBuffer(name.c_str(), bufferSize,
               sizeof(Administration))
+        , _ring(nullptr)
+        , _free()
+        , _queued()
+        , _decrypted()
     {
         Administration* admin = reinterpret_cast<Administration*>(AdministrationBuffer());
         // Clear the administration space before using it.
         ::memset(admin, 0, sizeof(Administration));
     }
-    ~DataExchange() {}
+    // The ring layout, with slots of bufferSize each. The shared buffer is that many times larger.
+    DataExchange(const string& name, const uint32_t bufferSize, const uint8_t slots)
+        : WPEFramework::Core::SharedBuffer(name.c_str(), Aligned(bufferSize) * RingSlots(slots),
+              sizeof(RingAdministration))
+        , _ring(reinterpret_cast<RingAdministration*>(AdministrationBuffer()))
+        , _free()
+        , _queued()
+        , _decrypted()
+    {
+        ASSERT((slots > 0) && (slots <= MaxSlots));
+
+        // Clear the administration space before using it.
+        ::memset(static_cast<void*>(_ring), 0, sizeof(RingAdministration));
+
+        _ring->Slots = RingSlots(slots);
+        _ring->SlotSize = Aligned(bufferSize);
+
+#ifndef __WIN32__
+        sem_init(&(_ring->Free), 1, _ring->Slots);
+        sem_init(&(_ring->Queued), 1, 0);
+        for (uint8_t index = 0; index < _ring->Slots; index++) {
+            sem_init(&(_ring->Slot[index].Decrypted), 1, 0);
+        }
+#endif
+        _ring->Magic = RingMagic;
+
+        Attach(name);
+    }
+    ~DataExchange()
+    {
+        for (WPEFramework::Core::SharedBuffer::Semaphore* semaphore : _decrypted) {
+            delete semaphore;
+        }
+    }
 
 public:
     inline void Status(uint32_t status)
@@ -119,6 +224,261 @@ public:
         ASSERT(length <= 16);
         return (length > 0 ? &admin->KeyId[1] : nullptr);
     }
+
+public:
+    // ---- Ring layout ----
+    inline bool IsRing() const
+    {
+        return (_ring != nullptr);
+    }
+    inline uint8_t Slots() const
+    {
+        return (_ring != nullptr ? static_cast<uint8_t>(_ring->Slots) : 0);
+    }
+    inline uint32_t SlotSize() const
+    {
+        return (_ring != nullptr ? _ring->SlotSize : 0);
+    }
+    inline uint8_t* Data(const uint8_t slot)
+    {
+        ASSERT(slot < Slots());
+        return (&(Buffer()[slot * _ring->SlotSize]));
+    }
+    inline const uint8_t* Data(const uint8_t slot) const
+    {
+        ASSERT(slot < Slots());
+        return (&(Buffer()[slot * _ring->SlotSize]));
+    }
+    // The slot of a buffer handed out by Allocate(), NoSlot if it is not in this ring.
+    uint8_t Slot(const uint8_t buffer[]) const
+    {
+        uint8_t result = NoSlot;
+
+        if ((_ring != nullptr) && (buffer >= Buffer()) && (buffer < &(Buffer()[_ring->Slots * _ring->SlotSize]))) {
+            result = static_cast<uint8_t>((buffer - Buffer()) / _ring->SlotSize);
+
+            ASSERT(buffer == Data(result));
+        }
+
+        return (result);
+    }
+
+    // Client side: claim a slot for a sample of the given length.
+    uint8_t* Allocate(const uint32_t length, const uint32_t waitTime)
+    {
+        uint8_t* result = nullptr;
+
+        ASSERT(_ring != nullptr);
+
+        if ((length <= _ring->SlotSize) && (_free->Lock(waitTime) == WPEFramework::Core::ERROR_NONE)) {
+            // The semaphore guarantees there is a free slot, just find it.
+            uint8_t index = 0;
+
+            while (result == nullptr) {
+                uint32_t expected = SLOT_FREE;
+
+                if (_ring->Slot[index].State.compare_exchange_strong(expected, SLOT_ALLOCATED) == true) {
+                    result = Data(index);
+                } else {
+                    index = ((index + 1) % _ring->Slots);
+                }
+            }
+        }
+
+        return (result);
+    }
+    void Release(const uint8_t buffer[])
+    {
+        const uint8_t slot = Slot(buffer);
+
+        ASSERT(slot != NoSlot);
+
+        SlotAdministration& admin(_ring->Slot[slot]);
+
+        if (admin.State.load() == SLOT_ALLOCATED) {
+            admin.State.store(SLOT_FREE);
+            _free->Unlock();
+        } else {
+            // A Decrypt that timed out, the decrypting side still owns the slot. Whoever of the two
+            // takes the orphan mark back, frees it.
+            admin.Orphaned.store(true);
+
+            if ((admin.State.load() == SLOT_DECRYPTED) && (admin.Orphaned.exchange(false) == true)) {
+                // Completed, but it did not see the mark, take the signal it gives (or gave) nobody.
+                _decrypted[slot]->Lock(WPEFramework::Core::infinite);
+
+                admin.State.store(SLOT_FREE);
+                _free->Unlock();
+            }
+        }
+    }
+    // Client side: have an allocated slot decrypted, in place. Blocks till it is done, other
+    // threads can have their samples decrypted at the same time. On a timeout, the slot stays
+    // with the decrypting side till it is Completed, it can only be Release()d from then on.
+    uint32_t Decrypt(const uint8_t buffer[], const uint32_t length,
+        const uint8_t ivLength, const uint8_t iv[],
+        const uint8_t keyIdLength, const uint8_t keyId[],
+        const uint16_t subSampleLength, const uint8_t subSample[],
+        const bool initWithLast15, const uint32_t waitTime)
+    {
+        const uint8_t slot = Slot(buffer);
+        uint32_t result = WPEFramework::Core::ERROR_INVALID_INPUT_LENGTH;
+
+        ASSERT(slot != NoSlot);
+
+        if ((slot != NoSlot) && (length <= _ring->SlotSize)) {
+            SlotAdministration& admin(_ring->Slot[slot]);
+
+            ASSERT(admin.State.load() == SLOT_ALLOCATED);
+            ASSERT(ivLength <= sizeof(SlotAdministration::IV));
+            ASSERT(keyIdLength <= 16);
+
+            admin.Length = length;
+            admin.IVLength = std::min(ivLength, static_cast<uint8_t>(sizeof(SlotAdministration::IV)));
+            ::memset(admin.IV, 0, sizeof(admin.IV));
+            if (iv != nullptr) {
+                ::memcpy(admin.IV, iv, admin.IVLength);
+            }
+            admin.KeyId[0] = std::min(keyIdLength, static_cast<uint8_t>(16));
+            if (admin.KeyId[0] != 0) {
+                ::memcpy(&(admin.KeyId[1]), keyId, admin.KeyId[0]);
+            }
+            admin.SubLength = std::min(subSampleLength, static_cast<uint16_t>(sizeof(SlotAdministration::Sub)));
+            if (subSample != nullptr) {
+                ::memcpy(admin.Sub, subSample, admin.SubLength);
+            }
+            admin.InitWithLast15 = initWithLast15;
+            admin.Sequence = _ring->Sequence.fetch_add(1);
+            admin.State.store(SLOT_QUEUED);
+
+            _queued->Unlock();
+
+            result = _decrypted[slot]->Lock(waitTime);
+
+            if (result == WPEFramework::Core::ERROR_NONE) {
+                ASSERT(admin.State.load() == SLOT_DECRYPTED);
+
+                result = admin.Status;
+                admin.State.store(SLOT_ALLOCATED);
+            }
+        }
+
+        return (result);
+    }
+
+    // Decrypting side: wait for the oldest queued sample, NoSlot if none came in time.
+    uint8_t Next(const uint32_t waitTime)
+    {
+        uint8_t result = NoSlot;
+
+        ASSERT(_ring != nullptr);
+
+        if (_queued->Lock(waitTime) == WPEFramework::Core::ERROR_NONE) {
+            // The semaphore guarantees there is a queued slot, more decrypting threads may be
+            // looking for it as well.
+            while (result == NoSlot) {
+                uint8_t oldest = NoSlot;
+
+                for (uint8_t index = 0; index < _ring->Slots; index++) {
+                    if ((_ring->Slot[index].State.load() == SLOT_QUEUED) && ((oldest == NoSlot) || (static_cast<int32_t>(_ring->Slot[index].Sequence - _ring->Slot[oldest].Sequence) < 0))) {
+                        oldest = index;
+                    }
+                }
+
+                if (oldest != NoSlot) {
+                    uint32_t expected = SLOT_QUEUED;
+
+                    if (_ring->Slot[oldest].State.compare_exchange_strong(expected, SLOT_DECRYPTING) == true) {
+                        result = oldest;
+                    }
+                }
+            }
+        }
+
+        return (result);
+    }
+    void Completed(const uint8_t slot, const uint32_t status)
+    {
+        ASSERT(slot < Slots());
+        ASSERT(_ring->Slot[slot].State.load() == SLOT_DECRYPTING);
+
+        _ring->Slot[slot].Status = status;
+        _ring->Slot[slot].State.store(SLOT_DECRYPTED);
+
+        if (_ring->Slot[slot].Orphaned.exchange(false) == true) {
+            // The client gave up on it and released it already.
+            _ring->Slot[slot].State.store(SLOT_FREE);
+            _free->Unlock();
+        } else {
+            _decrypted[slot]->Unlock();
+        }
+    }
+    inline uint32_t Length(const uint8_t slot) const
+    {
+        ASSERT(slot < Slots());
+        return (_ring->Slot[slot].Length);
+    }
+    inline bool InitWithLast15(const uint8_t slot) const
+    {
+        ASSERT(slot < Slots());
+        return (_ring->Slot[slot].InitWithLast15);
+    }
+    inline const uint8_t* IVKey(const uint8_t slot) const
+    {
+        ASSERT(slot < Slots());
+        return (_ring->Slot[slot].IV);
+    }
+    inline uint8_t IVKeyLength(const uint8_t slot) const
+    {
+        ASSERT(slot < Slots());
+        return (_ring->Slot[slot].IVLength);
+    }
+    const uint8_t* KeyId(const uint8_t slot, uint8_t& length) const
+    {
+        ASSERT(slot < Slots());
+        length = _ring->Slot[slot].KeyId[0];
+        return (length > 0 ? &(_ring->Slot[slot].KeyId[1]) : nullptr);
+    }
+    const uint8_t* SubSampleData(const uint8_t slot, uint16_t& length) const
+    {
+        ASSERT(slot < Slots());
+        length = _ring->Slot[slot].SubLength;
+        return (length > 0 ? _ring->Slot[slot].Sub : nullptr);
+    }
+
+private:
+    static uint8_t RingSlots(const uint8_t slots)
+    {
+        return (std::min(std::max(slots, static_cast<uint8_t>(1)), static_cast<uint8_t>(MaxSlots)));
+    }
+    // Cache line aligned slots, so clients and decryptors working on neighbours do not collide.
+    static uint32_t Aligned(const uint32_t bufferSize)
+    {
+        return ((bufferSize + 0x3F) & ~0x3F);
+    }
+    void Attach(const string& name)
+    {
+#ifdef __WIN32__
+        // Same counts as the POSIX ones in the administration get.
+        _free.reset(new WPEFramework::Core::SharedBuffer::Semaphore((name + ".free").c_str(), _ring->Slots, _ring->Slots));
+        _queued.reset(new WPEFramework::Core::SharedBuffer::Semaphore((name + ".queued").c_str(), 0, _ring->Slots));
+        for (uint8_t index = 0; index < _ring->Slots; index++) {
+            _decrypted.push_back(new WPEFramework::Core::SharedBuffer::Semaphore((name + ".decrypted" + WPEFramework::Core::NumberType<uint8_t>(index).Text()).c_str(), 0, 1));
+        }
+#else
+        _free.reset(new WPEFramework::Core::SharedBuffer::Semaphore(&(_ring->Free)));
+        _queued.reset(new WPEFramework::Core::SharedBuffer::Semaphore(&(_ring->Queued)));
+        for (uint8_t index = 0; index < _ring->Slots; index++) {
+            _decrypted.push_back(new WPEFramework::Core::SharedBuffer::Semaphore(&(_ring->Slot[index].Decrypted)));
+        }
+#endif
+    }
+
+private:
+    RingAdministration* _ring;
+    std::unique_ptr<WPEFramework::Core::SharedBuffer::Semaphore> _free;
+    std::unique_ptr<WPEFramework::Core::SharedBuffer::Semaphore> _queued;
+    std::vector<WPEFramework::Core::SharedBuffer::Semaphore*> _decrypted;
 };
 
 } // namespace OCDM
@@ -659,3 +659,27 @@ OpenCDMError opencdm_session_decrypt(struct OpenCDMSession* session,
     return (result);
 }
 
+uint8_t* opencdm_session_allocate_buffer(struct OpenCDMSession* session,
+    const uint32_t length)
+{
+    uint8_t* result = nullptr;
+
+    if (session != nullptr) {
+        result = session->AllocateBuffer(length);
+    }
+
+    return (result);
+}
+
+OpenCDMError opencdm_session_release_buffer(struct OpenCDMSession* session,
+    const uint8_t buffer[])
+{
+    OpenCDMError result(ERROR_INVALID_SESSION);
+
+    if (session != nullptr) {
+        result = static_cast<OpenCDMError>(session->ReleaseBuffer(buffer));
+    }
+
+    return (result);
+}
+
@@ -488,6 +488,29 @@ OpenCDMError opencdm_session_decrypt(struct OpenCDMSession* session,
     uint32_t initWithLast15);
 #endif // __cplusplus
 
+/**
+ * \brief Allocates a buffer in the memory shared with the decrypting side.
+ *
+ * Encrypted data written in this buffer and passed to \ref opencdm_session_decrypt
+ * is decrypted in place, without copying it in and out of the shared memory.
+ * Only available if the DRM system decrypts through a ring of buffers, which
+ * also lets multiple threads decrypt at the same time.
+ * \param session \ref OpenCDMSession instance.
+ * \param length Length of the buffer (in bytes).
+ * \return The buffer, NULL if not available (fall back to a buffer of your own).
+ */
+uint8_t* opencdm_session_allocate_buffer(struct OpenCDMSession* session,
+    const uint32_t length);
+
+/**
+ * Returns a buffer obtained by \ref opencdm_session_allocate_buffer.
+ * \param session \ref OpenCDMSession instance.
+ * \param buffer The buffer to release.
+ * \return Zero on success, non-zero on error.
+ */
+OpenCDMError opencdm_session_release_buffer(struct OpenCDMSession* session,
+    const uint8_t buffer[]);
+
 #ifdef __cplusplus
 }
 #endif
@@ -587,6 +587,10 @@ private:
         {
             int ret = 0;
 
+            if (IsRing() == true) {
+                return (DecryptSlot(encryptedData, encryptedDataLength, ivData, ivDataLength, keyId, keyIdLength, initWithLast15));
+            }
+
             // This works, because we know that the Audio and the Video streams are
             // fed from
             // the same process, so they will use the same critial section and thus
@@ -632,6 +636,40 @@ private:
             return (ret);
         }
 
+    private:
+        // Samples of different threads are decrypted concurrently, each in its own slot, so
+        // the _systemLock is not needed here.
+        uint32_t DecryptSlot(uint8_t* encryptedData, uint32_t encryptedDataLength,
+            const uint8_t* ivData, uint16_t ivDataLength,
+            const uint8_t* keyId, uint16_t keyIdLength,
+            uint32_t initWithLast15)
+        {
+            uint32_t ret = WPEFramework::Core::ERROR_INVALID_INPUT_LENGTH;
+
+            // Data handed out by Allocate() is decrypted in place, anything else is copied
+            // through a free slot.
+            const bool inPlace = (Slot(encryptedData) != NoSlot);
+            uint8_t* buffer = (inPlace == true ? encryptedData : Allocate(encryptedDataLength, WPEFramework::Core::infinite));
+
+            if (buffer != nullptr) {
+                if (inPlace == false) {
+                    ::memcpy(buffer, encryptedData, encryptedDataLength);
+                }
+
+                ret = OCDM::DataExchange::Decrypt(buffer, encryptedDataLength,
+                    static_cast<uint8_t>(ivDataLength), ivData,
+                    static_cast<uint8_t>(keyIdLength), keyId,
+                    0, nullptr, (initWithLast15 != 0), WPEFramework::Core::infinite);
+
+                if (inPlace == false) {
+                    ::memcpy(encryptedData, buffer, encryptedDataLength);
+                    Release(buffer);
+                }
+            }
+
+            return (ret);
+        }
+
     private:
         bool _busy;
     };
@@ -739,6 +777,27 @@ public:
         }
         return (result);
     }
+    // Only available if the decrypting side offers a ring, the buffer can be filled and
+    // passed to Decrypt() to have it decrypted without copying.
+    uint8_t* AllocateBuffer(const uint32_t length)
+    {
+        uint8_t* result = nullptr;
+
+        if ((_decryptSession != nullptr) && (_decryptSession->IsRing() == true)) {
+            result = _decryptSession->Allocate(length, WPEFramework::Core::infinite);
+        }
+        return (result);
+    }
+    uint32_t ReleaseBuffer(const uint8_t buffer[])
+    {
+        uint32_t result = OpenCDMError::ERROR_INVALID_DECRYPT_BUFFER;
+
+        if ((_decryptSession != nullptr) && (_decryptSession->Slot(buffer) != OCDM::DataExchange::NoSlot)) {
+            result = OpenCDMError::ERROR_NONE;
+            _decryptSession->Release(buffer);
+        }
+        return (result);
+    }
     inline void Revoke(OCDM::ISession::ICallback* callback)
     {
 
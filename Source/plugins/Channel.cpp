@@ -4,6 +4,10 @@ namespace WPEFramework {
 namespace PluginHost {
 
     /* static */ RequestPool Channel::_requestAllocator(10);
+    /* static */ Channel::Backpressure Channel::_defaultBackpressure;
+    /* static */ Web::WebSocket::Compression Channel::_defaultCompression;
+    /* static */ bool Channel::_defaultEncoding = false;
+    /* static */ constexpr uint32_t Channel::Package::ResponseFlag;
 
 #ifdef __WIN32__
 #pragma warning(disable : 4355)
@@ -19,7 +23,13 @@ namespace PluginHost {
         , _text()
         , _offset(0)
         , _sendQueue()
+        , _backpressure(_defaultBackpressure)
+        , _queuedBytes(0)
+        , _dropped(0)
+        , _coalesced(0)
+        , _congested(false)
     {
+        BaseClass::Compression(_defaultCompression);
     }
 #ifdef __WIN32__
 #pragma warning(default : 4355)
@@ -11,19 +11,33 @@ namespace PluginHost {
     private:
         typedef Web::WebSocketLinkType<Core::SocketStream, Request, Web::Response, RequestPool&> BaseClass;
 
-        union EXTERNAL Package {
+        class EXTERNAL Package {
         private:
             Package() = delete;
             Package(const Package&) = delete;
             Package& operator=(const Package&) = delete;
 
         public:
-            explicit Package(const Core::ProxyType<Core::JSON::IElement>& json)
+            explicit Package(const Core::ProxyType<Core::JSON::IElement>& json, const string& designator, const uint32_t size, const bool response)
                 : _json(json)
+                , _text()
+                , _designator(designator)
+                , _size(size | (response ? ResponseFlag : 0))
             {
             }
             explicit Package(const string& text)
-                : _text(text)
+                : _json()
+                , _text(text)
+                , _designator()
+                , _size(static_cast<uint32_t>(text.length()))
+            {
+            }
+            // JSON that is already serialized, it goes out as text.
+            explicit Package(string&& text, const string& designator, const bool response)
+                : _json()
+                , _text(std::move(text))
+                , _designator(designator)
+                , _size(static_cast<uint32_t>(_text.length()) | (response ? ResponseFlag : 0))
             {
             }
             ~Package()
@@ -39,10 +53,35 @@ namespace PluginHost {
             {
                 return (_json);
             }
+            // Events for the same designator can replace each other, empty if it should not be coalesced.
+            const string& Designator() const
+            {
+                return (_designator);
+            }
+            uint32_t Size() const
+            {
+                return (_size & (~ResponseFlag));
+            }
+            // A response (it carries an id) is awaited by the client, it is never dropped.
+            bool IsResponse() const
+            {
+                return ((_size & ResponseFlag) != 0);
+            }
+            void Swap(Package& other)
+            {
+                std::swap(_json, other._json);
+                _text.swap(other._text);
+                _designator.swap(other._designator);
+                std::swap(_size, other._size);
+            }
 
         private:
+            static constexpr uint32_t ResponseFlag = 0x80000000;
+
             Core::ProxyType<Core::JSON::IElement> _json;
             string _text;
+            string _designator;
+            uint32_t _size;
         };
         class EXTERNAL SerializerImpl {
         public:
@@ -145,6 +184,77 @@ namespace PluginHost {
             JSONRPC = 0x20
         };
 
+        // What to do with new data if the send queue of a channel has reached its high watermark.
+        enum overflow {
+            COALESCE, // Replace the queued event with the same designator, drop the oldest event if there is none.
+            DROPOLDEST, // Drop the oldest queued events till the low watermark is reached.
+            DISCONNECT // The client can not keep up, close the channel.
+        };
+
+        class EXTERNAL Backpressure {
+        public:
+            Backpressure()
+                : HighBytes(0)
+                , LowBytes(0)
+                , HighMessages(0)
+                , LowMessages(0)
+                , Policy(COALESCE)
+            {
+            }
+            // A high watermark of 0 means no limit, a low watermark of 0 defaults to 3/4 of the high one.
+            Backpressure(const uint32_t highBytes, const uint32_t lowBytes, const uint32_t highMessages, const uint32_t lowMessages, const overflow policy)
+                : HighBytes(highBytes)
+                , LowBytes(((lowBytes == 0) || (lowBytes > highBytes)) ? ((highBytes / 4) * 3) : lowBytes)
+                , HighMessages(highMessages)
+                , LowMessages(((lowMessages == 0) || (lowMessages > highMessages)) ? ((highMessages / 4) * 3) : lowMessages)
+                , Policy(policy)
+            {
+            }
+            Backpressure(const Backpressure& copy)
+                : HighBytes(copy.HighBytes)
+                , LowBytes(copy.LowBytes)
+                , HighMessages(copy.HighMessages)
+                , LowMessages(copy.LowMessages)
+                , Policy(copy.Policy)
+            {
+            }
+            ~Backpressure()
+            {
+            }
+
+            Backpressure& operator=(const Backpressure& RHS)
+            {
+                HighBytes = RHS.HighBytes;
+                LowBytes = RHS.LowBytes;
+                HighMessages = RHS.HighMessages;
+                LowMessages = RHS.LowMessages;
+                Policy = RHS.Policy;
+
+                return (*this);
+            }
+
+        public:
+            inline bool IsSet() const
+            {
+                return ((HighBytes != 0) || (HighMessages != 0));
+            }
+            inline bool Above(const uint32_t bytes, const uint32_t messages) const
+            {
+                return (((HighBytes != 0) && (bytes > HighBytes)) || ((HighMessages != 0) && (messages > HighMessages)));
+            }
+            inline bool Below(const uint32_t bytes, const uint32_t messages) const
+            {
+                return (((HighBytes == 0) || (bytes <= LowBytes)) && ((HighMessages == 0) || (messages <= LowMessages)));
+            }
+
+        public:
+            uint32_t HighBytes;
+            uint32_t LowBytes;
+            uint32_t HighMessages;
+            uint32_t LowMessages;
+            overflow Policy;
+        };
+
     public:
         Channel() = delete;
         Channel(const Channel& copy) = delete;
@@ -199,30 +309,37 @@ namespace PluginHost {
 
                 _sendQueue.emplace_back(text);
 
-                bool trigger = (_sendQueue.size() == 1);
-
-                _adminLock.Unlock();
-
-                if (trigger == true) {
-                    BaseClass::Trigger();
-                }
+                Enqueued();
             }
         }
         inline void Submit(const Core::ProxyType<Core::JSON::IElement>& entry)
         {
             if (IsOpen() == true) {
+                const Core::JSONRPC::Message* message = dynamic_cast<const Core::JSONRPC::Message*>(&(*entry));
+                const Core::JSONRPC::Notification* notification = (message == nullptr ? dynamic_cast<const Core::JSONRPC::Notification*>(&(*entry)) : nullptr);
+                const bool response((message != nullptr) && (message->Id.IsSet() == true));
 
-                _adminLock.Lock();
+                // Only notifications (no id) can be coalesced or dropped, responses are always delivered.
+                const string& designator((message != nullptr) && (response == false) ? message->Designator.Value() : (notification != nullptr ? notification->Designator() : EMPTY_STRING));
 
-                _sendQueue.emplace_back(entry);
+                if ((notification != nullptr) || (_backpressure.HighBytes == 0)) {
+                    // Shared frames know their size up front, without a byte limit the size is not used.
+                    const uint32_t size = (notification != nullptr ? notification->Length() : 0);
 
-                bool trigger = (_sendQueue.size() == 1);
+                    _adminLock.Lock();
 
-                _adminLock.Unlock();
+                    _sendQueue.emplace_back(entry, designator, size, response);
+                } else {
+                    // The size is only known by serializing it, so send what was serialized.
+                    string text;
+                    entry->ToString(text);
+
+                    _adminLock.Lock();
 
-                if (trigger == true) {
-                    BaseClass::Trigger();
+                    _sendQueue.emplace_back(std::move(text), designator, response);
                 }
+
+                Enqueued();
             }
         }
         inline void Submit(const Core::ProxyType<Web::Response>& entry)
@@ -233,12 +350,71 @@ namespace PluginHost {
         {
             BaseClass::Trigger();
         }
+        inline Backpressure Limits() const
+        {
+            _adminLock.Lock();
+            Backpressure result(_backpressure);
+            _adminLock.Unlock();
+
+            return (result);
+        }
+        inline void Limits(const Backpressure& limits)
+        {
+            _adminLock.Lock();
+            _backpressure = limits;
+            _adminLock.Unlock();
+        }
+        inline uint32_t QueueDepth() const
+        {
+            _adminLock.Lock();
+            uint32_t result = static_cast<uint32_t>(_sendQueue.size());
+            _adminLock.Unlock();
+
+            return (result);
+        }
+        inline uint32_t QueueBytes() const
+        {
+            return (_queuedBytes);
+        }
+        inline uint32_t Dropped() const
+        {
+            return (_dropped);
+        }
+        inline uint32_t Coalesced() const
+        {
+            return (_coalesced);
+        }
+
+        // The limits every new channel starts with.
+        static void DefaultLimits(const Backpressure& limits)
+        {
+            _defaultBackpressure = limits;
+        }
+        // The WebSocket compression every new channel offers.
+        static void DefaultCompression(const Web::WebSocket::Compression& compression)
+        {
+            _defaultCompression = compression;
+        }
+        // Encode (gzip/deflate) the HTTP response bodies for clients that accept it.
+        static void DefaultEncoding(const bool enabled)
+        {
+            _defaultEncoding = enabled;
+        }
 
     protected:
         inline void SetId(const uint32_t id)
         {
             _ID = id;
         }
+        // The response to this request goes out in an encoding the request accepts. Pipelined
+        // requests are answered in order, each response takes the choice of its own request.
+        // HTTP/1.0 does not know chunked bodies, so nothing is encoded on the fly for such a request.
+        inline void Accepts(const Web::Request& request)
+        {
+            const bool chunking = ((request.MajorVersion > 1) || ((request.MajorVersion == 1) && (request.MinorVersion >= 1)));
+
+            BaseClass::ContentEncoding(((_defaultEncoding == true) && (request.AcceptEncoding.IsSet() == true)) ? request.AcceptEncoding.Value() : Web::ENCODING_UNKNOWN, chunking);
+        }
         inline void Lock() const
         {
             _adminLock.Lock();
@@ -265,6 +441,11 @@ namespace PluginHost {
                 switch (State()) {
                 case JSON:
                 case JSONRPC: {
+                    if ((_serializer.IsIdle() == true) && (IsSerialized() == true)) {
+                        size = SerializeText(dataFrame, maxSendSize);
+                        break;
+                    }
+
                     // Seems we are sending JSON structs
                     size = _serializer.Serialize(reinterpret_cast<char*>(dataFrame), maxSendSize);
 
@@ -272,7 +453,7 @@ namespace PluginHost {
 
                         // See if there is more to do..
                         _adminLock.Lock();
-                        _sendQueue.pop_front();
+                        Dequeue();
                         bool trigger(_sendQueue.size() > 0);
                         _adminLock.Unlock();
 
@@ -287,27 +468,7 @@ namespace PluginHost {
                 }
                 case TEXT: {
                     // Seems we need to send plain strings...
-                    _adminLock.Lock();
-                    Package& data(_sendQueue.front());
-                    uint16_t neededBytes(static_cast<uint16_t>(data.Text().length() - _offset));
-
-                    if (neededBytes <= maxSendSize) {
-                        ::memcpy(dataFrame, &(data.Text().c_str()[_offset]), neededBytes);
-                        size = neededBytes;
-                        _offset = 0;
-
-                        // See if there is more to do..
-                        _sendQueue.pop_front();
-                    } else {
-                        uint16_t addedBytes = maxSendSize - size;
-                        ::memcpy(dataFrame, &(data.Text().c_str()[_offset]), addedBytes);
-                        _offset += addedBytes;
-                        size = addedBytes;
-                    }
-                    _adminLock.Unlock();
-
-                    ASSERT(size != 0);
-
+                    size = SerializeText(dataFrame, maxSendSize);
                     break;
                 }
                 case CLOSED:
@@ -388,6 +549,111 @@ namespace PluginHost {
         virtual bool IsIdle() const
         {
             return ((BaseClass::IsWebSocket() == false) || ((_serializer.IsIdle() == true) && (_deserializer.IsIdle() == true)));
+        }
+        inline bool IsSerialized() const
+        {
+            _adminLock.Lock();
+            bool result = ((_sendQueue.size() > 0) && (_sendQueue.front().JSON().IsValid() == false));
+            _adminLock.Unlock();
+
+            return (result);
+        }
+        uint16_t SerializeText(uint8_t* dataFrame, const uint16_t maxSendSize)
+        {
+            uint16_t size;
+
+            _adminLock.Lock();
+
+            const string& text(_sendQueue.front().Text());
+            const uint32_t neededBytes(static_cast<uint32_t>(text.length()) - _offset);
+
+            if (neededBytes <= maxSendSize) {
+                ::memcpy(dataFrame, &(text.c_str()[_offset]), neededBytes);
+                size = static_cast<uint16_t>(neededBytes);
+                _offset = 0;
+
+                // See if there is more to do..
+                Dequeue();
+            } else {
+                ::memcpy(dataFrame, &(text.c_str()[_offset]), maxSendSize);
+                _offset += maxSendSize;
+                size = maxSendSize;
+            }
+
+            _adminLock.Unlock();
+
+            ASSERT(size != 0);
+
+            return (size);
+        }
+        // Expects the _adminLock to be taken, releases it.
+        void Enqueued()
+        {
+            bool disconnect = false;
+            const bool trigger = (_sendQueue.size() == 1);
+
+            _queuedBytes += _sendQueue.back().Size();
+
+            if ((_congested == true) || (_backpressure.Above(_queuedBytes, static_cast<uint32_t>(_sendQueue.size())) == true)) {
+                _congested = true;
+
+                // The front is (about to be) on its way out, it is never touched.
+                if ((_backpressure.Policy == COALESCE) && (_sendQueue.back().Designator().empty() == false) && (_sendQueue.size() > 2)) {
+                    std::list<Package>::iterator latest(std::prev(_sendQueue.end()));
+                    std::list<Package>::iterator index(std::next(_sendQueue.begin()));
+
+                    while ((index != latest) && (index->Designator() != latest->Designator())) {
+                        index++;
+                    }
+
+                    if (index != latest) {
+                        // Keep the position of the old one, but with the latest content.
+                        index->Swap(*latest);
+                        _queuedBytes -= latest->Size();
+                        _sendQueue.pop_back();
+                        _coalesced++;
+                    }
+                }
+
+                if (_backpressure.Above(_queuedBytes, static_cast<uint32_t>(_sendQueue.size())) == true) {
+                    if (_backpressure.Policy != DISCONNECT) {
+                        // Drop the oldest notifications, a client waits for its responses.
+                        std::list<Package>::iterator index(std::next(_sendQueue.begin()));
+
+                        while ((index != _sendQueue.end()) && (_backpressure.Below(_queuedBytes, static_cast<uint32_t>(_sendQueue.size())) == false)) {
+                            if (index->IsResponse() == true) {
+                                index++;
+                            } else {
+                                _queuedBytes -= index->Size();
+                                index = _sendQueue.erase(index);
+                                _dropped++;
+                            }
+                        }
+                    }
+
+                    // Still above it, so it is all responses the client does not read.
+                    disconnect = (_backpressure.Above(_queuedBytes, static_cast<uint32_t>(_sendQueue.size())) == true);
+                }
+            }
+
+            _adminLock.Unlock();
+
+            if (disconnect == true) {
+                TRACE_L1("Channel %d can not keep up with its send queue, closing it.", _ID);
+                BaseClass::Close(0);
+            } else if (trigger == true) {
+                BaseClass::Trigger();
+            }
+        }
+        // Expects the _adminLock to be taken.
+        void Dequeue()
+        {
+            _queuedBytes -= _sendQueue.front().Size();
+            _sendQueue.pop_front();
+
+            if ((_congested == true) && (_backpressure.Below(_queuedBytes, static_cast<uint32_t>(_sendQueue.size())) == true)) {
+                _congested = false;
+            }
         }
 		Core::ProxyType<Core::JSON::IElement> Element() {
             Core::ProxyType<Core::JSON::IElement> result;
@@ -413,6 +679,15 @@ namespace PluginHost {
         string _text;
         uint32_t _offset;
         std::list<Package> _sendQueue;
+        Backpressure _backpressure;
+        uint32_t _queuedBytes;
+        uint32_t _dropped;
+        uint32_t _coalesced;
+        bool _congested;
+
+        static Backpressure _defaultBackpressure;
+        static Web::WebSocket::Compression _defaultCompression;
+        static bool _defaultEncoding;
 
         // All requests needed by any instance of this webserver are coming from this web server. They are extracted
         // from a pool. If the request is nolonger needed, the request returns to this pool.
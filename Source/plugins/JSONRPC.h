@@ -19,6 +19,14 @@ namespace PluginHost {
         virtual void Activate(IShell* service) = 0;
         virtual void Deactivate() = 0;
         virtual void Closed(const uint32_t channelId) = 0;
+
+        // The object the "params" for this designator should be parsed in to, if known, so the framework can
+        // deserialize them straight from the inbound frame. If none is returned, they are kept as text.
+        // Added last, to keep the layout of the existing entries.
+        virtual Core::ProxyType<Core::JSON::IElement> Parameters(const string& /* designator */)
+        {
+            return (Core::ProxyType<Core::JSON::IElement>());
+        }
     };
 
     class EXTERNAL JSONRPC : public IDispatcher {
@@ -68,14 +76,14 @@ namespace PluginHost {
         {
             std::vector<uint8_t> versions = { 1 };
 
-            _handlers.emplace_back([&](const uint32_t id, const string& designator, const string& data) { Notify(id, designator, data); }, versions);
+            _handlers.emplace_back([&](const uint32_t id, const string& designator, const string& data) { Notify(id, designator, data); }, [&](const uint32_t id, const string& designator, const Core::ProxyType<Core::JSONRPC::Frame>& frame) { Notify(id, designator, frame); }, versions);
         }
         JSONRPC(const std::vector<uint8_t> versions)
             : _adminLock()
             , _handlers()
             , _service(nullptr)
         {
-            _handlers.emplace_back([&](const uint32_t id, const string& designator, const string& data) { Notify(id, designator, data); }, versions);
+            _handlers.emplace_back([&](const uint32_t id, const string& designator, const string& data) { Notify(id, designator, data); }, [&](const uint32_t id, const string& designator, const Core::ProxyType<Core::JSONRPC::Frame>& frame) { Notify(id, designator, frame); }, versions);
         }
         virtual ~JSONRPC()
         {
@@ -111,12 +119,12 @@ namespace PluginHost {
         }
         Core::JSONRPC::Handler& CreateHandler(const std::vector<uint8_t>& versions)
         {
-            _handlers.emplace_back([&](const uint32_t id, const string& designator, const string& data) { Notify(id, designator, data); }, versions);
+            _handlers.emplace_back([&](const uint32_t id, const string& designator, const string& data) { Notify(id, designator, data); }, [&](const uint32_t id, const string& designator, const Core::ProxyType<Core::JSONRPC::Frame>& frame) { Notify(id, designator, frame); }, versions);
             return (_handlers.back());
         }
         Core::JSONRPC::Handler& CreateHandler(const std::vector<uint8_t>& versions, const Core::JSONRPC::Handler& source)
         {
-            _handlers.emplace_back([&](const uint32_t id, const string& designator, const string& data) { Notify(id, designator, data); }, versions, source);
+            _handlers.emplace_back([&](const uint32_t id, const string& designator, const string& data) { Notify(id, designator, data); }, [&](const uint32_t id, const string& designator, const Core::ProxyType<Core::JSONRPC::Frame>& frame) { Notify(id, designator, frame); }, versions, source);
             return (_handlers.back());
         }
         Core::JSONRPC::Handler* GetHandler(uint8_t version)
@@ -281,14 +289,15 @@ namespace PluginHost {
                 }
                 break;
             case STATE_CUSTOM:
-                string result;
-                uint32_t code = source->Invoke(Core::JSONRPC::Connection(channelId, inbound.Id.Value()), inbound.FullMethod(), inbound.Parameters.Value(), result);
+                // Results are written into the response directly, a notification (no id) has nowhere to put them.
+                Core::JSONRPC::Message::Payload discard;
+                Core::JSONRPC::Message::Payload& result(response.IsValid() == true ? response->Result : discard);
+                uint32_t code = source->Invoke(Core::JSONRPC::Connection(channelId, inbound.Id.Value()), inbound.FullMethod(), inbound.Parameters, result);
                 if (response.IsValid() == true) {
                     if (code == static_cast<uint32_t>(~0)) {
                         response.Release();
-                    } else if (code == Core::ERROR_NONE) {
-                        response->Result = result;
-                    } else {
+                    } else if (code != Core::ERROR_NONE) {
+                        response->Result.Clear();
                         response->Error.Code = code;
                         response->Error.Text = Core::ErrorToString(code);
                     }
@@ -297,6 +306,17 @@ namespace PluginHost {
 
             return response;
         }
+        virtual Core::ProxyType<Core::JSON::IElement> Parameters(const string& designator) override
+        {
+            Core::ProxyType<Core::JSON::IElement> result;
+            Core::JSONRPC::Handler* source = nullptr;
+
+            if (Destination(designator, source) == STATE_CUSTOM) {
+                result = source->Parameters(Core::JSONRPC::Message::FullMethod(designator));
+            }
+
+            return (result);
+        }
 
     private:
         state Destination(const string& designator, Core::JSONRPC::Handler*& source)
@@ -355,6 +375,16 @@ namespace PluginHost {
 
             _service->Submit(id, message);
         }
+        void Notify(const uint32_t id, const string& designator, const Core::ProxyType<Core::JSONRPC::Frame>& frame)
+        {
+            Core::ProxyType<Core::JSONRPC::Notification> message(_notificationFactory.Element());
+
+            ASSERT(_service != nullptr);
+
+            message->Set(frame, designator);
+
+            _service->Submit(id, Core::proxy_cast<Core::JSON::IElement>(message));
+        }
         virtual void Activate(IShell* service) override
         {
             ASSERT(_service == nullptr);
@@ -392,6 +422,7 @@ namespace PluginHost {
         string _callsign;
 
         static Core::ProxyPoolType<Web::JSONBodyType<Core::JSONRPC::Message>> _jsonRPCMessageFactory;
+        static Core::ProxyPoolType<Core::JSONRPC::Notification> _notificationFactory;
     };
 
     class EXTERNAL JSONRPCSupportsEventStatus : public JSONRPC {
@@ -133,6 +133,10 @@ ENUM_CONVERSION_BEGIN(PluginHost::MetaData::Channel::state)
         Core::JSON::Container::Add(_T("activity"), &Activity);
         Core::JSON::Container::Add(_T("id"), &ID);
         Core::JSON::Container::Add(_T("name"), &Name);
+        Core::JSON::Container::Add(_T("depth"), &Depth);
+        Core::JSON::Container::Add(_T("bytes"), &Bytes);
+        Core::JSON::Container::Add(_T("dropped"), &Dropped);
+        Core::JSON::Container::Add(_T("coalesced"), &Coalesced);
     }
     MetaData::Channel::Channel(const MetaData::Channel& copy)
         : Core::JSON::Container()
@@ -141,12 +145,20 @@ ENUM_CONVERSION_BEGIN(PluginHost::MetaData::Channel::state)
         , Activity(copy.Activity)
         , ID(copy.ID)
         , Name(copy.Name)
+        , Depth(copy.Depth)
+        , Bytes(copy.Bytes)
+        , Dropped(copy.Dropped)
+        , Coalesced(copy.Coalesced)
     {
         Core::JSON::Container::Add(_T("remote"), &Remote);
         Core::JSON::Container::Add(_T("state"), &JSONState);
         Core::JSON::Container::Add(_T("activity"), &Activity);
         Core::JSON::Container::Add(_T("id"), &ID);
         Core::JSON::Container::Add(_T("name"), &Name);
+        Core::JSON::Container::Add(_T("depth"), &Depth);
+        Core::JSON::Container::Add(_T("bytes"), &Bytes);
+        Core::JSON::Container::Add(_T("dropped"), &Dropped);
+        Core::JSON::Container::Add(_T("coalesced"), &Coalesced);
     }
     MetaData::Channel::~Channel()
     {
@@ -159,6 +171,10 @@ ENUM_CONVERSION_BEGIN(PluginHost::MetaData::Channel::state)
         Activity = RHS.Activity;
         ID = RHS.ID;
         Name = RHS.Name;
+        Depth = RHS.Depth;
+        Bytes = RHS.Bytes;
+        Dropped = RHS.Dropped;
+        Coalesced = RHS.Coalesced;
 
         return (*this);
     }
@@ -202,11 +218,64 @@ ENUM_CONVERSION_BEGIN(PluginHost::MetaData::Channel::state)
     {
     }
 
+    MetaData::Server::Pool::Pool()
+        : Core::JSON::Container()
+    {
+        Add(_T("name"), &Name);
+        Add(_T("hits"), &Hits);
+        Add(_T("misses"), &Misses);
+        Add(_T("inuse"), &InUse);
+        Add(_T("highwater"), &HighWater);
+        Add(_T("idle"), &Idle);
+        Add(_T("trimmed"), &Trimmed);
+    }
+    MetaData::Server::Pool::Pool(const Core::IProxyPool& pool)
+        : Core::JSON::Container()
+    {
+        Add(_T("name"), &Name);
+        Add(_T("hits"), &Hits);
+        Add(_T("misses"), &Misses);
+        Add(_T("inuse"), &InUse);
+        Add(_T("highwater"), &HighWater);
+        Add(_T("idle"), &Idle);
+        Add(_T("trimmed"), &Trimmed);
+
+        Name = Core::ClassNameOnly(pool.Name()).Text();
+        Hits = pool.Hits();
+        Misses = pool.Misses();
+        InUse = pool.InUse();
+        HighWater = pool.HighWater();
+        Idle = pool.QueuedElements();
+        Trimmed = pool.Trimmed();
+    }
+    MetaData::Server::Pool::Pool(const Pool& copy)
+        : Core::JSON::Container()
+        , Name(copy.Name)
+        , Hits(copy.Hits)
+        , Misses(copy.Misses)
+        , InUse(copy.InUse)
+        , HighWater(copy.HighWater)
+        , Idle(copy.Idle)
+        , Trimmed(copy.Trimmed)
+    {
+        Add(_T("name"), &Name);
+        Add(_T("hits"), &Hits);
+        Add(_T("misses"), &Misses);
+        Add(_T("inuse"), &InUse);
+        Add(_T("highwater"), &HighWater);
+        Add(_T("idle"), &Idle);
+        Add(_T("trimmed"), &Trimmed);
+    }
+    MetaData::Server::Pool::~Pool()
+    {
+    }
+
     MetaData::Server::Server()
     {
         Core::JSON::Container::Add(_T("threads"), &ThreadPoolRuns);
         Core::JSON::Container::Add(_T("pending"), &PendingRequests);
         Core::JSON::Container::Add(_T("occupation"), &PoolOccupation);
+        Core::JSON::Container::Add(_T("pools"), &Pools);
     }
     MetaData::Server::~Server()
     {
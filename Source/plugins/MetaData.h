@@ -113,6 +113,10 @@ namespace PluginHost {
             Core::JSON::Boolean Activity;
             Core::JSON::DecUInt32 ID;
             Core::JSON::String Name;
+            Core::JSON::DecUInt32 Depth;
+            Core::JSON::DecUInt32 Bytes;
+            Core::JSON::DecUInt32 Dropped;
+            Core::JSON::DecUInt32 Coalesced;
         };
 
         class EXTERNAL Bridge : public Core::JSON::Container {
@@ -137,6 +141,27 @@ namespace PluginHost {
             Server(const Server& copy) = delete;
             Server& operator=(const Server&) = delete;
 
+        public:
+            class EXTERNAL Pool : public Core::JSON::Container {
+            private:
+                Pool& operator=(const Pool&) = delete;
+
+            public:
+                Pool();
+                Pool(const Core::IProxyPool& pool);
+                Pool(const Pool& copy);
+                ~Pool();
+
+            public:
+                Core::JSON::String Name;
+                Core::JSON::DecUInt32 Hits;
+                Core::JSON::DecUInt32 Misses;
+                Core::JSON::DecUInt32 InUse;
+                Core::JSON::DecUInt32 HighWater;
+                Core::JSON::DecUInt32 Idle;
+                Core::JSON::DecUInt32 Trimmed;
+            };
+
         public:
             Server();
             ~Server();
@@ -144,12 +169,14 @@ namespace PluginHost {
             inline void Clear()
             {
                 ThreadPoolRuns.Clear();
+                Pools.Clear();
             }
 
         public:
             Core::JSON::ArrayType<Core::JSON::DecUInt32> ThreadPoolRuns;
             Core::JSON::DecUInt32 PendingRequests;
             Core::JSON::DecUInt32 PoolOccupation;
+            Core::JSON::ArrayType<Pool> Pools;
         };
 
         class EXTERNAL SubSystem : public Core::JSON::Container {
@@ -9,6 +9,9 @@
 namespace WPEFramework {
 namespace Trace {
     const uint16_t TRACINGBUFFERSIZE = 1024;
+    const uint16_t TRACINGARGUMENTSSIZE = 512;
+
+    class Arguments;
 
     struct ITraceControl {
         virtual ~ITraceControl() {}
@@ -24,6 +27,17 @@ namespace Trace {
         virtual const char* Module() const = 0;
         virtual const char* Data() const = 0;
         virtual uint16_t Length() const = 0;
+
+        // If the text was not formatted yet, the arguments it should be formatted from.
+        virtual const Arguments* Deferred() const
+        {
+            return (nullptr);
+        }
+        // Written out before the call returns, instead of by the drainer.
+        virtual bool Synchronous() const
+        {
+            return (false);
+        }
     };
 }
 }
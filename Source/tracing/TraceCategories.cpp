@@ -8,5 +8,402 @@ namespace Trace {
     /* static */ const std::string Destructor::_text("Destructor called");
     /* static */ const std::string CopyConstructor::_text("Copy Constructor called");
     /* static */ const std::string AssignmentOperator::_text("Assignment Operator called");
+
+    namespace {
+
+        enum class Kind : uint8_t {
+            NONE,
+            SIGNED,
+            UNSIGNED,
+            CHARACTER,
+            REAL,
+            TEXT,
+            POINTER,
+            COUNT,
+            UNSUPPORTED
+        };
+
+        // One conversion specification, as printf would see it.
+        struct Specification {
+            const char* Begin;
+            const char* End;
+            const char* Flags;
+            uint8_t FlagsLength;
+            bool WidthStar;
+            const char* Width;
+            uint8_t WidthLength;
+            bool HasPrecision;
+            bool PrecisionStar;
+            const char* Precision;
+            uint8_t PrecisionLength;
+            char Modifier[3];
+            char Conversion;
+            Kind Type;
+        };
+
+        // Find the next conversion, returns false if the format is done.
+        bool Next(const char*& format, Specification& spec)
+        {
+            while ((*format != '\0') && ((format[0] != '%') || (format[1] == '%'))) {
+                format += (format[0] == '%' ? 2 : 1);
+            }
+
+            if (*format == '\0') {
+                return (false);
+            }
+
+            spec.Begin = format++;
+            spec.Flags = format;
+            while ((*format != '\0') && (::strchr("-+ #0'", *format) != nullptr)) {
+                format++;
+            }
+            spec.FlagsLength = static_cast<uint8_t>(format - spec.Flags);
+
+            spec.WidthStar = (*format == '*');
+            spec.Width = format;
+            if (spec.WidthStar == true) {
+                format++;
+            } else {
+                while ((*format >= '0') && (*format <= '9')) {
+                    format++;
+                }
+            }
+            spec.WidthLength = static_cast<uint8_t>(format - spec.Width);
+
+            spec.HasPrecision = (*format == '.');
+            spec.PrecisionStar = false;
+            spec.PrecisionLength = 0;
+            if (spec.HasPrecision == true) {
+                format++;
+                spec.PrecisionStar = (*format == '*');
+                spec.Precision = format;
+                if (spec.PrecisionStar == true) {
+                    format++;
+                } else {
+                    while ((*format >= '0') && (*format <= '9')) {
+                        format++;
+                    }
+                }
+                spec.PrecisionLength = static_cast<uint8_t>(format - spec.Precision);
+            }
+
+            uint8_t index = 0;
+            while ((index < 2) && (*format != '\0') && (::strchr("hlLqjzt", *format) != nullptr)) {
+                spec.Modifier[index++] = *format++;
+            }
+            spec.Modifier[index] = '\0';
+
+            spec.Conversion = *format;
+            spec.End = (*format != '\0' ? format + 1 : format);
+
+            switch (spec.Conversion) {
+            case 'd':
+            case 'i':
+                spec.Type = Kind::SIGNED;
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                spec.Type = Kind::UNSIGNED;
+                break;
+            case 'c':
+                spec.Type = (index == 0 ? Kind::CHARACTER : Kind::UNSUPPORTED);
+                break;
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                spec.Type = Kind::REAL;
+                break;
+            case 's':
+                spec.Type = (index == 0 ? Kind::TEXT : Kind::UNSUPPORTED);
+                break;
+            case 'p':
+                spec.Type = Kind::POINTER;
+                break;
+            case 'n':
+                spec.Type = Kind::COUNT;
+                break;
+            default:
+                spec.Type = Kind::UNSUPPORTED;
+                break;
+            }
+
+            format = spec.End;
+
+            return (true);
+        }
+
+        template <typename TYPE>
+        bool Store(uint8_t buffer[], uint16_t& offset, const TYPE& value)
+        {
+            if ((offset + sizeof(TYPE)) > TRACINGARGUMENTSSIZE) {
+                return (false);
+            }
+            ::memcpy(&buffer[offset], &value, sizeof(TYPE));
+            offset += sizeof(TYPE);
+            return (true);
+        }
+
+        template <typename TYPE>
+        TYPE Load(const uint8_t buffer[], uint16_t& offset)
+        {
+            TYPE value;
+            ::memcpy(&value, &buffer[offset], sizeof(TYPE));
+            offset += sizeof(TYPE);
+            return (value);
+        }
+
+        template <typename TYPE>
+        void Append(string& dst, const char specification[], const TYPE value)
+        {
+            char buffer[128];
+            int length = ::snprintf(buffer, sizeof(buffer), specification, value);
+
+            if (length < static_cast<int>(sizeof(buffer))) {
+                dst.append(buffer, (length > 0 ? length : 0));
+            } else {
+                const size_t start = dst.length();
+                dst.resize(start + length);
+                ::snprintf(&dst[start], length + 1, specification, value);
+            }
+        }
+
+        // Copy the literal text, the escaped percentages unescaped.
+        void Literal(string& dst, const char* begin, const char* end)
+        {
+            while (begin < end) {
+                const char* percentage = begin;
+                while ((percentage < end) && (*percentage != '%')) {
+                    percentage++;
+                }
+                dst.append(begin, percentage - begin);
+                if (percentage < end) {
+                    dst += '%';
+                    percentage += 2;
+                }
+                begin = percentage;
+            }
+        }
+
+        int64_t Signed(const Specification& spec, va_list& ap)
+        {
+            int64_t result;
+
+            if (spec.Modifier[0] == '\0') {
+                result = va_arg(ap, int);
+            } else if (::strcmp(spec.Modifier, "hh") == 0) {
+                result = static_cast<signed char>(va_arg(ap, int));
+            } else if (::strcmp(spec.Modifier, "h") == 0) {
+                result = static_cast<short>(va_arg(ap, int));
+            } else if (::strcmp(spec.Modifier, "l") == 0) {
+                result = va_arg(ap, long);
+            } else if (spec.Modifier[0] == 'j') {
+                result = va_arg(ap, intmax_t);
+            } else if (spec.Modifier[0] == 'z') {
+                result = va_arg(ap, ssize_t);
+            } else if (spec.Modifier[0] == 't') {
+                result = va_arg(ap, ptrdiff_t);
+            } else {
+                result = va_arg(ap, long long);
+            }
+
+            return (result);
+        }
+
+        uint64_t Unsigned(const Specification& spec, va_list& ap)
+        {
+            uint64_t result;
+
+            if (spec.Modifier[0] == '\0') {
+                result = va_arg(ap, unsigned int);
+            } else if (::strcmp(spec.Modifier, "hh") == 0) {
+                result = static_cast<unsigned char>(va_arg(ap, unsigned int));
+            } else if (::strcmp(spec.Modifier, "h") == 0) {
+                result = static_cast<unsigned short>(va_arg(ap, unsigned int));
+            } else if (::strcmp(spec.Modifier, "l") == 0) {
+                result = va_arg(ap, unsigned long);
+            } else if (spec.Modifier[0] == 'j') {
+                result = va_arg(ap, uintmax_t);
+            } else if (spec.Modifier[0] == 'z') {
+                result = va_arg(ap, size_t);
+            } else if (spec.Modifier[0] == 't') {
+                result = va_arg(ap, ptrdiff_t);
+            } else {
+                result = va_arg(ap, unsigned long long);
+            }
+
+            return (result);
+        }
+    }
+
+    bool Arguments::Capture(const TCHAR formatter[], va_list arguments)
+    {
+        // A local copy, so it can be handed out by reference on all platforms.
+        va_list ap;
+        va_copy(ap, arguments);
+
+        uint16_t offset = static_cast<uint16_t>(::strlen(formatter) + 1);
+        bool result = (offset <= TRACINGARGUMENTSSIZE);
+
+        if (result == true) {
+            const char* format = formatter;
+            Specification spec;
+
+            ::memcpy(_data, formatter, offset);
+
+            while ((result == true) && (Next(format, spec) == true)) {
+                int precision = -1;
+
+                if (spec.WidthStar == true) {
+                    result = Store(_data, offset, va_arg(ap, int));
+                }
+                if ((result == true) && (spec.PrecisionStar == true)) {
+                    precision = va_arg(ap, int);
+                    result = Store(_data, offset, precision);
+                } else if (spec.HasPrecision == true) {
+                    precision = ::atoi(spec.Precision);
+                }
+                if (result == true) {
+                    switch (spec.Type) {
+                    case Kind::SIGNED:
+                        result = Store(_data, offset, Signed(spec, ap));
+                        break;
+                    case Kind::UNSIGNED:
+                        result = Store(_data, offset, Unsigned(spec, ap));
+                        break;
+                    case Kind::CHARACTER:
+                        result = Store(_data, offset, va_arg(ap, int));
+                        break;
+                    case Kind::REAL:
+                        if (spec.Modifier[0] == 'L') {
+                            result = Store(_data, offset, static_cast<double>(va_arg(ap, long double)));
+                        } else {
+                            result = Store(_data, offset, va_arg(ap, double));
+                        }
+                        break;
+                    case Kind::POINTER:
+                        result = Store(_data, offset, va_arg(ap, void*));
+                        break;
+                    case Kind::COUNT:
+                        // Nothing to report back to, the text is made later.
+                        va_arg(ap, void*);
+                        break;
+                    case Kind::TEXT: {
+                        const char* text = va_arg(ap, const char*);
+                        if (text == nullptr) {
+                            text = "(null)";
+                        }
+                        // A precision allows for text that is not terminated, a negative one is no precision.
+                        size_t length = 0;
+                        const size_t maximum = (precision < 0 ? static_cast<size_t>(~0) : static_cast<size_t>(precision));
+                        while ((length < maximum) && (text[length] != '\0')) {
+                            length++;
+                        }
+                        result = ((offset + sizeof(uint16_t) + length + 1) <= TRACINGARGUMENTSSIZE);
+                        if (result == true) {
+                            Store(_data, offset, static_cast<uint16_t>(length));
+                            ::memcpy(&_data[offset], text, length);
+                            _data[offset + length] = '\0';
+                            offset += static_cast<uint16_t>(length + 1);
+                        }
+                        break;
+                    }
+                    default:
+                        result = false;
+                        break;
+                    }
+                }
+            }
+        }
+
+        va_end(ap);
+
+        _length = (result == true ? offset : 0);
+
+        return (result);
+    }
+
+    /* static */ void Arguments::Format(string& dst, const uint8_t data[], const uint16_t length)
+    {
+        const char* format = reinterpret_cast<const char*>(data);
+        const char* literal = format;
+        uint16_t offset = static_cast<uint16_t>(::strlen(format) + 1);
+        Specification spec;
+
+        dst.clear();
+
+        while ((offset <= length) && (Next(literal, spec) == true)) {
+            Literal(dst, format, spec.Begin);
+
+            // Rebuild the specification, the stars resolved, integers always as long long.
+            char specification[64];
+            uint8_t index = 0;
+
+            specification[index++] = '%';
+            ::memcpy(&specification[index], spec.Flags, spec.FlagsLength);
+            index += spec.FlagsLength;
+            if (spec.WidthStar == true) {
+                index += ::snprintf(&specification[index], 12, "%d", Load<int>(data, offset));
+            } else {
+                ::memcpy(&specification[index], spec.Width, spec.WidthLength);
+                index += spec.WidthLength;
+            }
+            if (spec.HasPrecision == true) {
+                if (spec.PrecisionStar == true) {
+                    const int precision = Load<int>(data, offset);
+                    if (precision >= 0) {
+                        index += ::snprintf(&specification[index], 13, ".%d", precision);
+                    }
+                } else {
+                    specification[index++] = '.';
+                    ::memcpy(&specification[index], spec.Precision, spec.PrecisionLength);
+                    index += spec.PrecisionLength;
+                }
+            }
+            if ((spec.Type == Kind::SIGNED) || (spec.Type == Kind::UNSIGNED)) {
+                specification[index++] = 'l';
+                specification[index++] = 'l';
+            }
+            specification[index++] = spec.Conversion;
+            specification[index] = '\0';
+
+            switch (spec.Type) {
+            case Kind::SIGNED:
+                Append(dst, specification, static_cast<long long>(Load<int64_t>(data, offset)));
+                break;
+            case Kind::UNSIGNED:
+                Append(dst, specification, static_cast<unsigned long long>(Load<uint64_t>(data, offset)));
+                break;
+            case Kind::CHARACTER:
+                Append(dst, specification, Load<int>(data, offset));
+                break;
+            case Kind::REAL:
+                Append(dst, specification, Load<double>(data, offset));
+                break;
+            case Kind::POINTER:
+                Append(dst, specification, Load<void*>(data, offset));
+                break;
+            case Kind::TEXT: {
+                const uint16_t size = Load<uint16_t>(data, offset);
+                Append(dst, specification, reinterpret_cast<const char*>(&data[offset]));
+                offset += size + 1;
+                break;
+            }
+            default:
+                break;
+            }
+
+            format = spec.End;
+        }
+
+        // And whatever is left after the last conversion.
+        Literal(dst, format, format + ::strlen(format));
+    }
 }
 } // namespace Trace
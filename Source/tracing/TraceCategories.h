@@ -21,7 +21,117 @@ namespace Trace {
     void EXTERNAL Format(string& dst, const TCHAR format[], ...);
     void EXTERNAL Format(string& dst, const TCHAR format[], va_list ap);
 
-    class EXTERNAL Text {
+    // Binary snapshot of a printf style format and its arguments. Capturing is a
+    // few copies, the (expensive) formatting is done later, by whoever reads it.
+    class EXTERNAL Arguments {
+    private:
+        Arguments(const Arguments&) = delete;
+        Arguments& operator=(const Arguments&) = delete;
+
+    public:
+        Arguments()
+            : _length(0)
+        {
+        }
+        ~Arguments()
+        {
+        }
+
+    public:
+        inline bool IsSet() const
+        {
+            return (_length != 0);
+        }
+        inline void Clear()
+        {
+            _length = 0;
+        }
+        inline const uint8_t* Data() const
+        {
+            return (_data);
+        }
+        inline uint16_t Length() const
+        {
+            return (_length);
+        }
+        inline void Format(string& dst) const
+        {
+            Format(dst, _data, _length);
+        }
+
+        // Leaves ap untouched. Returns false if the arguments do not fit or can not be captured.
+        bool Capture(const TCHAR formatter[], va_list ap);
+
+        static void Format(string& dst, const uint8_t data[], const uint16_t length);
+
+    private:
+        uint16_t _length;
+        uint8_t _data[TRACINGARGUMENTSSIZE];
+    };
+
+    // The base of the formatting categories, the text is only formatted if someone actually reads it.
+    class EXTERNAL LazyText {
+    private:
+        LazyText(const LazyText&) = delete;
+        LazyText& operator=(const LazyText&) = delete;
+
+    protected:
+        inline LazyText()
+            : _arguments()
+            , _text()
+        {
+        }
+        inline LazyText(const std::string& text)
+            : _arguments()
+            , _text(text)
+        {
+        }
+        ~LazyText()
+        {
+        }
+
+        inline void Set(const std::string& text)
+        {
+            _arguments.Clear();
+            _text = text;
+        }
+        inline void Capture(const TCHAR formatter[], va_list ap)
+        {
+            if (_arguments.Capture(formatter, ap) == false) {
+                Trace::Format(_text, formatter, ap);
+            }
+        }
+
+    public:
+        inline const Arguments* Deferred() const
+        {
+            return (_arguments.IsSet() == true ? &_arguments : nullptr);
+        }
+        inline const char* Data() const
+        {
+            Resolve();
+            return (_text.c_str());
+        }
+        inline uint16_t Length() const
+        {
+            Resolve();
+            return (static_cast<uint16_t>(_text.length()));
+        }
+
+    private:
+        inline void Resolve() const
+        {
+            if ((_arguments.IsSet() == true) && (_text.empty() == true)) {
+                _arguments.Format(_text);
+            }
+        }
+
+    private:
+        Arguments _arguments;
+        mutable std::string _text;
+    };
+
+    class EXTERNAL Text : public LazyText {
     private:
         // -------------------------------------------------------------------
         // This object should not be copied or assigned. Prevent the copy
@@ -41,24 +151,24 @@ namespace Trace {
         {
             va_list ap;
             va_start(ap, formatter);
-            Format(_text, formatter, ap);
+            Capture(formatter, ap);
             va_end(ap);
         }
         inline Text(const std::string& text)
-            : _text(Core::ToString(text.c_str()))
+            : LazyText(Core::ToString(text.c_str()))
         {
         }
         inline Text(const char text[])
-            : _text(Core::ToString(text))
+            : LazyText(Core::ToString(text))
         {
         }
 #ifndef __NO_WCHAR_SUPPORT__
         inline Text(const std::wstring& text)
-            : _text(Core::ToString(text.c_str()))
+            : LazyText(Core::ToString(text.c_str()))
         {
         }
         inline Text(const wchar_t text[])
-            : _text(Core::ToString(text))
+            : LazyText(Core::ToString(text))
         {
         }
 #endif
@@ -68,19 +178,8 @@ namespace Trace {
 
         inline void Set(const string& text)
         {
-            _text = Core::ToString(text.c_str());
-        }
-        inline const char* Data() const
-        {
-            return (_text.c_str());
-        }
-        inline uint16_t Length() const
-        {
-            return (static_cast<uint16_t>(_text.length()));
+            LazyText::Set(Core::ToString(text.c_str()));
         }
-
-    private:
-        std::string _text;
     };
 
     class EXTERNAL Constructor {
@@ -309,7 +408,7 @@ namespace Trace {
         std::string _text;
     };
 
-    class EXTERNAL Information {
+    class EXTERNAL Information : public LazyText {
     private:
         // -------------------------------------------------------------------
         // This object should not be copied or assigned. Prevent the copy
@@ -327,32 +426,19 @@ namespace Trace {
         {
             va_list ap;
             va_start(ap, formatter);
-            Format(_text, formatter, ap);
+            Capture(formatter, ap);
             va_end(ap);
         }
         explicit Information(const string& text)
-            : _text(Core::ToString(text))
+            : LazyText(Core::ToString(text))
         {
         }
         ~Information()
         {
         }
-
-    public:
-        inline const char* Data() const
-        {
-            return (_text.c_str());
-        }
-        inline uint16_t Length() const
-        {
-            return (static_cast<uint16_t>(_text.length()));
-        }
-
-    private:
-        std::string _text;
     };
 
-    class EXTERNAL Warning {
+    class EXTERNAL Warning : public LazyText {
     private:
         // -------------------------------------------------------------------
         // This object should not be copied or assigned. Prevent the copy
@@ -370,32 +456,19 @@ namespace Trace {
         {
             va_list ap;
             va_start(ap, formatter);
-            Format(_text, formatter, ap);
+            Capture(formatter, ap);
             va_end(ap);
         }
         explicit Warning(const string& text)
-            : _text(Core::ToString(text))
+            : LazyText(Core::ToString(text))
         {
         }
         ~Warning()
         {
         }
-
-    public:
-        inline const char* Data() const
-        {
-            return (_text.c_str());
-        }
-        inline uint16_t Length() const
-        {
-            return (static_cast<uint16_t>(_text.length()));
-        }
-
-    private:
-        std::string _text;
     };
 
-    class EXTERNAL Error {
+    class EXTERNAL Error : public LazyText {
     private:
         // -------------------------------------------------------------------
         // This object should not be copied or assigned. Prevent the copy
@@ -413,32 +486,19 @@ namespace Trace {
         {
             va_list ap;
             va_start(ap, formatter);
-            Format(_text, formatter, ap);
+            Capture(formatter, ap);
             va_end(ap);
         }
         explicit Error(const string& text)
-            : _text(Core::ToString(text))
+            : LazyText(Core::ToString(text))
         {
         }
         ~Error()
         {
         }
-
-    public:
-        inline const char* Data() const
-        {
-            return (_text.c_str());
-        }
-        inline uint16_t Length() const
-        {
-            return (static_cast<uint16_t>(_text.length()));
-        }
-
-    private:
-        std::string _text;
     };
 
-    class EXTERNAL Fatal {
+    class EXTERNAL Fatal : public LazyText {
     private:
         // -------------------------------------------------------------------
         // This object should not be copied or assigned. Prevent the copy
@@ -456,32 +516,19 @@ namespace Trace {
         {
             va_list ap;
             va_start(ap, formatter);
-            Format(_text, formatter, ap);
+            Capture(formatter, ap);
             va_end(ap);
         }
         explicit Fatal(const string& text)
-            : _text(Core::ToString(text))
+            : LazyText(Core::ToString(text))
         {
         }
         ~Fatal()
         {
         }
-
-    public:
-        inline const char* Data() const
-        {
-            return (_text.c_str());
-        }
-        inline uint16_t Length() const
-        {
-            return (static_cast<uint16_t>(_text.length()));
-        }
-
-    private:
-        std::string _text;
     };
 
-    class EXTERNAL Initialisation {
+    class EXTERNAL Initialisation : public LazyText {
     private:
         // -------------------------------------------------------------------
         // This object should not be copied or assigned. Prevent the copy
@@ -499,32 +546,19 @@ namespace Trace {
         {
             va_list ap;
             va_start(ap, formatter);
-            Format(_text, formatter, ap);
+            Capture(formatter, ap);
             va_end(ap);
         }
         explicit Initialisation(const string& text)
-            : _text(Core::ToString(text))
+            : LazyText(Core::ToString(text))
         {
         }
         ~Initialisation()
         {
         }
-
-    public:
-        inline const char* Data() const
-        {
-            return (_text.c_str());
-        }
-        inline uint16_t Length() const
-        {
-            return (static_cast<uint16_t>(_text.length()));
-        }
-
-    private:
-        std::string _text;
     };
 
-    class EXTERNAL Assert {
+    class EXTERNAL Assert : public LazyText {
     private:
         // -------------------------------------------------------------------
         // This object should not be copied or assigned. Prevent the copy
@@ -538,36 +572,23 @@ namespace Trace {
 
     public:
         Assert()
-            : _text("Assertion: <<No description supplied>>")
+            : LazyText("Assertion: <<No description supplied>>")
         {
         }
         Assert(const TCHAR formatter[], ...)
         {
             va_list ap;
             va_start(ap, formatter);
-            Format(_text, formatter, ap);
+            Capture(formatter, ap);
             va_end(ap);
         }
         explicit Assert(const string& text)
-            : _text(std::string("Assertion: ") + (Core::ToString(text)))
+            : LazyText(std::string("Assertion: ") + (Core::ToString(text)))
         {
         }
         ~Assert()
         {
         }
-
-    public:
-        inline const char* Data() const
-        {
-            return (_text.c_str());
-        }
-        inline uint16_t Length() const
-        {
-            return (static_cast<uint16_t>(_text.length()));
-        }
-
-    private:
-        std::string _text;
     };
 }
 } // namespace Trace
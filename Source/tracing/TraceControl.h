@@ -38,6 +38,13 @@
 // ---- Class Definition ----
 namespace WPEFramework {
 namespace Trace {
+    // The base of the categories that can postpone their formatting.
+    class LazyText;
+    // The categories that are written out synchronously.
+    class Error;
+    class Fatal;
+    class Assert;
+
     template <typename CATEGORY, const char** MODULENAME>
     class TraceType : public ITrace {
     private:
@@ -164,6 +171,33 @@ namespace Trace {
         {
             return (_traceInfo.Length());
         }
+        virtual const Arguments* Deferred() const
+        {
+            return (__Deferred<CATEGORY, MODULENAME>());
+        }
+        // The process might not live long enough to see these drained.
+        virtual bool Synchronous() const
+        {
+            return ((std::is_same<CATEGORY, Error>::value == true) || (std::is_same<CATEGORY, Fatal>::value == true) || (std::is_same<CATEGORY, Assert>::value == true));
+        }
+
+    private:
+        // -----------------------------------------------------
+        // Categories that can postpone their formatting, Compile time !!!
+        // -----------------------------------------------------
+        template <typename SUBJECT, const char** SUBJECTMODULE>
+        inline typename Core::TypeTraits::enable_if<std::is_base_of<LazyText, SUBJECT>::value, const Arguments*>::type
+        __Deferred() const
+        {
+            return (_traceInfo.Deferred());
+        }
+
+        template <typename SUBJECT, const char** SUBJECTMODULE>
+        inline typename Core::TypeTraits::enable_if<!std::is_base_of<LazyText, SUBJECT>::value, const Arguments*>::type
+        __Deferred() const
+        {
+            return (nullptr);
+        }
 
     private:
         CATEGORY& _traceInfo;
@@ -87,6 +87,9 @@ namespace Trace {
         , m_Admin()
         , m_OutputChannel(nullptr)
         , m_DirectOut(false)
+        , m_Rings()
+        , m_Drainer(nullptr)
+        , m_Idle(true)
     {
     }
 
@@ -119,6 +122,93 @@ namespace Trace {
         _doorBell.Ring();
     }
 
+    void TraceUnit::Ring::Write(const uint32_t position, const void* data, const uint32_t length)
+    {
+        const uint32_t offset = position & (TRACE_RING_SIZE - 1);
+        const uint32_t first = std::min(length, static_cast<uint32_t>(TRACE_RING_SIZE - offset));
+
+        ::memcpy(&_buffer[offset], data, first);
+        ::memcpy(_buffer, &reinterpret_cast<const uint8_t*>(data)[first], length - first);
+    }
+
+    void TraceUnit::Ring::Read(const uint32_t position, void* data, const uint32_t length) const
+    {
+        const uint32_t offset = position & (TRACE_RING_SIZE - 1);
+        const uint32_t first = std::min(length, static_cast<uint32_t>(TRACE_RING_SIZE - offset));
+
+        ::memcpy(data, &_buffer[offset], first);
+        ::memcpy(&reinterpret_cast<uint8_t*>(data)[first], _buffer, length - first);
+    }
+
+    bool TraceUnit::Ring::Push(const Header& header, const char className[], const uint8_t data[])
+    {
+        const uint32_t tail = _tail.load(std::memory_order_relaxed);
+        const uint32_t size = Size(header);
+        bool result = ((size <= (TRACE_RING_SIZE / 2)) && ((TRACE_RING_SIZE - (tail - _head.load(std::memory_order_acquire))) >= size));
+
+        if (result == true) {
+            Write(tail, &header, sizeof(Header));
+            Write(tail + sizeof(Header), className, header.ClassName);
+            Write(tail + sizeof(Header) + header.ClassName, data, header.Length);
+
+            _tail.store(tail + size, std::memory_order_release);
+        }
+
+        return (result);
+    }
+
+    bool TraceUnit::Ring::Peek(Header& header) const
+    {
+        const uint32_t head = _head.load(std::memory_order_relaxed);
+        bool result = (head != _tail.load(std::memory_order_acquire));
+
+        if (result == true) {
+            Read(head, &header, sizeof(Header));
+        }
+
+        return (result);
+    }
+
+    void TraceUnit::Ring::Pop(Header& header, string& className, string& data)
+    {
+        const uint32_t head = _head.load(std::memory_order_relaxed);
+
+        Read(head, &header, sizeof(Header));
+
+        className.resize(header.ClassName);
+        Read(head + sizeof(Header), &className[0], header.ClassName);
+        data.resize(header.Length);
+        Read(head + sizeof(Header) + header.ClassName, &data[0], header.Length);
+
+        _head.store(head + Size(header), std::memory_order_release);
+    }
+
+    /* virtual */ uint32_t TraceUnit::Drainer::Worker()
+    {
+        uint32_t delay = Core::infinite;
+
+        Block();
+
+        _parent.m_Admin.Lock();
+
+        if (_parent.Drain() == true) {
+            // Busy, stay around for a bit and pick up more in one go.
+            delay = 10;
+        } else {
+            _parent.m_Idle.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            // Anything that slipped in while going idle, will not have woken us.
+            if ((_parent.Pending() == true) && (_parent.m_Idle.exchange(false) == true)) {
+                delay = 0;
+            }
+        }
+
+        _parent.m_Admin.Unlock();
+
+        return (delay);
+    }
+
     /* static */ TraceUnit& TraceUnit::Instance()
     {
         return (Core::SingletonType<TraceUnit>::Instance());
@@ -126,9 +216,35 @@ namespace Trace {
 
     TraceUnit::~TraceUnit()
     {
+        // The drainer needs the lock to finish, stop it before taking it.
         m_Admin.Lock();
+        Drainer* drainer = m_Drainer.exchange(nullptr);
+        m_Admin.Unlock();
+
+        if (drainer != nullptr) {
+            drainer->Stop();
+            drainer->Wait(Core::Thread::STOPPED, Core::infinite);
+        }
 
-        if (m_OutputChannel != nullptr) {
+        m_Admin.Lock();
+
+        // Threads that picked up the drainer before it was taken away might still wake it, it can only go
+        // once they are out. Later ones do not find it anymore.
+        for (Ring* ring : m_Rings) {
+            while (ring->IsBusy() == true) {
+                m_Admin.Unlock();
+                SleepMs(0);
+                m_Admin.Lock();
+            }
+        }
+
+        if (drainer != nullptr) {
+            delete drainer;
+        }
+
+        Drain();
+
+        if (m_OutputChannel.load() != nullptr) {
             Close();
         }
 
@@ -136,6 +252,13 @@ namespace Trace {
             m_Categories.front()->Destroy();
         }
 
+        for (Ring* ring : m_Rings) {
+            if (ring->Release() == true) {
+                delete ring;
+            }
+        }
+        m_Rings.clear();
+
         m_Admin.Unlock();
     }
 
@@ -152,13 +275,18 @@ namespace Trace {
 
     uint32_t TraceUnit::Open(const string& pathName, const uint32_t identifier)
     {
-        ASSERT(m_OutputChannel == nullptr);
-
         string actualPath(Core::Directory::Normalize(pathName) + TRACE_CYCLIC_BUFFER_PREFIX + '.' + Core::NumberType<uint32_t>(identifier).Text());
+        TraceBuffer* outputChannel = new TraceBuffer(actualPath);
+
+        ASSERT(outputChannel->IsValid());
 
-        m_OutputChannel = new TraceBuffer(actualPath);
+        m_Admin.Lock();
+
+        ASSERT(m_OutputChannel.load() == nullptr);
 
-        ASSERT(m_OutputChannel->IsValid());
+        m_OutputChannel.store(outputChannel);
+
+        m_Admin.Unlock();
 
         return (Core::ERROR_NONE);
     }
@@ -167,13 +295,15 @@ namespace Trace {
     {
         m_Admin.Lock();
 
-        ASSERT(m_OutputChannel != nullptr);
+        ASSERT(m_OutputChannel.load() != nullptr);
 
-        if (m_OutputChannel != nullptr) {
-            delete m_OutputChannel;
-        }
+        Drain();
+
+        TraceBuffer* outputChannel = m_OutputChannel.exchange(nullptr);
 
-        m_OutputChannel = nullptr;
+        if (outputChannel != nullptr) {
+            delete outputChannel;
+        }
 
         m_Admin.Unlock();
 
@@ -193,6 +323,9 @@ namespace Trace {
     {
         m_Admin.Lock();
 
+        // Pending records might still refer to the (unloading) module.
+        Drain();
+
         std::list<ITraceControl*>::iterator index(std::find(m_Categories.begin(), m_Categories.end(), &Category));
 
         if (index != m_Categories.end()) {
@@ -297,63 +430,224 @@ namespace Trace {
         return isDefaultCategory;
     }
 
-    void TraceUnit::Trace(const char file[], const uint32_t lineNumber, const char className[], const ITrace* const information)
+    TraceUnit::Ring* TraceUnit::Register()
     {
-        const char* fileName(Core::FileNameOnly(file));
+        Ring* ring = new Ring();
 
         m_Admin.Lock();
 
-        if (m_OutputChannel != nullptr) {
+        m_Rings.push_back(ring);
+
+        if (m_Drainer.load() == nullptr) {
+            m_Drainer.store(new Drainer(*this));
+        }
 
-            const char* category(information->Category());
-            const char* module(information->Module());
-            const uint64_t current = Core::Time::Now().Ticks();
-            const uint16_t fileNameLength = static_cast<uint16_t>(strlen(fileName) + 1); // File name.
-            const uint16_t moduleLength = static_cast<uint16_t>(strlen(module) + 1); // Module.
-            const uint16_t categoryLength = static_cast<uint16_t>(strlen(category) + 1); // Cateogory.
-            const uint16_t classNameLength = static_cast<uint16_t>(strlen(className) + 1); // Class name.
-            const uint16_t informationLength = information->Length(); // Actual data (no '\0' needed).
+        m_Admin.Unlock();
+
+        return (ring);
+    }
+
+    bool TraceUnit::Pending() const
+    {
+        Rings::const_iterator index(m_Rings.begin());
+
+        while ((index != m_Rings.end()) && ((*index)->Used() == 0)) {
+            index++;
+        }
+
+        return (index != m_Rings.end());
+    }
+
+    // Expects the admin lock to be taken.
+    void TraceUnit::Drain(Ring* ring)
+    {
+        Ring::Header header;
+        string className;
+        string data;
+        string text;
+
+        while (ring->Peek(header) == true) {
+            Forward(*ring, className, data, text);
+        }
+    }
+
+    // Expects the admin lock to be taken.
+    void TraceUnit::Forward(Ring& ring, string& className, string& data, string& text)
+    {
+        Ring::Header header;
+
+        ring.Pop(header, className, data);
+
+        if (header.Deferred == true) {
+            Arguments::Format(text, reinterpret_cast<const uint8_t*>(data.c_str()), header.Length);
+            Emit(header, className.c_str(), text.c_str(), static_cast<uint16_t>(text.length()));
+        } else {
+            Emit(header, className.c_str(), data.c_str(), header.Length);
+        }
+    }
+
+    // Expects the admin lock to be taken.
+    bool TraceUnit::Drain()
+    {
+        std::vector<std::pair<Ring*, uint32_t>> pending;
+        string className;
+        string data;
+        string text;
+        Ring::Header header;
+        bool drained = false;
+
+        // Only what is there now, producers can keep on adding while we are at it.
+        for (Ring* ring : m_Rings) {
+            const uint32_t used = ring->Used();
+            if (used != 0) {
+                pending.push_back(std::pair<Ring*, uint32_t>(ring, used));
+            }
+        }
+
+        while (pending.empty() == false) {
+            std::vector<std::pair<Ring*, uint32_t>>::iterator oldest(pending.end());
+            uint64_t time = ~0;
+
+            for (std::vector<std::pair<Ring*, uint32_t>>::iterator index(pending.begin()); index != pending.end(); index++) {
+                if ((index->first->Peek(header) == true) && (header.Time < time)) {
+                    time = header.Time;
+                    oldest = index;
+                }
+            }
+
+            ASSERT(oldest != pending.end());
+
+            const uint32_t before = oldest->first->Used();
+
+            Forward(*(oldest->first), className, data, text);
+
+            const uint32_t size = before - oldest->first->Used();
+            oldest->second = (size < oldest->second ? oldest->second - size : 0);
+            if (oldest->second == 0) {
+                pending.erase(oldest);
+            }
+
+            drained = true;
+        }
+
+        // Clean up after the threads that are gone.
+        Rings::iterator index(m_Rings.begin());
+        while (index != m_Rings.end()) {
+            if (((*index)->IsOrphan() == true) && ((*index)->Used() == 0)) {
+                (*index)->Release();
+                delete (*index);
+                index = m_Rings.erase(index);
+            } else {
+                index++;
+            }
+        }
+
+        return (drained);
+    }
+
+    // Expects the admin lock to be taken.
+    void TraceUnit::Emit(const Ring::Header& header, const char className[], const char text[], const uint16_t length)
+    {
+        TraceBuffer* outputChannel = m_OutputChannel.load(std::memory_order_relaxed);
+
+        if (outputChannel != nullptr) {
+
+            const uint16_t fileNameLength = static_cast<uint16_t>(strlen(header.File) + 1); // File name.
+            const uint16_t moduleLength = static_cast<uint16_t>(strlen(header.Module) + 1); // Module.
+            const uint16_t categoryLength = static_cast<uint16_t>(strlen(header.Category) + 1); // Cateogory.
+            const uint16_t classNameLength = header.ClassName; // Class name.
 
             // Trace entry has been simplified: 16 bit size followed by fields:
             // length(2 bytes) - clock ticks (8 bytes) - line number (4 bytes) - file/module/category/className
             const uint16_t headerLength = 2 + 8 + 4 + fileNameLength + moduleLength + categoryLength + classNameLength;
 
-            const uint32_t fullLength = informationLength + headerLength; // Actual data (no '\0' needed).
+            const uint32_t fullLength = length + headerLength; // Actual data (no '\0' needed).
 
             // Tell the buffer how much we are going to write.
-            const uint32_t actualLength = m_OutputChannel->Reserve(fullLength);
+            const uint32_t actualLength = outputChannel->Reserve(fullLength);
 
             if (actualLength >= headerLength) {
                 const uint16_t convertedLength = static_cast<uint16_t>(actualLength);
-                m_OutputChannel->Write(reinterpret_cast<const uint8_t*>(&convertedLength), 2);
-                m_OutputChannel->Write(reinterpret_cast<const uint8_t*>(&current), 8);
-                m_OutputChannel->Write(reinterpret_cast<const uint8_t*>(&lineNumber), 4);
-                m_OutputChannel->Write(reinterpret_cast<const uint8_t*>(fileName), fileNameLength);
-                m_OutputChannel->Write(reinterpret_cast<const uint8_t*>(module), moduleLength);
-                m_OutputChannel->Write(reinterpret_cast<const uint8_t*>(category), categoryLength);
-                m_OutputChannel->Write(reinterpret_cast<const uint8_t*>(className), classNameLength);
+                outputChannel->Write(reinterpret_cast<const uint8_t*>(&convertedLength), 2);
+                outputChannel->Write(reinterpret_cast<const uint8_t*>(&header.Time), 8);
+                outputChannel->Write(reinterpret_cast<const uint8_t*>(&header.Line), 4);
+                outputChannel->Write(reinterpret_cast<const uint8_t*>(header.File), fileNameLength);
+                outputChannel->Write(reinterpret_cast<const uint8_t*>(header.Module), moduleLength);
+                outputChannel->Write(reinterpret_cast<const uint8_t*>(header.Category), categoryLength);
+                outputChannel->Write(reinterpret_cast<const uint8_t*>(className), classNameLength);
 
                 if (actualLength >= fullLength) {
                     // We can write the whole information.
-                    m_OutputChannel->Write(reinterpret_cast<const uint8_t*>(information->Data()), informationLength);
+                    outputChannel->Write(reinterpret_cast<const uint8_t*>(text), length);
                 } else {
                     // Can only write information partially
                     const uint16_t dropLength = actualLength - headerLength;
 
-                    m_OutputChannel->Write(reinterpret_cast<const uint8_t*>(information->Data()), dropLength);
+                    outputChannel->Write(reinterpret_cast<const uint8_t*>(text), dropLength);
                 }
             }
         }
 
-        if (m_DirectOut == true) {
-            string time(Core::Time::Now().ToRFC1123(true));
+        if (m_DirectOut.load(std::memory_order_relaxed) == true) {
+            string time(Core::Time(header.Time).ToRFC1123(true));
             Core::TextFragment cleanClassName(Core::ClassNameOnly(className));
 
-            fprintf(stdout, "[%s]:[%s:%d]:[%s] %s: %s\n", time.c_str(), fileName, lineNumber, cleanClassName.Data(), information->Category(), information->Data());
+            fprintf(stdout, "[%s]:[%s:%d]:[%s] %s: %.*s\n", time.c_str(), header.File, header.Line, cleanClassName.Data(), header.Category, static_cast<int>(length), text);
             fflush(stdout);
         }
+    }
 
-        m_Admin.Unlock();
+    void TraceUnit::Trace(const char file[], const uint32_t lineNumber, const char className[], const ITrace* const information)
+    {
+        if ((m_OutputChannel.load(std::memory_order_relaxed) != nullptr) || (m_DirectOut.load(std::memory_order_relaxed) == true)) {
+
+            LocalRing& local(Core::Thread::GetContext<LocalRing>());
+            const Arguments* arguments(information->Deferred());
+            Ring::Header header;
+
+            if (local.Get() == nullptr) {
+                local.Set(Register());
+            }
+
+            Ring& ring(*local.Get());
+
+            header.Time = Core::Time::Now().Ticks();
+            header.File = Core::FileNameOnly(file);
+            header.Module = information->Module();
+            header.Category = information->Category();
+            header.Line = lineNumber;
+            header.ClassName = static_cast<uint16_t>(strlen(className) + 1);
+            header.Deferred = (arguments != nullptr);
+            header.Length = (arguments != nullptr ? arguments->Length() : information->Length());
+
+            const uint8_t* data = (arguments != nullptr ? arguments->Data() : reinterpret_cast<const uint8_t*>(information->Data()));
+
+            ring.Enter();
+
+            if ((information->Synchronous() == true) || (ring.Push(header, className, data) == false)) {
+                // Too big, no room left, or it should be out before we return: write out what this thread
+                // has pending and this one ourselves.
+                m_Admin.Lock();
+
+                Drain(&ring);
+
+                Emit(header, className, information->Data(), information->Length());
+
+                m_Admin.Unlock();
+            } else {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                if ((ring.Used() > (TRACE_RING_SIZE / 2)) || ((m_Idle.load(std::memory_order_relaxed) == true) && (m_Idle.exchange(false) == true))) {
+                    Drainer* drainer = m_Drainer.load();
+
+                    if (drainer != nullptr) {
+                        drainer->Run();
+                    }
+                }
+            }
+
+            ring.Leave();
+        }
     }
 }
 } // namespace WPEFramework::Trace
@@ -19,6 +19,7 @@ namespace Trace {
 #define TRACE_CYCLIC_BUFFER_ENVIRONMENT _T("TRACE_PATH")
 #define TRACE_CYCLIC_BUFFER_SIZE ((8 * 1024) - (sizeof(struct Core::CyclicBuffer::control))) /* 8Kb */
 #define TRACE_CYCLIC_BUFFER_PREFIX _T("tracebuffer")
+#define TRACE_RING_SIZE (16 * 1024) /* per tracing thread, power of 2 */
 
     // ---- Class Definition ----
     class EXTERNAL TraceUnit {
@@ -100,6 +101,145 @@ namespace Trace {
             Core::DoorBell _doorBell;
         };
 
+        // Single producer (the tracing thread), single consumer (the drainer) byte ring.
+        // The producer never takes a lock, records are copied in and out as a whole.
+        class Ring {
+        private:
+            Ring(const Ring&) = delete;
+            Ring& operator=(const Ring&) = delete;
+
+        public:
+            struct Header {
+                uint64_t Time;
+                const char* File;
+                const char* Module;
+                const char* Category;
+                uint32_t Line;
+                uint16_t ClassName; // Including the '\0'
+                uint16_t Length;
+                bool Deferred; // Data is a Trace::Arguments blob, not text.
+            };
+
+        public:
+            Ring()
+                : _head(0)
+                , _tail(0)
+                , _references(2)
+                , _busy(false)
+            {
+            }
+            ~Ring()
+            {
+            }
+
+        public:
+            // Owned by the tracing thread and by the unit, the last one out deletes it.
+            inline bool Release()
+            {
+                return (_references.fetch_sub(1) == 1);
+            }
+            inline bool IsOrphan() const
+            {
+                return (_references.load() == 1);
+            }
+            inline uint32_t Used() const
+            {
+                return (_tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire));
+            }
+            // Set by the tracing thread for as long as it might wake the drainer.
+            inline void Enter()
+            {
+                _busy.store(true);
+            }
+            inline void Leave()
+            {
+                _busy.store(false, std::memory_order_release);
+            }
+            inline bool IsBusy() const
+            {
+                return (_busy.load());
+            }
+
+            bool Push(const Header& header, const char className[], const uint8_t data[]);
+            bool Peek(Header& header) const;
+            void Pop(Header& header, string& className, string& data);
+
+        private:
+            void Write(const uint32_t position, const void* data, const uint32_t length);
+            void Read(const uint32_t position, void* data, const uint32_t length) const;
+            static inline uint32_t Size(const Header& header)
+            {
+                return ((sizeof(Header) + header.ClassName + header.Length + 7) & (~7));
+            }
+
+        private:
+            std::atomic<uint32_t> _head;
+            std::atomic<uint32_t> _tail;
+            std::atomic<uint32_t> _references;
+            std::atomic<bool> _busy;
+            uint8_t _buffer[TRACE_RING_SIZE];
+        };
+
+        // Thread local handle on the ring of the thread, lets go of it if the thread exits.
+        class LocalRing {
+        private:
+            LocalRing(const LocalRing&) = delete;
+            LocalRing& operator=(const LocalRing&) = delete;
+
+        public:
+            LocalRing()
+                : _ring(nullptr)
+            {
+            }
+            ~LocalRing()
+            {
+                if ((_ring != nullptr) && (_ring->Release() == true)) {
+                    delete _ring;
+                }
+            }
+
+        public:
+            inline Ring* Get() const
+            {
+                return (_ring);
+            }
+            inline void Set(Ring* ring)
+            {
+                _ring = ring;
+            }
+
+        private:
+            Ring* _ring;
+        };
+
+        // Formats and moves the records of all rings, oldest first, to the actual outputs.
+        class Drainer : public Core::Thread {
+        private:
+            Drainer() = delete;
+            Drainer(const Drainer&) = delete;
+            Drainer& operator=(const Drainer&) = delete;
+
+        public:
+            Drainer(TraceUnit& parent)
+                : Core::Thread(Core::Thread::DefaultStackSize(), _T("TraceDrainer"))
+                , _parent(parent)
+            {
+            }
+            ~Drainer()
+            {
+                Stop();
+                Wait(Core::Thread::STOPPED, Core::infinite);
+            }
+
+        private:
+            virtual uint32_t Worker() override;
+
+        private:
+            TraceUnit& _parent;
+        };
+
+        typedef std::list<Ring*> Rings;
+
     protected:
         TraceUnit();
 
@@ -127,31 +267,42 @@ namespace Trace {
 
         inline Core::DoorBell& TraceAnnouncement()
         {
-            ASSERT(m_OutputChannel != nullptr);
-            return (m_OutputChannel->DoorBell());
+            ASSERT(m_OutputChannel.load() != nullptr);
+            return (m_OutputChannel.load()->DoorBell());
         }
 
         inline Core::CyclicBuffer* CyclicBuffer()
         {
-            return (m_OutputChannel);
+            return (m_OutputChannel.load());
         }
         inline bool HasDirectOutput() const
         {
-            return (m_DirectOut);
+            return (m_DirectOut.load());
         }
         inline void DirectOutput(const bool enabled)
         {
-            m_DirectOut = enabled;
+            m_DirectOut.store(enabled);
         }
 
     private:
         void UpdateEnabledCategories();
+        Ring* Register();
+        bool Drain();
+        void Drain(Ring* ring);
+        void Forward(Ring& ring, string& className, string& data, string& text);
+        bool Pending() const;
+        void Emit(const Ring::Header& header, const char className[], const char text[], const uint16_t length);
 
+        // The outputs and the drainer are read by Trace() without taking the lock, they are only changed
+        // with the lock taken.
         TraceControlList m_Categories;
         Core::CriticalSection m_Admin;
-        TraceBuffer* m_OutputChannel;
+        std::atomic<TraceBuffer*> m_OutputChannel;
         EnabledCategories m_EnabledCategories;
-        bool m_DirectOut;
+        std::atomic<bool> m_DirectOut;
+        Rings m_Rings;
+        std::atomic<Drainer*> m_Drainer;
+        std::atomic<bool> m_Idle;
     };
 }
 } // namespace Trace
@@ -29,6 +29,8 @@ namespace Web {
                 , _lock()
                 , _queue(queueSize)
             {
+                // Only a socket can take file content directly and only if it is not transformed.
+                OUTBOUND::Serializer::ZeroCopy((std::is_base_of<Core::SocketPort, LINK>::value == true) && (ThisClass::TraitSerializer::value == false));
             }
             virtual ~SerializerImpl()
             {
@@ -222,6 +224,26 @@ namespace Web {
                 _parent.StateChange();
             }
 
+            // Zero-copy transfer of file bodies
+            virtual uint32_t SendFile(Core::File::Handle& file)
+            {
+                return (_parent.SendFile(file));
+            }
+            virtual void SentFile(const uint32_t length)
+            {
+                _activity = true;
+                _parent.SentFile(length);
+            }
+            virtual uint32_t ReceiveFile(Core::File::Handle& file)
+            {
+                return (_parent.ReceiveFile(_parent, file));
+            }
+            virtual void ReceivedFile(const uint32_t length)
+            {
+                _activity = true;
+                _parent.ReceivedFile(length);
+            }
+
         private:
             bool _activity;
             PARENTCLASS& _parent;
@@ -419,6 +441,35 @@ namespace Web {
             return (_serializerImpl.Serialize(dataFrame, receivedSize));
         }
 
+        // Transformed content is never offered by the serializer, as ZeroCopy is not enabled for it.
+        inline uint32_t SendFile(Core::File::Handle& file)
+        {
+            return (_serializerImpl.SendFile(file));
+        }
+        inline void SentFile(const uint32_t length)
+        {
+            _serializerImpl.SentFile(length);
+        }
+
+        template <typename CLASSNAME>
+        inline typename Core::TypeTraits::enable_if<CLASSNAME::TraitDeserializer::value, uint32_t>::type
+        ReceiveFile(const CLASSNAME&, Core::File::Handle&)
+        {
+            // Content has to pass the transformation first.
+            return (0);
+        }
+
+        template <typename CLASSNAME>
+        inline typename Core::TypeTraits::enable_if<!CLASSNAME::TraitDeserializer::value, uint32_t>::type
+        ReceiveFile(const CLASSNAME&, Core::File::Handle& file)
+        {
+            return (_deserialiserImpl.ReceiveFile(file));
+        }
+        inline void ReceivedFile(const uint32_t length)
+        {
+            _deserialiserImpl.ReceivedFile(length);
+        }
+
     private:
         SerializerImpl _serializerImpl;
         DeserializerImpl _deserialiserImpl;
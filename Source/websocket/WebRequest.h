@@ -47,6 +47,7 @@ namespace Web {
 
     enum EncodingTypes {
         ENCODING_GZIP,
+        ENCODING_DEFLATE,
         ENCODING_UNKNOWN
     };
 
@@ -76,6 +77,26 @@ namespace Web {
         // The Serialize and Deserialize methods allow the content to be serialized/deserialized.
         virtual void Serialize(uint8_t[] /* stream*/, const uint16_t /* maxLength */) const = 0;
         virtual void Deserialize(const uint8_t[] /* stream*/, const uint16_t /* maxLength */) = 0;
+
+        // Bodies kept in a file can be moved between the file and a socket without passing the
+        // Serialize/Deserialize methods. Return the (positioned) file to allow this, bodies that
+        // need to see the content, to sign or transform it, keep it on the buffered path.
+        virtual Core::File::Handle SourceFile() const
+        {
+            return (INVALID_HANDLE_VALUE);
+        }
+        virtual Core::File::Handle SinkFile()
+        {
+            return (INVALID_HANDLE_VALUE);
+        }
+
+        // Bodies that have a ready made, encoded, copy of their content (e.g. a pre-compressed
+        // static file) switch over to it if asked for, and return true. The content that is
+        // serialized from then on, up to the End, is the encoded copy.
+        virtual bool Encoded(const EncodingTypes /* encoding */) const
+        {
+            return (false);
+        }
     };
 
     class EXTERNAL Signature {
@@ -266,7 +287,8 @@ namespace Web {
                 PAIR_KEY = 6,
                 PAIR_VALUE = 7,
                 BODY = 8,
-                REPORT = 9
+                REPORT = 9,
+                OFFLOAD = 10
             };
             const static uint16_t EOL_MARKER = 0x8000;
 
@@ -282,6 +304,7 @@ namespace Web {
                 , _buffer(nullptr)
                 , _lock()
                 , _current()
+                , _zeroCopy(false)
             {
             }
             ~Serializer()
@@ -316,6 +339,15 @@ namespace Web {
 
             uint16_t Serialize(uint8_t stream[], const uint16_t maxLength);
 
+            // A link that can move a file straight to its socket, enables this. Bodies kept in a file
+            // are then not copied by Serialize, the link sends them through SendFile/SentFile.
+            inline void ZeroCopy(const bool enabled)
+            {
+                _zeroCopy = enabled;
+            }
+            uint32_t SendFile(Core::File::Handle& file);
+            void SentFile(const uint32_t length);
+
         private:
             uint16_t _state;
             uint16_t _offset;
@@ -325,6 +357,7 @@ namespace Web {
             const TCHAR* _buffer;
             Core::CriticalSection _lock;
             Request* _current;
+            bool _zeroCopy;
         };
         class EXTERNAL Deserializer {
         private:
@@ -389,6 +422,11 @@ namespace Web {
                 return (usedSize);
             }
 
+            // A link that can move socket data straight into a file, offers the body bytes that are due
+            // through ReceiveFile/ReceivedFile, if the body is kept in a file as is.
+            uint32_t ReceiveFile(Core::File::Handle& file);
+            void ReceivedFile(const uint32_t length);
+
             // The whole request object is deserialised..
             virtual void Deserialized(Web::Request& element) = 0;
 
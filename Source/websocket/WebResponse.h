@@ -5,6 +5,16 @@
 #include "URL.h"
 #include "WebRequest.h"
 
+#ifndef WEB_ENCODING_THRESHOLD
+// Response bodies smaller than this (bytes) are not worth encoding, they are sent as is.
+#define WEB_ENCODING_THRESHOLD 512
+#endif
+
+#ifndef WEB_ENCODING_LEVEL
+// The zlib level (1-9) response bodies are encoded with, if the client accepts it.
+#define WEB_ENCODING_LEVEL 6
+#endif
+
 namespace WPEFramework {
 namespace Web {
     enum WebStatus {
@@ -76,6 +86,7 @@ namespace Web {
             ALLOW,
             WEBSOCKET_ACCEPT,
             WEBSOCKET_PROTOCOL,
+            WEBSOCKET_EXTENSIONS,
             LOCATION,
             WAKEUP,
             U_S_N,
@@ -106,7 +117,8 @@ namespace Web {
                 PAIR_KEY = 4,
                 PAIR_VALUE = 5,
                 BODY = 6,
-                REPORT = 7
+                REPORT = 7,
+                OFFLOAD = 8
             };
 
             const static uint16_t EOL_MARKER = 0x8000;
@@ -123,10 +135,20 @@ namespace Web {
                 , _buffer(nullptr)
                 , _lock()
                 , _current()
+                , _zeroCopy(false)
+                , _negotiated()
+                , _encoding(ENCODING_UNKNOWN)
+                , _chunked(false)
+                , _vary(false)
+                , _deflater(ENCODING_UNKNOWN)
+                , _input()
             {
             }
             ~Serializer()
             {
+                if (_deflater != ENCODING_UNKNOWN) {
+                    deflateEnd(&_zlib);
+                }
             }
 
         public:
@@ -136,6 +158,7 @@ namespace Web {
             {
                 _lock.Lock();
                 _state = VERSION;
+                _negotiated.clear();
                 Web::Response* backup = _current;
                 _current = nullptr;
                 if (backup != nullptr) {
@@ -157,6 +180,38 @@ namespace Web {
 
             uint16_t Serialize(uint8_t stream[], const uint16_t maxLength);
 
+            // A link that can move a file straight to its socket, enables this. Bodies kept in a file
+            // are then not copied by Serialize, the link sends them through SendFile/SentFile.
+            inline void ZeroCopy(const bool enabled)
+            {
+                _zeroCopy = enabled;
+            }
+            uint32_t SendFile(Core::File::Handle& file);
+            void SentFile(const uint32_t length);
+
+            // The encoding a request accepts, for the body of the response to that request. Requests
+            // can be pipelined, so this is queued: responses go out in the order of the requests, each
+            // one takes the first choice that is not taken yet. Responses that do not set a
+            // ContentEncoding themselves, are encoded with it if they are large enough. A peer that can
+            // not take chunked bodies (HTTP/1.0) only gets ready made encoded copies.
+            inline void Encoding(const EncodingTypes accepted, const bool chunking)
+            {
+                _lock.Lock();
+                _negotiated.push_back({ accepted, chunking });
+                _lock.Unlock();
+            }
+
+        private:
+            struct Negotiated {
+                EncodingTypes Accepted;
+                bool Chunking;
+            };
+
+        private:
+            void Prepare();
+            bool Deflater(const EncodingTypes encoding);
+            uint16_t Encode(uint8_t stream[], const uint16_t maxLength);
+
         private:
             uint16_t _state;
             uint16_t _offset;
@@ -166,6 +221,14 @@ namespace Web {
             const TCHAR* _buffer;
             Core::CriticalSection _lock;
             Response* _current;
+            bool _zeroCopy;
+            std::list<Negotiated> _negotiated;
+            EncodingTypes _encoding;
+            bool _chunked;
+            bool _vary;
+            EncodingTypes _deflater;
+            z_stream _zlib;
+            std::vector<uint8_t> _input;
         };
         class EXTERNAL Deserializer {
         private:
@@ -230,6 +293,11 @@ namespace Web {
                 return (usedSize);
             }
 
+            // A link that can move socket data straight into a file, offers the body bytes that are due
+            // through ReceiveFile/ReceivedFile, if the body is kept in a file as is.
+            uint32_t ReceiveFile(Core::File::Handle& file);
+            void ReceivedFile(const uint32_t length);
+
             // The whole response object is deserialised..
             virtual void Deserialized(Web::Response& element) = 0;
 
@@ -383,6 +451,7 @@ namespace Web {
             ContentLength.Clear();
             ContentEncoding.Clear();
             WebSocketAccept.Clear();
+            WebSocketExtensions.Clear();
             AccessControlOrigin.Clear();
             AccessControlMethod.Clear();
             AccessControlHeaders.Clear();
@@ -431,6 +500,7 @@ namespace Web {
         Core::OptionalType<string> WakeUp;
         Core::OptionalType<string> ETag;
         Core::OptionalType<string> WebSocketProtocol;
+        Core::OptionalType<string> WebSocketExtensions;
         Core::OptionalType<string> CacheControl;
         Core::OptionalType<Core::URL> ApplicationURL;
 
@@ -23,6 +23,7 @@ static const TCHAR __CONNECTION_UPGRADE[] = _T("UPGRADE");
 static const TCHAR __CONNECTION_CLOSE[] = _T("CLOSE");
 static const TCHAR __CONNECTION_KEEPALIVE[] = _T("KEEP-ALIVE");
 static const TCHAR __ENCODING_GZIP[] = _T("GZIP");
+static const TCHAR __ENCODING_DEFLATE[] = _T("DEFLATE");
 
 static const TCHAR __HOST[] = _T("HOST:");
 static const TCHAR __UPGRADE[] = _T("UPGRADE:");
@@ -51,6 +52,7 @@ static const TCHAR __MODIFIED[] = _T("LAST-MODIFIED:");
 static const TCHAR __ACCEPT_RANGE[] = _T("ACCEPT-RANGES:");
 static const TCHAR __ETAG[] = _T("ETAG:");
 static const TCHAR __ALLOW[] = _T("ALLOW:");
+static const TCHAR __VARY[] = _T("VARY:");
 static const TCHAR __WEBSOCKET_KEY[] = _T("SEC-WEBSOCKET-KEY:");
 static const TCHAR __WEBSOCKET_PROTOCOL[] = _T("SEC-WEBSOCKET-PROTOCOL:");
 static const TCHAR __WEBSOCKET_VERSION[] = _T("SEC-WEBSOCKET-VERSION:");
@@ -105,7 +107,8 @@ ENUM_CONVERSION_END(Web::MIMETypes)
 
 ENUM_CONVERSION_BEGIN(Web::EncodingTypes)
 
-    { Web::ENCODING_GZIP, _TXT(__ENCODING_GZIP) },
+    { Web::ENCODING_GZIP, _TXT("gzip") },
+    { Web::ENCODING_DEFLATE, _TXT("deflate") },
     { Web::ENCODING_UNKNOWN, _TXT(__UNKNOWN) },
 
 ENUM_CONVERSION_END(Web::EncodingTypes)
@@ -208,6 +211,7 @@ ENUM_CONVERSION_BEGIN(Web::Request::keywords)
     { Web::Request::WEBSOCKET_KEY, __TXT(__WEBSOCKET_KEY) },
     { Web::Request::WEBSOCKET_PROTOCOL, __TXT(__WEBSOCKET_PROTOCOL) },
     { Web::Request::WEBSOCKET_VERSION, __TXT(__WEBSOCKET_VERSION) },
+    { Web::Request::WEBSOCKET_EXTENSIONS, __TXT(__WEBSOCKET_EXTENSIONS) },
     { Web::Request::MAN, __TXT(__MAN) },
     { Web::Request::M_X, __TXT(__MX) },
     { Web::Request::S_T, __TXT(__ST) },
@@ -252,6 +256,7 @@ ENUM_CONVERSION_BEGIN(Web::Response::keywords)
     { Web::Response::ACCESS_CONTROL_MAX_AGE, __TXT(__ACCESS_CONTROL_MAX_AGE) },
     { Web::Response::WEBSOCKET_ACCEPT, __TXT(__WEBSOCKET_ACCEPT) },
     { Web::Response::WEBSOCKET_PROTOCOL, __TXT(__WEBSOCKET_PROTOCOL) },
+    { Web::Response::WEBSOCKET_EXTENSIONS, __TXT(__WEBSOCKET_EXTENSIONS) },
     { Web::Response::LOCATION, __TXT(__LOCATION) },
     { Web::Response::WAKEUP, __TXT(__WAKEUP) },
     { Web::Response::U_S_N, __TXT(__USN) },
@@ -299,6 +304,28 @@ namespace Web
     static const TCHAR DefaultPath[] = _T("/");
     static const TCHAR HTTPKeyWord[] = _T("HTTP/");
 
+    static constexpr uint16_t EncodingBufferSize = 4096;
+    static constexpr uint8_t ChunkHeaderSize = 6;
+    static constexpr uint8_t ChunkTrailerSize = 2;
+    static constexpr uint8_t ChunkEndSize = 5;
+
+    // A coding with a quality of 0 (";q=0", ";q=0.0", ...) is not acceptable to the client.
+    static bool IsRefused(const Core::TextFragment& parameter)
+    {
+        Core::TextFragment text(parameter);
+
+        text.TrimBegin(_T(" \t"));
+        text.TrimEnd(_T(" \t"));
+
+        return ((text.Length() > 2) && (Core::TextFragment(text, 0, 2).EqualText(_T("q="), 0, 2, false) == true) && (text.ForwardSkip(_T("0."), 2) == text.Length()));
+    }
+
+    // Content that is compressed by itself, does not get any smaller by encoding it again.
+    static bool IsCompressible(const Core::OptionalType<MIMETypes>& type)
+    {
+        return ((type.IsSet() == false) || ((type.Value() != MIME_BINARY) && (type.Value() != MIME_IMAGE_WEBP) && (type.Value() != MIME_IMAGE_GIF) && (type.Value() != MIME_IMAGE_JPG) && (type.Value() != MIME_IMAGE_PNG) && (type.Value() != MIME_APPLICATION_FONT_WOFF) && (type.Value() != MIME_APPLICATION_JAVA_ARCHIVE)));
+    }
+
     static struct FileExtensionTable {
         Web::MIMETypes type;
         const TCHAR* fileExtension;
@@ -505,7 +532,7 @@ namespace Web
         }
 
         if (_current != nullptr) {
-            while ((current < maxLength) && (_state != REPORT)) {
+            while ((current < maxLength) && (_state != REPORT) && (_state != OFFLOAD)) {
                 while ((current < maxLength) && ((_state & EOL_MARKER) == EOL_MARKER)) {
                     if (_offset == 0) {
                         stream[current++] = '\r';
@@ -845,7 +872,10 @@ namespace Web
                     break;
                 }
                 case BODY: {
-                    if (_bodyLength != 0) {
+                    if ((_bodyLength != 0) && (_zeroCopy == true) && (_current->_body->SourceFile() != INVALID_HANDLE_VALUE)) {
+                        // The link sends the content straight from the file.
+                        _state = OFFLOAD;
+                    } else if (_bodyLength != 0) {
                         ASSERT(maxLength >= current);
                         uint32_t size = (static_cast<uint32_t>(maxLength - current) <= _bodyLength ? static_cast<uint32_t>(maxLength - current) : _bodyLength);
 
@@ -881,9 +911,42 @@ namespace Web
         return (current);
     }
 
+    uint32_t Request::Serializer::SendFile(Core::File::Handle& file)
+    {
+        uint32_t result = 0;
+
+        _lock.Lock();
+
+        if ((_current != nullptr) && (_state == OFFLOAD)) {
+            file = _current->_body->SourceFile();
+            result = _bodyLength;
+        }
+
+        _lock.Unlock();
+
+        return (result);
+    }
+
+    void Request::Serializer::SentFile(const uint32_t length)
+    {
+        _lock.Lock();
+
+        ASSERT(_state == OFFLOAD);
+        ASSERT(length <= _bodyLength);
+
+        _bodyLength -= length;
+
+        if (_bodyLength == 0) {
+            _state = REPORT;
+        }
+
+        _lock.Unlock();
+    }
+
     uint16_t Response::Serializer::Serialize(uint8_t stream[], const uint16_t maxLength)
     {
         uint16_t current = 0;
+        uint16_t limit = maxLength;
 
         _lock.Lock();
 
@@ -899,7 +962,7 @@ namespace Web
         }
 
         if (_current != nullptr) {
-            while ((current < maxLength) && (_state != REPORT)) {
+            while ((current < limit) && (_state != REPORT) && (_state != OFFLOAD)) {
                 while ((current < maxLength) && ((_state & EOL_MARKER) == EOL_MARKER)) {
                     if (_offset == 0) {
                         stream[current++] = '\r';
@@ -1002,6 +1065,9 @@ namespace Web
                             _offset = 0;
                             _state = PAIR_KEY | EOL_MARKER;
                             _keyIndex = static_cast<Response::keywords>(0);
+
+                            // The headers depend on how the body is going to be sent.
+                            Prepare();
                         }
                     }
                     break;
@@ -1055,8 +1121,13 @@ namespace Web
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __WEBSOCKET_PROTOCOL : _T("Sec-WebSocket-Protocol:"));
                             _value = _current->WebSocketProtocol.Value();
                             _offset = 0;
-                        } else if ((_keyIndex <= 9) && (_current->Allowed.IsSet() == true)) {
+                        } else if ((_keyIndex <= 9) && (_current->WebSocketExtensions.IsSet() == true)) {
                             _keyIndex = 10;
+                            _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __WEBSOCKET_EXTENSIONS : _T("Sec-WebSocket-Extensions:"));
+                            _value = _current->WebSocketExtensions.Value();
+                            _offset = 0;
+                        } else if ((_keyIndex <= 10) && (_current->Allowed.IsSet() == true)) {
+                            _keyIndex = 11;
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __ALLOW : _T("Allow:"));
                             _value = _T("");
                             _offset = 0;
@@ -1075,18 +1146,18 @@ namespace Web
                                 }
                                 entry = Core::EnumerateType<Request::type>::Entry(++index);
                             }
-                        } else if ((_keyIndex <= 10) && (_current->AccessControlHeaders.IsSet() == true)) {
-                            _keyIndex = 11;
+                        } else if ((_keyIndex <= 11) && (_current->AccessControlHeaders.IsSet() == true)) {
+                            _keyIndex = 12;
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __ACCESS_CONTROL_ALLOW_HEADERS : _T("Access-Control-Allow-Headers:"));
                             _value = _current->AccessControlHeaders.Value();
                             _offset = 0;
-                        } else if ((_keyIndex <= 11) && (_current->AccessControlOrigin.IsSet() == true)) {
-                            _keyIndex = 12;
+                        } else if ((_keyIndex <= 12) && (_current->AccessControlOrigin.IsSet() == true)) {
+                            _keyIndex = 13;
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __ACCESS_CONTROL_ALLOW_ORIGIN : _T("Access-Control-Allow-Origin:"));
                             _value = _current->AccessControlOrigin.Value();
                             _offset = 0;
-                        } else if ((_keyIndex <= 12) && (_current->AccessControlMethod.IsSet() == true)) {
-                            _keyIndex = 13;
+                        } else if ((_keyIndex <= 13) && (_current->AccessControlMethod.IsSet() == true)) {
+                            _keyIndex = 14;
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __ACCESS_CONTROL_ALLOW_METHODS : _T("Access-Control-Allow-Methods:"));
                             _value = _T("");
                             _offset = 0;
@@ -1105,17 +1176,17 @@ namespace Web
                                 }
                                 entry = Core::EnumerateType<Request::type>::Entry(++index);
                             }
-                        } else if ((_keyIndex <= 13) && (_current->AccessControlMaxAge.IsSet() == true)) {
-                            _keyIndex = 14;
+                        } else if ((_keyIndex <= 14) && (_current->AccessControlMaxAge.IsSet() == true)) {
+                            _keyIndex = 15;
 
                             Core::NumberType<uint32_t, false, BASE_DECIMAL> number(_current->AccessControlMaxAge.Value());
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __ACCESS_CONTROL_MAX_AGE : _T("Access-Control-Max-Age:"));
                             number.Serialize(_value);
                             _offset = 0;
-                        } else if ((_keyIndex <= 14) && (_current->ContentType.IsSet() == true)) {
+                        } else if ((_keyIndex <= 15) && (_current->ContentType.IsSet() == true)) {
                             Core::EnumerateType<MIMETypes> enumValue(_current->ContentType.Value());
 
-                            _keyIndex = 15;
+                            _keyIndex = 16;
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __CONTENT_TYPE : _T("Content-Type:"));
                             _value = enumValue.Data();
                             if (_current->ContentCharacterSet.IsSet() == true) {
@@ -1125,59 +1196,64 @@ namespace Web
                             }
 
                             _offset = 0;
-                        } else if ((_keyIndex <= 15) && (_current->ContentEncoding.IsSet() == true)) {
-                            Core::EnumerateType<EncodingTypes> enumValue(_current->ContentEncoding.Value());
+                        } else if ((_keyIndex <= 16) && (_encoding != ENCODING_UNKNOWN)) {
+                            Core::EnumerateType<EncodingTypes> enumValue(_encoding);
 
-                            _keyIndex = 16;
+                            _keyIndex = 17;
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __CONTENT_ENCODING : _T("Content-Encoding:"));
                             _value = enumValue.Data();
                             _offset = 0;
-                        } else if ((_keyIndex <= 16) && (_current->TransferEncoding.IsSet() == true)) {
-                            Core::EnumerateType<TransferTypes> enumValue(_current->TransferEncoding.Value());
+                        } else if ((_keyIndex <= 17) && (_vary == true)) {
+                            _keyIndex = 18;
+                            _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __VARY : _T("Vary:"));
+                            _value = _T("Accept-Encoding");
+                            _offset = 0;
+                        } else if ((_keyIndex <= 18) && ((_chunked == true) || (_current->TransferEncoding.IsSet() == true))) {
+                            Core::EnumerateType<TransferTypes> enumValue(_chunked == true ? TRANSFER_CHUNKED : _current->TransferEncoding.Value());
 
-                            _keyIndex = 17;
+                            _keyIndex = 19;
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __TRANSFER_ENCODING : _T("Transfer-Encoding:"));
                             _value = enumValue.Data();
                             _offset = 0;
-                        } else if ((_keyIndex <= 17) && (_current->Location.IsSet() == true)) {
-                            _keyIndex = 18;
+                        } else if ((_keyIndex <= 19) && (_current->Location.IsSet() == true)) {
+                            _keyIndex = 20;
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __LOCATION : _T("Location:"));
                             _value = _current->Location.Value();
                             _offset = 0;
-                        } else if ((_keyIndex <= 18) && (_current->WakeUp.IsSet() == true)) {
-                            _keyIndex = 19;
+                        } else if ((_keyIndex <= 20) && (_current->WakeUp.IsSet() == true)) {
+                            _keyIndex = 21;
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __WAKEUP : _T("Wakeup:"));
                             _value = _current->WakeUp.Value();
                             _offset = 0;
-                        } else if ((_keyIndex <= 19) && (_current->USN.IsSet() == true)) {
-                            _keyIndex = 20;
+                        } else if ((_keyIndex <= 21) && (_current->USN.IsSet() == true)) {
+                            _keyIndex = 22;
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __USN : _T("USN:"));
                             _value = _current->USN.Value();
                             _offset = 0;
-                        } else if ((_keyIndex <= 20) && (_current->ST.IsSet() == true)) {
-                            _keyIndex = 21;
+                        } else if ((_keyIndex <= 22) && (_current->ST.IsSet() == true)) {
+                            _keyIndex = 23;
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __ST : _T("ST:"));
                             _value = _current->ST.Value();
                             _offset = 0;
-                        } else if ((_keyIndex <= 21) && (_current->CacheControl.IsSet() == true)) {
-                            _keyIndex = 22;
+                        } else if ((_keyIndex <= 23) && (_current->CacheControl.IsSet() == true)) {
+                            _keyIndex = 24;
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __CACHE_CONTROL : _T("Cache-Control:"));
                             _value = _current->CacheControl.Value();
                             _offset = 0;
-                        } else if ((_keyIndex <= 22) && (_current->ApplicationURL.IsSet() == true)) {
-                            _keyIndex = 23;
+                        } else if ((_keyIndex <= 24) && (_current->ApplicationURL.IsSet() == true)) {
+                            _keyIndex = 25;
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __APPLICATION_URL : _T("Application-URL:"));
                             _value = _current->ApplicationURL.Value().Text().Text();
                             _offset = 0;
-                        } else if ((_keyIndex <= 23) && (((_bodyLength = (_current->_body.IsValid() ? _current->_body->Serialize() : 0)) > 0) || (_current->ContentLength.IsSet() == true) || (!_current->Connection.IsSet()) || (_current->Connection.Value() != Response::CONNECTION_CLOSE))) {
-                            _keyIndex = (_bodyLength > 0 ? 24 : 25);
+                        } else if ((_keyIndex <= 25) && (_chunked == false) && ((_bodyLength > 0) || (_current->ContentLength.IsSet() == true) || (!_current->Connection.IsSet()) || (_current->Connection.Value() != Response::CONNECTION_CLOSE))) {
+                            _keyIndex = (_bodyLength > 0 ? 26 : 27);
 
                             Core::NumberType<uint32_t, false, BASE_DECIMAL> number(_bodyLength);
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __CONTENT_LENGTH : _T("Content-Length:"));
                             number.Serialize(_value);
                             _offset = 0;
-                        } else if ((_keyIndex <= 24) && (_current->ContentSignature.IsSet() == true)) {
-                            _keyIndex = 25;
+                        } else if ((_keyIndex <= 26) && (_current->ContentSignature.IsSet() == true)) {
+                            _keyIndex = 27;
                             _buffer = (_current->Mode() == MARSHAL_UPPERCASE ? __CONTENT_SIGNATURE : _T("Content-HMAC:"));
                             FromSignature(_current->ContentSignature.Value(), _value);
                             _offset = 0;
@@ -1224,21 +1300,34 @@ namespace Web
                     break;
                 }
                 case BODY: {
-                    if (_bodyLength != 0) {
-                        ASSERT(maxLength >= current);
-                        uint32_t size = (static_cast<uint32_t>(maxLength - current) <= _bodyLength ? static_cast<uint32_t>(maxLength - current) : _bodyLength);
-
-                        if (size > 0) {
-                            ASSERT(_current->_body.IsValid() == true);
+                    if (_chunked == true) {
+                        uint16_t size = Encode(&(stream[current]), maxLength - current);
 
-                            _current->_body->Serialize(&(stream[current]), size);
-                            _bodyLength -= size;
-                            current += size;
+                        if (size == 0) {
+                            // No room left for a chunk, it goes out with the next frame.
+                            limit = current;
+                        }
+                        current += size;
+                    } else {
+                        if ((_bodyLength != 0) && (_zeroCopy == true) && (_current->_body->SourceFile() != INVALID_HANDLE_VALUE)) {
+                            // The link sends the content straight from the file.
+                            _state = OFFLOAD;
+                        } else if (_bodyLength != 0) {
+                            ASSERT(maxLength >= current);
+                            uint32_t size = (static_cast<uint32_t>(maxLength - current) <= _bodyLength ? static_cast<uint32_t>(maxLength - current) : _bodyLength);
+
+                            if (size > 0) {
+                                ASSERT(_current->_body.IsValid() == true);
+
+                                _current->_body->Serialize(&(stream[current]), size);
+                                _bodyLength -= size;
+                                current += size;
+                            }
                         }
-                    }
 
-                    if (_bodyLength == 0) {
-                        _state = REPORT;
+                        if (_bodyLength == 0) {
+                            _state = REPORT;
+                        }
                     }
                     break;
                 }
@@ -1260,6 +1349,186 @@ namespace Web
         return (current);
     }
 
+    uint32_t Response::Serializer::SendFile(Core::File::Handle& file)
+    {
+        uint32_t result = 0;
+
+        _lock.Lock();
+
+        if ((_current != nullptr) && (_state == OFFLOAD)) {
+            file = _current->_body->SourceFile();
+            result = _bodyLength;
+        }
+
+        _lock.Unlock();
+
+        return (result);
+    }
+
+    void Response::Serializer::SentFile(const uint32_t length)
+    {
+        _lock.Lock();
+
+        ASSERT(_state == OFFLOAD);
+        ASSERT(length <= _bodyLength);
+
+        _bodyLength -= length;
+
+        if (_bodyLength == 0) {
+            _state = REPORT;
+        }
+
+        _lock.Unlock();
+    }
+
+    void Response::Serializer::Prepare()
+    {
+        // What the request of this response accepts. Nothing negotiated, means nothing to encode.
+        Negotiated negotiated({ ENCODING_UNKNOWN, true });
+
+        if (_negotiated.empty() == false) {
+            negotiated = _negotiated.front();
+            _negotiated.pop_front();
+        }
+
+        // An encoding set on the response is always honoured, the one the peer accepts only for
+        // content that is not compressed already.
+        EncodingTypes encoding = (_current->ContentEncoding.IsSet() == true ? _current->ContentEncoding.Value() : (IsCompressible(_current->ContentType) == true ? negotiated.Accepted : ENCODING_UNKNOWN));
+
+        _bodyLength = (_current->_body.IsValid() == true ? _current->_body->Serialize() : 0);
+        _encoding = ENCODING_UNKNOWN;
+        _chunked = false;
+
+        if ((encoding != ENCODING_UNKNOWN) && (_bodyLength >= WEB_ENCODING_THRESHOLD)) {
+            if (_current->_body->Encoded(encoding) == true) {
+                // The body has an encoded copy of itself, that one goes out as is.
+                _bodyLength = _current->_body->Serialize();
+                _encoding = encoding;
+            } else if ((negotiated.Chunking == true) && (Deflater(encoding) == true)) {
+                // Encoded on the fly, the size is only known at the end, so it goes out in chunks.
+                _encoding = encoding;
+                _chunked = true;
+            }
+        }
+
+        // What goes out depends on the Accept-Encoding of the request, caches must know that.
+        _vary = (_encoding != ENCODING_UNKNOWN) && (_current->ContentEncoding.IsSet() == false);
+    }
+
+    bool Response::Serializer::Deflater(const EncodingTypes encoding)
+    {
+        // The stream is kept for the next responses, it is only set up again for another format.
+        if (_deflater == encoding) {
+            deflateReset(&_zlib);
+        } else {
+            if (_deflater != ENCODING_UNKNOWN) {
+                deflateEnd(&_zlib);
+                _deflater = ENCODING_UNKNOWN;
+            }
+
+            _zlib.zalloc = nullptr;
+            _zlib.zfree = nullptr;
+            _zlib.opaque = nullptr;
+
+            if (deflateInit2(&_zlib, WEB_ENCODING_LEVEL, Z_DEFLATED, (encoding == ENCODING_GZIP ? 16 + MAX_WBITS : MAX_WBITS), 8, Z_DEFAULT_STRATEGY) == Z_OK) {
+                _deflater = encoding;
+                _input.resize(EncodingBufferSize);
+            } else {
+                TRACE_L1("Could not set up the %s encoder, the body is sent as is.", (encoding == ENCODING_GZIP ? _T("gzip") : _T("deflate")));
+            }
+        }
+
+        _zlib.avail_in = 0;
+        _zlib.next_in = nullptr;
+
+        return (_deflater == encoding);
+    }
+
+    uint16_t Response::Serializer::Encode(uint8_t stream[], const uint16_t maxLength)
+    {
+        uint16_t result = 0;
+
+        // A chunk is "XXXX\r\n<data>\r\n", with a fixed width size, so the data can be deflated straight
+        // into place. There should always be room for the closing "0\r\n\r\n" as well.
+        if (maxLength > (ChunkHeaderSize + ChunkTrailerSize + ChunkEndSize)) {
+            int status;
+
+            _zlib.next_out = &(stream[ChunkHeaderSize]);
+            _zlib.avail_out = maxLength - (ChunkHeaderSize + ChunkTrailerSize + ChunkEndSize);
+
+            do {
+                if ((_zlib.avail_in == 0) && (_bodyLength > 0)) {
+                    uint16_t size = static_cast<uint16_t>(std::min(_bodyLength, static_cast<uint32_t>(_input.size())));
+
+                    _current->_body->Serialize(_input.data(), size);
+                    _zlib.next_in = _input.data();
+                    _zlib.avail_in = size;
+                    _bodyLength -= size;
+                }
+
+                status = deflate(&_zlib, (_bodyLength == 0 ? Z_FINISH : Z_NO_FLUSH));
+
+            } while ((status == Z_OK) && (_zlib.avail_out != 0));
+
+            uint16_t size = static_cast<uint16_t>(maxLength - (ChunkHeaderSize + ChunkTrailerSize + ChunkEndSize) - _zlib.avail_out);
+
+            if (size > 0) {
+                static const TCHAR hex[] = _T("0123456789ABCDEF");
+
+                stream[0] = hex[(size >> 12) & 0xF];
+                stream[1] = hex[(size >> 8) & 0xF];
+                stream[2] = hex[(size >> 4) & 0xF];
+                stream[3] = hex[size & 0xF];
+                stream[4] = '\r';
+                stream[5] = '\n';
+                result = ChunkHeaderSize + size;
+                stream[result++] = '\r';
+                stream[result++] = '\n';
+            }
+
+            if (status != Z_OK) {
+                if (status != Z_STREAM_END) {
+                    TRACE_L1("Encoding the body failed [%d], it is cut short.", status);
+                }
+
+                ::memcpy(&(stream[result]), "0\r\n\r\n", ChunkEndSize);
+                result += ChunkEndSize;
+                _state = REPORT;
+            }
+        }
+
+        return (result);
+    }
+
+    uint32_t Request::Deserializer::ReceiveFile(Core::File::Handle& file)
+    {
+        uint32_t result = 0;
+
+        _lock.Lock();
+
+        // Only content that is stored as is, not encoded, can bypass the parser.
+        if ((_current != nullptr) && (_current->_body.IsValid() == true) && (_zlibResult == static_cast<uint32_t>(~0)) && ((result = _parser.PassThrough()) != 0)) {
+            file = _current->_body->SinkFile();
+
+            if (file == INVALID_HANDLE_VALUE) {
+                result = 0;
+            }
+        }
+
+        _lock.Unlock();
+
+        return (result);
+    }
+
+    void Request::Deserializer::ReceivedFile(const uint32_t length)
+    {
+        _lock.Lock();
+
+        _parser.Passed(length);
+
+        _lock.Unlock();
+    }
+
     void Request::Deserializer::Parse(const uint8_t stream[], const uint16_t maxLength)
     {
         ASSERT(_current != nullptr);
@@ -1384,7 +1653,7 @@ namespace Web
                         _zlib.opaque = nullptr;
                         _zlib.avail_in = 0;
                         _zlib.next_in = nullptr;
-                        _zlibResult = inflateInit2(&_zlib, 16 + MAX_WBITS);
+                        _zlibResult = inflateInit2(&_zlib, 32 + MAX_WBITS);
                     } else {
                         _zlibResult = static_cast<uint32_t>(~0);
                     }
@@ -1478,12 +1747,30 @@ namespace Web
                 break;
             }
             case Request::ACCEPT_ENCODING: {
-                // We only allow for GZIP, right now, so see if it is an allowed format, if so, use it.
+                // We allow for GZIP and DEFLATE, GZIP is preferred if both are accepted.
                 Core::TextSegmentIterator entries(Core::TextFragment(buffer), true, ',');
 
                 while (entries.Next() != false) {
-                    if (entries.Current().EqualText(__ENCODING_GZIP, 0, ((sizeof(__ENCODING_GZIP) / sizeof(TCHAR)) - 1), false) == true) {
-                        _current->AcceptEncoding = ENCODING_GZIP;
+                    Core::TextSegmentIterator parameters(entries.Current(), true, ';');
+
+                    if (parameters.Next() == true) {
+                        Core::TextFragment coding(parameters.Current());
+                        bool refused = false;
+
+                        coding.TrimBegin(_T(" \t"));
+                        coding.TrimEnd(_T(" \t"));
+
+                        while ((refused == false) && (parameters.Next() == true)) {
+                            refused = IsRefused(parameters.Current());
+                        }
+
+                        if (refused == false) {
+                            if (coding.EqualText(__ENCODING_GZIP, 0, ((sizeof(__ENCODING_GZIP) / sizeof(TCHAR)) - 1), false) == true) {
+                                _current->AcceptEncoding = ENCODING_GZIP;
+                            } else if ((coding.EqualText(__ENCODING_DEFLATE, 0, ((sizeof(__ENCODING_DEFLATE) / sizeof(TCHAR)) - 1), false) == true) && (_current->AcceptEncoding.IsSet() == false)) {
+                                _current->AcceptEncoding = ENCODING_DEFLATE;
+                            }
+                        }
                     }
                 }
                 break;
@@ -1643,6 +1930,35 @@ namespace Web
         }
     }
 
+    uint32_t Response::Deserializer::ReceiveFile(Core::File::Handle& file)
+    {
+        uint32_t result = 0;
+
+        _lock.Lock();
+
+        // Only content that is stored as is, not encoded, can bypass the parser.
+        if ((_current != nullptr) && (_current->_body.IsValid() == true) && (_zlibResult == static_cast<uint32_t>(~0)) && ((result = _parser.PassThrough()) != 0)) {
+            file = _current->_body->SinkFile();
+
+            if (file == INVALID_HANDLE_VALUE) {
+                result = 0;
+            }
+        }
+
+        _lock.Unlock();
+
+        return (result);
+    }
+
+    void Response::Deserializer::ReceivedFile(const uint32_t length)
+    {
+        _lock.Lock();
+
+        _parser.Passed(length);
+
+        _lock.Unlock();
+    }
+
     void Response::Deserializer::Parse(const uint8_t stream[], const uint16_t maxLength)
     {
         ASSERT(_current != nullptr);
@@ -1741,7 +2057,7 @@ namespace Web
                         _zlib.opaque = nullptr;
                         _zlib.avail_in = 0;
                         _zlib.next_in = nullptr;
-                        _zlibResult = inflateInit2(&_zlib, 16 + MAX_WBITS);
+                        _zlibResult = inflateInit2(&_zlib, 32 + MAX_WBITS);
                     } else {
                         _zlibResult = static_cast<uint32_t>(~0);
                     }
@@ -1798,6 +2114,9 @@ namespace Web
             case Response::WEBSOCKET_PROTOCOL:
                 _current->WebSocketProtocol = buffer;
                 break;
+            case Response::WEBSOCKET_EXTENSIONS:
+                _current->WebSocketExtensions = buffer;
+                break;
             case Response::CONTENT_SIGNATURE:
                 _current->ContentSignature = ToSignature(buffer);
                 break;
@@ -129,6 +129,8 @@ namespace Web {
             : Core::File()
             , _opened(false)
             , _startPosition(0)
+            , _variant()
+            , _encoded(false)
         {
         }
 
@@ -136,6 +138,8 @@ namespace Web {
             : Core::File(path, sharable)
             , _opened(false)
             , _startPosition(0)
+            , _variant()
+            , _encoded(false)
         {
         }
 
@@ -160,8 +164,18 @@ namespace Web {
         }
 
     protected:
+        // Where the body starts in the file, only the remainder is sent.
+        inline int32_t Offset() const
+        {
+            return (_startPosition);
+        }
+
         virtual uint32_t Serialize() const override
         {
+            if (_encoded == true) {
+                return ((_variant.IsOpen() == true) || (_variant.Open() == true) ? static_cast<uint32_t>(_variant.Size()) : 0);
+            }
+
             _opened = (Core::File::IsOpen() == false);
 
             if (_opened == false) {
@@ -177,15 +191,40 @@ namespace Web {
         }
         virtual void Serialize(uint8_t stream[], const uint16_t maxLength) const override
         {
-
-            Core::File::Read(stream, maxLength);
+            if (_encoded == true) {
+                _variant.Read(stream, maxLength);
+            } else {
+                Core::File::Read(stream, maxLength);
+            }
         }
         virtual void Deserialize(const uint8_t stream[], const uint16_t maxLength) override
         {
             Core::File::Write(stream, maxLength);
         }
+        virtual Core::File::Handle SourceFile() const override
+        {
+            return (_encoded == true ? static_cast<Core::File::Handle>(_variant) : static_cast<Core::File::Handle>(const_cast<FileBody&>(*this)));
+        }
+        virtual Core::File::Handle SinkFile() override
+        {
+            return (static_cast<Core::File::Handle>(*this));
+        }
+        virtual bool Encoded(const EncodingTypes encoding) const override
+        {
+            // A gzip copy of the whole file, next to it, is used as long as it is not older than the file.
+            if ((encoding == ENCODING_GZIP) && (_startPosition == 0)) {
+                _variant = Core::File::Name() + _T(".gz");
+                _encoded = (_variant.Exists() == true) && (_variant.IsDirectory() == false) && (_variant.ModificationTime() >= Core::File::ModificationTime());
+            }
+
+            return (_encoded);
+        }
         virtual void End() const override
         {
+            if (_encoded == true) {
+                _variant.Close();
+                _encoded = false;
+            }
             if (Core::File::IsOpen() == true) {
                 if (_opened == true) {
                     Core::File::Close();
@@ -198,6 +237,8 @@ namespace Web {
     private:
         mutable bool _opened;
         mutable int32_t _startPosition;
+        mutable Core::File _variant;
+        mutable bool _encoded;
     };
 
     template <typename HASHALGORITHM>
@@ -244,19 +285,24 @@ namespace Web {
         {
             _hash.Reset();
 
-            // Read all Data
-            uint32_t length = FileBody::Serialize();
+            if (FileBody::Offset() == 0) {
+                // The whole file is sent, hash it straight from a memory map.
+                Crypto::HashFile(Core::File::Name(), _hash);
+            } else {
+                // Read all Data
+                uint32_t length = FileBody::Serialize();
 
-            uint8_t buffer[64];
+                uint8_t buffer[64];
 
-            while (length > 0) {
-                uint16_t size = (length > 64 ? 64 : length);
-                FileBody::Serialize(buffer, size);
-                _hash.Input(buffer, size);
-                length -= size;
-            }
+                while (length > 0) {
+                    uint16_t size = (length > 64 ? 64 : length);
+                    FileBody::Serialize(buffer, size);
+                    _hash.Input(buffer, size);
+                    length -= size;
+                }
 
-            FileBody::End();
+                FileBody::End();
+            }
 
             return (_hash.Result());
         }
@@ -279,6 +325,11 @@ namespace Web {
             // Also pass it through our hashing algorithm.
             _hash.Input(stream, maxLength);
         }
+        virtual Core::File::Handle SinkFile() override
+        {
+            // The content has to pass the hash, it can not bypass us.
+            return (INVALID_HANDLE_VALUE);
+        }
 
         mutable HASHALGORITHM _hash;
     };
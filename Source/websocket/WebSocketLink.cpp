@@ -1,5 +1,13 @@
 #include "WebSocketLink.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define __WEBSOCKET_MASK_X86__
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define __WEBSOCKET_MASK_NEON__
+#endif
+
 namespace WPEFramework {
 namespace Web {
     namespace WebSocket {
@@ -21,8 +29,126 @@ namespace Web {
         static const uint8_t TYPE_FRAME = 0x0F;
         static const uint8_t MASKING_FRAME = 0x80;
         static const uint8_t CONTROL_FRAME = 0x08;
+        static const uint8_t RESERVED_FRAME = 0x70;
+        static const uint8_t COMPRESSED_FRAME = 0x40;
         static const uint8_t HandShakeKey[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
 
+        namespace {
+
+            // A kernel masks as many bytes as fit its width and returns how many it did. The key is
+            // loaded from its byte layout in memory, so XOR-ing it as a word is endian neutral.
+            // Every block is loaded before it is stored, so a destination before the source is safe.
+            typedef uint32_t (*MaskKernel)(uint8_t[], const uint8_t[], const uint32_t, const uint32_t);
+
+            uint32_t MaskWord(uint8_t destination[], const uint8_t source[], const uint32_t length, const uint32_t key)
+            {
+                const uint64_t pattern = (static_cast<uint64_t>(key) << 32) | key;
+                uint32_t index = 0;
+
+                while ((index + sizeof(pattern)) <= length) {
+                    uint64_t value;
+                    ::memcpy(&value, &source[index], sizeof(value));
+                    value ^= pattern;
+                    ::memcpy(&destination[index], &value, sizeof(value));
+                    index += sizeof(pattern);
+                }
+
+                return (index);
+            }
+
+#if defined(__WEBSOCKET_MASK_X86__)
+            __attribute__((target("sse2"))) uint32_t MaskSSE2(uint8_t destination[], const uint8_t source[], const uint32_t length, const uint32_t key)
+            {
+                const __m128i pattern = _mm_set1_epi32(static_cast<int>(key));
+                uint32_t index = 0;
+
+                while ((index + sizeof(pattern)) <= length) {
+                    const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&source[index]));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(&destination[index]), _mm_xor_si128(value, pattern));
+                    index += sizeof(pattern);
+                }
+
+                return (index + MaskWord(&destination[index], &source[index], length - index, key));
+            }
+
+            __attribute__((target("avx2"))) uint32_t MaskAVX2(uint8_t destination[], const uint8_t source[], const uint32_t length, const uint32_t key)
+            {
+                const __m256i pattern = _mm256_set1_epi32(static_cast<int>(key));
+                uint32_t index = 0;
+
+                while ((index + sizeof(pattern)) <= length) {
+                    const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&source[index]));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(&destination[index]), _mm256_xor_si256(value, pattern));
+                    index += sizeof(pattern);
+                }
+
+                // Finish the half block here, calling the legacy encoded SSE2 kernel would stall on the AVX state.
+                if ((index + sizeof(__m128i)) <= length) {
+                    const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&source[index]));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(&destination[index]), _mm_xor_si128(value, _mm256_castsi256_si128(pattern)));
+                    index += sizeof(__m128i);
+                }
+
+                return (index + MaskWord(&destination[index], &source[index], length - index, key));
+            }
+#endif
+
+#if defined(__WEBSOCKET_MASK_NEON__)
+            uint32_t MaskNEON(uint8_t destination[], const uint8_t source[], const uint32_t length, const uint32_t key)
+            {
+                const uint8x16_t pattern = vreinterpretq_u8_u32(vdupq_n_u32(key));
+                uint32_t index = 0;
+
+                while ((index + sizeof(pattern)) <= length) {
+                    vst1q_u8(&destination[index], veorq_u8(vld1q_u8(&source[index]), pattern));
+                    index += sizeof(pattern);
+                }
+
+                return (index + MaskWord(&destination[index], &source[index], length - index, key));
+            }
+#endif
+
+            MaskKernel MaskSelect()
+            {
+                MaskKernel result = MaskWord;
+
+#if defined(__WEBSOCKET_MASK_X86__)
+                __builtin_cpu_init();
+
+                if (__builtin_cpu_supports("avx2")) {
+                    result = MaskAVX2;
+                } else if (__builtin_cpu_supports("sse2")) {
+                    result = MaskSSE2;
+                }
+#elif defined(__WEBSOCKET_MASK_NEON__)
+                result = MaskNEON;
+#endif
+
+                return (result);
+            }
+        }
+
+        /* static */ void Protocol::Mask(uint8_t destination[], const uint8_t source[], const uint32_t length, const uint8_t key[4], const uint8_t offset)
+        {
+            static const MaskKernel kernel = MaskSelect();
+
+            // Rotate the key, so the first byte to handle is always masked with the first key byte.
+            const uint8_t rotated[4] = { key[offset & 0x3], key[(offset + 1) & 0x3], key[(offset + 2) & 0x3], key[(offset + 3) & 0x3] };
+            uint32_t pattern;
+            uint32_t index = 0;
+
+            ::memcpy(&pattern, rotated, sizeof(pattern));
+
+            if (length >= sizeof(uint64_t)) {
+                index = kernel(destination, source, length, pattern);
+            }
+
+            while (index < length) {
+                destination[index] = (source[index] ^ rotated[index & 0x3]);
+                index++;
+            }
+        }
+
         std::string Protocol::RequestKey() const
         {
             string baseEncodedKey;
@@ -81,16 +207,9 @@ namespace Web {
                     maskKey[2] = (value >> 16) & 0xFF;
                     maskKey[3] = (value >> 24) & 0xFF;
 
-                    // Mask and insert the bytes on the right spots
-                    uint8_t* source = &dataFrame[usedSize - 1 + 4];
-                    uint8_t* destination = &dataFrame[usedSize - 1 + 4 + result];
-                    uint32_t bytesToMove = usedSize;
-
-                    while (bytesToMove != 0) {
-                        bytesToMove--;
-                        *destination-- = (*source ^ maskKey[(bytesToMove & 0x3)]);
-                        source--;
-                    }
+                    // The payload is at PayloadOffset(), so a large frame is masked in place and a
+                    // small frame moves down over the two length bytes it does not need.
+                    Mask(&dataFrame[result + 4], &dataFrame[8], usedSize, maskKey, 0);
 
                     // Now there is space again, write down the encryption key.
                     ::memcpy(&dataFrame[result], &maskKey, 4);
@@ -108,11 +227,11 @@ namespace Web {
 
                 if (usedSize < maxSendSize) {
                     // Seems like not all available space is used, so I guess we are ready..
-                    dataFrame[0] = FINISHING_FRAME | (SendInProgress() == true ? CONTINUATION_FRAME : TYPE_FRAME & _setFlags);
+                    dataFrame[0] = FINISHING_FRAME | (SendInProgress() == true ? CONTINUATION_FRAME : ((TYPE_FRAME & _setFlags) | (_compression & SEND_COMPRESSED)));
                     _progressInfo &= (~0x40);
                 } else {
                     // There is more to come, this is just part of a bigger picture
-                    dataFrame[0] = (SendInProgress() == true ? CONTINUATION_FRAME : TYPE_FRAME & _setFlags);
+                    dataFrame[0] = (SendInProgress() == true ? CONTINUATION_FRAME : ((TYPE_FRAME & _setFlags) | (_compression & SEND_COMPRESSED)));
                     _progressInfo |= (0x40);
                 }
 
@@ -121,9 +240,33 @@ namespace Web {
 
             if (((_controlStatus & (REQUEST_CLOSE | REQUEST_PING | REQUEST_PONG)) != 0) && ((result + 1) < maxSendSize)) {
                 if ((_controlStatus & REQUEST_CLOSE) != 0) {
-                    dataFrame[result++] = FINISHING_FRAME | Protocol::CLOSE;
-                    _controlStatus &= (~REQUEST_CLOSE);
-                    dataFrame[result++] = 0;
+                    if (_closeStatus == NO_STATUS) {
+                        dataFrame[result++] = FINISHING_FRAME | Protocol::CLOSE;
+                        _controlStatus &= (~REQUEST_CLOSE);
+                        dataFrame[result++] = 0;
+                    } else if ((result + 8) <= maxSendSize) {
+                        // The status is the payload, so it is masked like any other payload.
+                        const uint8_t status[2] = { static_cast<uint8_t>(_closeStatus >> 8), static_cast<uint8_t>(_closeStatus & 0xFF) };
+
+                        dataFrame[result++] = FINISHING_FRAME | Protocol::CLOSE;
+                        dataFrame[result++] = ((_setFlags & MASKING_FRAME) | sizeof(status));
+
+                        if ((_setFlags & MASKING_FRAME) != 0) {
+                            uint32_t value;
+                            Crypto::Random(value);
+                            const uint8_t maskKey[4] = { static_cast<uint8_t>(value & 0xFF), static_cast<uint8_t>((value >> 8) & 0xFF), static_cast<uint8_t>((value >> 16) & 0xFF), static_cast<uint8_t>((value >> 24) & 0xFF) };
+
+                            ::memcpy(&dataFrame[result], maskKey, 4);
+                            result += 4;
+                            Mask(&dataFrame[result], status, sizeof(status), maskKey, 0);
+                        } else {
+                            ::memcpy(&dataFrame[result], status, sizeof(status));
+                        }
+
+                        result += sizeof(status);
+                        _controlStatus &= (~REQUEST_CLOSE);
+                        _closeStatus = NO_STATUS;
+                    }
                 }
                 if (((_controlStatus & REQUEST_PING) != 0) && ((result + 1) < maxSendSize)) {
                     dataFrame[result++] = FINISHING_FRAME | Protocol::PING;
@@ -147,28 +290,18 @@ namespace Web {
             ASSERT(receivedSize > 0);
 
             if (_pendingReceiveBytes > 0) {
-                // Just unscramble, what is left...
+                // Just unscramble, what is left of the frame and has been received...
+                if (_pendingReceiveBytes < receivedSize) {
+                    receivedSize = _pendingReceiveBytes;
+                }
+
+                _pendingReceiveBytes -= receivedSize;
+
                 if ((_progressInfo & 0x20) == 0x20) {
                     // looks like we need to unscramble..
-                    uint8_t* source = dataFrame;
+                    Mask(dataFrame, dataFrame, receivedSize, _scrambleKey, _progressInfo);
 
-                    if (_pendingReceiveBytes < receivedSize) {
-                        receivedSize = _pendingReceiveBytes;
-                    }
-
-                    while (_pendingReceiveBytes != 0) {
-                        *source = (*source ^ _scrambleKey[(_progressInfo & 0x3)]);
-                        source++;
-                        _progressInfo = ((_progressInfo + 1) & 0x03) | (_progressInfo & 0xFC);
-                        _pendingReceiveBytes--;
-                    }
-                } else {
-                    if (_pendingReceiveBytes > receivedSize) {
-                        _pendingReceiveBytes -= receivedSize;
-                    } else {
-                        receivedSize = _pendingReceiveBytes;
-                        _pendingReceiveBytes = 0;
-                    }
+                    _progressInfo = ((_progressInfo + receivedSize) & 0x03) | (_progressInfo & 0xFC);
                 }
             } else if (receivedSize < 2) {
                 // This is a way too small frame..
@@ -187,6 +320,25 @@ namespace Web {
                 } else {
                     _frameType = static_cast<frameType>(dataFrame[0] & TYPE_FRAME);
 
+                    // RSV1 is only allowed on the first frame of a data message, if permessage-deflate is negotiated.
+                    if ((_frameType & CONTROL_FRAME) != 0) {
+                        if ((dataFrame[0] & RESERVED_FRAME) != 0) {
+                            _frameType = VIOLATION;
+                        }
+                    } else {
+                        if ((dataFrame[0] & RESERVED_FRAME) == 0) {
+                            if (_frameType != 0) {
+                                _compression &= (~RECEIVE_COMPRESSED);
+                            }
+                        } else if (((dataFrame[0] & RESERVED_FRAME) == COMPRESSED_FRAME) && (_frameType != 0) && (Deflate() == true)) {
+                            _compression |= RECEIVE_COMPRESSED;
+                        } else {
+                            _frameType = VIOLATION;
+                        }
+
+                        _compression = ((dataFrame[0] & FINISHING_FRAME) != 0 ? (_compression | RECEIVE_LAST) : (_compression & (~RECEIVE_LAST)));
+                    }
+
                     // Continuation frame is only allowed if a receive is in progress...
                     if (ReceiveInProgress() == true) {
                         if (_frameType == 0) {
@@ -241,14 +393,9 @@ namespace Web {
                             _progressInfo |= 0x20;
                             _progressInfo &= (~0x03);
 
-                            uint8_t* source = &dataFrame[actualHeader];
+                            Mask(&dataFrame[actualHeader], &dataFrame[actualHeader], bytesToMove, _scrambleKey, 0);
 
-                            while (bytesToMove != 0) {
-                                *source = (*source ^ _scrambleKey[(_progressInfo & 0x3)]);
-                                source++;
-                                bytesToMove--;
-                                _progressInfo = ((_progressInfo + 1) & 0xF3);
-                            }
+                            _progressInfo |= (bytesToMove & 0x03);
                         }
                     }
                 }
@@ -256,6 +403,309 @@ namespace Web {
 
             return (actualHeader);
         }
+
+        // RFC 7692, every compressed message ends with an empty stored block that is not sent.
+        static const uint8_t DeflateTrailer[] = { 0x00, 0x00, 0xFF, 0xFF };
+        static const TCHAR DeflateExtension[] = _T("permessage-deflate");
+        static constexpr uint16_t DeflateChunk = 4096;
+
+        namespace {
+
+            struct DeflateParameters {
+                DeflateParameters()
+                    : ServerNoContextTakeover(false)
+                    , ClientNoContextTakeover(false)
+                    , ServerMaxWindowBits(0)
+                    , ClientMaxWindowBits(0)
+                    , ClientMaxWindowBitsSet(false)
+                {
+                }
+
+                bool ServerNoContextTakeover;
+                bool ClientNoContextTakeover;
+                uint8_t ServerMaxWindowBits;
+                uint8_t ClientMaxWindowBits;
+                bool ClientMaxWindowBitsSet;
+            };
+
+            Core::TextFragment Trimmed(const Core::TextFragment& text)
+            {
+                Core::TextFragment result(text);
+
+                result.TrimBegin(_T(" \t\""));
+                result.TrimEnd(_T(" \t\""));
+
+                return (result);
+            }
+
+            uint8_t WindowBits(const Core::TextFragment& value)
+            {
+                uint8_t result = 0;
+                Core::NumberType<uint8_t> number(value);
+
+                if ((number.Value() >= 8) && (number.Value() <= 15)) {
+                    result = number.Value();
+                }
+
+                return (result);
+            }
+
+            // Parse one extension of a Sec-WebSocket-Extensions header, false if it is not a (valid) permessage-deflate.
+            bool Parse(const Core::TextFragment& extension, DeflateParameters& parameters)
+            {
+                bool result = false;
+                Core::TextSegmentIterator index(extension, true, ';');
+
+                if ((index.Next() == true) && (Trimmed(index.Current()).EqualText(DeflateExtension, 0, 0, false) == true)) {
+                    result = true;
+
+                    while ((result == true) && (index.Next() == true)) {
+                        Core::TextFragment parameter(Trimmed(index.Current()));
+                        uint32_t assign = parameter.ForwardFind('=');
+                        Core::TextFragment name(Trimmed(Core::TextFragment(parameter, 0, (assign < parameter.Length() ? assign : parameter.Length()))));
+                        Core::TextFragment value(assign < parameter.Length() ? Trimmed(Core::TextFragment(parameter, assign + 1, parameter.Length() - assign - 1)) : Core::TextFragment());
+
+                        if (name.EqualText(_T("server_no_context_takeover"), 0, 0, false) == true) {
+                            result = (parameters.ServerNoContextTakeover == false) && (value.IsEmpty() == true);
+                            parameters.ServerNoContextTakeover = true;
+                        } else if (name.EqualText(_T("client_no_context_takeover"), 0, 0, false) == true) {
+                            result = (parameters.ClientNoContextTakeover == false) && (value.IsEmpty() == true);
+                            parameters.ClientNoContextTakeover = true;
+                        } else if (name.EqualText(_T("server_max_window_bits"), 0, 0, false) == true) {
+                            result = (parameters.ServerMaxWindowBits == 0) && ((parameters.ServerMaxWindowBits = WindowBits(value)) != 0);
+                        } else if (name.EqualText(_T("client_max_window_bits"), 0, 0, false) == true) {
+                            result = (parameters.ClientMaxWindowBitsSet == false) && ((value.IsEmpty() == true) || ((parameters.ClientMaxWindowBits = WindowBits(value)) != 0));
+                            parameters.ClientMaxWindowBitsSet = true;
+                        } else {
+                            result = false;
+                        }
+                    }
+                }
+
+                return (result);
+            }
+        }
+
+        Deflate::Deflate()
+            : _settings()
+            , _active(false)
+            , _sendBits(15)
+            , _sendTakeover(true)
+            , _deflating(false)
+            , _inflating(false)
+            , _trailer(false)
+            , _failed(false)
+            , _outbound()
+            , _outboundOffset(0)
+            , _inbound()
+        {
+        }
+
+        Deflate::~Deflate()
+        {
+            Reset();
+        }
+
+        string Deflate::Offer() const
+        {
+            string result(DeflateExtension);
+
+            // We inflate with the full window, whatever the server picks, but it may limit ours.
+            result += _T("; client_max_window_bits");
+
+            if (_settings.WindowBits < 15) {
+                result += _T("; server_max_window_bits=") + Core::NumberType<uint8_t>(_settings.WindowBits).Text();
+            }
+            if (_settings.ContextTakeover == false) {
+                result += _T("; client_no_context_takeover");
+            }
+
+            return (result);
+        }
+
+        bool Deflate::Accept(const string& offers, string& response)
+        {
+            Core::TextSegmentIterator index(Core::TextFragment(offers), true, ',');
+
+            Deactivate();
+
+            while ((_active == false) && (index.Next() == true)) {
+                DeflateParameters offer;
+
+                // zlib can not deflate with a window of 8 bits, decline such an offer.
+                if ((Parse(index.Current(), offer) == true) && ((offer.ServerMaxWindowBits == 0) || (offer.ServerMaxWindowBits > 8))) {
+                    _active = true;
+                    _sendBits = ((offer.ServerMaxWindowBits != 0) && (offer.ServerMaxWindowBits < _settings.WindowBits) ? offer.ServerMaxWindowBits : _settings.WindowBits);
+                    _sendTakeover = ((_settings.ContextTakeover == true) && (offer.ServerNoContextTakeover == false));
+
+                    response = DeflateExtension;
+
+                    if (_sendTakeover == false) {
+                        response += _T("; server_no_context_takeover");
+                    }
+                    if (_sendBits < 15) {
+                        response += _T("; server_max_window_bits=") + Core::NumberType<uint8_t>(_sendBits).Text();
+                    }
+                    if ((offer.ClientMaxWindowBitsSet == true) && (_settings.WindowBits < 15)) {
+                        response += _T("; client_max_window_bits=") + Core::NumberType<uint8_t>(_settings.WindowBits).Text();
+                    }
+                }
+            }
+
+            return (_active);
+        }
+
+        bool Deflate::Accepted(const string& response)
+        {
+            DeflateParameters answer;
+
+            Deactivate();
+
+            if ((Parse(Core::TextFragment(response), answer) == true) && ((answer.ClientMaxWindowBits == 0) || (answer.ClientMaxWindowBits > 8))) {
+                _active = true;
+                _sendBits = ((answer.ClientMaxWindowBits != 0) && (answer.ClientMaxWindowBits < _settings.WindowBits) ? answer.ClientMaxWindowBits : _settings.WindowBits);
+                _sendTakeover = ((_settings.ContextTakeover == true) && (answer.ClientNoContextTakeover == false));
+            }
+
+            return (_active);
+        }
+
+        void Deflate::Deactivate()
+        {
+            Reset();
+
+            _active = false;
+            _sendBits = _settings.WindowBits;
+            _sendTakeover = _settings.ContextTakeover;
+        }
+
+        void Deflate::Reset()
+        {
+            if (_deflating == true) {
+                (void)deflateEnd(&_deflate);
+                _deflating = false;
+            }
+            if (_inflating == true) {
+                (void)inflateEnd(&_inflate);
+                _inflating = false;
+            }
+
+            _trailer = false;
+            _failed = false;
+            _outbound.clear();
+            _outboundOffset = 0;
+        }
+
+        void Deflate::Compress(const uint8_t data[], const uint16_t length, const bool last)
+        {
+            ASSERT(_active == true);
+
+            if (_deflating == false) {
+                ::memset(&_deflate, 0, sizeof(_deflate));
+                _deflating = (deflateInit2(&_deflate, _settings.Level, Z_DEFLATED, -_sendBits, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+
+                ASSERT(_deflating == true);
+            }
+
+            if (Pending() == 0) {
+                // A new message, the buffer of the previous one is reused.
+                _outbound.clear();
+                _outboundOffset = 0;
+            }
+
+            _deflate.next_in = const_cast<uint8_t*>(data);
+            _deflate.avail_in = length;
+
+            do {
+                uint32_t used = static_cast<uint32_t>(_outbound.size());
+
+                _outbound.resize(used + DeflateChunk);
+                _deflate.next_out = &(_outbound[used]);
+                _deflate.avail_out = DeflateChunk;
+
+                (void)deflate(&_deflate, (last == true ? Z_SYNC_FLUSH : Z_NO_FLUSH));
+
+                _outbound.resize(used + DeflateChunk - _deflate.avail_out);
+
+            } while (_deflate.avail_out == 0);
+
+            if (last == true) {
+                ASSERT((_outbound.size() >= sizeof(DeflateTrailer)) && (::memcmp(&(_outbound[_outbound.size() - sizeof(DeflateTrailer)]), DeflateTrailer, sizeof(DeflateTrailer)) == 0));
+
+                _outbound.resize(_outbound.size() - sizeof(DeflateTrailer));
+
+                if (_sendTakeover == false) {
+                    (void)deflateReset(&_deflate);
+                }
+            }
+        }
+
+        uint16_t Deflate::Compressed(uint8_t data[], const uint16_t maxLength)
+        {
+            uint16_t result = static_cast<uint16_t>(std::min(Pending(), static_cast<uint32_t>(maxLength)));
+
+            if (result != 0) {
+                ::memcpy(data, &(_outbound[_outboundOffset]), result);
+                _outboundOffset += result;
+            }
+
+            return (result);
+        }
+
+        void Deflate::Decompress(const uint8_t data[], const uint16_t length, const bool last)
+        {
+            ASSERT(_active == true);
+
+            if (_inflating == false) {
+                ::memset(&_inflate, 0, sizeof(_inflate));
+                _inflating = (inflateInit2(&_inflate, -MAX_WBITS) == Z_OK);
+                _inbound.resize(DeflateChunk);
+
+                ASSERT(_inflating == true);
+            }
+
+            _inflate.next_in = const_cast<uint8_t*>(data);
+            _inflate.avail_in = length;
+            _trailer = last;
+        }
+
+        uint16_t Deflate::Decompressed(uint8_t*& data)
+        {
+            uint16_t result = 0;
+
+            data = _inbound.data();
+
+            while ((result == 0) && ((_inflate.avail_in != 0) || (_trailer == true))) {
+                if (_inflate.avail_in == 0) {
+                    // All payload of the message is in, add what the sender left out.
+                    _inflate.next_in = const_cast<uint8_t*>(DeflateTrailer);
+                    _inflate.avail_in = sizeof(DeflateTrailer);
+                    _trailer = false;
+                }
+
+                _inflate.next_out = _inbound.data();
+                _inflate.avail_out = static_cast<uInt>(_inbound.size());
+
+                int status = inflate(&_inflate, Z_SYNC_FLUSH);
+
+                result = static_cast<uint16_t>(_inbound.size() - _inflate.avail_out);
+
+                if (status == Z_STREAM_END) {
+                    // The sender closed its stream (BFINAL), the next message starts a new one.
+                    (void)inflateReset(&_inflate);
+                } else if ((status != Z_OK) && (status != Z_BUF_ERROR)) {
+                    TRACE_L1("Could not inflate the WebSocket message. Error: %d", status);
+
+                    (void)inflateReset(&_inflate);
+                    _inflate.avail_in = 0;
+                    _trailer = false;
+                    _failed = true;
+                    result = 0;
+                }
+            }
+
+            return (result);
+        }
     }
 }
 }
@@ -6,6 +6,11 @@
 #include "WebRequest.h"
 #include "WebResponse.h"
 
+#ifndef WEBSOCKET_DEFLATE_THRESHOLD
+// Messages smaller than this are not worth compressing.
+#define WEBSOCKET_DEFLATE_THRESHOLD 256
+#endif
+
 namespace WPEFramework {
 namespace Web {
     namespace WebSocket {
@@ -21,6 +26,11 @@ namespace Web {
                 TOO_BIG = 0x20, // Protocol max support for 2^16 message per chunk
                 INCONSISTENT = 0x30 // e.g. Protocol defined as Text, but received a binary.
             };
+            // Status codes (RFC 6455, 7.4.1) that can go along with a close.
+            enum closeStatus {
+                NO_STATUS = 0,
+                INVALID_PAYLOAD = 1007 // e.g. a compressed message that can not be inflated.
+            };
 
         private:
             enum controlTypes {
@@ -29,6 +39,12 @@ namespace Web {
                 REQUEST_PONG = 0x04,
                 CLOSE_INPROGRESS = 0x08
             };
+            enum compressionTypes {
+                DEFLATE = 0x01,
+                RECEIVE_COMPRESSED = 0x02,
+                RECEIVE_LAST = 0x04,
+                SEND_COMPRESSED = 0x40 // Same bit as RSV1 in the frame header.
+            };
 
             Protocol() = delete;
             Protocol(const Protocol&) = delete;
@@ -40,7 +56,8 @@ namespace Web {
                 , _progressInfo(0)
                 , _pendingReceiveBytes(0)
                 , _controlStatus(0)
-
+                , _closeStatus(NO_STATUS)
+                , _compression(0)
             {
             }
             ~Protocol()
@@ -63,6 +80,11 @@ namespace Web {
             {
                 _controlStatus |= REQUEST_CLOSE;
             }
+            inline void Close(const closeStatus status)
+            {
+                _closeStatus = status;
+                _controlStatus |= REQUEST_CLOSE;
+            }
             inline bool ReceiveInProgress() const
             {
                 return ((_progressInfo & 0x80) != 0);
@@ -99,10 +121,46 @@ namespace Web {
             {
                 return ((_setFlags & 0x80) != 0);
             }
+            // permessage-deflate negotiated, only than RSV1 may be set on the first frame of a message.
+            inline void Deflate(const bool enabled)
+            {
+                _compression = (enabled ? DEFLATE : 0);
+            }
+            inline bool Deflate() const
+            {
+                return ((_compression & DEFLATE) != 0);
+            }
+            // Mark the next message that is sent as compressed, or not.
+            inline void Compress(const bool compress)
+            {
+                ASSERT((compress == false) || (Deflate() == true));
+
+                _compression = (compress ? (_compression | SEND_COMPRESSED) : (_compression & (~SEND_COMPRESSED)));
+            }
+            inline bool IsCompressedMessage() const
+            {
+                return ((_compression & RECEIVE_COMPRESSED) != 0);
+            }
+            // The payload handed out is the end of a message (not only of a frame).
+            inline bool IsLastFrame() const
+            {
+                return (((_compression & RECEIVE_LAST) != 0) && (_pendingReceiveBytes == 0));
+            }
+
+            // Offset in the dataFrame where the Encoder expects the payload. This leaves room for the
+            // largest header, so a masked payload is XOR-ed in place instead of moved.
+            inline uint8_t PayloadOffset() const
+            {
+                return (Masking() == true ? 8 : 4);
+            }
 
             uint16_t Encoder(uint8_t* dataFrame, const uint16_t maxSendSize, const uint16_t usedSize);
             uint16_t Decoder(uint8_t* dataFrame, uint16_t& receivedSize);
 
+            // XOR the source with the 4 byte key, starting at key[offset & 0x3], into the destination.
+            // The destination may be the source itself or start before it, never after it.
+            static void Mask(uint8_t destination[], const uint8_t source[], const uint32_t length, const uint8_t key[4], const uint8_t offset);
+
         private:
             uint8_t _setFlags;
             uint8_t _progressInfo;
@@ -110,6 +168,132 @@ namespace Web {
             frameType _frameType;
             uint8_t _scrambleKey[4];
             uint8_t _controlStatus;
+            closeStatus _closeStatus;
+            uint8_t _compression;
+        };
+
+        // The RFC 7692 permessage-deflate parameters of a link, a level of 0 leaves it off.
+        class EXTERNAL Compression {
+        public:
+            Compression()
+                : Level(0)
+                , WindowBits(15)
+                , ContextTakeover(true)
+                , Threshold(WEBSOCKET_DEFLATE_THRESHOLD)
+            {
+            }
+            // The window bits (9-15) apply to what we send and to what we allow the other side to send.
+            Compression(const uint8_t level, const uint8_t windowBits, const bool contextTakeover, const uint16_t threshold)
+                : Level(level > 9 ? 9 : level)
+                , WindowBits(windowBits < 9 ? 9 : (windowBits > 15 ? 15 : windowBits))
+                , ContextTakeover(contextTakeover)
+                , Threshold(threshold)
+            {
+            }
+            Compression(const Compression& copy)
+                : Level(copy.Level)
+                , WindowBits(copy.WindowBits)
+                , ContextTakeover(copy.ContextTakeover)
+                , Threshold(copy.Threshold)
+            {
+            }
+            ~Compression()
+            {
+            }
+
+            Compression& operator=(const Compression& RHS)
+            {
+                Level = RHS.Level;
+                WindowBits = RHS.WindowBits;
+                ContextTakeover = RHS.ContextTakeover;
+                Threshold = RHS.Threshold;
+
+                return (*this);
+            }
+
+        public:
+            inline bool IsEnabled() const
+            {
+                return (Level != 0);
+            }
+
+        public:
+            uint8_t Level;
+            uint8_t WindowBits;
+            bool ContextTakeover;
+            uint16_t Threshold;
+        };
+
+        // The permessage-deflate state of a single link. The zlib streams and buffers are created
+        // with the first compressed message and reused for every next message on that link.
+        class EXTERNAL Deflate {
+        private:
+            Deflate(const Deflate&) = delete;
+            Deflate& operator=(const Deflate&) = delete;
+
+        public:
+            Deflate();
+            ~Deflate();
+
+        public:
+            inline const Compression& Settings() const
+            {
+                return (_settings);
+            }
+            inline void Settings(const Compression& settings)
+            {
+                _settings = settings;
+            }
+            inline bool IsActive() const
+            {
+                return (_active);
+            }
+            inline uint16_t Threshold() const
+            {
+                return (_settings.Threshold);
+            }
+            inline uint32_t Pending() const
+            {
+                return (static_cast<uint32_t>(_outbound.size()) - _outboundOffset);
+            }
+            // The inbound data could not be inflated, the stream can not be continued.
+            inline bool HasError() const
+            {
+                return (_failed);
+            }
+
+            // Negotiation, the client Offer()s, the server Accept()s one of the offers and the
+            // client checks what is Accepted(). Both sides are active if that succeeds.
+            string Offer() const;
+            bool Accept(const string& offers, string& response);
+            bool Accepted(const string& response);
+            void Deactivate();
+
+            // Outbound, the message is compressed as it is offered and than handed out in frames.
+            void Compress(const uint8_t data[], const uint16_t length, const bool last);
+            uint16_t Compressed(uint8_t data[], const uint16_t maxLength);
+
+            // Inbound, the frame payload is fed and taken out inflated till nothing is left.
+            void Decompress(const uint8_t data[], const uint16_t length, const bool last);
+            uint16_t Decompressed(uint8_t*& data);
+
+        private:
+            void Reset();
+
+        private:
+            Compression _settings;
+            bool _active;
+            uint8_t _sendBits;
+            bool _sendTakeover;
+            bool _deflating;
+            bool _inflating;
+            bool _trailer;
+            bool _failed;
+            z_stream _deflate;
+            z_stream _inflate;
+            std::vector<uint8_t> _outbound;
+            uint32_t _outboundOffset;
+            std::vector<uint8_t> _inbound;
         };
 
         class EXTERNAL RequestAllocator : public Core::ProxyPoolType<Web::Request> {
@@ -186,6 +370,8 @@ namespace Web {
                     , _adminLock()
                     , _queue(queueSize)
                 {
+                    // Web responses (not the WebSocket frames) may go straight from a file to the socket.
+                    OUTBOUND::Serializer::ZeroCopy(std::is_base_of<Core::SocketPort, ACTUALLINK>::value);
                 }
                 virtual ~SerializerImpl()
                 {
@@ -651,6 +837,26 @@ namespace Web {
             {
                 _handler.Masking(masking);
             }
+            inline void Compression(const WebSocket::Compression& settings)
+            {
+                _adminLock.Lock();
+
+                _deflate.Settings(settings);
+
+                _adminLock.Unlock();
+            }
+            inline const WebSocket::Compression& Compression() const
+            {
+                return (_deflate.Settings());
+            }
+            inline bool IsCompressed() const
+            {
+                return (_deflate.IsActive());
+            }
+            inline void ContentEncoding(const EncodingTypes accepted, const bool chunking)
+            {
+                _serializerImpl.Encoding(accepted, chunking);
+            }
             inline void Ping()
             {
                 _pingFireTime = Core::Time::Now().Ticks();
@@ -731,10 +937,17 @@ namespace Web {
                 _state = static_cast<EnumlinkState>(_state | ACTIVITY);
 
                 if ((_state & WEBSOCKET) != 0) {
-                    if (maxSendSize > 4) {
-                        result = _parent.SendData(&(dataFrame[4]), (maxSendSize - 4));
+                    // Leave room for the largest header we write, including the mask.
+                    const uint16_t headerSize = _handler.PayloadOffset();
 
-                        result = _handler.Encoder(dataFrame, (maxSendSize - 4), result);
+                    if (maxSendSize > headerSize) {
+                        if (_deflate.IsActive() == false) {
+                            result = _parent.SendData(&(dataFrame[headerSize]), (maxSendSize - headerSize));
+                        } else {
+                            result = Compress(&(dataFrame[headerSize]), (maxSendSize - headerSize));
+                        }
+
+                        result = _handler.Encoder(dataFrame, (maxSendSize - headerSize), result);
                     }
                 } else {
                     result = _serializerImpl.Serialize(dataFrame, maxSendSize);
@@ -807,6 +1020,28 @@ namespace Web {
                                 }
 
                                 result += headerSize; // actualDataSize
+                            } else if (_handler.IsCompressedMessage() == true) {
+                                uint8_t* inflated;
+                                uint16_t length;
+
+                                if (_deflate.HasError() == false) {
+                                    _deflate.Decompress(&(dataFrame[result + headerSize]), actualDataSize, _handler.IsLastFrame());
+
+                                    while ((length = _deflate.Decompressed(inflated)) != 0) {
+                                        _parent.ReceiveData(inflated, length);
+                                    }
+
+                                    if (_deflate.HasError() == true) {
+                                        TRACE_L1("Could not inflate a message on the web socket, failing the connection.");
+
+                                        // Nothing after this can be inflated anymore, send the reason and close (RFC 7692, 8.1).
+                                        _handler.Close(WebSocket::Protocol::INVALID_PAYLOAD);
+                                        _state = static_cast<EnumlinkState>(_state | SUSPENDED);
+                                        ACTUALLINK::Trigger();
+                                    }
+                                }
+
+                                result += (headerSize + actualDataSize);
                             } else {
                                 _parent.ReceiveData(&(dataFrame[result + headerSize]), actualDataSize);
 
@@ -827,6 +1062,56 @@ namespace Web {
                 return (result);
             }
 
+            // Zero-copy transfer of file bodies, never for WebSocket frames
+            virtual uint32_t SendFile(Core::File::Handle& file)
+            {
+                uint32_t result = 0;
+
+                _adminLock.Lock();
+
+                if ((_state & WEBSOCKET) == 0) {
+                    result = _serializerImpl.SendFile(file);
+                }
+
+                _adminLock.Unlock();
+
+                return (result);
+            }
+            virtual void SentFile(const uint32_t length)
+            {
+                _adminLock.Lock();
+
+                _state = static_cast<EnumlinkState>(_state | ACTIVITY);
+
+                _serializerImpl.SentFile(length);
+
+                _adminLock.Unlock();
+            }
+            virtual uint32_t ReceiveFile(Core::File::Handle& file)
+            {
+                uint32_t result = 0;
+
+                _adminLock.Lock();
+
+                if ((_state & WEBSOCKET) == 0) {
+                    result = _deserialiserImpl.ReceiveFile(file);
+                }
+
+                _adminLock.Unlock();
+
+                return (result);
+            }
+            virtual void ReceivedFile(const uint32_t length)
+            {
+                _adminLock.Lock();
+
+                _state = static_cast<EnumlinkState>(_state | ACTIVITY);
+
+                _deserialiserImpl.ReceivedFile(length);
+
+                _adminLock.Unlock();
+            }
+
             // Signal a state change, Opened, Closed, Accepted or Error
             virtual void StateChange()
             {
@@ -853,6 +1138,38 @@ namespace Web {
             }
 
         private:
+            // The payload of the next frame. Small messages go out as they are, larger ones are
+            // deflated as a whole and than handed out frame by frame.
+            uint16_t Compress(uint8_t* dataFrame, const uint16_t maxSendSize)
+            {
+                uint16_t result = 0;
+
+                if ((_deflate.Pending() == 0) && (_handler.SendInProgress() == false)) {
+                    result = _parent.SendData(dataFrame, maxSendSize);
+
+                    if ((result != 0) && ((result == maxSendSize) || (result >= _deflate.Threshold()))) {
+                        uint16_t loaded = result;
+
+                        _deflate.Compress(dataFrame, loaded, (loaded < maxSendSize));
+
+                        while (loaded == maxSendSize) {
+                            loaded = _parent.SendData(dataFrame, maxSendSize);
+
+                            _deflate.Compress(dataFrame, loaded, (loaded < maxSendSize));
+                        }
+
+                        _handler.Compress(true);
+
+                        result = _deflate.Compressed(dataFrame, maxSendSize);
+                    } else {
+                        _handler.Compress(false);
+                    }
+                } else {
+                    result = _deflate.Compressed(dataFrame, maxSendSize);
+                }
+
+                return (result);
+            }
             inline uint32_t CheckForClose(uint32_t waitTime)
             {
                 uint32_t result = 0;
@@ -946,10 +1263,22 @@ namespace Web {
                             if (_protocol.empty() == false) {
                                 _webSocketMessage->WebSocketProtocol = _protocol;
                             }
+
+                            string extensions;
+
+                            if ((element->WebSocketExtensions.IsSet() == true) && (_deflate.Settings().IsEnabled() == true) && (_deflate.Accept(element->WebSocketExtensions.Value(), extensions) == true)) {
+                                _webSocketMessage->WebSocketExtensions = extensions;
+                            } else {
+                                _deflate.Deactivate();
+                                _webSocketMessage->WebSocketExtensions.Clear();
+                            }
+
+                            _handler.Deflate(_deflate.IsActive());
                         }
                     }
 
-                    // Send out the result of the upgraded message.
+                    // Send out the result of the upgraded message, it answers this request.
+                    _serializerImpl.Encoding(ENCODING_UNKNOWN, true);
                     _serializerImpl.Submit(_webSocketMessage);
 
                     _adminLock.Unlock();
@@ -1007,6 +1336,9 @@ namespace Web {
                     if (protocol.empty() == false) {
                         _webSocketMessage->WebSocketProtocol = protocol;
                     }
+                    if (_deflate.Settings().IsEnabled() == true) {
+                        _webSocketMessage->WebSocketExtensions = _deflate.Offer();
+                    }
 
                     _query = query;
                     _path = path;
@@ -1027,7 +1359,7 @@ namespace Web {
             inline void ReceivedWebSocket(Core::ProxyType<INBOUND>& element, const TemplateIntToType<0>& /* For compile time diffrentiation */)
             {
                 // We might receive a response on the update request
-                if ((_webSocketMessage.IsValid() == true) && (element->ErrorCode == Web::STATUS_SWITCH_PROTOCOL) && (element->WebSocketAccept.Value() == _handler.ResponseKey(_webSocketMessage->WebSocketKey.Value()))) {
+                if ((_webSocketMessage.IsValid() == true) && (element->ErrorCode == Web::STATUS_SWITCH_PROTOCOL) && (element->WebSocketAccept.Value() == _handler.ResponseKey(_webSocketMessage->WebSocketKey.Value())) && (Negotiated(element->WebSocketExtensions) == true)) {
                     ASSERT((_state & UPGRADING) != 0);
 
                     _adminLock.Lock();
@@ -1043,6 +1375,23 @@ namespace Web {
                 }
             }
 
+            // The server may only agree on what we offered, if it answers with anything else, the upgrade fails.
+            inline bool Negotiated(const Core::OptionalType<string>& extensions)
+            {
+                bool result = false;
+
+                if (extensions.IsSet() == false) {
+                    _deflate.Deactivate();
+                    result = true;
+                } else if (_deflate.Settings().IsEnabled() == true) {
+                    result = _deflate.Accepted(extensions.Value());
+                }
+
+                _handler.Deflate(_deflate.IsActive());
+
+                return (result);
+            }
+
         private:
             WebSocket::Protocol _handler;
             ParentClass& _parent;
@@ -1057,6 +1406,7 @@ namespace Web {
             string _commandData;
             Core::ProxyType<typename OUTBOUND::BaseElement> _webSocketMessage;
             uint64_t _pingFireTime;
+            WebSocket::Deflate _deflate;
         };
 
     public:
@@ -1203,6 +1553,22 @@ namespace Web {
         {
             return (_channel.Masking());
         }
+        inline void Compression(const WebSocket::Compression& settings)
+        {
+            _channel.Compression(settings);
+        }
+        inline const WebSocket::Compression& Compression() const
+        {
+            return (_channel.Compression());
+        }
+        inline bool IsCompressed() const
+        {
+            return (_channel.IsCompressed());
+        }
+        inline void ContentEncoding(const EncodingTypes accepted, const bool chunking)
+        {
+            _channel.ContentEncoding(accepted, chunking);
+        }
         inline void ResetActivity()
         {
             return (_channel.ResetActivity());
@@ -1522,6 +1888,18 @@ namespace Web {
         {
             return (_channel.Masking());
         }
+        inline void Compression(const WebSocket::Compression& settings)
+        {
+            _channel.Compression(settings);
+        }
+        inline const WebSocket::Compression& Compression() const
+        {
+            return (_channel.Compression());
+        }
+        inline bool IsCompressed() const
+        {
+            return (_channel.IsCompressed());
+        }
         inline uint32_t Open(const uint32_t waitTime)
         {
             return (_channel.Open(waitTime));
@@ -1760,6 +2138,25 @@ namespace Web {
         {
             return (_channel.Masking());
         }
+        inline void Compression(const WebSocket::Compression& settings)
+        {
+            _channel.Compression(settings);
+        }
+        inline const WebSocket::Compression& Compression() const
+        {
+            return (_channel.Compression());
+        }
+        inline bool IsCompressed() const
+        {
+            return (_channel.IsCompressed());
+        }
+        // The body of the response to the request at hand is encoded for a peer that accepts it,
+        // ENCODING_UNKNOWN encodes none. Call it once for every request that gets a response.
+        // Without chunking (HTTP/1.0 peers), only bodies with an encoded copy are encoded.
+        inline void ContentEncoding(const EncodingTypes accepted, const bool chunking)
+        {
+            _channel.ContentEncoding(accepted, chunking);
+        }
         inline uint32_t Open(const uint32_t waitTime)
         {
             return (_channel.Open(waitTime));
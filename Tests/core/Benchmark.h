@@ -0,0 +1,24 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+// The throughput tests only report numbers, they are disabled so they do not slow down every unit
+// test run. Run them on purpose with:
+//    WPEFramework_test_core --gtest_also_run_disabled_tests --gtest_filter=*DISABLED_throughput*
+
+// Runs the work, returns how long it took in seconds.
+template <typename WORK>
+inline double Measure(WORK work)
+{
+   const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+   work();
+
+   return (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+}
+
+inline void Report(const char what[], const double value, const char unit[])
+{
+   printf("%-48s %12.1f %s\n", what, value, unit);
+}
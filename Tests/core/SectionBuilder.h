@@ -0,0 +1,95 @@
+#pragma once
+
+#include <core/core.h>
+
+#include <vector>
+
+// Builds MPEG sections and the transport stream that carries them, for the broadcast tests.
+
+// Fills in the section length of a section with the section syntax, and appends the CRC.
+inline void SealSection(std::vector<uint8_t>& section)
+{
+   const uint16_t length = static_cast<uint16_t>(section.size() - 3 + 4);
+
+   section[1] = (section[1] & 0xF0) | static_cast<uint8_t>(length >> 8);
+   section[2] = static_cast<uint8_t>(length & 0xFF);
+
+   const uint32_t crc = WPEFramework::Core::CRC32Calculator::Calculate(~0, section.data(), static_cast<uint32_t>(section.size()));
+   section.push_back(static_cast<uint8_t>(crc >> 24));
+   section.push_back(static_cast<uint8_t>(crc >> 16));
+   section.push_back(static_cast<uint8_t>(crc >> 8));
+   section.push_back(static_cast<uint8_t>(crc));
+}
+
+inline std::vector<uint8_t> MakeSection(const uint8_t tableId, const uint16_t extension, const uint8_t version, const uint8_t number, const uint8_t last, const std::vector<uint8_t>& payload, const bool current = true)
+{
+   std::vector<uint8_t> section = { tableId, 0xB0, 0x00,
+      static_cast<uint8_t>(extension >> 8), static_cast<uint8_t>(extension & 0xFF),
+      static_cast<uint8_t>(0xC0 | ((version & 0x1F) << 1) | (current ? 0x01 : 0x00)), number, last };
+
+   section.insert(section.end(), payload.begin(), payload.end());
+   SealSection(section);
+
+   return (section);
+}
+
+// A section with a payload of the given length, its content derived from the seed.
+inline std::vector<uint8_t> MakeSection(const uint8_t tableId, const uint16_t extension, const uint8_t version, const uint8_t number, const uint8_t last, const uint16_t payload, const uint32_t seed, const bool current = true)
+{
+   std::vector<uint8_t> data(payload);
+
+   for (uint16_t index = 0; index < payload; index++) {
+      data[index] = static_cast<uint8_t>((index * 13) ^ seed);
+   }
+
+   return (MakeSection(tableId, extension, version, number, last, data, current));
+}
+
+// Packs the sections back to back in TS packets on the given PID, as a multiplexer does.
+inline void Packetize(std::vector<uint8_t>& stream, const uint16_t pid, uint8_t& continuity, const std::vector<std::vector<uint8_t>>& sections)
+{
+   std::vector<uint8_t> payload;
+   std::vector<uint32_t> starts;
+
+   for (const std::vector<uint8_t>& section : sections) {
+      starts.push_back(static_cast<uint32_t>(payload.size()));
+      payload.insert(payload.end(), section.begin(), section.end());
+   }
+
+   uint32_t position = 0;
+   uint32_t next = 0;
+
+   while (position < payload.size()) {
+      uint8_t packet[188];
+      uint8_t offset = 4;
+
+      ::memset(packet, 0xFF, sizeof(packet));
+
+      while ((next < starts.size()) && (starts[next] < position)) {
+         next++;
+      }
+
+      packet[0] = 0x47;
+      packet[1] = static_cast<uint8_t>(pid >> 8);
+      packet[2] = static_cast<uint8_t>(pid & 0xFF);
+      packet[3] = 0x10 | (continuity & 0x0F);
+      continuity++;
+
+      uint32_t size = std::min(184u, static_cast<uint32_t>(payload.size()) - position);
+
+      if ((next < starts.size()) && (starts[next] < (position + 183))) {
+         packet[1] |= 0x40;
+         packet[4] = static_cast<uint8_t>(starts[next] - position);
+         offset = 5;
+         size = std::min(183u, size);
+      } else if ((next < starts.size()) && (starts[next] < (position + 184))) {
+         // The next section would start in the last byte, stuff it and start in the next packet.
+         size = starts[next] - position;
+      }
+
+      ::memcpy(&packet[offset], &payload[position], size);
+      position += size;
+
+      stream.insert(stream.end(), packet, packet + sizeof(packet));
+   }
+}
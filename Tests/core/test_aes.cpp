@@ -0,0 +1,279 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <cryptalgo/cryptalgo.h>
+
+#include "Benchmark.h"
+
+using namespace WPEFramework;
+
+static std::vector<uint8_t> Bytes(const char hex[])
+{
+   std::vector<uint8_t> result;
+
+   for (uint32_t index = 0; hex[index] != '\0'; index += 2) {
+      const char digits[3] = { hex[index], hex[index + 1], '\0' };
+      result.push_back(static_cast<uint8_t>(strtoul(digits, nullptr, 16)));
+   }
+
+   return (result);
+}
+
+TEST(Crypto_AES, ecb)
+{
+   // FIPS-197, appendix C.
+   const std::vector<uint8_t> plain = Bytes("00112233445566778899aabbccddeeff");
+   const std::vector<uint8_t> key = Bytes("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f");
+   const char* expected[] = { "69c4e0d86a7b0430d8cdb78070b4c55a", "dda97ca4864cdfe06eaf70a0ec0d7191", "8ea2b7ca516745bfeafc49904b496089" };
+
+   for (uint8_t index = 0; index < 3; index++) {
+      const uint8_t keyLength = 16 + (index * 8);
+      std::vector<uint8_t> input;
+
+      // More blocks than are interleaved, so both the wide and the single block path are taken.
+      for (uint8_t block = 0; block < 11; block++) {
+         input.insert(input.end(), plain.begin(), plain.end());
+      }
+
+      std::vector<uint8_t> output(input.size());
+      std::vector<uint8_t> decrypted(input.size());
+
+      Crypto::AESEncryption encryptor(Crypto::AES_ECB);
+      Crypto::AESDecryption decryptor(Crypto::AES_ECB);
+      EXPECT_EQ(encryptor.Key(keyLength, key.data()), 0u);
+      EXPECT_EQ(decryptor.Key(keyLength, key.data()), 0u);
+
+      encryptor.Encrypt(input.size(), input.data(), output.data());
+      for (uint8_t block = 0; block < 11; block++) {
+         EXPECT_EQ(std::vector<uint8_t>(&output[block * 16], &output[(block + 1) * 16]), Bytes(expected[index])) << "key " << (keyLength * 8);
+      }
+
+      decryptor.Decrypt(output.size(), output.data(), decrypted.data());
+      EXPECT_EQ(decrypted, input);
+   }
+}
+
+TEST(Crypto_AES, cbc)
+{
+   // NIST SP 800-38A, F.2.1 and F.2.2.
+   const std::vector<uint8_t> key = Bytes("2b7e151628aed2a6abf7158809cf4f3c");
+   const std::vector<uint8_t> iv = Bytes("000102030405060708090a0b0c0d0e0f");
+   const std::vector<uint8_t> plain = Bytes("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e5130c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710");
+   const std::vector<uint8_t> cipher = Bytes("7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b273bed6b8e3c1743b7116e69e222295163ff1caa1681fac09120eca307586e1a7");
+   std::vector<uint8_t> output(plain.size());
+
+   Crypto::AESEncryption encryptor(Crypto::AES_CBC);
+   encryptor.Key(key.size(), key.data());
+   encryptor.InitialVector(iv.data());
+   encryptor.Encrypt(plain.size(), plain.data(), output.data());
+   EXPECT_EQ(output, cipher);
+
+   // In place, the blocks are decrypted in parallel so the chaining must survive the overwrite.
+   Crypto::AESDecryption decryptor(Crypto::AES_CBC);
+   decryptor.Key(key.size(), key.data());
+   decryptor.InitialVector(iv.data());
+   decryptor.Decrypt(output.size(), output.data(), output.data());
+   EXPECT_EQ(output, plain);
+}
+
+TEST(Crypto_AES, ctr)
+{
+   // NIST SP 800-38A, F.5.1 and F.5.2.
+   const std::vector<uint8_t> key = Bytes("2b7e151628aed2a6abf7158809cf4f3c");
+   const std::vector<uint8_t> counter = Bytes("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff");
+   const std::vector<uint8_t> plain = Bytes("6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e5130c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710");
+   const std::vector<uint8_t> cipher = Bytes("874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee");
+
+   // Fed in parts that do not line up with the blocks.
+   for (uint32_t part : { 1, 5, 16, 17, 64 }) {
+      std::vector<uint8_t> output(plain.size());
+      Crypto::AESEncryption encryptor(Crypto::AES_CTR);
+      encryptor.Key(key.size(), key.data());
+      encryptor.InitialVector(counter.data());
+
+      for (uint32_t offset = 0; offset < plain.size(); offset += part) {
+         const uint32_t size = std::min(part, static_cast<uint32_t>(plain.size()) - offset);
+         encryptor.Encrypt(size, &plain[offset], &output[offset]);
+      }
+      EXPECT_EQ(output, cipher) << "part " << part;
+
+      Crypto::AESDecryption decryptor(Crypto::AES_CTR);
+      decryptor.Key(key.size(), key.data());
+      decryptor.InitialVector(counter.data());
+      decryptor.Decrypt(output.size(), output.data(), output.data());
+      EXPECT_EQ(output, plain) << "part " << part;
+   }
+}
+
+TEST(Crypto_AES, ctr_carry)
+{
+   const std::vector<uint8_t> key = Bytes("2b7e151628aed2a6abf7158809cf4f3c");
+
+   // The counter is 128 bits, the carry has to go beyond the last 32 bits, and wrap at the end.
+   for (const char* start : { "000102030405060708090a0bfffffff0", "0001020304050607fffffffffffffff0", "fffffffffffffffffffffffffffffff0" }) {
+      std::vector<uint8_t> counter = Bytes(start);
+      std::vector<uint8_t> counters;
+
+      for (uint8_t block = 0; block < 40; block++) {
+         counters.insert(counters.end(), counter.begin(), counter.end());
+         for (uint8_t index = 16; (index > 0) && (++counter[index - 1] == 0); index--) {
+         }
+      }
+
+      std::vector<uint8_t> expected(counters.size());
+      Crypto::AESEncryption reference(Crypto::AES_ECB);
+      reference.Key(key.size(), key.data());
+      reference.Encrypt(counters.size(), counters.data(), expected.data());
+
+      std::vector<uint8_t> output(counters.size(), 0);
+      Crypto::AESEncryption encryptor(Crypto::AES_CTR);
+      encryptor.Key(key.size(), key.data());
+      encryptor.InitialVector(Bytes(start).data());
+      encryptor.Encrypt(output.size(), output.data(), output.data());
+
+      EXPECT_EQ(output, expected) << start;
+      EXPECT_EQ(std::vector<uint8_t>(encryptor.InitialVector(), encryptor.InitialVector() + 16), counter) << start;
+   }
+}
+
+TEST(Crypto_AES, gcm)
+{
+   // The test cases of "The Galois/Counter Mode of Operation (GCM)", McGrew and Viega.
+   struct Vector {
+      const char* key;
+      const char* iv;
+      const char* additional;
+      const char* plain;
+      const char* cipher;
+      const char* tag;
+   };
+   const char plain[] = "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39";
+   const char additional[] = "feedfacedeadbeeffeedfacedeadbeefabaddad2";
+   const Vector vectors[] = {
+      // Test case 2, 4, 5 and 6: 96 bit, 64 bit and 480 bit IV.
+      { "00000000000000000000000000000000", "000000000000000000000000", "", "00000000000000000000000000000000", "0388dace60b6a392f328c2b971b2fe78", "ab6e47d42cec13bdf53a67b21257bddf" },
+      { "feffe9928665731c6d6a8f9467308308", "cafebabefacedbaddecaf888", additional, plain, "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091", "5bc94fbc3221a5db94fae95ae7121a47" },
+      { "feffe9928665731c6d6a8f9467308308", "cafebabefacedbad", additional, plain, "61353b4c2806934a777ff51fa22a4755699b2a714fcdc6f83766e5f97b6c742373806900e49f24b22b097544d4896b424989b5e1ebac0f07c23f4598", "3612d2e79e3b0785561be14aaca2fccb" },
+      { "feffe9928665731c6d6a8f9467308308", "9313225df88406e555909c5aff5269aa6a7a9538534f7da1e4c303d2a318a728c3c0c95156809539fcf0e2429a6b525416aedbf5a0de6a57a637b39b", additional, plain, "8ce24998625615b603a033aca13fb894be9112a5c3a211a8ba262a3cca7e2ca701e4a9a4fba43c90ccdcb281d48c7c6fd62875d2aca417034c34aee5", "619cc5aefffe0bfa462af43c1699d050" },
+      // Test case 14: AES-256.
+      { "0000000000000000000000000000000000000000000000000000000000000000", "000000000000000000000000", "", "00000000000000000000000000000000", "cea7403d4d606b6e074ec5d3baf39d18", "d0d1c8a799996bf0265b98b5d48ab919" },
+   };
+
+   for (const Vector& vector : vectors) {
+      const std::vector<uint8_t> key = Bytes(vector.key);
+      const std::vector<uint8_t> iv = Bytes(vector.iv);
+      const std::vector<uint8_t> aad = Bytes(vector.additional);
+      const std::vector<uint8_t> input = Bytes(vector.plain);
+      const std::vector<uint8_t> expected = Bytes(vector.tag);
+
+      // Additional data and text both fed in parts that do not line up with the blocks.
+      for (uint32_t part : { 3, 16, 1000 }) {
+         std::vector<uint8_t> output(input.size());
+         uint8_t tag[16];
+
+         Crypto::AESEncryption encryptor(Crypto::AES_GCM);
+         encryptor.Key(key.size(), key.data());
+         encryptor.InitialVector(iv.size(), iv.data());
+         for (uint32_t offset = 0; offset < aad.size(); offset += part) {
+            encryptor.AdditionalData(std::min(part, static_cast<uint32_t>(aad.size()) - offset), &aad[offset]);
+         }
+         for (uint32_t offset = 0; offset < input.size(); offset += part) {
+            const uint32_t size = std::min(part, static_cast<uint32_t>(input.size()) - offset);
+            encryptor.Encrypt(size, &input[offset], &output[offset]);
+         }
+         EXPECT_EQ(encryptor.Tag(sizeof(tag), tag), 0u);
+
+         EXPECT_EQ(output, Bytes(vector.cipher)) << vector.iv << ", part " << part;
+         EXPECT_EQ(std::vector<uint8_t>(tag, tag + sizeof(tag)), expected) << vector.iv << ", part " << part;
+
+         Crypto::AESDecryption decryptor(Crypto::AES_GCM);
+         decryptor.Key(key.size(), key.data());
+         decryptor.InitialVector(iv.size(), iv.data());
+         decryptor.AdditionalData(aad.size(), aad.data());
+         decryptor.Decrypt(output.size(), output.data(), output.data());
+         EXPECT_EQ(decryptor.Verify(sizeof(tag), tag), Core::ERROR_NONE);
+         EXPECT_EQ(output, input);
+      }
+   }
+}
+
+TEST(Crypto_AES, gcm_forgery)
+{
+   const std::vector<uint8_t> key = Bytes("feffe9928665731c6d6a8f9467308308");
+   const std::vector<uint8_t> iv = Bytes("cafebabefacedbaddecaf888");
+   std::vector<uint8_t> data(1000);
+   uint8_t tag[16];
+
+   for (uint32_t index = 0; index < data.size(); index++) {
+      data[index] = static_cast<uint8_t>(index * 13);
+   }
+
+   Crypto::AESEncryption encryptor(Crypto::AES_GCM);
+   encryptor.Key(key.size(), key.data());
+   encryptor.InitialVector(iv.size(), iv.data());
+   encryptor.Encrypt(data.size(), data.data(), data.data());
+   encryptor.Tag(sizeof(tag), tag);
+
+   Crypto::AESDecryption decryptor(Crypto::AES_GCM);
+   decryptor.Key(key.size(), key.data());
+
+   // One flipped bit, in the text or in the tag, must be noticed.
+   for (uint32_t position : { 0u, 511u, 999u }) {
+      std::vector<uint8_t> tampered(data);
+      std::vector<uint8_t> output(data.size());
+      tampered[position] ^= 0x10;
+
+      decryptor.InitialVector(iv.size(), iv.data());
+      decryptor.Decrypt(tampered.size(), tampered.data(), output.data());
+      EXPECT_EQ(decryptor.Verify(sizeof(tag), tag), Core::ERROR_INCORRECT_HASH) << "position " << position;
+   }
+
+   std::vector<uint8_t> output(data.size());
+   tag[15] ^= 0x01;
+   decryptor.InitialVector(iv.size(), iv.data());
+   decryptor.Decrypt(data.size(), data.data(), output.data());
+   EXPECT_EQ(decryptor.Verify(sizeof(tag), tag), Core::ERROR_INCORRECT_HASH);
+}
+
+TEST(Crypto_AES, DISABLED_throughput)
+{
+   const std::vector<uint8_t> key = Bytes("000102030405060708090a0b0c0d0e0f");
+   const uint8_t iv[16] = {};
+   std::vector<uint8_t> buffer(1024 * 1024, 0xA5);
+   const uint32_t iterations = 16;
+   const double megabytes = (static_cast<double>(buffer.size()) * iterations) / (1024 * 1024);
+
+   // The table based block function, one block at a time, as the reference.
+   mbedtls_aes_context context;
+   mbedtls_aes_init(&context);
+   mbedtls_aes_setkey_enc(&context, key.data(), 128);
+
+   Report("AES-128 table based block", megabytes / Measure([&]() {
+      for (uint32_t index = 0; index < iterations; index++) {
+         for (uint32_t offset = 0; offset < buffer.size(); offset += 16) {
+            mbedtls_aes_encrypt(&context, &buffer[offset], &buffer[offset]);
+         }
+      }
+   }), "MB/s");
+
+   for (Crypto::aesType type : { Crypto::AES_ECB, Crypto::AES_CBC, Crypto::AES_CTR, Crypto::AES_GCM }) {
+      const char* names[] = { "ECB", "CBC", "CFB8", "CFB128", "OFB", "CTR", "GCM" };
+      Crypto::AESEncryption encryptor(type);
+      Crypto::AESDecryption decryptor(type);
+      encryptor.Key(key.size(), key.data());
+      decryptor.Key(key.size(), key.data());
+
+      Report((string("AES-128 ") + names[type] + " encrypt").c_str(), megabytes / Measure([&]() {
+         for (uint32_t index = 0; index < iterations; index++) {
+            encryptor.InitialVector(type == Crypto::AES_GCM ? 12 : 16, iv);
+            encryptor.Encrypt(buffer.size(), buffer.data(), buffer.data());
+         }
+      }), "MB/s");
+      Report((string("AES-128 ") + names[type] + " decrypt").c_str(), megabytes / Measure([&]() {
+         for (uint32_t index = 0; index < iterations; index++) {
+            decryptor.InitialVector(type == Crypto::AES_GCM ? 12 : 16, iv);
+            decryptor.Decrypt(buffer.size(), buffer.data(), buffer.data());
+         }
+      }), "MB/s");
+   }
+}
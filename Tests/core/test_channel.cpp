@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <plugins/plugins.h>
+
+#include <sys/socket.h>
+
+using namespace WPEFramework;
+
+namespace {
+
+   // A channel over one end of a socket pair. It stays a web channel, so nothing is taken from
+   // its send queue, all that is submitted stays there.
+   class Link : public PluginHost::Channel {
+   public:
+      Link() = delete;
+      Link(const Link&) = delete;
+      Link& operator=(const Link&) = delete;
+
+      Link(const SOCKET connector)
+         : PluginHost::Channel(connector, Core::NodeId())
+      {
+      }
+      ~Link() override = default;
+
+   private:
+      void LinkBody(Core::ProxyType<PluginHost::Request>&) override
+      {
+      }
+      void Received(Core::ProxyType<PluginHost::Request>&) override
+      {
+      }
+      void Send(const Core::ProxyType<Web::Response>&) override
+      {
+      }
+      void Send(const Core::ProxyType<Core::JSON::IElement>&) override
+      {
+      }
+      Core::ProxyType<Core::JSON::IElement> Element(const string&) override
+      {
+         return (Core::ProxyType<Core::JSON::IElement>());
+      }
+      void Received(Core::ProxyType<Core::JSON::IElement>&) override
+      {
+      }
+      uint16_t SendData(uint8_t*, const uint16_t) override
+      {
+         return (0);
+      }
+      uint16_t ReceiveData(uint8_t*, const uint16_t receivedSize) override
+      {
+         return (receivedSize);
+      }
+      void Received(const string&) override
+      {
+      }
+      void StateChange() override
+      {
+      }
+   };
+
+   class Pair {
+   public:
+      Pair(const Pair&) = delete;
+      Pair& operator=(const Pair&) = delete;
+
+      Pair()
+         : _peer(-1)
+         , _link(nullptr)
+      {
+         int fds[2];
+
+         EXPECT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+         _peer = fds[1];
+         _link = new Link(fds[0]);
+
+         // Monitored, like an accepted channel is, it is triggered when something is queued.
+         EXPECT_EQ(_link->Open(0), Core::ERROR_NONE);
+      }
+      ~Pair()
+      {
+         _link->Close(Core::infinite);
+         delete _link;
+         ::close(_peer);
+      }
+
+   public:
+      Link* operator->()
+      {
+         return (_link);
+      }
+
+   private:
+      int _peer;
+      Link* _link;
+   };
+
+   Core::ProxyType<Core::JSON::IElement> Notification(const string& designator)
+   {
+      Core::ProxyType<Core::JSONRPC::Message> message(Core::ProxyType<Core::JSONRPC::Message>::Create());
+
+      message->Designator = designator;
+
+      return (Core::ProxyType<Core::JSON::IElement>(message));
+   }
+
+   Core::ProxyType<Core::JSON::IElement> Response(const uint32_t id)
+   {
+      Core::ProxyType<Core::JSONRPC::Message> message(Core::ProxyType<Core::JSONRPC::Message>::Create());
+
+      message->Id = id;
+      message->Result = _T("true");
+
+      return (Core::ProxyType<Core::JSON::IElement>(message));
+   }
+}
+
+class Plugin_Channel : public ::testing::Test {
+protected:
+   // The ResourceMonitor can not be created again once disposed, keep it for all tests.
+   static void TearDownTestCase()
+   {
+      Core::Singleton::Dispose();
+   }
+};
+
+TEST_F(Plugin_Channel, limits)
+{
+   Pair channel;
+
+   channel->Limits(PluginHost::Channel::Backpressure(0, 0, 8, 0, PluginHost::Channel::DROPOLDEST));
+
+   PluginHost::Channel::Backpressure limits(channel->Limits());
+   EXPECT_EQ(limits.HighMessages, 8u);
+   EXPECT_EQ(limits.LowMessages, 6u);
+   EXPECT_EQ(limits.HighBytes, 0u);
+   EXPECT_EQ(limits.Policy, PluginHost::Channel::DROPOLDEST);
+
+   // No watermark, nothing is ever taken out.
+   channel->Limits(PluginHost::Channel::Backpressure());
+   for (uint32_t index = 0; index < 100; index++) {
+      channel->Submit(Notification(_T("Test.event")));
+   }
+   EXPECT_EQ(channel->QueueDepth(), 100u);
+   EXPECT_EQ(channel->Dropped(), 0u);
+   EXPECT_EQ(channel->Coalesced(), 0u);
+}
+
+TEST_F(Plugin_Channel, coalesce)
+{
+   Pair channel;
+
+   channel->Limits(PluginHost::Channel::Backpressure(0, 0, 4, 2, PluginHost::Channel::COALESCE));
+
+   channel->Submit(Notification(_T("Test.front")));
+   channel->Submit(Notification(_T("Test.a")));
+   channel->Submit(Notification(_T("Test.b")));
+   channel->Submit(Notification(_T("Test.c")));
+   EXPECT_EQ(channel->QueueDepth(), 4u);
+
+   // Over the watermark, it replaces the queued one for the same event.
+   channel->Submit(Notification(_T("Test.a")));
+   EXPECT_EQ(channel->QueueDepth(), 4u);
+   EXPECT_EQ(channel->Coalesced(), 1u);
+   EXPECT_EQ(channel->Dropped(), 0u);
+
+   // The one being sent is never replaced, nothing else to coalesce with, so the oldest go.
+   channel->Submit(Notification(_T("Test.front")));
+   EXPECT_EQ(channel->Coalesced(), 1u);
+   EXPECT_EQ(channel->Dropped(), 3u);
+   EXPECT_EQ(channel->QueueDepth(), 2u);
+   EXPECT_TRUE(channel->IsOpen());
+}
+
+TEST_F(Plugin_Channel, dropOldest)
+{
+   Pair channel;
+
+   channel->Limits(PluginHost::Channel::Backpressure(0, 0, 4, 2, PluginHost::Channel::DROPOLDEST));
+
+   channel->Submit(Notification(_T("Test.front")));
+   channel->Submit(Notification(_T("Test.a")));
+   channel->Submit(Notification(_T("Test.b")));
+   channel->Submit(Notification(_T("Test.c")));
+
+   // Not coalesced, it drops back to the low watermark.
+   channel->Submit(Notification(_T("Test.a")));
+   EXPECT_EQ(channel->Coalesced(), 0u);
+   EXPECT_EQ(channel->Dropped(), 3u);
+   EXPECT_EQ(channel->QueueDepth(), 2u);
+
+   // Back under the high watermark, nothing has to go.
+   channel->Submit(Notification(_T("Test.b")));
+   EXPECT_EQ(channel->Dropped(), 3u);
+   EXPECT_EQ(channel->QueueDepth(), 3u);
+   EXPECT_TRUE(channel->IsOpen());
+}
+
+TEST_F(Plugin_Channel, disconnect)
+{
+   Pair channel;
+
+   channel->Limits(PluginHost::Channel::Backpressure(0, 0, 4, 2, PluginHost::Channel::DISCONNECT));
+
+   for (uint32_t index = 0; index < 4; index++) {
+      channel->Submit(Notification(_T("Test.event")));
+   }
+   EXPECT_TRUE(channel->IsOpen());
+
+   channel->Submit(Notification(_T("Test.event")));
+   EXPECT_EQ(channel->Dropped(), 0u);
+   EXPECT_EQ(channel->Coalesced(), 0u);
+   EXPECT_FALSE(channel->IsOpen());
+
+   // A closed channel takes nothing in.
+   channel->Submit(Notification(_T("Test.event")));
+   EXPECT_EQ(channel->QueueDepth(), 5u);
+}
+
+TEST_F(Plugin_Channel, responsesKept)
+{
+   Pair channel;
+
+   channel->Limits(PluginHost::Channel::Backpressure(0, 0, 4, 2, PluginHost::Channel::COALESCE));
+
+   channel->Submit(Notification(_T("Test.front")));
+   channel->Submit(Response(1));
+   channel->Submit(Notification(_T("Test.a")));
+   channel->Submit(Response(2));
+
+   // Only the notification can go, the responses stay.
+   channel->Submit(Notification(_T("Test.a")));
+   EXPECT_EQ(channel->Coalesced(), 1u);
+   channel->Submit(Notification(_T("Test.b")));
+   EXPECT_EQ(channel->Dropped(), 2u);
+   EXPECT_EQ(channel->QueueDepth(), 3u);
+   EXPECT_TRUE(channel->IsOpen());
+
+   // Responses are not coalesced either, the client waits for each of them.
+   channel->Submit(Response(1));
+   EXPECT_EQ(channel->Coalesced(), 1u);
+   EXPECT_EQ(channel->QueueDepth(), 4u);
+
+   // Nothing left to drop, rather than losing a response the channel is closed.
+   channel->Submit(Response(3));
+   EXPECT_EQ(channel->Dropped(), 2u);
+   EXPECT_EQ(channel->QueueDepth(), 5u);
+   EXPECT_FALSE(channel->IsOpen());
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+
+using namespace WPEFramework;
+
+static uint32_t ReferenceCRC(uint32_t crc, const uint8_t data[], const uint32_t length)
+{
+   for (uint32_t index = 0; index < length; index++) {
+      crc ^= (data[index] << 24);
+      for (uint8_t bit = 0; bit < 8; bit++) {
+         crc = ((crc & 0x80000000) != 0 ? ((crc << 1) ^ 0x04C11DB7) : (crc << 1));
+      }
+   }
+   return (crc);
+}
+
+TEST(Core_CRC32, check)
+{
+   const uint8_t text[] = "123456789";
+
+   // The CRC-32/MPEG-2 check value.
+   EXPECT_EQ(Core::CRC32Calculator::Calculate(~0, text, 9), 0x0376E6E7u);
+}
+
+TEST(Core_CRC32, lengths)
+{
+   uint8_t data[1100];
+
+   for (uint32_t index = 0; index < sizeof(data); index++) {
+      data[index] = static_cast<uint8_t>((index * 131) ^ (index >> 3));
+   }
+
+   for (uint32_t length = 0; length < 1030; length++) {
+      const uint8_t alignment = length & 0x7;
+
+      EXPECT_EQ(Core::CRC32Calculator::Calculate(~0, &data[alignment], length), ReferenceCRC(~0, &data[alignment], length)) << "length " << length;
+   }
+}
+
+TEST(Core_CRC32, incremental)
+{
+   uint8_t section[4096];
+
+   for (uint32_t index = 0; index < sizeof(section); index++) {
+      section[index] = static_cast<uint8_t>(index * 7 + (index >> 8));
+   }
+
+   const uint32_t expected = ReferenceCRC(~0, section, sizeof(section));
+
+   // As a section coming in over TS packets, with the first part after the pointer field.
+   for (uint32_t first : { 1, 17, 100, 183, 184 }) {
+      Core::CRC32Calculator crc;
+      uint32_t offset = 0;
+      uint32_t part = first;
+
+      while (offset < sizeof(section)) {
+         part = std::min(part, static_cast<uint32_t>(sizeof(section)) - offset);
+         crc.Input(&section[offset], part);
+         offset += part;
+         part = 184;
+      }
+
+      EXPECT_EQ(crc.Result(), expected) << "first " << first;
+   }
+
+   Core::DataElement element(sizeof(section), section);
+
+   EXPECT_EQ(element.CRC32(0, sizeof(section)), expected);
+   EXPECT_EQ(element.CRC32(10, 300), ReferenceCRC(~0, &section[10], 300));
+}
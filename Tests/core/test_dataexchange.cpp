@@ -0,0 +1,419 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <cryptalgo/cryptalgo.h>
+#include <ocdm/DataExchange.h>
+
+#include <atomic>
+#include <thread>
+
+#include "Benchmark.h"
+
+using namespace WPEFramework;
+
+const char g_exchangeName[] = "testexchange01";
+const uint8_t g_key[16] = { 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c };
+
+static void CleanUpExchange()
+{
+   char systemCmd[1024];
+   sprintf(systemCmd, "rm -f %s", g_exchangeName);
+   system(systemCmd);
+   sprintf(systemCmd, "rm -f %s.admin", g_exchangeName);
+   system(systemCmd);
+}
+
+static void Sample(std::vector<uint8_t>& data, const uint32_t length, const uint32_t seed)
+{
+   data.resize(length);
+   for (uint32_t index = 0; index < length; index++) {
+      data[index] = static_cast<uint8_t>((index * 31) ^ seed);
+   }
+}
+
+static void IV(uint8_t iv[16], const uint32_t seed)
+{
+   for (uint8_t index = 0; index < 16; index++) {
+      iv[index] = static_cast<uint8_t>(seed + (index * 17));
+   }
+}
+
+static void Encrypt(std::vector<uint8_t>& data, const uint8_t iv[16])
+{
+   Crypto::AESEncryption aes(Crypto::AES_CTR);
+   aes.Key(sizeof(g_key), g_key);
+   aes.InitialVector(iv);
+   aes.Encrypt(static_cast<uint32_t>(data.size()), data.data(), data.data());
+}
+
+// Stands in for the decrypting side (the OpenCDMi plugin), AES-CTR with a fixed key.
+class Decryptor {
+public:
+   Decryptor() = delete;
+   Decryptor(const Decryptor&) = delete;
+   Decryptor& operator=(const Decryptor&) = delete;
+
+   // Single slot layout.
+   Decryptor(const uint32_t bufferSize)
+      : _exchange(g_exchangeName, bufferSize)
+      , _running(true)
+      , _threads()
+   {
+      _threads.emplace_back([this]() {
+         while (_running == true) {
+            if (_exchange.RequestConsume(100) == Core::ERROR_NONE) {
+               Crypto::AESDecryption aes(Crypto::AES_CTR);
+               aes.Key(sizeof(g_key), g_key);
+               aes.InitialVector(_exchange.IVKey());
+               aes.Decrypt(static_cast<uint32_t>(_exchange.Size()), _exchange.Buffer(), _exchange.Buffer());
+               _exchange.Status(Core::ERROR_NONE);
+               _exchange.Consumed();
+            }
+         }
+      });
+   }
+   // Ring layout, with a number of decrypting threads.
+   Decryptor(const uint32_t bufferSize, const uint8_t slots, const uint8_t threads)
+      : _exchange(g_exchangeName, bufferSize, slots)
+      , _running(true)
+      , _threads()
+   {
+      for (uint8_t index = 0; index < threads; index++) {
+         _threads.emplace_back([this]() {
+            while (_running == true) {
+               const uint8_t slot = _exchange.Next(100);
+
+               if (slot != OCDM::DataExchange::NoSlot) {
+                  uint8_t keyIdLength;
+                  _exchange.KeyId(slot, keyIdLength);
+
+                  Crypto::AESDecryption aes(Crypto::AES_CTR);
+                  aes.Key(sizeof(g_key), g_key);
+                  aes.InitialVector(_exchange.IVKey(slot));
+                  aes.Decrypt(_exchange.Length(slot), _exchange.Data(slot), _exchange.Data(slot));
+                  _exchange.Completed(slot, (keyIdLength == 16 ? Core::ERROR_NONE : Core::ERROR_UNKNOWN_KEY));
+               }
+            }
+         });
+      }
+   }
+   ~Decryptor()
+   {
+      _running = false;
+      for (std::thread& thread : _threads) {
+         thread.join();
+      }
+   }
+
+private:
+   OCDM::DataExchange _exchange;
+   std::atomic<bool> _running;
+   std::vector<std::thread> _threads;
+};
+
+// The client side of the single slot layout, as OpenCDMSession does it.
+static uint32_t DecryptSingle(OCDM::DataExchange& exchange, uint8_t data[], const uint32_t length, const uint8_t iv[16], const uint8_t keyId[16])
+{
+   uint32_t result = Core::ERROR_GENERAL;
+
+   if (exchange.RequestProduce(Core::infinite) == Core::ERROR_NONE) {
+      exchange.SetIV(16, iv);
+      exchange.SetSubSampleData(0, nullptr);
+      exchange.KeyId(16, keyId);
+      exchange.InitWithLast15(false);
+      exchange.Write(length, data);
+      exchange.Produced();
+
+      if (exchange.RequestProduce(Core::infinite) == Core::ERROR_NONE) {
+         exchange.Read(length, data);
+         result = exchange.Status();
+         exchange.Consumed();
+      }
+   }
+
+   return (result);
+}
+
+// The client side of the ring layout, copying through a slot.
+static uint32_t DecryptCopy(OCDM::DataExchange& exchange, uint8_t data[], const uint32_t length, const uint8_t iv[16], const uint8_t keyId[16])
+{
+   uint32_t result = Core::ERROR_GENERAL;
+   uint8_t* buffer = exchange.Allocate(length, Core::infinite);
+
+   if (buffer != nullptr) {
+      ::memcpy(buffer, data, length);
+      result = exchange.Decrypt(buffer, length, 16, iv, 16, keyId, 0, nullptr, false, Core::infinite);
+      ::memcpy(data, buffer, length);
+      exchange.Release(buffer);
+   }
+
+   return (result);
+}
+
+TEST(OCDM_DataExchange, layout)
+{
+   CleanUpExchange();
+
+   {
+      Decryptor decryptor(64 * 1024);
+      OCDM::DataExchange client(g_exchangeName);
+
+      EXPECT_FALSE(client.IsRing());
+      EXPECT_EQ(client.Slots(), 0);
+   }
+   {
+      Decryptor decryptor(64 * 1024 + 100, 6, 1);
+      OCDM::DataExchange client(g_exchangeName);
+
+      ASSERT_TRUE(client.IsRing());
+      EXPECT_EQ(client.Slots(), 6);
+      // Every slot takes what the single slot of that size takes.
+      EXPECT_EQ(client.SlotSize() % 64, 0u);
+      EXPECT_GE(client.SlotSize(), 64u * 1024 + 100);
+      EXPECT_LT(client.SlotSize(), 64u * 1024 + 100 + 64);
+
+      // Too large for a slot.
+      EXPECT_EQ(client.Allocate(client.SlotSize() + 1, 0), nullptr);
+
+      // All slots can be taken, and given back.
+      uint8_t* buffers[6];
+      for (uint8_t index = 0; index < 6; index++) {
+         buffers[index] = client.Allocate(client.SlotSize(), 100);
+         ASSERT_NE(buffers[index], nullptr);
+         EXPECT_EQ(client.Data(client.Slot(buffers[index])), buffers[index]);
+      }
+      EXPECT_EQ(client.Allocate(16, 10), nullptr);
+      EXPECT_EQ(client.Slot(reinterpret_cast<const uint8_t*>(&client)), OCDM::DataExchange::NoSlot);
+
+      client.Release(buffers[3]);
+      uint8_t* again = client.Allocate(16, 100);
+      EXPECT_EQ(again, buffers[3]);
+      buffers[3] = again;
+
+      for (uint8_t index = 0; index < 6; index++) {
+         client.Release(buffers[index]);
+      }
+   }
+
+   CleanUpExchange();
+}
+
+TEST(OCDM_DataExchange, decrypt)
+{
+   const uint8_t keyId[16] = { 0 };
+   std::vector<uint8_t> expected;
+   std::vector<uint8_t> data;
+   uint8_t iv[16];
+
+   CleanUpExchange();
+
+   {
+      Decryptor decryptor(256 * 1024);
+      OCDM::DataExchange client(g_exchangeName);
+
+      for (uint32_t length : { 1u, 15u, 16u, 17u, 1000u, 65536u, 262144u }) {
+         Sample(expected, length, length);
+         data = expected;
+         IV(iv, length);
+         Encrypt(data, iv);
+
+         EXPECT_EQ(DecryptSingle(client, data.data(), length, iv, keyId), Core::ERROR_NONE);
+         EXPECT_EQ(data, expected) << "single slot, length " << length;
+      }
+   }
+   {
+      Decryptor decryptor(256 * 1024, 4, 2);
+      OCDM::DataExchange client(g_exchangeName);
+
+      // Up to the largest sample the single slot above takes, more than a quarter of that.
+      for (uint32_t length : { 1u, 15u, 16u, 17u, 1000u, 65536u, 262144u }) {
+         Sample(expected, length, length);
+         data = expected;
+         IV(iv, length);
+         Encrypt(data, iv);
+
+         EXPECT_EQ(DecryptCopy(client, data.data(), length, iv, keyId), Core::ERROR_NONE);
+         EXPECT_EQ(data, expected) << "ring, length " << length;
+
+         // In place, the sample is written straight into the slot.
+         data = expected;
+         Encrypt(data, iv);
+
+         uint8_t* buffer = client.Allocate(length, Core::infinite);
+         ASSERT_NE(buffer, nullptr);
+         ::memcpy(buffer, data.data(), length);
+         EXPECT_EQ(client.Decrypt(buffer, length, 16, iv, 16, keyId, 0, nullptr, false, Core::infinite), Core::ERROR_NONE);
+         EXPECT_EQ(::memcmp(buffer, expected.data(), length), 0) << "in place, length " << length;
+         client.Release(buffer);
+      }
+
+      // Larger than the single slot of the same size takes, is not taken here either.
+      EXPECT_EQ(client.Allocate(256 * 1024 + 64 + 1, 0), nullptr);
+      Sample(data, 256 * 1024 + 64 + 1, 0);
+      EXPECT_EQ(DecryptCopy(client, data.data(), static_cast<uint32_t>(data.size()), iv, keyId), Core::ERROR_GENERAL);
+
+      // The status of the decrypting side comes back per slot.
+      uint8_t* buffer = client.Allocate(16, Core::infinite);
+      EXPECT_EQ(client.Decrypt(buffer, 16, 16, iv, 4, keyId, 0, nullptr, false, Core::infinite), Core::ERROR_UNKNOWN_KEY);
+      client.Release(buffer);
+   }
+
+   CleanUpExchange();
+}
+
+TEST(OCDM_DataExchange, timeout)
+{
+   const uint8_t keyId[16] = { 0 };
+   uint8_t iv[16];
+
+   IV(iv, 0);
+   CleanUpExchange();
+
+   {
+      // No threads, the decrypting side is driven by hand.
+      OCDM::DataExchange server(g_exchangeName, 4096, 1);
+      OCDM::DataExchange client(g_exchangeName);
+
+      // Released before it is completed, the completion hands the slot back.
+      uint8_t* buffer = client.Allocate(16, 100);
+      ASSERT_NE(buffer, nullptr);
+      EXPECT_EQ(client.Decrypt(buffer, 16, 16, iv, 16, keyId, 0, nullptr, false, 10), Core::ERROR_TIMEDOUT);
+      client.Release(buffer);
+      EXPECT_EQ(client.Allocate(16, 10), nullptr);
+
+      uint8_t slot = server.Next(100);
+      ASSERT_EQ(slot, 0);
+      EXPECT_EQ(client.Allocate(16, 10), nullptr);
+      server.Completed(slot, Core::ERROR_NONE);
+
+      // Completed before it is released, the release takes the signal nobody waited for.
+      buffer = client.Allocate(16, 100);
+      ASSERT_NE(buffer, nullptr);
+      EXPECT_EQ(client.Decrypt(buffer, 16, 16, iv, 16, keyId, 0, nullptr, false, 10), Core::ERROR_TIMEDOUT);
+      slot = server.Next(100);
+      ASSERT_EQ(slot, 0);
+      server.Completed(slot, Core::ERROR_UNKNOWN_KEY);
+      client.Release(buffer);
+
+      // So the next one really waits for its own sample.
+      buffer = client.Allocate(16, 100);
+      ASSERT_NE(buffer, nullptr);
+      EXPECT_EQ(client.Decrypt(buffer, 16, 16, iv, 16, keyId, 0, nullptr, false, 10), Core::ERROR_TIMEDOUT);
+      slot = server.Next(100);
+      ASSERT_EQ(slot, 0);
+      server.Completed(slot, Core::ERROR_NONE);
+      client.Release(buffer);
+
+      buffer = client.Allocate(16, 100);
+      ASSERT_NE(buffer, nullptr);
+      client.Release(buffer);
+   }
+
+   CleanUpExchange();
+}
+
+TEST(OCDM_DataExchange, concurrent)
+{
+   const uint8_t keyId[16] = { 0 };
+   std::atomic<uint32_t> failures(0);
+
+   CleanUpExchange();
+
+   {
+      Decryptor decryptor(64 * 1024, 8, 2);
+      OCDM::DataExchange client(g_exchangeName);
+      std::vector<std::thread> clients;
+
+      // Like audio and video of one player, or more players, sharing the session.
+      for (uint32_t thread = 0; thread < 4; thread++) {
+         clients.emplace_back([&, thread]() {
+            std::vector<uint8_t> expected;
+            std::vector<uint8_t> data;
+            uint8_t iv[16];
+
+            for (uint32_t index = 0; index < 200; index++) {
+               const uint32_t length = 1 + ((index * 7919 + thread * 104729) % 60000);
+
+               Sample(expected, length, index ^ (thread << 8));
+               data = expected;
+               IV(iv, index + thread);
+               Encrypt(data, iv);
+
+               if ((index & 1) == 0) {
+                  if ((DecryptCopy(client, data.data(), length, iv, keyId) != Core::ERROR_NONE) || (data != expected)) {
+                     failures++;
+                  }
+               } else {
+                  uint8_t* buffer = client.Allocate(length, Core::infinite);
+                  ::memcpy(buffer, data.data(), length);
+                  if ((client.Decrypt(buffer, length, 16, iv, 16, keyId, 0, nullptr, false, Core::infinite) != Core::ERROR_NONE) || (::memcmp(buffer, expected.data(), length) != 0)) {
+                     failures++;
+                  }
+                  client.Release(buffer);
+               }
+            }
+         });
+      }
+
+      for (std::thread& thread : clients) {
+         thread.join();
+      }
+   }
+
+   EXPECT_EQ(failures.load(), 0u);
+
+   CleanUpExchange();
+}
+
+TEST(OCDM_DataExchange, DISABLED_throughput)
+{
+   const uint8_t keyId[16] = { 0 };
+   const uint32_t length = 64 * 1024;
+   const uint32_t samples = 1000;
+   const uint8_t clients = 2;
+   const double total = static_cast<double>(clients) * samples;
+   uint8_t iv[16];
+
+   IV(iv, 0);
+
+   CleanUpExchange();
+
+   // Decrypting "encrypted" data is fine, only the time counts here.
+   for (uint8_t mode = 0; mode < 3; mode++) {
+      static const char* names[] = { "DataExchange single slot", "DataExchange ring, copy", "DataExchange ring, in place" };
+      std::unique_ptr<Decryptor> decryptor(mode == 0 ? new Decryptor(length) : new Decryptor(length, 8, 2));
+      OCDM::DataExchange client(g_exchangeName);
+      Core::CriticalSection systemLock;
+
+      Report(names[mode], total / Measure([&]() {
+         std::vector<std::thread> threads;
+
+         for (uint8_t thread = 0; thread < clients; thread++) {
+            threads.emplace_back([&]() {
+               std::vector<uint8_t> data(length, 0x5A);
+
+               for (uint32_t index = 0; index < samples; index++) {
+                  if (mode == 0) {
+                     // The single slot can only be used by one thread at a time.
+                     systemLock.Lock();
+                     DecryptSingle(client, data.data(), length, iv, keyId);
+                     systemLock.Unlock();
+                  } else if (mode == 1) {
+                     DecryptCopy(client, data.data(), length, iv, keyId);
+                  } else {
+                     uint8_t* buffer = client.Allocate(length, Core::infinite);
+                     client.Decrypt(buffer, length, 16, iv, 16, keyId, 0, nullptr, false, Core::infinite);
+                     client.Release(buffer);
+                  }
+               }
+            });
+         }
+
+         for (std::thread& thread : threads) {
+            thread.join();
+         }
+      }), "samples/s");
+   }
+
+   CleanUpExchange();
+}
@@ -0,0 +1,304 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <broadcast/broadcast.h>
+
+#include "Benchmark.h"
+#include "SectionBuilder.h"
+
+using namespace WPEFramework;
+
+static void Filler(std::vector<uint8_t>& stream, const uint16_t pid, uint8_t& continuity, const uint32_t count)
+{
+   for (uint32_t index = 0; index < count; index++) {
+      uint8_t packet[188];
+
+      ::memset(packet, static_cast<uint8_t>(index), sizeof(packet));
+      packet[0] = 0x47;
+      packet[1] = static_cast<uint8_t>(pid >> 8) | (index == 0 ? 0x40 : 0x00);
+      packet[2] = static_cast<uint8_t>(pid & 0xFF);
+      packet[3] = 0x10 | (continuity & 0x0F);
+      continuity++;
+
+      stream.insert(stream.end(), packet, packet + sizeof(packet));
+   }
+}
+
+class Collector : public Broadcast::ISection {
+public:
+   Collector(const Collector&) = delete;
+   Collector& operator=(const Collector&) = delete;
+
+   Collector()
+      : Sections()
+   {
+   }
+   ~Collector() override
+   {
+   }
+
+   void Handle(const Broadcast::MPEG::Section& section) override
+   {
+      const Core::DataElement data(section.Data());
+
+      Sections.push_back({ section.TableId(), section.Extension(), section.SectionNumber(), std::vector<uint8_t>(data.Buffer(), data.Buffer() + data.Size()) });
+   }
+
+   static std::vector<uint8_t> Payload(const std::vector<uint8_t>& section)
+   {
+      return (std::vector<uint8_t>(section.begin() + 8, section.end() - 4));
+   }
+
+public:
+   struct Entry {
+      uint8_t TableId;
+      uint16_t Extension;
+      uint8_t Number;
+      std::vector<uint8_t> Payload;
+   };
+
+   std::vector<Entry> Sections;
+};
+
+static std::vector<std::vector<uint8_t>> TestSections(const uint8_t tableId, const uint32_t count)
+{
+   std::vector<std::vector<uint8_t>> sections;
+
+   for (uint32_t index = 0; index < count; index++) {
+      // Tiny ones sharing packets, up to the maximum spanning many.
+      const uint16_t payload = (index % 5 == 4 ? 4084 : static_cast<uint16_t>(1 + ((index * 397) % 700)));
+      sections.push_back(MakeSection(tableId, static_cast<uint16_t>(index), 1, static_cast<uint8_t>(index), static_cast<uint8_t>(index), payload, index));
+   }
+
+   return (sections);
+}
+
+TEST(Broadcast_Demultiplexer, sections)
+{
+   const std::vector<std::vector<uint8_t>> eit = TestSections(0x50, 40);
+   const std::vector<std::vector<uint8_t>> sdt = TestSections(0x42, 7);
+   std::vector<uint8_t> stream;
+   uint8_t continuity[3] = { 0, 0, 0 };
+
+   Filler(stream, 0x100, continuity[0], 10);
+   Packetize(stream, 0x12, continuity[1], eit);
+   Filler(stream, 0x100, continuity[0], 10);
+   Packetize(stream, 0x11, continuity[2], sdt);
+
+   Broadcast::Demultiplexer demux;
+   Collector eitCollector;
+   Collector sdtCollector;
+
+   EXPECT_EQ(demux.Filter(0x12, 0x50, &eitCollector), Core::ERROR_NONE);
+   EXPECT_EQ(demux.Filter(0x11, 0x42, &sdtCollector), Core::ERROR_NONE);
+   EXPECT_EQ(demux.Filter(0x2000, 0x42, &sdtCollector), Core::ERROR_BAD_REQUEST);
+
+   EXPECT_EQ(demux.Input(stream.data(), static_cast<uint32_t>(stream.size())), stream.size() / 188);
+
+   ASSERT_EQ(eitCollector.Sections.size(), eit.size());
+   for (uint32_t index = 0; index < eit.size(); index++) {
+      EXPECT_EQ(eitCollector.Sections[index].Extension, index);
+      EXPECT_EQ(eitCollector.Sections[index].Payload, Collector::Payload(eit[index])) << "section " << index;
+   }
+   ASSERT_EQ(sdtCollector.Sections.size(), sdt.size());
+   EXPECT_EQ(demux.Statistic().Sections, eit.size() + sdt.size());
+   EXPECT_EQ(demux.Statistic().ContinuityErrors, 0u);
+   EXPECT_EQ(demux.Statistic().CRCErrors, 0u);
+
+   // Fed in arbitrary parts, with garbage in front, it all ends up the same.
+   Broadcast::Demultiplexer chunked;
+   Collector chunkedCollector;
+   std::vector<uint8_t> garbage(100, 0x47);
+
+   garbage.insert(garbage.end(), stream.begin(), stream.end());
+   chunked.Filter(0x12, 0x50, &chunkedCollector);
+
+   uint32_t offset = 0;
+   uint32_t part = 1;
+   while (offset < garbage.size()) {
+      part = std::min((part * 7 + 3) % 1000, static_cast<uint32_t>(garbage.size()) - offset);
+      chunked.Input(&garbage[offset], part);
+      offset += part;
+   }
+
+   ASSERT_EQ(chunkedCollector.Sections.size(), eit.size());
+   for (uint32_t index = 0; index < eit.size(); index++) {
+      EXPECT_EQ(chunkedCollector.Sections[index].Payload, Collector::Payload(eit[index])) << "section " << index;
+   }
+   EXPECT_GT(chunked.Statistic().SyncLosses, 0u);
+
+   // Revoked, nothing comes in any more.
+   EXPECT_EQ(demux.Revoke(&eitCollector), Core::ERROR_NONE);
+   EXPECT_EQ(demux.Revoke(&eitCollector), Core::ERROR_UNAVAILABLE);
+   demux.Input(stream.data(), static_cast<uint32_t>(stream.size()));
+   EXPECT_EQ(eitCollector.Sections.size(), eit.size());
+}
+
+TEST(Broadcast_Demultiplexer, errors)
+{
+   const std::vector<std::vector<uint8_t>> eit = TestSections(0x50, 10);
+   std::vector<uint8_t> stream;
+   uint8_t continuity = 0;
+
+   Packetize(stream, 0x12, continuity, eit);
+
+   // Section 4 is a large one, drop a packet in the middle of it.
+   uint32_t packet = 0;
+   uint32_t collected = 0;
+   for (uint32_t index = 0; index < 4; index++) {
+      collected += static_cast<uint32_t>(eit[index].size());
+   }
+   packet = (collected / 183) + 4;
+
+   std::vector<uint8_t> lost(stream);
+   lost.erase(lost.begin() + (packet * 188), lost.begin() + ((packet + 1) * 188));
+
+   // And send another one twice.
+   lost.insert(lost.begin() + (2 * 188), lost.begin() + (1 * 188), lost.begin() + (2 * 188));
+
+   Broadcast::Demultiplexer demux;
+   Collector collector;
+
+   demux.Filter(0x12, 0x50, &collector);
+   demux.Input(lost.data(), static_cast<uint32_t>(lost.size()));
+
+   EXPECT_EQ(demux.Statistic().ContinuityErrors, 1u);
+   ASSERT_EQ(collector.Sections.size(), eit.size() - 1);
+   for (uint32_t index = 0; index < collector.Sections.size(); index++) {
+      EXPECT_NE(collector.Sections[index].Number, 4);
+   }
+
+   // A bit flipped, fails the CRC.
+   std::vector<uint8_t> corrupt(stream);
+   corrupt[188 + 100] ^= 0x01;
+
+   Collector crc;
+   Broadcast::Demultiplexer crcDemux;
+   crcDemux.Filter(0x12, 0x50, &crc);
+   crcDemux.Input(corrupt.data(), static_cast<uint32_t>(corrupt.size()));
+
+   EXPECT_EQ(crcDemux.Statistic().CRCErrors, 1u);
+   EXPECT_EQ(crc.Sections.size(), eit.size() - 1);
+
+   // The transport_error_indicator set, drops what it is part of.
+   std::vector<uint8_t> error(stream);
+   error[(packet * 188) + 1] |= 0x80;
+
+   Collector tei;
+   Broadcast::Demultiplexer teiDemux;
+   teiDemux.Filter(0x12, 0x50, &tei);
+   teiDemux.Input(error.data(), static_cast<uint32_t>(error.size()));
+
+   EXPECT_EQ(teiDemux.Statistic().TransportErrors, 1u);
+   EXPECT_EQ(tei.Sections.size(), eit.size() - 1);
+}
+
+TEST(Broadcast_Demultiplexer, masks)
+{
+   std::vector<std::vector<uint8_t>> sections;
+   std::vector<uint8_t> stream;
+   uint8_t continuity = 0;
+
+   // EIT schedule actual (0x50-0x5F) and other (0x60-0x6F) for a few services, and p/f (0x4E).
+   for (uint8_t table : { 0x4E, 0x50, 0x51, 0x5F, 0x60, 0x6F }) {
+      for (uint16_t service = 1; service <= 3; service++) {
+         sections.push_back(MakeSection(table, service, 0, 0, 0, 20, table));
+      }
+   }
+   Packetize(stream, 0x12, continuity, sections);
+
+   Broadcast::Demultiplexer demux;
+   Collector schedule;
+   Collector service2;
+   Collector presentFollowing;
+
+   demux.Filter(0x12, 0x50, 0xF0, 0, 0, &schedule);
+   demux.Filter(0x12, 0x40, 0xC0, 2, 0xFFFF, &service2);
+   demux.Filter(0x12, 0x4E, &presentFollowing);
+
+   demux.Input(stream.data(), static_cast<uint32_t>(stream.size()));
+
+   ASSERT_EQ(schedule.Sections.size(), 9u);
+   for (const Collector::Entry& entry : schedule.Sections) {
+      EXPECT_EQ(entry.TableId & 0xF0, 0x50);
+   }
+   ASSERT_EQ(service2.Sections.size(), 6u);
+   for (const Collector::Entry& entry : service2.Sections) {
+      EXPECT_EQ(entry.Extension, 2);
+   }
+   EXPECT_EQ(presentFollowing.Sections.size(), 3u);
+
+   // Updating a filter replaces it.
+   demux.Filter(0x12, 0x60, 0xF0, 0, 0, &schedule);
+   schedule.Sections.clear();
+   demux.Input(stream.data(), static_cast<uint32_t>(stream.size()));
+   ASSERT_EQ(schedule.Sections.size(), 6u);
+   EXPECT_EQ(schedule.Sections[0].TableId, 0x60);
+}
+
+TEST(Broadcast_Demultiplexer, file)
+{
+   const std::vector<std::vector<uint8_t>> eit = TestSections(0x50, 25);
+   std::vector<uint8_t> stream;
+   uint8_t continuity = 0;
+   const char fileName[] = "testdemux01.ts";
+
+   Packetize(stream, 0x12, continuity, eit);
+
+   FILE* file = fopen(fileName, "wb");
+   ASSERT_NE(file, nullptr);
+   fwrite(stream.data(), 1, stream.size(), file);
+   fclose(file);
+
+   // A read buffer of an odd number of packets, reads end in the middle of sections.
+   Broadcast::Demultiplexer demux(7);
+   Collector collector;
+
+   demux.Filter(0x12, 0x50, &collector);
+   EXPECT_EQ(demux.Load(fileName), Core::ERROR_NONE);
+   EXPECT_EQ(collector.Sections.size(), eit.size());
+   EXPECT_EQ(demux.Statistic().Packets, stream.size() / 188);
+
+   EXPECT_EQ(demux.Load("nonexisting.ts"), Core::ERROR_OPENING_FAILED);
+
+   remove(fileName);
+}
+
+TEST(Broadcast_Demultiplexer, DISABLED_throughput)
+{
+   // Something like a DVB-T mux: mostly audio/video, with the EIT schedule on its PID.
+   std::vector<uint8_t> stream;
+   uint8_t continuity[2] = { 0, 0 };
+   uint32_t sections = 0;
+
+   while (stream.size() < (32 * 1024 * 1024)) {
+      const std::vector<std::vector<uint8_t>> eit = TestSections(0x50, 10);
+      Packetize(stream, 0x12, continuity[0], eit);
+      Filler(stream, 0x100, continuity[1], 400);
+      sections += 10;
+   }
+
+   Broadcast::Demultiplexer demux;
+   Collector collector;
+   demux.Filter(0x12, 0x50, 0xF0, 0, 0, &collector);
+
+   Report("Demultiplexer mux", (stream.size() * 8.0) / (1000000.0 * Measure([&]() {
+      for (uint32_t offset = 0; offset < stream.size(); offset += (512 * 188)) {
+         demux.Input(&stream[offset], std::min(static_cast<uint32_t>(512 * 188), static_cast<uint32_t>(stream.size() - offset)));
+      }
+   })), "Mbit/s");
+
+   EXPECT_EQ(collector.Sections.size(), sections);
+
+   // Nothing but sections.
+   std::vector<uint8_t> si;
+   while (si.size() < (16 * 1024 * 1024)) {
+      Packetize(si, 0x12, continuity[0], TestSections(0x50, 10));
+   }
+   collector.Sections.clear();
+   collector.Sections.reserve(si.size() / 1000);
+
+   Report("Demultiplexer sections only", (si.size() * 8.0) / (1000000.0 * Measure([&]() {
+      demux.Input(si.data(), static_cast<uint32_t>(si.size()));
+   })), "Mbit/s");
+}
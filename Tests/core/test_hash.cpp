@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <cryptalgo/cryptalgo.h>
+
+#include "Benchmark.h"
+
+using namespace WPEFramework;
+
+template <typename HASH>
+static string Digest(HASH& hash, const uint8_t length = HASH::Length)
+{
+   const uint8_t* result = hash.Result();
+   string text;
+
+   for (uint8_t index = 0; index < length; index++) {
+      char buffer[3];
+      snprintf(buffer, sizeof(buffer), "%02x", result[index]);
+      text += buffer;
+   }
+
+   return (text);
+}
+
+// The digest of one million 'a', fed in parts of an odd size, so blocks are split everywhere.
+template <typename HASH>
+static string MillionA(const uint32_t part)
+{
+   std::vector<uint8_t> data(1000000, 'a');
+   HASH hash;
+   uint32_t offset = 0;
+
+   while (offset < data.size()) {
+      const uint32_t size = std::min(part, static_cast<uint32_t>(data.size()) - offset);
+      hash.Input(&data[offset], size);
+      offset += size;
+   }
+
+   return (Digest(hash));
+}
+
+template <typename HASH>
+static string ABC()
+{
+   HASH hash(reinterpret_cast<const uint8_t*>("abc"), 3);
+
+   return (Digest(hash));
+}
+
+TEST(Crypto_Hash, vectors)
+{
+   EXPECT_EQ(ABC<Crypto::MD5>(), "900150983cd24fb0d6963f7d28e17f72");
+   EXPECT_EQ(ABC<Crypto::SHA1>(), "a9993e364706816aba3e25717850c26c9cd0d89d");
+   EXPECT_EQ(ABC<Crypto::SHA224>(), "23097d223405d8228642a477bda255b32aadbce4bda0b3f7e36c9da7");
+   EXPECT_EQ(ABC<Crypto::SHA256>(), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+   EXPECT_EQ(ABC<Crypto::SHA384>(), "cb00753f45a35e8bb5a03d699ac65007272c32ab0eded1631a8b605a43ff5bed8086072ba1e7cc2358baeca134c825a7");
+   EXPECT_EQ(ABC<Crypto::SHA512>(), "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f");
+
+   for (uint32_t part : { 1000000, 4097, 63, 1 }) {
+      EXPECT_EQ(MillionA<Crypto::MD5>(part), "7707d6ae4e027c70eea2a935c2296f21") << part;
+      EXPECT_EQ(MillionA<Crypto::SHA1>(part), "34aa973cd4c4daa4f61eeb2bdbad27316534016f") << part;
+      EXPECT_EQ(MillionA<Crypto::SHA224>(part), "20794655980c91d8bbb4c1ea97618a4bf03f42581948b2ee4ee7ad67") << part;
+      EXPECT_EQ(MillionA<Crypto::SHA256>(part), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0") << part;
+      EXPECT_EQ(MillionA<Crypto::SHA384>(part), "9d0e1809716474cb086e834e310a4a1ced149e9c00f248527972cec5704c2a5b07b8b3dc38ecc4ebae97ddd87f3d8985") << part;
+      EXPECT_EQ(MillionA<Crypto::SHA512>(part), "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973ebde0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b") << part;
+   }
+}
+
+TEST(Crypto_Hash, file)
+{
+   const string fileName(_T("/tmp/test_hash.bin"));
+   std::vector<uint8_t> data(300000);
+
+   for (uint32_t index = 0; index < data.size(); index++) {
+      data[index] = static_cast<uint8_t>(index * 13 + (index >> 10));
+   }
+
+   Core::File file(fileName);
+   ASSERT_TRUE(file.Create());
+   file.Write(data.data(), static_cast<uint32_t>(data.size()));
+   file.Close();
+
+   Crypto::SHA256 expected(data.data(), data.size());
+   Crypto::SHA256 actual;
+
+   EXPECT_TRUE(Crypto::HashFile(fileName, actual));
+   EXPECT_EQ(Digest(actual), Digest(expected));
+
+   file.Destroy();
+
+   Crypto::SHA256 missing;
+   EXPECT_FALSE(Crypto::HashFile(fileName, missing));
+}
+
+TEST(Crypto_Hash, stream)
+{
+   std::vector<uint8_t> data(1000000, 'a');
+   Crypto::HashStreamType<Crypto::SHA256, Crypto::HASH_SHA256> sha256;
+   Crypto::HashStreamType<Crypto::HMACType<Crypto::SHA256>, Crypto::HASH_SHA256> hmac(Core::TextFragment(_T("key")));
+   Crypto::IHashStream* streams[] = { &sha256, &hmac };
+   const uint8_t length = Crypto::SHA256::Length;
+
+   for (Crypto::IHashStream* stream : streams) {
+      EXPECT_EQ(stream->Type(), Crypto::HASH_SHA256);
+      EXPECT_EQ(stream->Length(), length);
+   }
+
+   // The length of a block is not limited to 16 bits.
+   sha256.Input(data.data(), data.size());
+   EXPECT_EQ(Digest(static_cast<Crypto::IHashStream&>(sha256), length), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+   static_cast<Crypto::IHashStream&>(hmac).Input(reinterpret_cast<const uint8_t*>("The quick brown fox jumps over the lazy dog"), 43);
+   EXPECT_EQ(Digest(static_cast<Crypto::IHashStream&>(hmac), length), "f7bc83f430538424b13298e6aa6fb143ef4d59a14946175997479dbc2d1a3cd8");
+}
+
+template <typename HASH>
+static void Throughput(const char name[], const std::vector<uint8_t>& data)
+{
+   HASH hash;
+
+   Report(name, (data.size() / (1024.0 * 1024.0)) / Measure([&]() {
+      hash.Input(data.data(), data.size());
+      hash.Result();
+   }), "MB/s");
+}
+
+TEST(Crypto_Hash, DISABLED_throughput)
+{
+   std::vector<uint8_t> data(64 * 1024 * 1024, 0x5A);
+
+   Throughput<Crypto::MD5>("MD5", data);
+   Throughput<Crypto::SHA1>("SHA1", data);
+   Throughput<Crypto::SHA224>("SHA224", data);
+   Throughput<Crypto::SHA256>("SHA256", data);
+   Throughput<Crypto::SHA384>("SHA384", data);
+   Throughput<Crypto::SHA512>("SHA512", data);
+}
@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <plugins/plugins.h>
+
+#include "Benchmark.h"
+
+using namespace WPEFramework;
+
+static void Service(PluginHost::MetaData::Service& source)
+{
+   source.Callsign = _T("Controller");
+   source.Locator = _T("libWPEFrameworkController.so");
+   source.ClassName = _T("Controller");
+   source.Versions = _T("1.0");
+   source.AutoStart = true;
+   source.WebUI = _T("UI");
+   source.Configuration = _T("{\"name\":\"value\"}");
+   source.Module = _T("Controller");
+   source.Hash = _T("0123456789abcdef");
+}
+
+TEST(Core_JSON, containerLookup)
+{
+   PluginHost::MetaData::Service source;
+   Service(source);
+
+   string text;
+   source.ToString(text);
+
+   PluginHost::MetaData::Service target;
+   target.FromString(text);
+
+   EXPECT_EQ(target.Callsign.Value(), source.Callsign.Value());
+   EXPECT_EQ(target.Locator.Value(), source.Locator.Value());
+   EXPECT_EQ(target.ClassName.Value(), source.ClassName.Value());
+   EXPECT_EQ(target.AutoStart.Value(), source.AutoStart.Value());
+   EXPECT_EQ(target.Module.Value(), source.Module.Value());
+   EXPECT_EQ(target.Hash.Value(), source.Hash.Value());
+   EXPECT_TRUE(target.HasLabel(_T("hash")));
+   EXPECT_FALSE(target.HasLabel(_T("unknown")));
+}
+
+TEST(Core_JSON, DISABLED_throughput)
+{
+   PluginHost::MetaData::Service source;
+   Service(source);
+
+   string text;
+   source.ToString(text);
+
+   // Resolve every label of a complete MetaData::Service, in a fresh object, as a request would.
+   const uint32_t iterations = 20000;
+
+   Report("MetaData::Service deserialization", iterations / Measure([&]() {
+      for (uint32_t index = 0; index < iterations; index++) {
+         PluginHost::MetaData::Service target;
+         target.FromString(text);
+      }
+   }), "objects/s");
+}
+
+namespace {
+
+   class Point : public Core::JSON::Container {
+   public:
+      Point()
+         : Core::JSON::Container()
+         , X(0)
+         , Y(0)
+      {
+         Add(_T("x"), &X);
+         Add(_T("y"), &Y);
+      }
+      Point(const Point& copy)
+         : Core::JSON::Container()
+         , X(copy.X)
+         , Y(copy.Y)
+      {
+         Add(_T("x"), &X);
+         Add(_T("y"), &Y);
+      }
+      ~Point() override = default;
+
+      Point& operator=(const Point& RHS)
+      {
+         X = RHS.X;
+         Y = RHS.Y;
+         return (*this);
+      }
+
+   public:
+      Core::JSON::DecUInt32 X;
+      Core::JSON::DecUInt32 Y;
+   };
+
+   typedef Core::JSON::ArrayType<Core::JSON::DecUInt32> Numbers;
+}
+
+TEST(Core_JSON, arrayReserve)
+{
+   Numbers::Storage storage;
+
+   // Chunks of 8, 16, 32, ...
+   EXPECT_EQ(storage.Capacity(), 0u);
+   storage.Reserve(1);
+   EXPECT_EQ(storage.Capacity(), 8u);
+   storage.Reserve(9);
+   EXPECT_EQ(storage.Capacity(), 24u);
+   storage.Reserve(100);
+   EXPECT_EQ(storage.Capacity(), 120u);
+
+   // Filling up what was reserved does not grow it, nor does clearing it shrink it.
+   for (uint32_t index = 0; index < 120; index++) {
+      storage.Append() = index;
+   }
+   EXPECT_EQ(storage.size(), 120u);
+   EXPECT_EQ(storage.Capacity(), 120u);
+
+   storage.Clear();
+   EXPECT_TRUE(storage.empty());
+   EXPECT_EQ(storage.Capacity(), 120u);
+
+   storage.Append() = 1;
+   EXPECT_EQ(storage.Capacity(), 120u);
+   EXPECT_EQ(storage[0].Value(), 1u);
+}
+
+TEST(Core_JSON, arrayIndexing)
+{
+   Numbers numbers;
+   std::vector<const Core::JSON::DecUInt32*> addresses;
+
+   for (uint32_t index = 0; index < 300; index++) {
+      Core::JSON::DecUInt32& element(numbers.Add());
+      element = index * 3;
+      addresses.push_back(&element);
+   }
+   ASSERT_EQ(numbers.Length(), 300u);
+
+   // Every element, so also the first and last one of every chunk, and none of them moved.
+   for (uint32_t index = 0; index < 300; index++) {
+      EXPECT_EQ(numbers[index].Value(), index * 3);
+      EXPECT_EQ(&numbers[index], addresses[index]);
+   }
+
+   // A copy has its own elements.
+   const Numbers copy(numbers);
+   numbers[8] = 1;
+   EXPECT_EQ(copy.Length(), 300u);
+   EXPECT_EQ(copy[8].Value(), 24u);
+   EXPECT_EQ(copy.Get(299).Value(), 897u);
+}
+
+TEST(Core_JSON, arrayIterators)
+{
+   Numbers numbers;
+
+   for (uint32_t index = 0; index < 20; index++) {
+      Core::JSON::DecUInt32& element(numbers.Add());
+
+      // Elements that are not set are skipped.
+      if ((index % 5) != 4) {
+         element = index;
+      }
+   }
+
+   Numbers::Iterator iterator(numbers.Elements());
+   uint32_t expected = 0;
+
+   EXPECT_EQ(iterator.Count(), 20u);
+   EXPECT_FALSE(iterator.IsValid());
+
+   while (iterator.Next() == true) {
+      EXPECT_EQ(iterator.Current().Value(), expected);
+      expected += (((expected < 20) && ((expected % 5) == 3)) ? 2 : 1);
+
+      // Adding, past the next chunk, while iterating does not invalidate the iterator.
+      if (expected == 10) {
+         for (uint32_t index = 20; index < 40; index++) {
+            numbers.Add() = index;
+         }
+      }
+   }
+   EXPECT_FALSE(iterator.IsValid());
+   EXPECT_EQ(expected, 40u);
+   EXPECT_EQ(iterator.Count(), 40u);
+
+   const Numbers& constant(numbers);
+   Numbers::ConstIterator constIterator(constant.Elements());
+   uint32_t count = 0;
+
+   while (constIterator.Next() == true) {
+      count++;
+   }
+   EXPECT_EQ(count, 36u);
+
+   constIterator.Reset();
+   EXPECT_TRUE(constIterator.Next());
+   EXPECT_EQ(constIterator.Current().Value(), 0u);
+}
+
+TEST(Core_JSON, arrayOfContainers)
+{
+   Core::JSON::ArrayType<Point> points;
+
+   for (uint32_t index = 0; index < 50; index++) {
+      Point& point(points.Add());
+      point.X = index;
+      point.Y = index * 2;
+   }
+
+   string text;
+   points.ToString(text);
+
+   // The containers added while parsing keep on referring to their own members.
+   Core::JSON::ArrayType<Point> parsed;
+   parsed.FromString(text);
+   ASSERT_EQ(parsed.Length(), 50u);
+   EXPECT_EQ(parsed[7].X.Value(), 7u);
+   EXPECT_EQ(parsed[8].Y.Value(), 16u);
+   EXPECT_EQ(parsed[49].Y.Value(), 98u);
+
+   string again;
+   parsed.ToString(again);
+   EXPECT_EQ(again, text);
+}
@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+
+using namespace WPEFramework;
+
+namespace {
+
+class Point : public Core::JSON::Container {
+public:
+   Point()
+      : Core::JSON::Container()
+      , X(0)
+      , Y(0)
+   {
+      Add(_T("x"), &X);
+      Add(_T("y"), &Y);
+   }
+
+   Core::JSON::DecSInt32 X;
+   Core::JSON::DecSInt32 Y;
+};
+
+class Sum : public Core::JSON::Container {
+public:
+   Sum()
+      : Core::JSON::Container()
+      , Value(0)
+   {
+      Add(_T("value"), &Value);
+   }
+
+   Core::JSON::DecSInt32 Value;
+};
+
+class Resolver : public Core::JSONRPC::Message::IResolver {
+public:
+   Resolver(Core::JSONRPC::Handler& handler)
+      : _handler(handler)
+      , Resolved(0)
+      , Refuse()
+   {
+   }
+
+   virtual Core::ProxyType<Core::JSON::IElement> Parameters(const Core::JSONRPC::Message& message) override
+   {
+      Core::ProxyType<Core::JSON::IElement> result;
+
+      // As a channel would do, judge the message as far as it is parsed.
+      Resolved++;
+      if (message.Method() != Refuse) {
+         result = _handler.Parameters(message.FullMethod());
+      }
+      return (result);
+   }
+
+private:
+   Core::JSONRPC::Handler& _handler;
+
+public:
+   uint32_t Resolved;
+   string Refuse;
+};
+
+// Parse as a channel does, FromString would Clear() the resolver.
+void Receive(Core::JSONRPC::Message& message, Resolver& resolver, const string& text)
+{
+   uint16_t offset = 0;
+
+   message.Resolver(&resolver);
+   static_cast<Core::JSON::IElement&>(message).Deserialize(text.c_str(), static_cast<uint16_t>(text.length() + 1), offset);
+
+   EXPECT_EQ(offset, 0);
+}
+
+uint32_t Add(const Point& inbound, Sum& outbound)
+{
+   outbound.Value = inbound.X.Value() + inbound.Y.Value();
+   return (Core::ERROR_NONE);
+}
+
+}
+
+TEST(Core_JSONRPC, directDispatch)
+{
+   Core::JSONRPC::Handler handler([](const uint32_t, const string&, const string&) {}, { 1 });
+   Resolver resolver(handler);
+
+   handler.Register<Point, Sum>(_T("add"), &Add);
+
+   // "method" before "params", the parameters are parsed into a Point on arrival.
+   Core::JSONRPC::Message inbound;
+   Receive(inbound, resolver, _T("{\"jsonrpc\":\"2.0\",\"id\":7,\"method\":\"Test.1.add\",\"params\":{\"x\":2,\"y\":3}}"));
+
+   EXPECT_EQ(resolver.Resolved, 1u);
+   ASSERT_TRUE(inbound.Parameters.Element().IsValid());
+   EXPECT_EQ(inbound.Parameters.Value(), _T("{\"x\":2,\"y\":3}"));
+
+   Core::JSONRPC::Message response;
+   response.JSONRPC = Core::JSONRPC::Message::DefaultVersion;
+   response.Id = inbound.Id.Value();
+
+   EXPECT_EQ(handler.Invoke(Core::JSONRPC::Connection(1, inbound.Id.Value()), inbound.FullMethod(), inbound.Parameters, response.Result), Core::ERROR_NONE);
+   EXPECT_TRUE(response.Result.Element().IsValid());
+
+   string text;
+   response.ToString(text);
+   EXPECT_EQ(text, _T("{\"jsonrpc\":\"2.0\",\"id\":7,\"result\":{\"value\":5}}"));
+}
+
+TEST(Core_JSONRPC, textFallback)
+{
+   Core::JSONRPC::Handler handler([](const uint32_t, const string&, const string&) {}, { 1 });
+   Resolver resolver(handler);
+
+   handler.Register<Point, Sum>(_T("add"), &Add);
+
+   // "params" before "method", the handler still gets its Point, parsed from the text.
+   Core::JSONRPC::Message inbound;
+   Receive(inbound, resolver, _T("{\"jsonrpc\":\"2.0\",\"id\":8,\"params\":{\"x\":4,\"y\":5},\"method\":\"add\"}"));
+
+   EXPECT_EQ(resolver.Resolved, 0u);
+   EXPECT_FALSE(inbound.Parameters.Element().IsValid());
+
+   Core::JSONRPC::Message::Payload result;
+   EXPECT_EQ(handler.Invoke(Core::JSONRPC::Connection(1, inbound.Id.Value()), inbound.FullMethod(), inbound.Parameters, result), Core::ERROR_NONE);
+   EXPECT_EQ(result.Value(), _T("{\"value\":9}"));
+
+   // The text interface keeps working for the same handler.
+   string text;
+   EXPECT_EQ(handler.Invoke(Core::JSONRPC::Connection(1, 9), _T("add"), _T("{\"x\":1,\"y\":1}"), text), Core::ERROR_NONE);
+   EXPECT_EQ(text, _T("{\"value\":2}"));
+}
+
+TEST(Core_JSONRPC, refusedParameters)
+{
+   Core::JSONRPC::Handler handler([](const uint32_t, const string&, const string&) {}, { 1 });
+   Resolver resolver(handler);
+
+   handler.Register<Point, Sum>(_T("add"), &Add);
+   resolver.Refuse = _T("add");
+
+   // A message that is not allowed does not get the handler's parameters, they are kept as text.
+   Core::JSONRPC::Message inbound;
+   Receive(inbound, resolver, _T("{\"jsonrpc\":\"2.0\",\"id\":9,\"method\":\"Test.1.add\",\"params\":{\"x\":1,\"y\":2}}"));
+
+   EXPECT_EQ(resolver.Resolved, 1u);
+   EXPECT_FALSE(inbound.Parameters.Element().IsValid());
+   EXPECT_EQ(inbound.Parameters.Value(), _T("{\"x\":1,\"y\":2}"));
+}
+
+TEST(Core_JSONRPC, sharedNotificationFrame)
+{
+   std::list<std::pair<uint32_t, string>> texts;
+   std::list<std::pair<uint32_t, string>> references;
+   std::list<Core::ProxyType<Core::JSONRPC::Frame>> frames;
+
+   // A message per subscriber, as it is build without frames.
+   std::function<void(const uint32_t, const string&, const string&)> perSubscriber = [&](const uint32_t id, const string& designator, const string& parameters) {
+      Core::JSONRPC::Message message;
+      message.JSONRPC = Core::JSONRPC::Message::DefaultVersion;
+      message.Designator = designator;
+      if (parameters.empty() == false) {
+         message.Parameters = parameters;
+      }
+      string text;
+      message.ToString(text);
+      references.emplace_back(id, text);
+   };
+
+   Core::JSONRPC::Handler reference(perSubscriber, { 1 });
+   Core::JSONRPC::Handler handler(perSubscriber,
+      [&](const uint32_t id, const string& designator, const Core::ProxyType<Core::JSONRPC::Frame>& frame) {
+         Core::ProxyType<Core::JSONRPC::Notification> notification(Core::ProxyType<Core::JSONRPC::Notification>::Create());
+         notification->Set(frame, designator);
+         string text;
+         notification->ToString(text);
+         EXPECT_EQ(notification->Length(), text.length());
+         texts.emplace_back(id, text);
+         frames.push_back(frame);
+      },
+      { 1 });
+   Core::JSONRPC::Message response;
+
+   handler.Subscribe(1, _T("statechange"), _T("client.events.1"), response);
+   handler.Subscribe(2, _T("statechange"), _T("other"), response);
+   handler.Subscribe(3, _T("statechange"), _T(""), response);
+   reference.Subscribe(1, _T("statechange"), _T("client.events.1"), response);
+   reference.Subscribe(2, _T("statechange"), _T("other"), response);
+   reference.Subscribe(3, _T("statechange"), _T(""), response);
+
+   Point point;
+   point.X = 1;
+   point.Y = -2;
+   EXPECT_EQ(handler.Notify(_T("statechange"), point), Core::ERROR_NONE);
+   EXPECT_EQ(handler.Notify(_T("unknown"), point), Core::ERROR_UNKNOWN_KEY);
+   EXPECT_EQ(reference.Notify(_T("statechange"), point), Core::ERROR_NONE);
+
+   // One serialization, shared by all subscribers, with the same outcome.
+   ASSERT_EQ(frames.size(), 3u);
+   EXPECT_EQ(&(*frames.front()), &(*frames.back()));
+   EXPECT_EQ(texts, references);
+   EXPECT_EQ(texts.front().second, _T("{\"jsonrpc\":\"2.0\",\"method\":\"client.events.1.statechange\",\"params\":{\"x\":1,\"y\":-2}}"));
+
+   // Small chunks, as a socket would ask for them.
+   Core::ProxyType<Core::JSONRPC::Notification> notification(Core::ProxyType<Core::JSONRPC::Notification>::Create());
+   notification->Set(frames.front(), _T("other"));
+   string chunked;
+   char buffer[5];
+   uint16_t offset = 0;
+   uint16_t loaded;
+   do {
+      loaded = static_cast<const Core::JSON::IElement&>(*notification).Serialize(buffer, sizeof(buffer), offset);
+      chunked += string(buffer, loaded);
+   } while ((offset != 0) && (loaded == sizeof(buffer)));
+   EXPECT_EQ(chunked, std::next(texts.begin())->second);
+
+   // Without parameters there is no "params".
+   texts.clear();
+   references.clear();
+   EXPECT_EQ(handler.Notify(_T("statechange")), Core::ERROR_NONE);
+   EXPECT_EQ(reference.Notify(_T("statechange")), Core::ERROR_NONE);
+   EXPECT_EQ(texts, references);
+   EXPECT_EQ(texts.back().second, _T("{\"jsonrpc\":\"2.0\",\"method\":\"statechange\"}"));
+}
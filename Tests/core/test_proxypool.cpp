@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace WPEFramework;
+
+namespace {
+
+   class Item {
+   public:
+      Item(const Item&) = delete;
+      Item& operator=(const Item&) = delete;
+
+      Item()
+         : _owner(0)
+         , _value(0)
+      {
+      }
+      ~Item() = default;
+
+   public:
+      // Claims it for the calling thread, it fails if some other thread has it as well.
+      bool Take(const uint32_t owner)
+      {
+         uint32_t expected = 0;
+         return (_owner.compare_exchange_strong(expected, owner) == true);
+      }
+      bool Give(const uint32_t owner)
+      {
+         uint32_t expected = owner;
+         return (_owner.compare_exchange_strong(expected, 0) == true);
+      }
+      uint32_t Value() const
+      {
+         return (_value);
+      }
+      void Value(const uint32_t value)
+      {
+         _value = value;
+      }
+
+      // Called by the pool when it is returned.
+      void Clear()
+      {
+         _value = 0;
+      }
+
+   private:
+      std::atomic<uint32_t> _owner;
+      uint32_t _value;
+   };
+
+   typedef Core::ProxyPoolType<Item> Pool;
+
+   const Core::IProxyPool* Registered(const Pool& pool)
+   {
+      const Core::IProxyPool* result = nullptr;
+
+      Core::ProxyPoolAdministrator::Instance().Visit([&](const Core::IProxyPool& entry) {
+         if (&entry == &pool) {
+            result = &entry;
+         }
+      });
+
+      return (result);
+   }
+}
+
+TEST(Core_ProxyPool, reuse)
+{
+   Pool pool(4);
+
+   EXPECT_EQ(Registered(pool), &pool);
+
+   Core::ProxyType<Item> first(pool.Element());
+   Item* address = &(*first);
+   first->Value(42);
+   first.Release();
+
+   EXPECT_EQ(pool.QueuedElements(), 1u);
+   EXPECT_EQ(pool.InUse(), 0u);
+
+   // The idle one is handed out again, cleared.
+   Core::ProxyType<Item> second(pool.Element());
+   EXPECT_EQ(&(*second), address);
+   EXPECT_EQ(second->Value(), 0u);
+   EXPECT_EQ(pool.QueuedElements(), 0u);
+
+   EXPECT_EQ(pool.Misses(), 1u);
+   EXPECT_EQ(pool.Hits(), 1u);
+   EXPECT_EQ(pool.CreatedElements(), 1u);
+}
+
+TEST(Core_ProxyPool, trim)
+{
+   Pool pool(16);
+   std::vector<Core::ProxyType<Item>> items;
+
+   for (uint32_t index = 0; index < 10; index++) {
+      items.push_back(pool.Element());
+   }
+   EXPECT_EQ(pool.InUse(), 10u);
+   EXPECT_EQ(pool.HighWater(), 10u);
+   items.clear();
+   EXPECT_EQ(pool.QueuedElements(), 10u);
+
+   // Before now the pool ran empty, so none of them was surplus.
+   EXPECT_EQ(pool.Trim(), 0u);
+   EXPECT_EQ(pool.QueuedElements(), 10u);
+
+   // Never fewer than 6 idle, those were not needed.
+   for (uint32_t index = 0; index < 4; index++) {
+      items.push_back(pool.Element());
+   }
+   items.clear();
+   EXPECT_EQ(pool.Trim(), 6u);
+   EXPECT_EQ(pool.QueuedElements(), 4u);
+
+   // Not used at all since, so all of them go.
+   EXPECT_EQ(pool.Trim(), 4u);
+   EXPECT_EQ(pool.QueuedElements(), 0u);
+   EXPECT_EQ(pool.Trimmed(), 10u);
+
+   EXPECT_EQ(pool.Hits(), 4u);
+   EXPECT_EQ(pool.Misses(), 10u);
+   EXPECT_EQ(pool.HighWater(), 10u);
+}
+
+TEST(Core_ProxyPool, limit)
+{
+   Pool pool(8, 8);
+   std::vector<Core::ProxyType<Item>> items;
+
+   for (uint32_t index = 0; index < 12; index++) {
+      items.push_back(pool.Element());
+   }
+   items.clear();
+
+   // No more idle elements than it was created for, the rest is deleted when returned.
+   EXPECT_EQ(pool.QueuedElements(), 8u);
+   EXPECT_EQ(pool.Trimmed(), 4u);
+
+   // Lowering the limit deletes idle elements right away.
+   pool.Limit(3);
+   EXPECT_EQ(pool.Limit(), 3u);
+   EXPECT_EQ(pool.QueuedElements(), 3u);
+   EXPECT_EQ(pool.Trimmed(), 9u);
+
+   // It can never be raised beyond what it was created for.
+   pool.Limit(100);
+   EXPECT_EQ(pool.Limit(), 8u);
+}
+
+TEST(Core_ProxyPool, threads)
+{
+   const uint32_t threads = 4;
+   const uint32_t rounds = 20000;
+   const uint32_t held = 4;
+
+   Pool pool(8, 8);
+   std::atomic<uint32_t> conflicts(0);
+   std::atomic<uint32_t> dirty(0);
+   std::vector<std::thread> workers;
+
+   // More held at the same time than the pool keeps, so elements are created, parked and deleted
+   // by all threads at once.
+   for (uint32_t thread = 1; thread <= threads; thread++) {
+      workers.emplace_back([&, thread]() {
+         std::vector<Core::ProxyType<Item>> items;
+
+         for (uint32_t round = 0; round < rounds; round++) {
+            const uint32_t count = 1 + ((round + thread) % held);
+
+            for (uint32_t index = 0; index < count; index++) {
+               Core::ProxyType<Item> item(pool.Element());
+
+               if (item->Take(thread) == false) {
+                  conflicts++;
+               }
+               if (item->Value() != 0) {
+                  dirty++;
+               }
+               item->Value(thread);
+               items.push_back(item);
+            }
+            for (Core::ProxyType<Item>& item : items) {
+               if ((item->Value() != thread) || (item->Give(thread) == false)) {
+                  conflicts++;
+               }
+            }
+            items.clear();
+
+            if ((round % 1000) == 0) {
+               pool.Trim();
+            }
+         }
+      });
+   }
+   for (std::thread& worker : workers) {
+      worker.join();
+   }
+
+   // Never handed out twice at the same time, and always cleared on return.
+   EXPECT_EQ(conflicts.load(), 0u);
+   EXPECT_EQ(dirty.load(), 0u);
+
+   uint32_t requests = 0;
+   for (uint32_t thread = 1; thread <= threads; thread++) {
+      for (uint32_t round = 0; round < rounds; round++) {
+         requests += 1 + ((round + thread) % held);
+      }
+   }
+
+   EXPECT_EQ(pool.InUse(), 0u);
+   EXPECT_EQ(pool.Hits() + pool.Misses(), requests);
+   EXPECT_EQ(pool.CreatedElements(), pool.Misses());
+   EXPECT_LE(pool.HighWater(), threads * held);
+   EXPECT_LE(pool.QueuedElements(), pool.Limit());
+
+   // All that was created is either parked or deleted.
+   EXPECT_EQ(pool.CreatedElements(), pool.QueuedElements() + pool.Trimmed());
+}
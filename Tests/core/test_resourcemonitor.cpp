@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+
+#include <atomic>
+#include <memory>
+
+using namespace WPEFramework;
+
+namespace {
+
+   typedef Core::ResourceMonitorType<Core::IResource> Monitor;
+
+   // The read end of a pipe. It can register other pipes from within the monitor, the way a socket
+   // registers an accepted connection from its Opened() (reported from Events()) or Handle().
+   class Pipe : public Core::IResource {
+   public:
+      Pipe() = delete;
+      Pipe(const Pipe&) = delete;
+      Pipe& operator=(const Pipe&) = delete;
+
+      Pipe(Monitor& monitor, std::atomic<uint32_t>& handled)
+         : _monitor(monitor)
+         , _handled(handled)
+         , _opened(nullptr)
+         , _handle(nullptr)
+      {
+         int descriptors[2];
+         EXPECT_EQ(::pipe(descriptors), 0);
+         _read = descriptors[0];
+         _write = descriptors[1];
+      }
+      ~Pipe() override
+      {
+         ::close(_read);
+         ::close(_write);
+      }
+
+   public:
+      // Registered on the first Events(), or the first Handle(), respectively.
+      void OnOpened(std::vector<std::unique_ptr<Pipe>>& pipes)
+      {
+         _opened = &pipes;
+      }
+      void OnHandle(std::vector<std::unique_ptr<Pipe>>& pipes)
+      {
+         _handle = &pipes;
+      }
+      void Signal()
+      {
+         const uint8_t data = 0x55;
+         EXPECT_EQ(::write(_write, &data, 1), 1);
+      }
+
+      handle Descriptor() const override
+      {
+         return (_read);
+      }
+      uint16_t Events() override
+      {
+         if (_opened != nullptr) {
+            Register(*_opened);
+            _opened = nullptr;
+         }
+         return (POLLIN);
+      }
+      void Handle(const uint16_t events) override
+      {
+         if ((events & POLLIN) != 0) {
+            uint8_t data;
+
+            if (::read(_read, &data, 1) == 1) {
+               _handled++;
+            }
+         }
+         if (_handle != nullptr) {
+            Register(*_handle);
+            _handle = nullptr;
+         }
+      }
+
+   private:
+      void Register(std::vector<std::unique_ptr<Pipe>>& pipes)
+      {
+         for (std::unique_ptr<Pipe>& pipe : pipes) {
+            _monitor.Register(*pipe);
+         }
+      }
+
+   private:
+      Monitor& _monitor;
+      std::atomic<uint32_t>& _handled;
+      std::vector<std::unique_ptr<Pipe>>* _opened;
+      std::vector<std::unique_ptr<Pipe>>* _handle;
+      int _read;
+      int _write;
+   };
+
+   void Create(Monitor& monitor, std::atomic<uint32_t>& handled, std::vector<std::unique_ptr<Pipe>>& pipes, const uint32_t count)
+   {
+      for (uint32_t index = 0; index < count; index++) {
+         pipes.emplace_back(new Pipe(monitor, handled));
+      }
+   }
+
+   bool WaitFor(const std::atomic<uint32_t>& value, const uint32_t expected)
+   {
+      uint32_t waited = 0;
+
+      while ((value.load() < expected) && (waited < 5000)) {
+         SleepMs(10);
+         waited += 10;
+      }
+
+      return (value.load() == expected);
+   }
+
+   // Unregistered resources might only be dropped by the monitor thread.
+   bool Drained(const Monitor& monitor)
+   {
+      uint32_t waited = 0;
+
+      while ((monitor.Count() != 0) && (waited < 5000)) {
+         SleepMs(10);
+         waited += 10;
+      }
+
+      return (monitor.Count() == 0);
+   }
+}
+
+TEST(Core_ResourceMonitor, handle)
+{
+   std::atomic<uint32_t> handled(0);
+   std::vector<std::unique_ptr<Pipe>> pipes;
+   Monitor monitor;
+
+   Create(monitor, handled, pipes, 8);
+
+   for (std::unique_ptr<Pipe>& pipe : pipes) {
+      monitor.Register(*pipe);
+   }
+   EXPECT_EQ(monitor.Count(), 8u);
+
+   for (uint8_t round = 1; round <= 3; round++) {
+      for (std::unique_ptr<Pipe>& pipe : pipes) {
+         pipe->Signal();
+      }
+      EXPECT_TRUE(WaitFor(handled, round * 8u));
+   }
+
+   for (std::unique_ptr<Pipe>& pipe : pipes) {
+      monitor.Unregister(*pipe);
+   }
+   EXPECT_TRUE(Drained(monitor));
+}
+
+TEST(Core_ResourceMonitor, registerFromEvents)
+{
+   std::atomic<uint32_t> handled(0);
+   std::vector<std::unique_ptr<Pipe>> listeners;
+   std::vector<std::unique_ptr<Pipe>> accepted;
+   Monitor monitor;
+
+   Create(monitor, handled, listeners, 1);
+   Create(monitor, handled, accepted, 200);
+
+   // Enough registrations, while the monitor evaluates the first one, to move the administration.
+   listeners[0]->OnOpened(accepted);
+   monitor.Register(*listeners[0]);
+   listeners[0]->Signal();
+
+   EXPECT_TRUE(WaitFor(handled, 1));
+
+   for (std::unique_ptr<Pipe>& pipe : accepted) {
+      pipe->Signal();
+   }
+   EXPECT_TRUE(WaitFor(handled, 201));
+   EXPECT_EQ(monitor.Count(), 201u);
+
+   for (std::unique_ptr<Pipe>& pipe : accepted) {
+      monitor.Unregister(*pipe);
+   }
+   monitor.Unregister(*listeners[0]);
+   EXPECT_TRUE(Drained(monitor));
+}
+
+TEST(Core_ResourceMonitor, registerFromHandle)
+{
+   std::atomic<uint32_t> handled(0);
+   std::vector<std::unique_ptr<Pipe>> listeners;
+   std::vector<std::unique_ptr<Pipe>> accepted;
+   Monitor monitor;
+
+   Create(monitor, handled, listeners, 4);
+   Create(monitor, handled, accepted, 200);
+
+   // One of them registers the others while it is handled, the rest of the batch still has to be
+   // dispatched after that.
+   listeners[0]->OnHandle(accepted);
+   for (std::unique_ptr<Pipe>& listener : listeners) {
+      monitor.Register(*listener);
+   }
+   SleepMs(50);
+   for (std::unique_ptr<Pipe>& listener : listeners) {
+      listener->Signal();
+   }
+
+   EXPECT_TRUE(WaitFor(handled, 4));
+
+   for (std::unique_ptr<Pipe>& pipe : accepted) {
+      pipe->Signal();
+   }
+   EXPECT_TRUE(WaitFor(handled, 204));
+   EXPECT_EQ(monitor.Count(), 204u);
+
+   for (std::unique_ptr<Pipe>& pipe : accepted) {
+      monitor.Unregister(*pipe);
+   }
+   for (std::unique_ptr<Pipe>& listener : listeners) {
+      monitor.Unregister(*listener);
+   }
+   EXPECT_TRUE(Drained(monitor));
+}
@@ -6,6 +6,9 @@
 #include <com/com.h>
 #include <core/Portability.h>
 
+#include <chrono>
+#include <thread>
+
 string g_connectorName = _T("/tmp/wperpc01");
 
 namespace WPEFramework {
@@ -32,12 +35,18 @@ public:
 
     uint32_t GetValue()
     {
-        return m_value;
+        m_lock.Lock();
+        uint32_t result = m_value;
+        m_lock.Unlock();
+
+        return result;
     }
 
     void Add(uint32_t value)
     {
+        m_lock.Lock();
         m_value += value;
+        m_lock.Unlock();
     }
 
     pid_t GetPid()
@@ -50,6 +59,7 @@ public:
     END_INTERFACE_MAP
 
 private:
+    Core::CriticalSection m_lock;
     uint32_t m_value;
 };
 
@@ -84,11 +94,11 @@ namespace WPEFramework {
           },
     };
 
-    typedef ProxyStub::StubType<Exchange::IAdder, AdderStubMethods, ProxyStub::UnknownStub> AdderStub;
+    typedef ProxyStub::UnknownStubType<Exchange::IAdder, AdderStubMethods> AdderStub;
 
     class AdderProxy : public ProxyStub::UnknownProxyType<Exchange::IAdder> {
     public:
-        AdderProxy(Core::ProxyType<Core::IPCChannel>& channel, void* implementation,
+        AdderProxy(const Core::ProxyType<Core::IPCChannel>& channel, void* implementation,
             const bool otherSideInformed)
             : BaseClass(channel, implementation, otherSideInformed)
         {
@@ -155,7 +165,7 @@ private:
 
 public:
     ExternalAccess(const Core::NodeId & source)
-        : RPC::Communicator(source, Core::ProxyType< RPC::InvokeServerType<4, 1> >::Create(), _T(""))
+        : RPC::Communicator(source, Core::ProxyType< RPC::InvokeServerType<32, 4> >::Create(), _T(""))
     {
         Open(Core::infinite);
     }
@@ -218,6 +228,34 @@ TEST(Core_RPC, adder)
       // Make sure other side is indeed running in other process.
       EXPECT_NE(adder->GetPid(), getpid());
 
+      // Calls from different threads are multiplexed over the same channel. Check that
+      // every call gets its own response and report the throughput per thread count.
+      const uint32_t callsPerThread = 2000;
+      uint32_t expected = 42;
+
+      for (uint32_t threads = 1; threads <= 8; threads <<= 1) {
+         std::vector<std::thread> callers;
+         std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+         for (uint32_t index = 0; index < threads; index++) {
+            callers.emplace_back([adder, callsPerThread]() {
+               for (uint32_t call = 0; call < callsPerThread; call++) {
+                  adder->Add(1);
+               }
+            });
+         }
+         for (std::thread& caller : callers) {
+            caller.join();
+         }
+
+         std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+         expected += (threads * callsPerThread);
+
+         printf("COM-RPC: %2d thread(s), %8.0f calls/s\n", threads, (threads * callsPerThread) / elapsed.count());
+
+         EXPECT_EQ(adder->GetValue(), expected);
+      }
+
       adder->Release();
 
       client->Close(Core::infinite);
@@ -0,0 +1,415 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <broadcast/broadcast.h>
+#include <broadcast/TunerAdministrator.h>
+
+#include "Benchmark.h"
+#include "SectionBuilder.h"
+
+using namespace WPEFramework;
+
+namespace {
+
+   const uint32_t Base = 20744 * 86400; // 2026-10-18 00:00 UTC
+   const uint32_t Day = 86400;
+   const uint32_t Segment = 3 * 3600;
+   const uint16_t Channels = 500;
+   const uint8_t Days = 7;
+
+   struct Programme {
+      uint16_t EventId;
+      uint32_t Start;
+      uint32_t Duration;
+      string Title;
+      string Text;
+   };
+
+   // A stand in for a tuner locked on a transport stream, it only hands out the section filters.
+   class Tuner : public Broadcast::ITuner {
+   public:
+      Tuner()
+         : _filters()
+      {
+         ::memset(_filters, 0, sizeof(_filters));
+      }
+      ~Tuner() override
+      {
+      }
+
+   public:
+      uint32_t Properties() const override
+      {
+         return (Broadcast::ITuner::DVB | Broadcast::ITuner::Cable);
+      }
+      uint16_t Id() const override
+      {
+         return (1);
+      }
+      state State() const override
+      {
+         return (Broadcast::ITuner::LOCKED);
+      }
+      uint32_t Tune(const uint16_t, const Broadcast::Modulation, const uint32_t, const uint16_t, const Broadcast::SpectralInversion) override
+      {
+         return (Core::ERROR_NONE);
+      }
+      uint32_t Prepare(const uint16_t) override
+      {
+         return (Core::ERROR_NONE);
+      }
+      uint32_t Filter(const uint16_t pid, const uint8_t tableId, Broadcast::ISection* callback) override
+      {
+         EXPECT_EQ(pid, 0x12);
+         _filters[tableId] = callback;
+         return (Core::ERROR_NONE);
+      }
+      uint32_t Attach(const uint8_t) override
+      {
+         return (Core::ERROR_NONE);
+      }
+      uint32_t Detach(const uint8_t) override
+      {
+         return (Core::ERROR_NONE);
+      }
+
+      void Send(const std::vector<uint8_t>& section)
+      {
+         ASSERT_NE(_filters[section[0]], nullptr);
+         _filters[section[0]]->Handle(Broadcast::MPEG::Section(Core::DataElement(section.size(), const_cast<uint8_t*>(section.data()))));
+      }
+
+   private:
+      Broadcast::ISection* _filters[256];
+   };
+
+   void BCD(std::vector<uint8_t>& buffer, const uint32_t seconds)
+   {
+      const uint8_t parts[] = { static_cast<uint8_t>(seconds / 3600), static_cast<uint8_t>((seconds / 60) % 60), static_cast<uint8_t>(seconds % 60) };
+
+      for (uint8_t part : parts) {
+         buffer.push_back(static_cast<uint8_t>(((part / 10) << 4) | (part % 10)));
+      }
+   }
+
+   // One EIT schedule section, the events of one 3 hour segment of a service.
+   std::vector<uint8_t> MakeEIT(const uint16_t serviceId, const uint8_t version, const uint32_t segment, const std::vector<Programme>& events)
+   {
+      const uint8_t tableId = Broadcast::DVB::EIT::SCHEDULE_ACTUAL + static_cast<uint8_t>(segment / 32);
+      const uint8_t number = static_cast<uint8_t>((segment % 32) * 8);
+      std::vector<uint8_t> section = { tableId, 0xF0, 0x00, static_cast<uint8_t>(serviceId >> 8), static_cast<uint8_t>(serviceId),
+         static_cast<uint8_t>(0xC1 | ((version & 0x1F) << 1)), number, 0xF8,
+         0x00, 0x01, 0x00, 0x02, number, static_cast<uint8_t>(Broadcast::DVB::EIT::SCHEDULE_ACTUAL + 1) };
+
+      for (const Programme& event : events) {
+         const uint16_t MJD = static_cast<uint16_t>((event.Start / Day) + 40587);
+         const uint8_t descriptor = static_cast<uint8_t>(3 + 1 + event.Title.length() + 1 + event.Text.length());
+
+         section.push_back(static_cast<uint8_t>(event.EventId >> 8));
+         section.push_back(static_cast<uint8_t>(event.EventId));
+         section.push_back(static_cast<uint8_t>(MJD >> 8));
+         section.push_back(static_cast<uint8_t>(MJD));
+         BCD(section, event.Start % Day);
+         BCD(section, event.Duration);
+         section.push_back(0x40 | ((descriptor + 2) >> 8));
+         section.push_back(static_cast<uint8_t>(descriptor + 2));
+         section.insert(section.end(), { Broadcast::DVB::Descriptors::ShortEvent::TAG, descriptor, 'e', 'n', 'g' });
+         section.push_back(static_cast<uint8_t>(event.Title.length()));
+         section.insert(section.end(), event.Title.begin(), event.Title.end());
+         section.push_back(static_cast<uint8_t>(event.Text.length()));
+         section.insert(section.end(), event.Text.begin(), event.Text.end());
+      }
+
+      SealSection(section);
+
+      return (section);
+   }
+
+   // A week of programmes, a title comes back every few days, the description a bit less often.
+   std::vector<Programme> MakeSchedule(const uint16_t serviceId)
+   {
+      static const uint32_t durations[] = { 30, 60, 45, 90, 15, 120, 25, 50 };
+      std::vector<Programme> schedule;
+      uint32_t start = Base;
+      uint16_t eventId = 1;
+
+      while (start < (Base + (Days * Day))) {
+         const uint32_t duration = durations[(serviceId + eventId) % (sizeof(durations) / sizeof(durations[0]))] * 60;
+         const uint32_t programme = ((serviceId * 7) + eventId) % 2000;
+
+         schedule.push_back({ eventId, start, duration,
+            "Programme " + std::to_string(programme),
+            "Episode " + std::to_string(eventId % 12) + " of the series about topic " + std::to_string(programme) + ", in which things happen." });
+
+         start += duration;
+         eventId++;
+      }
+
+      return (schedule);
+   }
+
+   std::vector<std::vector<uint8_t>> MakeSections(const uint16_t serviceId, const uint8_t version, const std::vector<Programme>& schedule)
+   {
+      std::vector<std::vector<uint8_t>> sections;
+      std::vector<Programme> events;
+      uint32_t segment = 0;
+
+      for (const Programme& event : schedule) {
+         if (((event.Start - Base) / Segment) != segment) {
+            sections.push_back(MakeEIT(serviceId, version, segment, events));
+            events.clear();
+            segment = (event.Start - Base) / Segment;
+         }
+         events.push_back(event);
+      }
+      sections.push_back(MakeEIT(serviceId, version, segment, events));
+
+      return (sections);
+   }
+
+   void Compare(const std::list<Broadcast::Schedules::Event>& events, const std::vector<Programme>& schedule, const uint32_t start, const uint32_t end)
+   {
+      std::list<Broadcast::Schedules::Event>::const_iterator index(events.begin());
+
+      for (const Programme& programme : schedule) {
+         if ((programme.Start < end) && ((programme.Start + programme.Duration) > start)) {
+            ASSERT_NE(index, events.end());
+            EXPECT_EQ(index->EventId(), programme.EventId);
+            EXPECT_EQ(index->Start(), programme.Start);
+            EXPECT_EQ(index->Duration(), programme.Duration);
+            EXPECT_EQ(index->Title(), programme.Title);
+            EXPECT_EQ(index->Text(), programme.Text);
+            EXPECT_EQ(index->Language(), _T("eng"));
+            EXPECT_EQ(index->RunningMode(), Broadcast::DVB::EIT::AboutToStart);
+            index++;
+         }
+      }
+      EXPECT_EQ(index, events.end());
+   }
+}
+
+TEST(Broadcast_EIT, malformedEvents)
+{
+   const uint16_t MJD = static_cast<uint16_t>((Base / Day) + 40587);
+   const uint8_t shortEvent = Broadcast::DVB::Descriptors::ShortEvent::TAG;
+   std::vector<uint8_t> payload = { 0x00, 0x01, 0x00, 0x02, 0x00, Broadcast::DVB::EIT::SCHEDULE_ACTUAL };
+
+   // Without descriptors, with a short event descriptor, and one cut short: it claims more
+   // descriptors than the section holds.
+   const uint8_t events[][12] = {
+      { 0x00, 0x01, static_cast<uint8_t>(MJD >> 8), static_cast<uint8_t>(MJD), 0x20, 0x00, 0x00, 0x00, 0x30, 0x00, 0x80, 0x00 },
+      { 0x00, 0x02, static_cast<uint8_t>(MJD >> 8), static_cast<uint8_t>(MJD), 0x20, 0x30, 0x00, 0x01, 0x00, 0x00, 0x80, 0x0B },
+      { 0x00, 0x03, static_cast<uint8_t>(MJD >> 8), static_cast<uint8_t>(MJD), 0x21, 0x30, 0x00, 0x01, 0x00, 0x00, 0x80, 0x28 }
+   };
+   payload.insert(payload.end(), events[0], events[0] + 12);
+   payload.insert(payload.end(), events[1], events[1] + 12);
+   payload.insert(payload.end(), { Broadcast::DVB::Descriptors::ShortEvent::TAG, 9, 'e', 'n', 'g', 4, 'N', 'e', 'w', 's', 0 });
+   payload.insert(payload.end(), events[2], events[2] + 12);
+   payload.insert(payload.end(), { Broadcast::DVB::Descriptors::ShortEvent::TAG, 9, 'e', 'n', 'g' });
+
+   const std::vector<uint8_t> section(MakeSection(Broadcast::DVB::EIT::SCHEDULE_ACTUAL, 10, 1, 0, 0, payload));
+   const Broadcast::DVB::EIT table(Broadcast::MPEG::Section(Core::DataElement(section.size(), const_cast<uint8_t*>(section.data()))));
+   ASSERT_TRUE(table.IsValid());
+
+   Broadcast::DVB::EIT::EventIterator index(table.Events());
+   EXPECT_EQ(index.Events(), 2u);
+
+   ASSERT_TRUE(index.Next());
+   EXPECT_EQ(index.EventId(), 1u);
+   EXPECT_EQ(index.StartTime(), Base + (20 * 3600));
+   EXPECT_EQ(index.Duration(), 30u * 60);
+
+   // Nothing to iterate, not the rest of the section.
+   Broadcast::MPEG::DescriptorIterator descriptors(index.Descriptors());
+   EXPECT_FALSE(descriptors.Next());
+   EXPECT_FALSE(index.Descriptors().Tag(Broadcast::DVB::Descriptors::ShortEvent::TAG));
+
+   ASSERT_TRUE(index.Next());
+   EXPECT_EQ(index.EventId(), 2u);
+   descriptors = index.Descriptors();
+   ASSERT_TRUE(descriptors.Next());
+   EXPECT_EQ(descriptors.Current().Tag(), shortEvent);
+   EXPECT_FALSE(descriptors.Next());
+
+   // Its header is there, its descriptors are not.
+   EXPECT_FALSE(index.Next());
+   EXPECT_FALSE(index.IsValid());
+}
+
+TEST(Broadcast_Schedules, store)
+{
+   Broadcast::Schedules epg;
+   Tuner tuner;
+   Broadcast::TunerAdministrator::Instance().Announce(&tuner)->StateChange(&tuner);
+
+   std::vector<std::vector<Programme>> schedules;
+   std::vector<std::vector<uint8_t>> sections;
+   uint32_t total = 0;
+
+   for (uint16_t service = 1; service <= Channels; service++) {
+      schedules.push_back(MakeSchedule(service));
+      std::vector<std::vector<uint8_t>> serviceSections(MakeSections(service, 1, schedules.back()));
+      sections.insert(sections.end(), serviceSections.begin(), serviceSections.end());
+      total += static_cast<uint32_t>(schedules.back().size());
+   }
+
+   // The broadcaster carousels it, the second round brings nothing new.
+   for (uint8_t round = 0; round < 2; round++) {
+      for (const std::vector<uint8_t>& section : sections) {
+         tuner.Send(section);
+      }
+   }
+
+   EXPECT_EQ(epg.Events(), total);
+
+   std::list<Broadcast::Schedules::Event> events;
+   EXPECT_EQ(epg.Window(9, 9, 42, Base + Day + 3600, Base + Day + (5 * 3600), events), 0u);
+   EXPECT_GT(epg.Window(2, 1, 42, Base + Day + 3600, Base + Day + (5 * 3600), events), 0u);
+   Compare(events, schedules[41], Base + Day + 3600, Base + Day + (5 * 3600));
+
+   Broadcast::Schedules::Current current;
+   const uint32_t now = Base + (3 * Day) + 1234;
+   EXPECT_FALSE(epg.NowNext(2, 1, Channels + 1, now, current));
+   ASSERT_TRUE(epg.NowNext(2, 1, 7, now, current));
+   ASSERT_TRUE(current.Now.IsValid());
+   ASSERT_TRUE(current.Next.IsValid());
+   EXPECT_LE(current.Now.Start(), now);
+   EXPECT_GT(current.Now.End(), now);
+   EXPECT_EQ(current.Next.Start(), current.Now.End());
+   EXPECT_EQ(current.Now.ServiceId(), 7);
+
+   std::list<Broadcast::Schedules::Current> all;
+   EXPECT_EQ(epg.NowNext(now, all), Channels);
+
+   // After the week, nothing is on.
+   EXPECT_TRUE(epg.NowNext(2, 1, 7, Base + (Days * Day) + Day, current));
+   EXPECT_FALSE(current.Now.IsValid());
+   EXPECT_FALSE(current.Next.IsValid());
+
+   // A new version of a segment: a different title, and the first two events merged into one.
+   std::vector<Programme>& schedule(schedules[9]);
+   const uint32_t segment = 8 + 1;
+   std::vector<Programme> update;
+   for (Programme& programme : schedule) {
+      if (((programme.Start - Base) / Segment) == segment) {
+         update.push_back(programme);
+      }
+   }
+   ASSERT_GE(update.size(), 3u);
+   update[0].Title = _T("Breaking news");
+   update[0].Duration += update[1].Duration;
+   update[0].EventId = 9999;
+   update.erase(update.begin() + 1);
+
+   tuner.Send(MakeEIT(10, 2, segment, update));
+   EXPECT_EQ(epg.Events(), total - 1);
+
+   events.clear();
+   EXPECT_EQ(epg.Window(2, 1, 10, update[0].Start, update[0].Start + 1, events), 1u);
+   EXPECT_EQ(events.front().Title(), _T("Breaking news"));
+   EXPECT_EQ(events.front().EventId(), 9999);
+
+   // The past is dropped, with the strings only it used.
+   const uint32_t footprint = epg.Footprint();
+   epg.Expire(Base + (3 * Day));
+   EXPECT_LT(epg.Events(), total - 1);
+   EXPECT_LT(epg.Footprint(), footprint);
+   events.clear();
+   EXPECT_EQ(epg.Window(2, 1, 42, Base, Base + (2 * Day), events), 0u);
+   EXPECT_GT(epg.Window(2, 1, 42, Base + (3 * Day), Base + (4 * Day), events), 0u);
+   Compare(events, schedules[41], Base + (3 * Day), Base + (4 * Day));
+
+   Broadcast::TunerAdministrator::Instance().Revoke(&tuner);
+}
+
+TEST(Broadcast_Schedules, persistence)
+{
+   Broadcast::Schedules epg;
+   Tuner tuner;
+   Broadcast::TunerAdministrator::Instance().Announce(&tuner)->StateChange(&tuner);
+
+   std::vector<std::vector<Programme>> schedules;
+   for (uint16_t service = 1; service <= 20; service++) {
+      schedules.push_back(MakeSchedule(service));
+      for (const std::vector<uint8_t>& section : MakeSections(service, 1, schedules.back())) {
+         tuner.Send(section);
+      }
+   }
+   Broadcast::TunerAdministrator::Instance().Revoke(&tuner);
+
+   const string fileName(_T("/tmp/test_schedules.epg"));
+   EXPECT_EQ(epg.Save(fileName), Core::ERROR_NONE);
+
+   Broadcast::Schedules restored;
+   EXPECT_EQ(restored.Restore(fileName + _T(".missing")), Core::ERROR_OPENING_FAILED);
+   EXPECT_EQ(restored.Restore(fileName), Core::ERROR_NONE);
+   EXPECT_EQ(restored.Events(), epg.Events());
+
+   for (uint16_t service = 1; service <= 20; service++) {
+      std::list<Broadcast::Schedules::Event> events;
+      EXPECT_GT(restored.Window(2, 1, service, Base + Day, Base + (2 * Day), events), 0u);
+      Compare(events, schedules[service - 1], Base + Day, Base + (2 * Day));
+   }
+
+   // Garbage is not taken in, what was there stays.
+   Core::File file(fileName);
+   ASSERT_TRUE(file.Open(false));
+   EXPECT_EQ(file.Write(reinterpret_cast<const uint8_t*>("garbage"), 7), 7u);
+   file.Close();
+   EXPECT_EQ(restored.Restore(fileName), Core::ERROR_READ_ERROR);
+   EXPECT_EQ(restored.Events(), epg.Events());
+
+   file.Destroy();
+}
+
+TEST(Broadcast_Schedules, DISABLED_throughput)
+{
+   Broadcast::Schedules epg;
+   Tuner tuner;
+   Broadcast::TunerAdministrator::Instance().Announce(&tuner)->StateChange(&tuner);
+
+   std::vector<std::vector<uint8_t>> sections;
+   uint32_t strings = 0;
+   for (uint16_t service = 1; service <= Channels; service++) {
+      const std::vector<Programme> schedule(MakeSchedule(service));
+      for (const Programme& programme : schedule) {
+         strings += static_cast<uint32_t>(programme.Title.length() + programme.Text.length() + 2);
+      }
+      std::vector<std::vector<uint8_t>> serviceSections(MakeSections(service, 1, schedule));
+      sections.insert(sections.end(), serviceSections.begin(), serviceSections.end());
+   }
+
+   Report("Schedules acquisition", sections.size() / Measure([&]() {
+      for (const std::vector<uint8_t>& section : sections) {
+         tuner.Send(section);
+      }
+   }), "sections/s");
+   Broadcast::TunerAdministrator::Instance().Revoke(&tuner);
+
+   Report("Schedules events", epg.Events(), "events");
+   Report("Schedules footprint", epg.Footprint() / 1024.0, "KB");
+   Report("Schedules strings, as received", strings / 1024.0, "KB");
+
+   // What the EPG grid asks for: 3 hours of a service, and now/next for all of them.
+   const uint32_t queries = 100000;
+   uint32_t found = 0;
+   Report("Schedules window of 3 hours", queries / Measure([&]() {
+      for (uint32_t index = 0; index < queries; index++) {
+         std::list<Broadcast::Schedules::Event> events;
+         const uint32_t time = Base + ((index * 7919) % ((Days * Day) - Segment));
+         found += epg.Window(2, 1, static_cast<uint16_t>((index % Channels) + 1), time, time + Segment, events);
+      }
+   }), "windows/s");
+
+   const uint32_t rounds = 200;
+   uint32_t current = 0;
+   Report("Schedules now/next of all services", rounds / Measure([&]() {
+      for (uint32_t index = 0; index < rounds; index++) {
+         std::list<Broadcast::Schedules::Current> all;
+         current += epg.NowNext(Base + (index * 3037), all);
+      }
+   }), "rounds/s");
+
+   EXPECT_GT(found, queries);
+   EXPECT_EQ(current, rounds * Channels);
+}
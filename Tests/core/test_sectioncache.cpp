@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <broadcast/broadcast.h>
+
+#include "Benchmark.h"
+#include "SectionBuilder.h"
+
+using namespace WPEFramework;
+
+static std::vector<uint8_t> Payload(const std::vector<uint8_t>& section)
+{
+   return (std::vector<uint8_t>(section.begin() + 8, section.end() - 4));
+}
+
+static const Broadcast::MPEG::Table* Add(Broadcast::MPEG::SectionCache& cache, std::vector<uint8_t> section)
+{
+   return (cache.AddSection(Broadcast::MPEG::Section(Core::DataElement(section.size(), section.data()))));
+}
+
+TEST(Broadcast_MPEGTable, sections)
+{
+   std::vector<uint8_t> sections[3] = {
+      MakeSection(0x42, 1, 3, 0, 2, 100, 0),
+      MakeSection(0x42, 1, 3, 1, 2, 7, 1),
+      MakeSection(0x42, 1, 3, 2, 2, 300, 2)
+   };
+   Broadcast::MPEG::Table table(Core::ProxyType<Core::DataStore>::Create(512));
+
+   // Out of order, they end up in order.
+   for (uint8_t number : { 2, 0, 1 }) {
+      EXPECT_FALSE(table.IsValid());
+      EXPECT_TRUE(table.AddSection(Broadcast::MPEG::Section(Core::DataElement(sections[number].size(), sections[number].data()))));
+   }
+
+   ASSERT_TRUE(table.IsValid());
+   EXPECT_EQ(table.Version(), 3);
+   EXPECT_EQ(table.LastSectionNumber(), 2);
+
+   std::vector<uint8_t> expected;
+   for (const std::vector<uint8_t>& section : sections) {
+      const std::vector<uint8_t> payload(Payload(section));
+      expected.insert(expected.end(), payload.begin(), payload.end());
+   }
+   ASSERT_EQ(table.Data().Size(), expected.size());
+   EXPECT_EQ(::memcmp(table.Data().Buffer(), expected.data(), expected.size()), 0);
+
+   // Replacing the middle one, with a longer one.
+   sections[1] = MakeSection(0x42, 1, 3, 1, 2, 150, 9);
+   EXPECT_TRUE(table.AddSection(Broadcast::MPEG::Section(Core::DataElement(sections[1].size(), sections[1].data()))));
+
+   expected.clear();
+   for (const std::vector<uint8_t>& section : sections) {
+      const std::vector<uint8_t> payload(Payload(section));
+      expected.insert(expected.end(), payload.begin(), payload.end());
+   }
+   ASSERT_EQ(table.Data().Size(), expected.size());
+   EXPECT_EQ(::memcmp(table.Data().Buffer(), expected.data(), expected.size()), 0);
+
+   // A section beyond the last one announced does not belong here.
+   std::vector<uint8_t> stray(MakeSection(0x42, 1, 3, 3, 2, 10, 0));
+   EXPECT_FALSE(table.AddSection(Broadcast::MPEG::Section(Core::DataElement(stray.size(), stray.data()))));
+
+   // A new version starts all over.
+   std::vector<uint8_t> update(MakeSection(0x42, 1, 4, 1, 1, 10, 0));
+   EXPECT_TRUE(table.AddSection(Broadcast::MPEG::Section(Core::DataElement(update.size(), update.data()))));
+   EXPECT_FALSE(table.IsValid());
+   EXPECT_EQ(table.Data().Size(), 10u);
+}
+
+TEST(Broadcast_SectionCache, changes)
+{
+   Broadcast::MPEG::SectionCache cache;
+   uint32_t reported = 0;
+
+   // Two services, both with a table of three sections, repeated over and over.
+   for (uint8_t cycle = 0; cycle < 10; cycle++) {
+      for (uint16_t service = 1; service <= 2; service++) {
+         for (uint8_t number = 0; number < 3; number++) {
+            const Broadcast::MPEG::Table* table = Add(cache, MakeSection(0x42, service, 5, number, 2, 50, service));
+
+            if (table != nullptr) {
+               EXPECT_EQ(table->Extension(), service);
+               EXPECT_EQ(number, 2);
+               reported++;
+            }
+         }
+      }
+   }
+
+   EXPECT_EQ(reported, 2u);
+   EXPECT_EQ(cache.Tables(), 2u);
+   EXPECT_EQ(cache.Duplicates(), (10u * 6u) - 6u);
+
+   // A new version of service 2, only reported once complete.
+   EXPECT_EQ(Add(cache, MakeSection(0x42, 2, 6, 0, 1, 60, 7)), nullptr);
+   EXPECT_EQ(Add(cache, MakeSection(0x42, 1, 5, 0, 2, 50, 1)), nullptr);
+   const Broadcast::MPEG::Table* table = Add(cache, MakeSection(0x42, 2, 6, 1, 1, 60, 7));
+   ASSERT_NE(table, nullptr);
+   EXPECT_EQ(table->Version(), 6);
+   EXPECT_EQ(Add(cache, MakeSection(0x42, 2, 6, 1, 1, 60, 7)), nullptr);
+
+   // Changed content without a version bump (it happens), is still a change.
+   table = Add(cache, MakeSection(0x42, 2, 6, 1, 1, 60, 8));
+   ASSERT_NE(table, nullptr);
+   EXPECT_EQ(table->Data().Size(), 120u);
+
+   // The next version is not applicable yet, and a different table id is a table of its own.
+   EXPECT_EQ(Add(cache, MakeSection(0x42, 2, 7, 0, 0, 60, 7, false)), nullptr);
+   EXPECT_NE(Add(cache, MakeSection(0x46, 2, 1, 0, 0, 60, 7)), nullptr);
+   EXPECT_EQ(cache.Tables(), 3u);
+}
+
+TEST(Broadcast_SectionCache, DISABLED_throughput)
+{
+   // An EIT cycle of 500 services with 4 sections each, as repeated by the broadcaster.
+   std::vector<std::vector<uint8_t>> cycle;
+   for (uint16_t service = 0; service < 500; service++) {
+      for (uint8_t number = 0; number < 4; number++) {
+         cycle.push_back(MakeSection(0x50, service, 1, number, 3, 400, service + number));
+      }
+   }
+
+   const uint32_t repetitions = 20;
+   const double sections = static_cast<double>(cycle.size()) * repetitions;
+   uint32_t loaded = 0;
+   uint32_t descriptors = 0;
+
+   // Every complete table reparsed, as before.
+   std::map<uint32_t, std::unique_ptr<Broadcast::MPEG::Table>> tables;
+   Report("SectionCache, without", sections / Measure([&]() {
+      for (uint32_t repetition = 0; repetition < repetitions; repetition++) {
+         for (std::vector<uint8_t>& section : cycle) {
+            const Broadcast::MPEG::Section entry(Core::DataElement(section.size(), section.data()));
+            std::unique_ptr<Broadcast::MPEG::Table>& table(tables[(entry.TableId() << 16) | entry.Extension()]);
+
+            if (table == nullptr) {
+               table.reset(new Broadcast::MPEG::Table(Core::ProxyType<Core::DataStore>::Create(512)));
+            }
+            table->AddSection(entry);
+            if (table->IsValid() == true) {
+               Broadcast::MPEG::DescriptorIterator index(table->Data());
+               while (index.Next() == true) {
+                  descriptors++;
+               }
+               loaded++;
+            }
+         }
+      }
+   }), "sections/s");
+   const uint32_t reparsed = loaded;
+
+   Broadcast::MPEG::SectionCache cache;
+   loaded = 0;
+   Report("SectionCache", sections / Measure([&]() {
+      for (uint32_t repetition = 0; repetition < repetitions; repetition++) {
+         for (std::vector<uint8_t>& section : cycle) {
+            const Broadcast::MPEG::Table* table = cache.AddSection(Broadcast::MPEG::Section(Core::DataElement(section.size(), section.data())));
+            if (table != nullptr) {
+               Broadcast::MPEG::DescriptorIterator index(table->Data());
+               while (index.Next() == true) {
+                  descriptors++;
+               }
+               loaded++;
+            }
+         }
+      }
+   }), "sections/s");
+
+   EXPECT_EQ(loaded, 500u);
+   EXPECT_GT(reparsed, loaded);
+}
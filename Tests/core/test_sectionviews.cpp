@@ -0,0 +1,338 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <broadcast/broadcast.h>
+#include <broadcast/TunerAdministrator.h>
+
+#include "SectionBuilder.h"
+
+#ifdef __GLIBC__
+
+using namespace WPEFramework;
+
+// Counts the heap allocations of this thread, while it is told to. Everything, operator new included,
+// ends up here. It replaces the allocator of the whole process, so these tests have a runner of their own.
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+static thread_local bool counting = false;
+static thread_local uint32_t allocations = 0;
+
+extern "C" void* malloc(size_t size)
+{
+   allocations += (counting ? 1 : 0);
+   return (__libc_malloc(size));
+}
+extern "C" void* calloc(size_t count, size_t size)
+{
+   allocations += (counting ? 1 : 0);
+   return (__libc_calloc(count, size));
+}
+extern "C" void* realloc(void* ptr, size_t size)
+{
+   allocations += (counting ? 1 : 0);
+   return (__libc_realloc(ptr, size));
+}
+// The aligned ones too, an aligned operator new ends up in one of these.
+extern "C" void* memalign(size_t alignment, size_t size)
+{
+   allocations += (counting ? 1 : 0);
+   return (__libc_memalign(alignment, size));
+}
+extern "C" void* aligned_alloc(size_t alignment, size_t size)
+{
+   allocations += (counting ? 1 : 0);
+   return (__libc_memalign(alignment, size));
+}
+extern "C" int posix_memalign(void** ptr, size_t alignment, size_t size)
+{
+   if ((alignment < sizeof(void*)) || ((alignment & (alignment - 1)) != 0)) {
+      return (EINVAL);
+   }
+
+   allocations += (counting ? 1 : 0);
+   *ptr = __libc_memalign(alignment, size);
+   return (*ptr != nullptr ? 0 : ENOMEM);
+}
+extern "C" void* valloc(size_t size)
+{
+   allocations += (counting ? 1 : 0);
+   return (__libc_memalign(sysconf(_SC_PAGESIZE), size));
+}
+extern "C" void free(void* ptr)
+{
+   __libc_free(ptr);
+}
+
+namespace {
+
+   const uint32_t Base = 20744 * 86400;
+   const uint16_t Channels = 50;
+
+   class Counter {
+   public:
+      Counter()
+      {
+         allocations = 0;
+         counting = true;
+      }
+      ~Counter()
+      {
+         counting = false;
+      }
+
+   public:
+      uint32_t Allocations() const
+      {
+         return (allocations);
+      }
+   };
+
+   // A tuner in software: the section filters are installed on a demultiplexer, fed from a capture.
+   class Tuner : public Broadcast::ITuner {
+   private:
+      class Forwarder : public Broadcast::ISection {
+      public:
+         Forwarder()
+            : Callback(nullptr)
+         {
+         }
+         ~Forwarder() override
+         {
+         }
+
+      public:
+         void Handle(const Broadcast::MPEG::Section& section) override
+         {
+            Callback->Handle(section);
+         }
+
+      public:
+         Broadcast::ISection* Callback;
+      };
+
+   public:
+      Tuner(Broadcast::Demultiplexer& demux)
+         : _demux(demux)
+      {
+      }
+      ~Tuner() override
+      {
+      }
+
+   public:
+      uint32_t Properties() const override
+      {
+         return (Broadcast::ITuner::DVB | Broadcast::ITuner::Terrestrial);
+      }
+      uint16_t Id() const override
+      {
+         return (1);
+      }
+      state State() const override
+      {
+         return (Broadcast::ITuner::LOCKED);
+      }
+      uint32_t Tune(const uint16_t, const Broadcast::Modulation, const uint32_t, const uint16_t, const Broadcast::SpectralInversion) override
+      {
+         return (Core::ERROR_NONE);
+      }
+      uint32_t Prepare(const uint16_t) override
+      {
+         return (Core::ERROR_NONE);
+      }
+      // A filter per table id, the demultiplexer filters per callback, so every table id gets one.
+      uint32_t Filter(const uint16_t pid, const uint8_t tableId, Broadcast::ISection* callback) override
+      {
+         _forwarders[tableId].Callback = callback;
+         return (callback != nullptr ? _demux.Filter(pid, tableId, &(_forwarders[tableId])) : _demux.Revoke(&(_forwarders[tableId]), pid));
+      }
+      uint32_t Attach(const uint8_t) override
+      {
+         return (Core::ERROR_NONE);
+      }
+      uint32_t Detach(const uint8_t) override
+      {
+         return (Core::ERROR_NONE);
+      }
+
+   private:
+      Broadcast::Demultiplexer& _demux;
+      Forwarder _forwarders[256];
+   };
+
+   // Holds on to the last section it got, as a table cache or a recorder would.
+   class Keeper : public Broadcast::ISection {
+   public:
+      Keeper()
+         : Last()
+         , Count(0)
+      {
+      }
+      ~Keeper() override
+      {
+      }
+
+   public:
+      void Handle(const Broadcast::MPEG::Section& section) override
+      {
+         Last = section;
+         Count++;
+      }
+
+   public:
+      Broadcast::MPEG::Section Last;
+      uint32_t Count;
+   };
+
+   void AddEvent(std::vector<uint8_t>& payload, const uint16_t eventId, const uint32_t start, const uint32_t duration, const string& title, const string& text)
+   {
+      const uint16_t MJD = static_cast<uint16_t>((start / 86400) + 40587);
+      const uint32_t times[] = { start % 86400, duration };
+      const uint8_t descriptor = static_cast<uint8_t>(3 + 1 + title.length() + 1 + text.length());
+
+      payload.insert(payload.end(), { static_cast<uint8_t>(eventId >> 8), static_cast<uint8_t>(eventId), static_cast<uint8_t>(MJD >> 8), static_cast<uint8_t>(MJD) });
+      for (uint32_t time : times) {
+         for (uint32_t part : { time / 3600, (time / 60) % 60, time % 60 }) {
+            payload.push_back(static_cast<uint8_t>(((part / 10) << 4) | (part % 10)));
+         }
+      }
+      payload.insert(payload.end(), { static_cast<uint8_t>(0x80 | ((descriptor + 2) >> 8)), static_cast<uint8_t>(descriptor + 2),
+         Broadcast::DVB::Descriptors::ShortEvent::TAG, descriptor, 'e', 'n', 'g', static_cast<uint8_t>(title.length()) });
+      payload.insert(payload.end(), title.begin(), title.end());
+      payload.push_back(static_cast<uint8_t>(text.length()));
+      payload.insert(payload.end(), text.begin(), text.end());
+   }
+
+   string Title(const uint16_t service, const uint16_t eventId, const uint8_t version)
+   {
+      return ("Programme " + std::to_string(service) + "/" + std::to_string(eventId) + (version > 1 ? " (changed)" : ""));
+   }
+
+   // The EIT of a service: present/following and a day of schedule, in segments of 3 hours, an
+   // event an hour. The version only changes the first event.
+   std::vector<std::vector<uint8_t>> MakeEIT(const uint16_t service, const uint8_t version)
+   {
+      const uint8_t header[] = { 0x00, 0x01, 0x00, 0x02 };
+      std::vector<std::vector<uint8_t>> sections;
+
+      for (uint8_t number = 0; number < 2; number++) {
+         std::vector<uint8_t> payload(header, header + sizeof(header));
+         payload.insert(payload.end(), { 1, Broadcast::DVB::EIT::ACTUAL });
+         AddEvent(payload, number, Base + (number * 3600), 3600, Title(service, number, number == 0 ? version : 1), "The description of a programme that is on this service, long enough to be on the heap.");
+         sections.push_back(MakeSection(Broadcast::DVB::EIT::ACTUAL, service, version, number, 1, payload));
+      }
+      for (uint8_t segment = 0; segment < 8; segment++) {
+         std::vector<uint8_t> payload(header, header + sizeof(header));
+         payload.insert(payload.end(), { static_cast<uint8_t>(segment * 8), Broadcast::DVB::EIT::SCHEDULE_ACTUAL });
+         for (uint8_t hour = 0; hour < 3; hour++) {
+            const uint16_t eventId = (segment * 3) + hour;
+            AddEvent(payload, eventId, Base + (eventId * 3600), 3600, Title(service, eventId, eventId == 0 ? version : 1), "The description of a programme that is on this service, long enough to be on the heap.");
+         }
+         sections.push_back(MakeSection(Broadcast::DVB::EIT::SCHEDULE_ACTUAL, service, version, segment * 8, 7 * 8, payload));
+      }
+
+      return (sections);
+   }
+
+   // A capture of the SI PIDs: the SDT and the EIT of all services, repeated as the broadcaster does.
+   void Record(const char fileName[], const uint32_t cycles, const uint8_t version, uint8_t continuity[2], std::vector<uint8_t>& sdt)
+   {
+      std::vector<uint8_t> stream;
+      std::vector<uint8_t> services(std::initializer_list<uint8_t>{ 0x00, 0x02, 0xFF });
+
+      for (uint16_t service = 1; service <= Channels; service++) {
+         services.insert(services.end(), { static_cast<uint8_t>(service >> 8), static_cast<uint8_t>(service), 0xFD, 0x80, 0x00 });
+      }
+      sdt = MakeSection(0x42, 1, version, 0, 0, services);
+
+      for (uint32_t cycle = 0; cycle < cycles; cycle++) {
+         Packetize(stream, 0x11, continuity[0], { sdt });
+         for (uint16_t service = 1; service <= Channels; service++) {
+            Packetize(stream, 0x12, continuity[1], MakeEIT(service, version));
+         }
+      }
+
+      FILE* file = fopen(fileName, "wb");
+      ASSERT_NE(file, nullptr);
+      fwrite(stream.data(), 1, stream.size(), file);
+      fclose(file);
+   }
+}
+
+TEST(Broadcast_SectionViews, allocations)
+{
+   const string first(_T("testviews01.ts"));
+   const string repeated(_T("testviews02.ts"));
+   const string updated(_T("testviews03.ts"));
+   uint8_t continuity[2] = { 0, 0 };
+   std::vector<uint8_t> sdt[3];
+
+   Record(first.c_str(), 1, 1, continuity, sdt[0]);
+   Record(repeated.c_str(), 20, 1, continuity, sdt[1]);
+   Record(updated.c_str(), 2, 2, continuity, sdt[2]);
+
+   Broadcast::Demultiplexer demux;
+   Broadcast::Schedules epg;
+   Tuner tuner(demux);
+   Keeper keeper;
+
+   demux.Filter(0x11, 0x42, &keeper);
+   Broadcast::TunerAdministrator::Instance().Announce(&tuner)->StateChange(&tuner);
+
+   // The first time around, the store fills up.
+   uint32_t count;
+   {
+      Counter counter;
+      EXPECT_EQ(demux.Load(first), Core::ERROR_NONE);
+      count = counter.Allocations();
+   }
+   EXPECT_EQ(epg.Events(), Channels * 24u);
+   EXPECT_GT(count, 0u);
+
+   // The broadcaster repeating itself costs nothing, the section kept included.
+   {
+      Counter counter;
+      EXPECT_EQ(demux.Load(repeated), Core::ERROR_NONE);
+      count = counter.Allocations();
+   }
+   EXPECT_EQ(count, 0u);
+   EXPECT_EQ(keeper.Count, 21u);
+   EXPECT_EQ(demux.Statistic().CRCErrors, 0u);
+
+   // A new version, only the changed titles are copied, and the 50 of them fit in the room the
+   // strings pool has left, so not even that allocates.
+   const uint32_t sections = demux.Statistic().Sections;
+   {
+      Counter counter;
+      EXPECT_EQ(demux.Load(updated), Core::ERROR_NONE);
+      count = counter.Allocations();
+   }
+   EXPECT_EQ(count, 0u);
+   EXPECT_EQ(epg.Events(), Channels * 24u);
+
+   std::list<Broadcast::Schedules::Event> events;
+   EXPECT_EQ(epg.Window(2, 1, 7, Base, Base + 1, events), 1u);
+   EXPECT_EQ(events.front().Title(), Title(7, 0, 2));
+
+   // The section kept, is still the section it was, whatever came in after it.
+   ASSERT_EQ(keeper.Last.Length(), sdt[2].size());
+   EXPECT_EQ(::memcmp(keeper.Last.Data().Buffer() - 8, sdt[2].data(), sdt[2].size()), 0);
+   EXPECT_EQ(keeper.Last.Version(), 2);
+
+   printf("SectionViews: %u sections, %u allocations for the %u sections of a new version\n", sections, count, demux.Statistic().Sections - sections);
+
+   Broadcast::TunerAdministrator::Instance().Revoke(&tuner);
+   demux.Revoke(&keeper);
+
+   remove(first.c_str());
+   remove(repeated.c_str());
+   remove(updated.c_str());
+}
+
+#endif // __GLIBC__
@@ -0,0 +1,466 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+
+#ifndef __WIN32__
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+using namespace WPEFramework;
+
+#ifndef __WIN32__
+
+namespace {
+
+   // The consumers take whole records only, the ring sizes are no multiple of it, so records
+   // end up split over the end of the rings.
+   const uint8_t RecordSize = 8;
+   const uint32_t RingSize = 100;
+
+   uint8_t Pattern(const uint32_t position)
+   {
+      return (static_cast<uint8_t>(position % 251));
+   }
+
+   bool IsPattern(const std::vector<uint8_t>& data)
+   {
+      uint32_t index = 0;
+
+      while ((index < data.size()) && (data[index] == Pattern(index))) {
+         index++;
+      }
+
+      return (index == data.size());
+   }
+
+   bool ReadAll(const int fd, std::vector<uint8_t>& data, const uint32_t length)
+   {
+      uint8_t buffer[64];
+
+      while (data.size() < length) {
+         struct pollfd info = { fd, POLLIN, 0 };
+
+         if (::poll(&info, 1, 2000) <= 0) {
+            break;
+         }
+
+         ssize_t loaded = ::read(fd, buffer, std::min(static_cast<uint32_t>(sizeof(buffer)), static_cast<uint32_t>(length - data.size())));
+
+         if (loaded <= 0) {
+            break;
+         }
+
+         data.insert(data.end(), buffer, &(buffer[loaded]));
+      }
+
+      return (data.size() == length);
+   }
+
+   class RecordStream : public Core::SocketStream {
+   public:
+      RecordStream() = delete;
+      RecordStream(const RecordStream&) = delete;
+      RecordStream& operator=(const RecordStream&) = delete;
+
+      RecordStream(const SOCKET connector, const uint32_t length)
+         : Core::SocketStream(false, connector, Core::NodeId(_T("/tmp/test_socketport.stream")), RingSize, RingSize)
+         , _length(length)
+         , _sent(0)
+         , _received()
+         , _done(false, true)
+      {
+      }
+      ~RecordStream() override
+      {
+         Close(Core::infinite);
+      }
+
+   public:
+      const std::vector<uint8_t>& Received() const
+      {
+         return (_received);
+      }
+      bool Wait()
+      {
+         return (_done.Lock(2000) == Core::ERROR_NONE);
+      }
+      uint16_t SendData(uint8_t* dataFrame, const uint16_t maxSendSize) override
+      {
+         // Odd portions, so the queued data wraps in the send ring.
+         uint16_t size = static_cast<uint16_t>(std::min(std::min(static_cast<uint32_t>(maxSendSize), static_cast<uint32_t>(23)), _length - _sent));
+
+         for (uint16_t index = 0; index < size; index++) {
+            dataFrame[index] = Pattern(_sent + index);
+         }
+         _sent += size;
+
+         return (size);
+      }
+      uint16_t ReceiveData(uint8_t* dataFrame, const uint16_t receivedSize) override
+      {
+         uint16_t taken = receivedSize - (receivedSize % RecordSize);
+
+         _received.insert(_received.end(), dataFrame, &(dataFrame[taken]));
+
+         if (_received.size() >= _length) {
+            _done.SetEvent();
+         }
+
+         return (taken);
+      }
+      void StateChange() override
+      {
+      }
+
+   private:
+      const uint32_t _length;
+      uint32_t _sent;
+      std::vector<uint8_t> _received;
+      Core::Event _done;
+   };
+
+   class RecordDatagram : public Core::SocketDatagram {
+   public:
+      RecordDatagram() = delete;
+      RecordDatagram(const RecordDatagram&) = delete;
+      RecordDatagram& operator=(const RecordDatagram&) = delete;
+
+      RecordDatagram(const Core::NodeId& local, const uint32_t length)
+         : Core::SocketDatagram(false, local, Core::NodeId(), RingSize, RingSize)
+         , _length(length)
+         , _received()
+         , _done(false, true)
+      {
+      }
+      ~RecordDatagram() override
+      {
+         Close(Core::infinite);
+      }
+
+   public:
+      const std::vector<uint8_t>& Received() const
+      {
+         return (_received);
+      }
+      bool Wait()
+      {
+         return (_done.Lock(2000) == Core::ERROR_NONE);
+      }
+      uint16_t SendData(uint8_t*, const uint16_t) override
+      {
+         return (0);
+      }
+      uint16_t ReceiveData(uint8_t* dataFrame, const uint16_t receivedSize) override
+      {
+         uint16_t taken = receivedSize - (receivedSize % RecordSize);
+
+         _received.insert(_received.end(), dataFrame, &(dataFrame[taken]));
+
+         if (_received.size() >= _length) {
+            _done.SetEvent();
+         }
+
+         return (taken);
+      }
+      void StateChange() override
+      {
+      }
+
+   private:
+      const uint32_t _length;
+      std::vector<uint8_t> _received;
+      Core::Event _done;
+   };
+
+   class FileStream : public Core::SocketStream {
+   public:
+      FileStream() = delete;
+      FileStream(const FileStream&) = delete;
+      FileStream& operator=(const FileStream&) = delete;
+
+      FileStream(const SOCKET connector, const Core::File::Handle sendFile, const uint32_t sendLength, const Core::File::Handle receiveFile, const uint32_t receiveLength)
+         : Core::SocketStream(false, connector, Core::NodeId(_T("/tmp/test_socketport.stream")), RingSize, RingSize)
+         , _sendFile(sendFile)
+         , _sendLength(sendLength)
+         , _receiveFile(receiveFile)
+         , _receiveLength(receiveLength)
+         , _buffered(0)
+         , _done(false, true)
+      {
+      }
+      ~FileStream() override
+      {
+         Close(Core::infinite);
+      }
+
+   public:
+      uint32_t Buffered() const
+      {
+         return (_buffered);
+      }
+      bool Wait()
+      {
+         return (_done.Lock(2000) == Core::ERROR_NONE);
+      }
+      uint16_t SendData(uint8_t*, const uint16_t) override
+      {
+         return (0);
+      }
+      uint16_t ReceiveData(uint8_t*, const uint16_t receivedSize) override
+      {
+         // Anything that did not go to the file.
+         _buffered += receivedSize;
+
+         return (receivedSize);
+      }
+      void StateChange() override
+      {
+         if (HasError() == true) {
+            _done.SetEvent();
+         }
+      }
+      uint32_t SendFile(Core::File::Handle& file) override
+      {
+         file = _sendFile;
+
+         return (_sendLength);
+      }
+      void SentFile(const uint32_t length) override
+      {
+         _sendLength -= length;
+      }
+      uint32_t ReceiveFile(Core::File::Handle& file) override
+      {
+         file = _receiveFile;
+
+         return (_receiveLength);
+      }
+      void ReceivedFile(const uint32_t length) override
+      {
+         _receiveLength -= length;
+
+         if (_receiveLength == 0) {
+            _done.SetEvent();
+         }
+      }
+
+   private:
+      Core::File::Handle _sendFile;
+      uint32_t _sendLength;
+      Core::File::Handle _receiveFile;
+      uint32_t _receiveLength;
+      uint32_t _buffered;
+      Core::Event _done;
+   };
+
+   // An anonymous file, opened with the given mode on a name that is gone right away.
+   int TemporaryFile(const uint32_t length, const int flags)
+   {
+      char name[] = "/tmp/test_socketport.XXXXXX";
+      int fd = ::mkstemp(name);
+
+      if (fd != -1) {
+         for (uint32_t index = 0; index < length; index++) {
+            uint8_t value = Pattern(index);
+            ::write(fd, &value, 1);
+         }
+         ::close(fd);
+
+         fd = ::open(name, flags);
+         ::unlink(name);
+      }
+
+      return (fd);
+   }
+}
+
+class Core_SocketPort : public ::testing::Test {
+protected:
+   // The ResourceMonitor can not be created again once disposed, keep it for all tests.
+   static void TearDownTestCase()
+   {
+      Core::Singleton::Dispose();
+   }
+};
+
+TEST_F(Core_SocketPort, streamReceiveWrapsAndRotates)
+{
+   const uint32_t length = 20000;
+   int fds[2];
+   ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+   {
+      RecordStream stream(fds[0], length);
+      ASSERT_EQ(stream.Open(0), Core::ERROR_NONE);
+
+      // Portions that are no multiple of the record, nor of the ring.
+      uint8_t buffer[37];
+      uint32_t written = 0;
+
+      while (written < length) {
+         uint32_t size = std::min(static_cast<uint32_t>(sizeof(buffer)), length - written);
+
+         for (uint32_t index = 0; index < size; index++) {
+            buffer[index] = Pattern(written + index);
+         }
+         ASSERT_EQ(::write(fds[1], buffer, size), static_cast<ssize_t>(size));
+         written += size;
+      }
+
+      EXPECT_TRUE(stream.Wait());
+      EXPECT_EQ(stream.Received().size(), length);
+      EXPECT_TRUE(IsPattern(stream.Received()));
+   }
+
+   ::close(fds[1]);
+}
+
+TEST_F(Core_SocketPort, streamSendWraps)
+{
+   const uint32_t length = 20000;
+   int fds[2];
+   ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+   {
+      RecordStream stream(fds[0], length);
+      ASSERT_EQ(stream.Open(0), Core::ERROR_NONE);
+
+      stream.Trigger();
+
+      // Let the socket fill up first, from then on the ring is only partly written at a time
+      // and the queued data is gathered from both ends of the ring.
+      SleepMs(100);
+
+      std::vector<uint8_t> received;
+      EXPECT_TRUE(ReadAll(fds[1], received, length));
+      EXPECT_TRUE(IsPattern(received));
+   }
+
+   ::close(fds[1]);
+}
+
+TEST_F(Core_SocketPort, datagramIsNotTruncated)
+{
+   const Core::NodeId node(_T("/tmp/test_socketport.datagram"));
+   const uint8_t frameSize = 60;
+   const uint8_t frames = 20;
+
+   {
+      RecordDatagram datagram(node, frameSize * frames);
+      ASSERT_EQ(datagram.Open(0), Core::ERROR_NONE);
+
+      int sender = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+      ASSERT_NE(sender, -1);
+
+      // Each datagram leaves half a record in the ring, the next one still has to fit completely.
+      for (uint8_t frame = 0; frame < frames; frame++) {
+         uint8_t buffer[frameSize];
+
+         for (uint8_t index = 0; index < frameSize; index++) {
+            buffer[index] = Pattern((frame * frameSize) + index);
+         }
+         EXPECT_EQ(::sendto(sender, buffer, frameSize, 0, static_cast<const struct sockaddr*>(node), node.Size()), frameSize);
+      }
+
+      EXPECT_TRUE(datagram.Wait());
+      EXPECT_EQ(datagram.Received().size(), static_cast<uint32_t>(frameSize * frames));
+      EXPECT_TRUE(IsPattern(datagram.Received()));
+
+      ::close(sender);
+   }
+}
+
+TEST_F(Core_SocketPort, streamSendFile)
+{
+   const uint32_t length = 100000;
+   int fds[2];
+   ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+   int file = TemporaryFile(length, O_RDONLY);
+   ASSERT_NE(file, -1);
+
+   {
+      FileStream stream(fds[0], file, length, -1, 0);
+      ASSERT_EQ(stream.Open(0), Core::ERROR_NONE);
+
+      stream.Trigger();
+
+      std::vector<uint8_t> received;
+      EXPECT_TRUE(ReadAll(fds[1], received, length));
+      EXPECT_TRUE(IsPattern(received));
+   }
+
+   ::close(file);
+   ::close(fds[1]);
+}
+
+TEST_F(Core_SocketPort, streamReceiveFile)
+{
+   const uint32_t length = 100000;
+   const uint32_t extra = 100;
+   int fds[2];
+   ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+   int file = TemporaryFile(0, O_RDWR);
+   ASSERT_NE(file, -1);
+
+   {
+      FileStream stream(fds[0], -1, 0, file, length);
+      ASSERT_EQ(stream.Open(0), Core::ERROR_NONE);
+
+      // Some bytes beyond the file, they continue on the buffered path.
+      std::vector<uint8_t> content;
+      for (uint32_t index = 0; index < (length + extra); index++) {
+         content.push_back(Pattern(index));
+      }
+      ASSERT_EQ(::write(fds[1], content.data(), content.size()), static_cast<ssize_t>(content.size()));
+
+      EXPECT_TRUE(stream.Wait());
+
+      uint32_t waitTime = 2000;
+      while ((stream.Buffered() < extra) && (waitTime > 0)) {
+         SleepMs(10);
+         waitTime -= 10;
+      }
+      EXPECT_EQ(stream.Buffered(), extra);
+   }
+
+   std::vector<uint8_t> stored;
+   ASSERT_EQ(::lseek(file, 0, SEEK_SET), 0);
+   EXPECT_TRUE(ReadAll(file, stored, length));
+   EXPECT_TRUE(IsPattern(stored));
+
+   ::close(file);
+   ::close(fds[1]);
+}
+
+TEST_F(Core_SocketPort, streamReceiveFileFails)
+{
+   int fds[2];
+   ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+   // The content can not be stored, it may not end up on the buffered path either.
+   int file = TemporaryFile(0, O_RDONLY);
+   ASSERT_NE(file, -1);
+
+   {
+      FileStream stream(fds[0], -1, 0, file, 1000);
+      ASSERT_EQ(stream.Open(0), Core::ERROR_NONE);
+
+      uint8_t content[500];
+      ::memset(content, 0x55, sizeof(content));
+      ASSERT_EQ(::write(fds[1], content, sizeof(content)), static_cast<ssize_t>(sizeof(content)));
+
+      EXPECT_TRUE(stream.Wait());
+      EXPECT_FALSE(stream.IsOpen());
+      EXPECT_EQ(stream.Buffered(), 0u);
+   }
+
+   ::close(file);
+   ::close(fds[1]);
+}
+
+#endif
@@ -0,0 +1,291 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+#include "Benchmark.h"
+
+using namespace WPEFramework;
+
+namespace {
+
+   // The smallest context a pool can run: it refers to the work, jobs are the same if the work is.
+   class Task {
+   public:
+      Task()
+         : _work(nullptr)
+      {
+      }
+      Task(std::function<void()>& work)
+         : _work(&work)
+      {
+      }
+      Task(const Task& copy) = default;
+      Task& operator=(const Task& rhs) = default;
+      ~Task() = default;
+
+   public:
+      bool operator==(const Task& rhs) const
+      {
+         return (_work == rhs._work);
+      }
+      bool operator!=(const Task& rhs) const
+      {
+         return (!operator==(rhs));
+      }
+      void Dispatch()
+      {
+         (*_work)();
+      }
+
+   private:
+      std::function<void()>* _work;
+   };
+
+   bool WaitFor(const std::atomic<uint32_t>& value, const uint32_t expected)
+   {
+      uint32_t waited = 0;
+
+      while ((value.load() < expected) && (waited < 5000)) {
+         SleepMs(1);
+         waited++;
+      }
+
+      return (value.load() == expected);
+   }
+
+   // Keeps all workers of a pool busy, till it is released.
+   template <typename POOL>
+   class Blockers {
+   public:
+      Blockers() = delete;
+      Blockers(const Blockers&) = delete;
+      Blockers& operator=(const Blockers&) = delete;
+
+      Blockers(POOL& pool)
+         : _release(false, true)
+         , _started(0)
+         , _finished(0)
+         , _work([this]() {
+            _started++;
+            _release.Lock(Core::infinite);
+            _finished++;
+         })
+      {
+         // The same work for every worker, they are all different jobs to the pool though.
+         for (uint8_t index = 0; index < pool.Count(); index++) {
+            _tasks.emplace_back(std::function<void()>(_work));
+         }
+         for (std::function<void()>& task : _tasks) {
+            pool.Submit(Task(task), Core::infinite);
+         }
+
+         EXPECT_TRUE(WaitFor(_started, pool.Count()));
+      }
+      ~Blockers()
+      {
+         Release();
+
+         // Do not pull the work away from under the workers.
+         EXPECT_TRUE(WaitFor(_finished, static_cast<uint32_t>(_tasks.size())));
+         SleepMs(10);
+      }
+
+   public:
+      void Release()
+      {
+         _release.SetEvent();
+      }
+
+   private:
+      Core::Event _release;
+      std::atomic<uint32_t> _started;
+      std::atomic<uint32_t> _finished;
+      std::function<void()> _work;
+      std::list<std::function<void()>> _tasks;
+   };
+}
+
+TEST(Core_ThreadPool, submitFromWorker)
+{
+   std::atomic<uint32_t> executed(0);
+   std::vector<std::function<void()>> nested(100, [&executed]() { executed++; });
+   std::function<void()> parent;
+   Core::ThreadPoolType<Task, 4> pool(0, _T("Test"));
+
+   parent = [&]() {
+      for (std::function<void()>& work : nested) {
+         pool.Submit(Task(work), Core::infinite);
+      }
+   };
+   pool.Submit(Task(parent), Core::infinite);
+
+   EXPECT_TRUE(WaitFor(executed, 100));
+   EXPECT_EQ(pool.Pending(), 0u);
+}
+
+TEST(Core_ThreadPool, stealing)
+{
+   std::atomic<uint32_t> executed(0);
+   std::atomic<uint32_t> stolen(0);
+   std::atomic<uint32_t> done(0);
+   ::ThreadId owner = 0;
+   std::vector<std::function<void()>> nested(50, [&]() {
+      stolen += (Core::Thread::ThreadId() != owner ? 1 : 0);
+      executed++;
+   });
+   std::function<void()> parent;
+   Core::ThreadPoolType<Task, 2> pool(0, _T("Test"));
+
+   // The jobs land on the deque of the submitting worker, but that one stays busy till they are all
+   // done. The other one has to take them.
+   parent = [&]() {
+      owner = Core::Thread::ThreadId();
+      for (std::function<void()>& work : nested) {
+         pool.Submit(Task(work), Core::infinite);
+      }
+      WaitFor(executed, 50);
+      done++;
+   };
+   pool.Submit(Task(parent), Core::infinite);
+
+   EXPECT_TRUE(WaitFor(done, 1));
+   EXPECT_EQ(executed.load(), 50u);
+   EXPECT_EQ(stolen.load(), 50u);
+}
+
+TEST(Core_ThreadPool, overflow)
+{
+   std::atomic<uint32_t> executed(0);
+   std::vector<std::function<void()>> jobs(300, [&executed]() { executed++; });
+   Core::ThreadPoolType<Task, 2> pool(0, _T("Test"));
+
+   {
+      Blockers<Core::ThreadPoolType<Task, 2>> blockers(pool);
+
+      // More than the deques of the workers can hold.
+      for (std::function<void()>& work : jobs) {
+         pool.Submit(Task(work), Core::infinite);
+      }
+      EXPECT_EQ(pool.Pending(), 300u);
+      EXPECT_EQ(executed.load(), 0u);
+   }
+
+   EXPECT_TRUE(WaitFor(executed, 300));
+   EXPECT_EQ(pool.Pending(), 0u);
+}
+
+TEST(Core_ThreadPool, bounded)
+{
+   typedef Core::ThreadPoolType<Task, 2, 8> Pool;
+
+   std::atomic<uint32_t> executed(0);
+   std::vector<std::function<void()>> jobs(10, [&executed]() { executed++; });
+   Pool pool(0, _T("Test"));
+
+   {
+      Blockers<Pool> blockers(pool);
+
+      for (uint8_t index = 0; index < 8; index++) {
+         pool.Submit(Task(jobs[index]), Core::infinite);
+      }
+      EXPECT_EQ(pool.Pending(), 8u);
+
+      // Full, this one is not taken in..
+      pool.Submit(Task(jobs[8]), 50);
+      EXPECT_EQ(pool.Pending(), 8u);
+
+      // ..this one waits till there is room.
+      std::thread waiting([&]() { pool.Submit(Task(jobs[9]), Core::infinite); });
+      SleepMs(50);
+      EXPECT_EQ(pool.Pending(), 8u);
+
+      blockers.Release();
+      waiting.join();
+   }
+
+   EXPECT_TRUE(WaitFor(executed, 9));
+   SleepMs(50);
+   EXPECT_EQ(executed.load(), 9u);
+}
+
+TEST(Core_ThreadPool, revokeQueued)
+{
+   std::atomic<uint32_t> executed(0);
+   std::vector<std::function<void()>> jobs(3, [&executed]() { executed++; });
+   Core::ThreadPoolType<Task, 2> pool(0, _T("Test"));
+
+   {
+      Blockers<Core::ThreadPoolType<Task, 2>> blockers(pool);
+
+      for (std::function<void()>& work : jobs) {
+         pool.Submit(Task(work), Core::infinite);
+      }
+
+      EXPECT_EQ(pool.Revoke(Task(jobs[1]), 0), Core::ERROR_NONE);
+      EXPECT_EQ(pool.Pending(), 2u);
+   }
+
+   EXPECT_TRUE(WaitFor(executed, 2));
+   SleepMs(50);
+   EXPECT_EQ(executed.load(), 2u);
+
+   // Not queued, nor running.
+   EXPECT_EQ(pool.Revoke(Task(jobs[1]), 0), Core::ERROR_UNAVAILABLE);
+}
+
+TEST(Core_ThreadPool, revokeRunning)
+{
+   Core::Event release(false, true);
+   std::atomic<uint32_t> started(0);
+   std::atomic<bool> finished(false);
+   std::function<void()> running([&]() {
+      started++;
+      release.Lock(Core::infinite);
+      SleepMs(20);
+      finished = true;
+   });
+   Core::ThreadPoolType<Task, 2> pool(0, _T("Test"));
+
+   pool.Submit(Task(running), Core::infinite);
+   ASSERT_TRUE(WaitFor(started, 1));
+
+   // It can not be taken out anymore, the revoke waits for it to complete.
+   EXPECT_EQ(pool.Revoke(Task(running), 50), Core::ERROR_TIMEDOUT);
+
+   std::atomic<bool> revoked(false);
+   std::thread revoker([&]() {
+      EXPECT_EQ(pool.Revoke(Task(running), Core::infinite), Core::ERROR_NONE);
+      EXPECT_TRUE(finished.load());
+      revoked = true;
+   });
+
+   SleepMs(50);
+   EXPECT_FALSE(revoked.load());
+
+   release.SetEvent();
+   revoker.join();
+
+   EXPECT_TRUE(revoked.load());
+}
+
+TEST(Core_ThreadPool, DISABLED_throughput)
+{
+   const uint32_t jobs = 1000000;
+   std::atomic<uint32_t> executed(0);
+   std::function<void()> work([&executed]() { executed++; });
+   Core::ThreadPoolType<Task, 4> pool(0, _T("Test"));
+
+   // The same work over and over, it is a new job to the pool every time.
+   Report("ThreadPool submit and dispatch", jobs / Measure([&]() {
+      for (uint32_t index = 0; index < jobs; index++) {
+         pool.Submit(Task(work), Core::infinite);
+      }
+      while (executed.load() < jobs) {
+         std::this_thread::yield();
+      }
+   }), "jobs/s");
+}
@@ -0,0 +1,267 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+
+#include <atomic>
+#include <vector>
+
+using namespace WPEFramework;
+
+namespace {
+
+   // Keeps track of the order in which the timers fired.
+   class Recorder {
+   public:
+      Recorder(const Recorder&) = delete;
+      Recorder& operator=(const Recorder&) = delete;
+
+      Recorder()
+         : _lock()
+         , _fired()
+         , _count(0)
+      {
+      }
+      ~Recorder() = default;
+
+   public:
+      void Fired(const uint32_t id)
+      {
+         _lock.Lock();
+         _fired.push_back(id);
+         _lock.Unlock();
+         _count++;
+      }
+      std::vector<uint32_t> Fired() const
+      {
+         _lock.Lock();
+         std::vector<uint32_t> result(_fired);
+         _lock.Unlock();
+         return (result);
+      }
+      bool WaitFor(const uint32_t expected) const
+      {
+         uint32_t waited = 0;
+
+         while ((_count.load() < expected) && (waited < 5000)) {
+            SleepMs(1);
+            waited++;
+         }
+
+         return (_count.load() == expected);
+      }
+
+   private:
+      mutable Core::CriticalSection _lock;
+      std::vector<uint32_t> _fired;
+      std::atomic<uint32_t> _count;
+   };
+
+   class Job {
+   public:
+      Job()
+         : _recorder(nullptr)
+         , _id(0)
+         , _repeat(0)
+         , _interval(0)
+         , _release(nullptr)
+      {
+      }
+      Job(Recorder& recorder, const uint32_t id)
+         : _recorder(&recorder)
+         , _id(id)
+         , _repeat(0)
+         , _interval(0)
+         , _release(nullptr)
+      {
+      }
+      Job(const Job& copy) = default;
+      Job& operator=(const Job& rhs) = default;
+      ~Job() = default;
+
+   public:
+      // Reschedules itself, _repeat more times, _interval ms after the time it was scheduled for.
+      Job& Repeat(const uint32_t repeat, const uint32_t interval)
+      {
+         _repeat = repeat;
+         _interval = interval;
+         return (*this);
+      }
+      // Holds up the timer thread, till the event is set.
+      Job& Block(Core::Event& release)
+      {
+         _release = &release;
+         return (*this);
+      }
+
+      bool operator==(const Job& rhs) const
+      {
+         return (_id == rhs._id);
+      }
+      bool operator!=(const Job& rhs) const
+      {
+         return (!operator==(rhs));
+      }
+
+      uint64_t Timed(const uint64_t scheduledTime)
+      {
+         uint64_t result = 0;
+
+         if (_release != nullptr) {
+            _release->Lock(Core::infinite);
+         }
+
+         _recorder->Fired(_id);
+
+         if (_repeat > 0) {
+            _repeat--;
+            result = scheduledTime + (_interval * Core::Time::TicksPerMillisecond);
+         }
+
+         return (result);
+      }
+
+   private:
+      Recorder* _recorder;
+      uint32_t _id;
+      uint32_t _repeat;
+      uint32_t _interval;
+      Core::Event* _release;
+   };
+
+   typedef Core::TimerType<Job> Timer;
+
+   uint64_t After(const uint32_t ms)
+   {
+      return (Core::Time::Now().Ticks() + (static_cast<uint64_t>(ms) * Core::Time::TicksPerMillisecond));
+   }
+}
+
+TEST(Core_Timer, ordering)
+{
+   Recorder recorder;
+   Timer timer(0, _T("Test"));
+   const uint64_t base = After(100);
+
+   // Scheduled out of order, enough of them to fill a few levels of the heap.
+   for (uint32_t index = 0; index < 100; index++) {
+      uint32_t slot = (index * 37) % 100;
+      timer.Schedule(base + (slot * Core::Time::TicksPerMillisecond), Job(recorder, slot));
+   }
+   EXPECT_EQ(timer.Pending(), 100u);
+
+   EXPECT_TRUE(recorder.WaitFor(100));
+
+   std::vector<uint32_t> fired(recorder.Fired());
+   ASSERT_EQ(fired.size(), 100u);
+   for (uint32_t index = 0; index < 100; index++) {
+      EXPECT_EQ(fired[index], index);
+   }
+   EXPECT_EQ(timer.Pending(), 0u);
+}
+
+TEST(Core_Timer, equalDeadline)
+{
+   Recorder recorder;
+   Core::Event release(false, true);
+   Timer timer(0, _T("Test"));
+   const uint64_t due = Core::Time::Now().Ticks();
+
+   // Keep the timer busy, so all of them are due by the time it gets to them.
+   timer.Schedule(due, Job(recorder, 0).Block(release));
+   for (uint32_t waited = 0; (timer.Pending() != 0) && (waited < 5000); waited++) {
+      SleepMs(1);
+   }
+   ASSERT_EQ(timer.Pending(), 0u);
+
+   for (uint32_t index = 1; index <= 50; index++) {
+      timer.Schedule(due, Job(recorder, index));
+   }
+   release.SetEvent();
+
+   EXPECT_TRUE(recorder.WaitFor(51));
+
+   std::vector<uint32_t> fired(recorder.Fired());
+   ASSERT_EQ(fired.size(), 51u);
+   for (uint32_t index = 0; index <= 50; index++) {
+      EXPECT_EQ(fired[index], index);
+   }
+}
+
+TEST(Core_Timer, revoke)
+{
+   Recorder recorder;
+   Timer timer(0, _T("Test"));
+
+   for (uint32_t index = 0; index < 20; index++) {
+      timer.Schedule(After(100 + index), Job(recorder, index));
+   }
+   // The same content twice, both of them go.
+   timer.Schedule(After(50), Job(recorder, 7));
+
+   // The first one due, one from the middle and the last one.
+   EXPECT_TRUE(timer.Revoke(Job(recorder, 0)));
+   EXPECT_TRUE(timer.Revoke(Job(recorder, 7)));
+   EXPECT_TRUE(timer.Revoke(Job(recorder, 19)));
+   EXPECT_FALSE(timer.Revoke(Job(recorder, 7)));
+   EXPECT_FALSE(timer.Revoke(Job(recorder, 20)));
+   EXPECT_EQ(timer.Pending(), 17u);
+
+   EXPECT_TRUE(recorder.WaitFor(17));
+   SleepMs(50);
+
+   std::vector<uint32_t> fired(recorder.Fired());
+   ASSERT_EQ(fired.size(), 17u);
+
+   uint32_t expected = 1;
+   for (const uint32_t id : fired) {
+      if (expected == 7) {
+         expected++;
+      }
+      EXPECT_EQ(id, expected);
+      expected++;
+   }
+   EXPECT_EQ(timer.Pending(), 0u);
+}
+
+TEST(Core_Timer, reschedule)
+{
+   Recorder recorder;
+   Timer timer(0, _T("Test"));
+
+   // One that keeps coming back, interleaved with one that fires once.
+   timer.Schedule(After(10), Job(recorder, 1).Repeat(3, 50));
+   timer.Schedule(After(85), Job(recorder, 2));
+
+   EXPECT_TRUE(recorder.WaitFor(5));
+   SleepMs(50);
+
+   std::vector<uint32_t> fired(recorder.Fired());
+   ASSERT_EQ(fired.size(), 5u);
+   EXPECT_EQ(fired[0], 1u);
+   EXPECT_EQ(fired[1], 1u);
+   EXPECT_EQ(fired[2], 2u);
+   EXPECT_EQ(fired[3], 1u);
+   EXPECT_EQ(fired[4], 1u);
+   EXPECT_EQ(timer.Pending(), 0u);
+}
+
+TEST(Core_Timer, trigger)
+{
+   Recorder recorder;
+   Timer timer(0, _T("Test"));
+
+   timer.Schedule(After(10000), Job(recorder, 1));
+   timer.Schedule(After(10000), Job(recorder, 2));
+
+   // Replaces the pending one, it is not added next to it.
+   timer.Trigger(Core::Time::Now().Ticks(), Job(recorder, 1));
+   EXPECT_TRUE(recorder.WaitFor(1));
+
+   std::vector<uint32_t> fired(recorder.Fired());
+   ASSERT_EQ(fired.size(), 1u);
+   EXPECT_EQ(fired[0], 1u);
+   EXPECT_EQ(timer.Pending(), 1u);
+
+   EXPECT_TRUE(timer.Revoke(Job(recorder, 2)));
+   EXPECT_EQ(timer.Pending(), 0u);
+}
@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <tracing/tracing.h>
+
+#ifndef __WIN32__
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
+#include <fstream>
+#include <thread>
+
+using namespace WPEFramework;
+
+namespace {
+
+   const char* moduleName = "Test_Tracing";
+
+   string Captured(const TCHAR formatter[], ...)
+   {
+      Trace::Arguments arguments;
+      string result;
+      va_list ap;
+
+      va_start(ap, formatter);
+      if (arguments.Capture(formatter, ap) == true) {
+         arguments.Format(result);
+      }
+      va_end(ap);
+
+      return (result);
+   }
+
+#ifndef __WIN32__
+   // Sends the direct output of the trace unit to a file, for as long as it lives.
+   class Output {
+   public:
+      Output(const Output&) = delete;
+      Output& operator=(const Output&) = delete;
+
+      Output(const char fileName[])
+         : _fileName(fileName)
+         , _saved(::dup(STDOUT_FILENO))
+      {
+         ::fflush(stdout);
+
+         int descriptor = ::open(fileName, O_CREAT | O_TRUNC | O_WRONLY, 0644);
+         ::dup2(descriptor, STDOUT_FILENO);
+         ::close(descriptor);
+      }
+      ~Output()
+      {
+         ::fflush(stdout);
+         ::dup2(_saved, STDOUT_FILENO);
+         ::close(_saved);
+         ::unlink(_fileName.c_str());
+      }
+
+   public:
+      // The text of every line of the given category, in the order they were written.
+      std::vector<string> Lines(const string& category) const
+      {
+         std::vector<string> result;
+         std::ifstream file(_fileName);
+         const string marker("] " + category + ": ");
+         string line;
+
+         while (std::getline(file, line)) {
+            size_t position = line.find(marker);
+
+            if (position != string::npos) {
+               result.push_back(line.substr(position + marker.length()));
+            }
+         }
+
+         return (result);
+      }
+      std::vector<string> WaitFor(const string& category, const uint32_t count) const
+      {
+         std::vector<string> result(Lines(category));
+
+         for (uint32_t waited = 0; (result.size() < count) && (waited < 5000); waited += 10) {
+            SleepMs(10);
+            result = Lines(category);
+         }
+
+         return (result);
+      }
+
+   private:
+      const string _fileName;
+      int _saved;
+   };
+
+   template <typename CATEGORY>
+   void Emit(CATEGORY& category)
+   {
+      Trace::TraceType<CATEGORY, &moduleName> trace(category);
+
+      Trace::TraceUnit::Instance().Trace(__FILE__, __LINE__, "Test", &trace);
+   }
+#endif
+}
+
+TEST(Trace_Arguments, format)
+{
+   EXPECT_EQ(Captured(_T("%d %u %x %s"), -1, 3000000000u, 255, "text"), _T("-1 3000000000 ff text"));
+   EXPECT_EQ(Captured(_T("%*d|%-*d|%.*f"), 6, 1, -6, 2, 3, 3.14159), _T("     1|2     |3.142"));
+   EXPECT_EQ(Captured(_T("%.*s|%.*s"), 3, "abcdef", -1, "xyz"), _T("abc|xyz"));
+}
+
+#ifndef __WIN32__
+TEST(Trace_Arguments, precisionBoundsText)
+{
+   // Text that is not terminated and ends right before a page that can not be read.
+   const long page = ::sysconf(_SC_PAGESIZE);
+   uint8_t* memory = static_cast<uint8_t*>(::mmap(nullptr, 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+   ASSERT_NE(memory, MAP_FAILED);
+   ASSERT_EQ(::mprotect(&(memory[page]), page, PROT_NONE), 0);
+
+   char* text = reinterpret_cast<char*>(&(memory[page - 4]));
+   ::memcpy(text, "abcd", 4);
+
+   EXPECT_EQ(Captured(_T("[%.*s]"), 4, text), _T("[abcd]"));
+   EXPECT_EQ(Captured(_T("[%.*s]"), 2, text), _T("[ab]"));
+   EXPECT_EQ(Captured(_T("[%.4s]"), text), _T("[abcd]"));
+
+   ::munmap(memory, 2 * page);
+}
+#endif
+
+#ifndef __WIN32__
+TEST(Trace_Unit, ringDrainOverflow)
+{
+   Output output("/tmp/test_tracing.out");
+   std::vector<string> expected;
+
+   Trace::TraceUnit::Instance().DirectOutput(true);
+
+   // Deferred ones, through the ring of this thread, formatted by the drainer.
+   for (uint32_t index = 0; index < 100; index++) {
+      Trace::Information information(_T("ring %d"), index);
+      Emit(information);
+      expected.push_back("ring " + Core::NumberType<uint32_t>(index).Text());
+   }
+
+   // One that does not fit the ring, written out right away, after what this thread has pending.
+   Trace::Information large(string(TRACE_RING_SIZE, 'x'));
+   Emit(large);
+   expected.push_back(string(TRACE_RING_SIZE, 'x'));
+
+   // More than the ring holds, whatever did not fit is written out by this thread.
+   for (uint32_t index = 0; index < 200; index++) {
+      Trace::Information information(Core::NumberType<uint32_t>(index).Text() + string(200, '-'));
+      Emit(information);
+      expected.push_back(Core::NumberType<uint32_t>(index).Text() + string(200, '-'));
+   }
+
+   // An error is out before the call returns, and so is everything traced before it.
+   Trace::Error error(_T("error %d"), 1);
+   Emit(error);
+
+   EXPECT_EQ(output.Lines(_T("Error")), std::vector<string>(1, _T("error 1")));
+   EXPECT_EQ(output.Lines(_T("Information")), expected);
+
+   // And back to the drainer.
+   for (uint32_t index = 0; index < 10; index++) {
+      Trace::Information information(_T("after %d"), index);
+      Emit(information);
+      expected.push_back("after " + Core::NumberType<uint32_t>(index).Text());
+   }
+
+   EXPECT_EQ(output.WaitFor(_T("Information"), static_cast<uint32_t>(expected.size())), expected);
+
+   Trace::TraceUnit::Instance().DirectOutput(false);
+}
+
+TEST(Trace_Unit, threads)
+{
+   Output output("/tmp/test_tracing.out");
+   std::list<std::thread> threads;
+
+   Trace::TraceUnit::Instance().DirectOutput(true);
+
+   // Every thread has a ring of its own, they are merged by the drainer.
+   for (uint8_t thread = 0; thread < 4; thread++) {
+      threads.emplace_back([thread]() {
+         for (uint32_t index = 0; index < 50; index++) {
+            Trace::Information information(_T("%d:%d"), thread, index);
+            Emit(information);
+         }
+      });
+   }
+   for (std::thread& thread : threads) {
+      thread.join();
+   }
+
+   std::vector<string> lines(output.WaitFor(_T("Information"), 200));
+   ASSERT_EQ(lines.size(), 200u);
+
+   // In order per thread.
+   uint32_t next[4] = { 0, 0, 0, 0 };
+   for (const string& line : lines) {
+      const uint32_t thread = line[0] - '0';
+
+      ASSERT_LT(thread, 4u);
+      EXPECT_EQ(line.substr(2), Core::NumberType<uint32_t>(next[thread]).Text());
+      next[thread]++;
+   }
+
+   Trace::TraceUnit::Instance().DirectOutput(false);
+}
+#endif
+
+TEST(Trace_Categories, deferred)
+{
+   Trace::Information information(_T("value %d of %s"), 42, "answer");
+   Trace::Information literal(string(_T("as is")));
+   Trace::Constructor constructor;
+
+   // Formatting categories keep the arguments, till someone reads the text.
+   EXPECT_NE((Trace::TraceType<Trace::Information, &moduleName>(information).Deferred()), nullptr);
+   EXPECT_EQ((Trace::TraceType<Trace::Information, &moduleName>(literal).Deferred()), nullptr);
+   EXPECT_EQ((Trace::TraceType<Trace::Constructor, &moduleName>(constructor).Deferred()), nullptr);
+
+   EXPECT_EQ(string(information.Data(), information.Length()), _T("value 42 of answer"));
+   EXPECT_EQ(string(literal.Data(), literal.Length()), _T("as is"));
+
+   Core::Singleton::Dispose();
+}
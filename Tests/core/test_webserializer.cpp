@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <websocket/websocket.h>
+
+#include <zlib.h>
+
+using namespace WPEFramework;
+
+namespace {
+
+   class Serializer : public Web::Response::Serializer {
+   public:
+      Serializer(const Serializer&) = delete;
+      Serializer& operator=(const Serializer&) = delete;
+
+      Serializer() = default;
+      ~Serializer() = default;
+
+   public:
+      void Serialized(const Web::Response&) override
+      {
+      }
+
+      // The headers (upper cased, so they can be found in any marshal mode) and the body.
+      void Serialize(const Web::Response& response, string& headers, string& body)
+      {
+         uint8_t buffer[256];
+         uint16_t size;
+         string message;
+
+         Submit(response);
+
+         while ((size = Web::Response::Serializer::Serialize(buffer, sizeof(buffer))) != 0) {
+            message.append(reinterpret_cast<const char*>(buffer), size);
+         }
+
+         size_t end = message.find(_T("\r\n\r\n"));
+         ASSERT_NE(end, string::npos);
+
+         headers = message.substr(0, end + 2);
+         body = message.substr(end + 4);
+         Core::ToUpper(headers, headers);
+      }
+   };
+
+   string Text()
+   {
+      string result;
+
+      for (uint16_t index = 0; index < 200; index++) {
+         result += _T("{\"index\":") + Core::NumberType<uint16_t>(index).Text() + _T("}");
+      }
+
+      return (result);
+   }
+
+   Core::ProxyType<Web::Response> TextResponse(const string& text)
+   {
+      Core::ProxyType<Web::Response> response(Core::ProxyType<Web::Response>::Create());
+      Core::ProxyType<Web::TextBody> body(Core::ProxyType<Web::TextBody>::Create());
+
+      *body = text;
+      response->ErrorCode = Web::STATUS_OK;
+      response->ContentType = Web::MIME_JSON;
+      response->Body(body);
+
+      return (response);
+   }
+
+   string Dechunked(const string& body)
+   {
+      string result;
+      size_t offset = 0;
+      size_t end;
+
+      while ((end = body.find(_T("\r\n"), offset)) != string::npos) {
+         uint32_t size = static_cast<uint32_t>(::strtoul(body.substr(offset, end - offset).c_str(), nullptr, 16));
+
+         result += body.substr(end + 2, size);
+         offset = end + 2 + size + 2;
+      }
+
+      return (result);
+   }
+
+   string Gunzipped(const string& data)
+   {
+      string result;
+      z_stream stream;
+      uint8_t buffer[1024];
+
+      ::memset(&stream, 0, sizeof(stream));
+      inflateInit2(&stream, 16 + MAX_WBITS);
+
+      stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.c_str()));
+      stream.avail_in = static_cast<uInt>(data.length());
+
+      int status;
+      do {
+         stream.next_out = buffer;
+         stream.avail_out = sizeof(buffer);
+         status = inflate(&stream, Z_NO_FLUSH);
+         result.append(reinterpret_cast<const char*>(buffer), sizeof(buffer) - stream.avail_out);
+      } while (status == Z_OK);
+
+      inflateEnd(&stream);
+
+      return (status == Z_STREAM_END ? result : string());
+   }
+}
+
+TEST(Web_Serializer, encodedChunked)
+{
+   Serializer serializer;
+   string headers, body;
+   const string text(Text());
+
+   serializer.Encoding(Web::ENCODING_GZIP, true);
+   serializer.Serialize(*TextResponse(text), headers, body);
+
+   EXPECT_NE(headers.find(_T("CONTENT-ENCODING: GZIP\r\n")), string::npos);
+   EXPECT_NE(headers.find(_T("VARY: ACCEPT-ENCODING\r\n")), string::npos);
+   EXPECT_NE(headers.find(_T("TRANSFER-ENCODING: CHUNKED\r\n")), string::npos);
+   EXPECT_EQ(headers.find(_T("CONTENT-LENGTH:")), string::npos);
+   EXPECT_EQ(Gunzipped(Dechunked(body)), text);
+}
+
+TEST(Web_Serializer, identityWithoutChunking)
+{
+   Serializer serializer;
+   string headers, body;
+   const string text(Text());
+
+   // An HTTP/1.0 peer, that accepts gzip, still can not take a chunked body.
+   serializer.Encoding(Web::ENCODING_GZIP, false);
+   serializer.Serialize(*TextResponse(text), headers, body);
+
+   EXPECT_EQ(headers.find(_T("CONTENT-ENCODING:")), string::npos);
+   EXPECT_EQ(headers.find(_T("TRANSFER-ENCODING:")), string::npos);
+   EXPECT_EQ(headers.find(_T("VARY:")), string::npos);
+   EXPECT_NE(headers.find(_T("CONTENT-LENGTH: ") + Core::NumberType<uint32_t>(static_cast<uint32_t>(text.length())).Text() + _T("\r\n")), string::npos);
+   EXPECT_EQ(body, text);
+}
+
+TEST(Web_Serializer, encodedByResponse)
+{
+   Serializer serializer;
+   string headers, body;
+   const string text(Text());
+   Core::ProxyType<Web::Response> response(TextResponse(text));
+
+   // Not negotiated, so nothing for a cache to vary on.
+   response->ContentEncoding = Web::ENCODING_GZIP;
+   serializer.Encoding(Web::ENCODING_UNKNOWN, true);
+   serializer.Serialize(*response, headers, body);
+
+   EXPECT_NE(headers.find(_T("CONTENT-ENCODING: GZIP\r\n")), string::npos);
+   EXPECT_EQ(headers.find(_T("VARY:")), string::npos);
+   EXPECT_EQ(Gunzipped(Dechunked(body)), text);
+}
+
+TEST(Web_Serializer, pipelined)
+{
+   Serializer serializer;
+   string headers, body;
+   const string text(Text());
+
+   // Three requests in before the first response goes out, each response follows its own request.
+   serializer.Encoding(Web::ENCODING_GZIP, true);
+   serializer.Encoding(Web::ENCODING_UNKNOWN, true);
+   serializer.Encoding(Web::ENCODING_GZIP, false);
+
+   serializer.Serialize(*TextResponse(text), headers, body);
+   EXPECT_NE(headers.find(_T("CONTENT-ENCODING: GZIP\r\n")), string::npos);
+   EXPECT_NE(headers.find(_T("TRANSFER-ENCODING: CHUNKED\r\n")), string::npos);
+   EXPECT_EQ(Gunzipped(Dechunked(body)), text);
+
+   serializer.Serialize(*TextResponse(text), headers, body);
+   EXPECT_EQ(headers.find(_T("CONTENT-ENCODING:")), string::npos);
+   EXPECT_EQ(headers.find(_T("VARY:")), string::npos);
+   EXPECT_EQ(body, text);
+
+   serializer.Serialize(*TextResponse(text), headers, body);
+   EXPECT_EQ(headers.find(_T("CONTENT-ENCODING:")), string::npos);
+   EXPECT_EQ(headers.find(_T("TRANSFER-ENCODING:")), string::npos);
+   EXPECT_EQ(body, text);
+
+   // Nothing negotiated for this one, it goes out as is.
+   serializer.Serialize(*TextResponse(text), headers, body);
+   EXPECT_EQ(headers.find(_T("CONTENT-ENCODING:")), string::npos);
+   EXPECT_EQ(body, text);
+}
+
+#ifndef __WIN32__
+TEST(Web_Serializer, encodedCopy)
+{
+   const string name(_T("/tmp/test_webserializer.json"));
+   const string text(Text());
+   string encoded;
+
+   // The file and a gzip copy of it, next to it.
+   {
+      Core::File file(name);
+      ASSERT_TRUE(file.Create());
+      file.Write(reinterpret_cast<const uint8_t*>(text.c_str()), static_cast<uint32_t>(text.length()));
+
+      gzFile copy = gzopen((name + _T(".gz")).c_str(), "wb");
+      ASSERT_NE(copy, nullptr);
+      gzwrite(copy, text.c_str(), static_cast<unsigned>(text.length()));
+      gzclose(copy);
+
+      Core::File gz(name + _T(".gz"));
+      ASSERT_TRUE(gz.Open(true));
+      encoded.resize(static_cast<size_t>(gz.Size()));
+      gz.Read(reinterpret_cast<uint8_t*>(&encoded[0]), static_cast<uint32_t>(encoded.size()));
+   }
+
+   for (bool chunking : { true, false }) {
+      Serializer serializer;
+      string headers, body;
+      Core::ProxyType<Web::Response> response(Core::ProxyType<Web::Response>::Create());
+      Core::ProxyType<Web::FileBody> file(Core::ProxyType<Web::FileBody>::Create(name, false));
+
+      response->ErrorCode = Web::STATUS_OK;
+      response->ContentType = Web::MIME_JSON;
+      response->Body(file);
+
+      // The ready made copy goes out as is, also to peers that can not take chunks.
+      serializer.Encoding(Web::ENCODING_GZIP, chunking);
+      serializer.Serialize(*response, headers, body);
+
+      EXPECT_NE(headers.find(_T("CONTENT-ENCODING: GZIP\r\n")), string::npos);
+      EXPECT_NE(headers.find(_T("VARY: ACCEPT-ENCODING\r\n")), string::npos);
+      EXPECT_EQ(headers.find(_T("TRANSFER-ENCODING:")), string::npos);
+      EXPECT_NE(headers.find(_T("CONTENT-LENGTH: ") + Core::NumberType<uint32_t>(static_cast<uint32_t>(encoded.length())).Text() + _T("\r\n")), string::npos);
+      EXPECT_EQ(body, encoded);
+   }
+
+   ::unlink((name + _T(".gz")).c_str());
+   ::unlink(name.c_str());
+}
+#endif
@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+
+#include <core/core.h>
+#include <websocket/websocket.h>
+
+#include "Benchmark.h"
+
+using namespace WPEFramework;
+
+static void ReferenceMask(uint8_t destination[], const uint8_t source[], const uint32_t length, const uint8_t key[4], const uint8_t offset)
+{
+   for (uint32_t index = 0; index < length; index++) {
+      destination[index] = source[index] ^ key[(index + offset) & 0x3];
+   }
+}
+
+TEST(WebSocket_Mask, kernels)
+{
+   const uint8_t key[4] = { 0x37, 0xFA, 0x21, 0x3D };
+   uint8_t source[300];
+   uint8_t expected[300];
+   uint8_t actual[300];
+
+   for (uint16_t index = 0; index < sizeof(source); index++) {
+      source[index] = static_cast<uint8_t>(index * 7 + 3);
+   }
+
+   // All lengths around the kernel widths, on every alignment and every key phase.
+   for (uint32_t length = 0; length <= 260; length++) {
+      for (uint8_t alignment = 0; alignment < 8; alignment++) {
+         for (uint8_t offset = 0; offset < 4; offset++) {
+            ReferenceMask(expected, &source[alignment], length, key, offset);
+            ::memset(actual, 0, sizeof(actual));
+            Web::WebSocket::Protocol::Mask(&actual[alignment], &source[alignment], length, key, offset);
+            ASSERT_EQ(::memcmp(&actual[alignment], expected, length), 0) << "length " << length << ", alignment " << static_cast<uint32_t>(alignment) << ", offset " << static_cast<uint32_t>(offset);
+
+            // In place, as the Decoder does.
+            ::memcpy(actual, &source[alignment], length);
+            Web::WebSocket::Protocol::Mask(actual, actual, length, key, offset);
+            ASSERT_EQ(::memcmp(actual, expected, length), 0) << "in place, length " << length;
+
+            // Moved down by the 2 unused length bytes, as the Encoder does for small frames.
+            ::memcpy(&actual[2], &source[alignment], length);
+            Web::WebSocket::Protocol::Mask(actual, &actual[2], length, key, offset);
+            ASSERT_EQ(::memcmp(actual, expected, length), 0) << "moved, length " << length;
+         }
+      }
+   }
+}
+
+TEST(WebSocket_Mask, frames)
+{
+   for (uint16_t length : { 1, 5, 125, 126, 1000 }) {
+      uint8_t frame[1100];
+      uint8_t payload[1000];
+
+      for (uint16_t index = 0; index < length; index++) {
+         payload[index] = static_cast<uint8_t>(index ^ 0x5A);
+      }
+
+      Web::WebSocket::Protocol sender(true, true);
+      Web::WebSocket::Protocol receiver(true, false);
+
+      ::memcpy(&frame[sender.PayloadOffset()], payload, length);
+      const uint16_t size = sender.Encoder(frame, sizeof(frame) - sender.PayloadOffset(), length);
+
+      ASSERT_EQ(size, length + (length <= 125 ? 6 : 8));
+
+      // Deliver the frame in two parts, the second part continues in the middle of the key.
+      uint16_t first = (size > 11 ? size - 3 : size);
+      uint16_t received = first;
+      const uint16_t header = receiver.Decoder(frame, received);
+
+      ASSERT_EQ(header, size - length);
+      ASSERT_EQ(::memcmp(&frame[header], payload, received), 0) << "length " << length;
+
+      if (first < size) {
+         uint16_t rest = size - first;
+         EXPECT_EQ(receiver.Decoder(&frame[first], rest), 0);
+         EXPECT_EQ(rest, size - first);
+         EXPECT_EQ(::memcmp(&frame[first], &payload[first - header], rest), 0) << "length " << length;
+      }
+   }
+}
+
+TEST(WebSocket_Mask, DISABLED_throughput)
+{
+   const uint8_t key[4] = { 0x37, 0xFA, 0x21, 0x3D };
+   std::vector<uint8_t> buffer(65536 + 8, 0xA5);
+
+   for (uint32_t length = 16; length <= 65536; length <<= 2) {
+      // Move about 64MB through each implementation.
+      const uint32_t iterations = (64 * 1024 * 1024) / length;
+      const double megabytes = (static_cast<double>(length) * iterations) / (1024 * 1024);
+      const string size(Core::NumberType<uint32_t>(length).Text());
+
+      Report(("Mask " + size + " bytes, bytewise").c_str(), megabytes / Measure([&]() {
+         for (uint32_t index = 0; index < iterations; index++) {
+            ReferenceMask(&buffer[1], &buffer[1], length, key, static_cast<uint8_t>(index));
+         }
+      }), "MB/s");
+      Report(("Mask " + size + " bytes, kernel").c_str(), megabytes / Measure([&]() {
+         for (uint32_t index = 0; index < iterations; index++) {
+            Web::WebSocket::Protocol::Mask(&buffer[1], &buffer[1], length, key, static_cast<uint8_t>(index));
+         }
+      }), "MB/s");
+   }
+}
+
+TEST(WebSocket_Deflate, negotiation)
+{
+   Web::WebSocket::Deflate client;
+   Web::WebSocket::Deflate server;
+   string response;
+
+   client.Settings(Web::WebSocket::Compression(6, 15, true, 0));
+   server.Settings(Web::WebSocket::Compression(6, 10, true, 0));
+
+   // The client allows the server to pick its window, the server limits its own.
+   EXPECT_EQ(client.Offer(), _T("permessage-deflate; client_max_window_bits"));
+   EXPECT_TRUE(server.Accept(client.Offer(), response));
+   EXPECT_EQ(response, _T("permessage-deflate; server_max_window_bits=10; client_max_window_bits=10"));
+   EXPECT_TRUE(client.Accepted(response));
+   EXPECT_TRUE(client.IsActive());
+   EXPECT_TRUE(server.IsActive());
+
+   // The first offer that can be served is taken, malformed or unknown ones are skipped.
+   EXPECT_TRUE(server.Accept(_T("x-webkit-deflate-frame, permessage-deflate; server_max_window_bits=8, permessage-deflate; server_no_context_takeover"), response));
+   EXPECT_EQ(response, _T("permessage-deflate; server_no_context_takeover; server_max_window_bits=10"));
+
+   EXPECT_FALSE(server.Accept(_T("permessage-deflate; unknown_parameter"), response));
+   EXPECT_FALSE(server.Accept(_T("permessage-deflate; server_no_context_takeover; server_no_context_takeover"), response));
+   EXPECT_FALSE(server.Accept(_T("permessage-deflate; server_max_window_bits=16"), response));
+   EXPECT_FALSE(server.IsActive());
+
+   // A client without context takeover asks for it, an answer it can not handle leaves it off.
+   client.Settings(Web::WebSocket::Compression(6, 12, false, 0));
+   EXPECT_EQ(client.Offer(), _T("permessage-deflate; client_max_window_bits; server_max_window_bits=12; client_no_context_takeover"));
+   EXPECT_FALSE(client.Accepted(_T("permessage-deflate; client_max_window_bits=8")));
+   EXPECT_FALSE(client.IsActive());
+}
+
+TEST(WebSocket_Deflate, roundTrip)
+{
+   Web::WebSocket::Deflate client;
+   Web::WebSocket::Deflate server;
+   string response;
+
+   client.Settings(Web::WebSocket::Compression(6, 15, true, 0));
+   server.Settings(Web::WebSocket::Compression(6, 15, true, 0));
+
+   ASSERT_TRUE(server.Accept(client.Offer(), response));
+   ASSERT_TRUE(client.Accepted(response));
+
+   const string message(_T("{\"jsonrpc\":\"2.0\",\"method\":\"Controller.1.statechange\",\"params\":{\"callsign\":\"WebKitBrowser\",\"state\":\"activated\"}}"));
+   uint32_t sizes[3];
+
+   for (uint8_t round = 0; round < 3; round++) {
+      uint8_t frame[512];
+      uint16_t length;
+
+      client.Compress(reinterpret_cast<const uint8_t*>(message.c_str()), static_cast<uint16_t>(message.length()), true);
+      sizes[round] = client.Pending();
+
+      // Handed out in two frames, inflated as they come in.
+      string inflated;
+      uint16_t first = static_cast<uint16_t>(client.Pending() / 2);
+
+      for (uint16_t part : { first, static_cast<uint16_t>(sizeof(frame)) }) {
+         length = client.Compressed(frame, part);
+
+         server.Decompress(frame, length, (client.Pending() == 0));
+
+         uint8_t* data;
+         while ((length = server.Decompressed(data)) != 0) {
+            inflated.append(reinterpret_cast<const char*>(data), length);
+         }
+      }
+
+      EXPECT_EQ(client.Pending(), 0u);
+      EXPECT_FALSE(server.HasError());
+      EXPECT_EQ(inflated, message) << "round " << static_cast<uint32_t>(round);
+   }
+
+   // With the context taken over, repeated messages are mostly references to the previous ones.
+   EXPECT_LT(sizes[1], sizes[0] / 2);
+   EXPECT_LT(sizes[2], sizes[0] / 2);
+}
+
+TEST(WebSocket_Deflate, invalidPayload)
+{
+   Web::WebSocket::Deflate server;
+   string response;
+
+   server.Settings(Web::WebSocket::Compression(6, 15, true, 0));
+   ASSERT_TRUE(server.Accept(_T("permessage-deflate"), response));
+
+   // Block type 3 does not exist.
+   const uint8_t garbage[] = { 0xFF, 0xFF, 0xFF, 0xFF };
+   uint8_t* data;
+
+   server.Decompress(garbage, sizeof(garbage), true);
+   EXPECT_EQ(server.Decompressed(data), 0);
+   EXPECT_TRUE(server.HasError());
+
+   // Such a connection is failed with a close that states the reason.
+   for (bool masking : { false, true }) {
+      Web::WebSocket::Protocol sender(false, masking);
+      uint8_t frame[16];
+
+      sender.Close(Web::WebSocket::Protocol::INVALID_PAYLOAD);
+
+      const uint16_t size = sender.Encoder(frame, sizeof(frame), 0);
+      ASSERT_EQ(size, (masking ? 8 : 4));
+      EXPECT_EQ(frame[0], 0x88);
+      EXPECT_EQ(frame[1], (masking ? 0x82 : 0x02));
+
+      const uint8_t noKey[4] = { 0, 0, 0, 0 };
+      uint8_t status[2];
+      Web::WebSocket::Protocol::Mask(status, &frame[size - 2], 2, (masking ? &frame[2] : noKey), 0);
+      EXPECT_EQ((status[0] << 8) | status[1], 1007);
+
+      // The status is only sent once.
+      EXPECT_EQ(sender.Encoder(frame, sizeof(frame), 0), 0);
+   }
+}